@@ -23,6 +23,11 @@
 #import "YKFAccessoryConnectionController.h"
 #import "YKFAccessoryConnectionConfiguration.h"
 #import "YKFAccessoryDescription.h"
+#import "YKFAccessoryReadinessProbe.h"
+#import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YubiKitConfiguration.h"
 #import "YKFKVOObservation.h"
 #import "YKFBlockMacros.h"
 #import "YKFLogger.h"
@@ -56,9 +61,6 @@ typedef void (^YKFAccessorySessionDispatchBlock)(void);
 
 NSString* const YKFAccessoryConnectionStatePropertyKey = @"sessionState";
 
-static NSTimeInterval const YubiAccessorySessionStartDelay = 0.05; // seconds
-static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // seconds
-
 #pragma mark - YKFAccessorySession
 
 @interface YKFAccessoryConnection()<NSStreamDelegate>
@@ -75,8 +77,10 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
 @property (nonatomic) id<YKFEAAccessoryManagerProtocol> accessoryManager;
 @property (nonatomic) id<YKFEAAccessoryProtocol> accessory;
 @property (nonatomic) id<YKFEASessionProtocol> session;
+@property (nonatomic, nullable) YKFAccessoryReadinessProbe *readinessProbe;
 
 @property (nonatomic) id<YKFConnectionControllerProtocol> connectionController;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
 
 // Services
 
@@ -149,6 +153,28 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
     }];
 }
 
+- (void)oathSessionWithAccessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:nil
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
+- (void)oathSession:(id<YKFSCPKeyParamsProtocol> _Nonnull)scpKeyParams accessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:scpKeyParams
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
 - (void)u2fSession:(YKFU2FSessionCompletionBlock _Nonnull)callback {
     [self.currentSession clearSessionState];
     [YKFU2FSession sessionWithConnectionController:self.connectionController
@@ -170,8 +196,14 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
 
 - (void)fido2Session:(YKFFIDO2SessionCompletionBlock _Nonnull)callback {
     [self.currentSession clearSessionState];
+    // The serial number and firmware revision identify the key for the GetInfo cache across connections.
+    NSString *deviceIdentifier = nil;
+    if (self.accessoryDescription.serialNumber && self.accessoryDescription.firmwareRevision) {
+        deviceIdentifier = [NSString stringWithFormat:@"%@/%@", self.accessoryDescription.serialNumber, self.accessoryDescription.firmwareRevision];
+    }
     [YKFFIDO2Session sessionWithConnectionController:self.connectionController
-                                            completion:^(YKFFIDO2Session *_Nullable session, NSError * _Nullable error) {
+                                    deviceIdentifier:deviceIdentifier
+                                          completion:^(YKFFIDO2Session *_Nullable session, NSError * _Nullable error) {
         self.currentSession = session;
         callback(session, error);
     }];
@@ -532,11 +564,20 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
             return;
         }
         
-        [strongSelf dispatchOnSharedQueueBlock:^{
+        // The connection is open when the streams report they are open and, unless disabled, the key answers
+        // the probe command, instead of after fixed delays.
+        YKFAccessoryReadinessProbe *readinessProbe = strongSelf.readinessProbe;
+        YKFConnectionMetrics *metrics = strongSelf.metrics;
+        [readinessProbe waitUntilReadyWithConnectionController:strongSelf.connectionController completion:^(BOOL ready, NSTimeInterval timeToReady) {
+            ykf_safe_strong_self();
+            if (strongSelf.readinessProbe != readinessProbe || strongSelf.connectionState != YKFAccessoryConnectionStateOpening) {
+                return;
+            }
+            strongSelf.readinessProbe = nil;
+            [metrics recordTimeToReady:timeToReady];
             strongSelf.connectionState = YKFAccessoryConnectionStateOpen;
-        } delay:YubiAccessorySessionStreamOpenDelay]; // Add a small delay to allow the streams to open.
-    }
-    delay:YubiAccessorySessionStartDelay]; // Add a small delay to allow the Key to initialize after connected.
+        }];
+    }];
 }
 
 - (void)accessoryDidDisconnect:(id)notification {
@@ -605,8 +646,15 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
     
     if (self.session) {
         self.reconnectOnApplicationActive = NO;
-        self.connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.session operationQueue:self.communicationQueue];
+        // The delegates are set before the connection controller opens the streams to get the open events.
+        self.readinessProbe = [[YKFAccessoryReadinessProbe alloc] initWithSession:self.session queue:self.sharedDispatchQueue];
+        if (YubiKitConfiguration.accessoryReadinessProbeEnabled) {
+            self.readinessProbe.probeCommand = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameManagement];
+        }
+        self.session.inputStream.delegate = self;
         self.session.outputStream.delegate = self;
+        self.connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.session operationQueue:self.communicationQueue];
+        self.metrics = self.connectionController.metrics;
         
         YKFLogInfo(@"Session opened.");
     } else {
@@ -624,6 +672,8 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
     }
     
     self.connectionState = YKFAccessoryConnectionStateClosing;
+    [self.readinessProbe cancel];
+    self.readinessProbe = nil;
         
     ykf_weak_self();
     [self.connectionController closeConnectionWithCompletion:^{
@@ -649,6 +699,7 @@ static NSTimeInterval const YubiAccessorySessionStreamOpenDelay = 0.2; // second
 
 - (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode {
     if (eventCode != NSStreamEventErrorOccurred && eventCode != NSStreamEventEndEncountered) {
+        [self.readinessProbe stream:aStream handleEvent:eventCode];
         return;
     }
     
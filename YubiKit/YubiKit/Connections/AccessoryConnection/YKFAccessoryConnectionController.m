@@ -22,11 +22,18 @@
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFSessionError+Private.h"
 #import "YKFAPDU+Private.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
 
 @interface YKFAccessoryConnectionController()
 
 @property (nonatomic) NSOperationQueue *communicationQueue;
-@property (nonatomic) NSMutableDictionary *delayedDispatches;
+
+@property (atomic, readwrite) YKFCancellationToken *cancellationToken;
+// The token of the command currently executed on the communication queue.
+@property (atomic) YKFCancellationToken *activeCommandToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
 
 @property (nonatomic) NSInputStream *inputStream;
 @property (nonatomic) NSOutputStream *outputStream;
@@ -38,7 +45,6 @@
 
 static NSUInteger const YubiKeyConnectionControllerReadBufferSize = 512; // bytes
 static NSTimeInterval const YKFAccessoryConnectionCommandProbeTime = 0.05;
-static NSTimeInterval const YKFAccessoryConnectionDefaultTimeout = 10.0;
 static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
 
 - (instancetype)initWithSession:(id<YKFEASessionProtocol>)session operationQueue:(NSOperationQueue *)operationQueue {
@@ -54,7 +60,9 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
         YKFAssertAbortInit(self.inputStream);
         YKFAssertAbortInit(self.outputStream);
         
-        self.delayedDispatches = [[NSMutableDictionary alloc] init];
+        self.cancellationToken = [[YKFCancellationToken alloc] init];
+        self.metrics = [[YKFConnectionMetrics alloc] init];
+        self.timeoutPolicy = [YKFAccessoryConnectionController sharedTimeoutPolicy];
         
         self.streamsThread = [[NSThread alloc] initWithTarget: self selector:@selector(streamsThreadExecution) object:nil];
         [self.streamsThread start];
@@ -68,6 +76,15 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
     return self;
 }
 
++ (YKFTimeoutPolicy *)sharedTimeoutPolicy {
+    static YKFTimeoutPolicy *sharedTimeoutPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedTimeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    });
+    return sharedTimeoutPolicy;
+}
+
 - (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completionBlock {
     YKFParameterAssertReturn(completionBlock);
     
@@ -85,7 +102,16 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
 
 - (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
     YKFParameterAssertReturn(block);
-    
+    NSOperation *operation = [self operationWithBlock:block];
+    // Commands queued later with a higher priority may run before the block, but the block waits for all
+    // the commands already queued.
+    for (NSOperation *queuedOperation in self.communicationQueue.operations) {
+        [operation addDependency:queuedOperation];
+    }
+    [self.communicationQueue addOperation:operation];
+}
+
+- (NSOperation *)operationWithBlock:(YKFConnectionControllerCommunicationQueueBlock)block {
     NSBlockOperation *operation = [[NSBlockOperation alloc] init];
     __weak NSBlockOperation *weakOperation = operation;
     
@@ -97,7 +123,7 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
         block(strongOperation); // Execute the operation if it's still alive and not canceled.
     }];
     
-    [self.communicationQueue addOperation:operation];
+    return operation;
 }
 
 - (void)streamsThreadExecution {
@@ -157,17 +183,17 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
 
 #pragma mark - Stream IO
 
-- (BOOL)writeData:(NSData *)data timeout:(NSTimeInterval)timeout parentOperation:(NSOperation *)operation {
+- (BOOL)writeData:(NSData *)data timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken {
     YKFAssertOffMainThread();
     
     YKFParameterAssertReturnValue(data, NO);
     YKFParameterAssertReturnValue(self.outputStream, NO);
     
     NSMutableData *writeData = [data mutableCopy];
-    NSTimeInterval totalSleepTime = 0;
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
     
-    while (writeData.length > 0 && !operation.isCancelled) {
-        while (self.outputStream.hasSpaceAvailable && writeData.length > 0 && !operation.isCancelled) {
+    while (writeData.length > 0 && !cancellationToken.isCancelled) {
+        while (self.outputStream.hasSpaceAvailable && writeData.length > 0 && !cancellationToken.isCancelled) {
             NSInteger bytesWritten = [self.outputStream write:writeData.bytes maxLength:writeData.length];
             if (bytesWritten > 0) {
                 [writeData replaceBytesInRange:NSMakeRange(0, bytesWritten) withBytes:NULL length:0];
@@ -176,37 +202,48 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
             }
         }
         
-        [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandProbeTime];
-        totalSleepTime += YKFAccessoryConnectionCommandProbeTime;
-        if (totalSleepTime >= timeout) {
+        if (writeData.length == 0) {
+            break;
+        }
+        
+        // The deadline is checked against the clock, the time spent writing and waking up counts too.
+        NSTimeInterval timeLeft = deadline.timeIntervalSinceNow;
+        if (timeLeft <= 0) {
+            return NO;
+        }
+        // Wakes up immediately if the command is cancelled.
+        if ([cancellationToken waitForTimeInterval: MIN(YKFAccessoryConnectionCommandProbeTime, timeLeft)]) {
             return NO;
         }
     }
     
-    if (operation.isCancelled) {
+    if (cancellationToken.isCancelled) {
         return  NO;
     }
     
     return YES;
 }
 
-- (BOOL)readData:(NSData**)readData timeout:(NSTimeInterval)timeout parentOperation:(NSOperation *)operation {
+- (BOOL)readData:(NSData**)readData timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken {
     YKFAssertOffMainThread();
     YKFParameterAssertReturnValue(self.inputStream, NO);
     
     NSMutableData *buffer = [[NSMutableData alloc] init];
     UInt8 readBuffer[YubiKeyConnectionControllerReadBufferSize];
     
-    NSTimeInterval totalSleepTime = 0;
-    while (!self.inputStream.hasBytesAvailable && !operation.isCancelled) {
-        [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandProbeTime];
-        totalSleepTime += YKFAccessoryConnectionCommandProbeTime;
-        if (totalSleepTime >= timeout) {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (!self.inputStream.hasBytesAvailable && !cancellationToken.isCancelled) {
+        NSTimeInterval timeLeft = deadline.timeIntervalSinceNow;
+        if (timeLeft <= 0) {
             return NO;
         }
+        // Wakes up immediately if the command is cancelled.
+        if ([cancellationToken waitForTimeInterval: MIN(YKFAccessoryConnectionCommandProbeTime, timeLeft)]) {
+            break;
+        }
     }
     
-    if (operation.isCancelled) {
+    if (cancellationToken.isCancelled) {
         return NO;
     }
     
@@ -228,101 +265,143 @@ static NSTimeInterval const YKFAccessoryConnectionCommandTime = 0.002;
 #pragma mark - Commands
 
 - (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
-    [self execute:command timeout:YKFAccessoryConnectionDefaultTimeout completion:completion];
+    [self execute:command timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
 }
 
 - (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command priority:YKFCommandPriorityNormal deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
     YKFParameterAssertReturn(command);
     YKFParameterAssertReturn(completion);
     
-    YKFLogVerbose(@"AccessoryConnectionController - Execute command...");
+    // Cancelled by the caller token or by cancelAllCommands while the command is in flight.
+    YKFCancellationToken *commandToken = [[YKFCancellationToken alloc] init];
     
+    NSDate *queuedDate = [NSDate date];
     ykf_weak_self();
-    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+    NSOperation *queuedOperation = [self operationWithBlock:^(NSOperation *operation) {
         ykf_safe_strong_self();
-        NSDate *commandStartDate = [NSDate date];
-        YKFLogVerbose(@"Sent(IAP): %@", [command.ylpApduData ykf_hexadecimalString]);
+        NSTimeInterval commandTimeout = timeout == YKFTimeoutPolicyAdaptiveTimeout ? [strongSelf.timeoutPolicy timeoutForCommand:command] : timeout;
+        BOOL deadlineExceeded = deadline && deadline.timeIntervalSinceNow <= 0;
+        [strongSelf.metrics recordQueueingDelay:-queuedDate.timeIntervalSinceNow priority:priority deadlineExceeded:deadlineExceeded];
+        if (deadlineExceeded) {
+            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorDeadlineExceededCode], 0);
+            return;
+        }
+        strongSelf.activeCommandToken = commandToken;
+        if (!operation.isCancelled) {
+            [strongSelf executeCommand:command timeout:commandTimeout cancellationToken:commandToken completion:completion];
+        }
+        strongSelf.activeCommandToken = nil;
+    }];
+    queuedOperation.queuePriority = YKFOperationQueuePriorityForCommandPriority(priority);
+    
+    __weak NSOperation *weakOperation = queuedOperation;
+    id registration = [cancellationToken addCancellationHandler:^{
+        [weakOperation cancel];
+        [commandToken cancel];
+    }];
+    if (registration) {
+        [queuedOperation setCompletionBlock:^{
+            [cancellationToken removeCancellationHandler:registration];
+        }];
+    }
+    
+    [self.communicationQueue addOperation:queuedOperation];
+}
+
+- (void)executeCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)commandToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFAssertOffMainThread();
+    NSDate *commandStartDate = [NSDate date];
+    UInt8 ins = YKFEventRingIns(command.apduData);
+    YKFEventRingRecord(YKFEventTypeAPDUSent, ins, (UInt32)command.apduData.length, 0);
 
-        // 1. Send the command to the key.
-        BOOL success = [strongSelf writeData:command.ylpApduData timeout:timeout parentOperation:operation];
+    // 1. Send the command to the key.
+    BOOL success = [self writeData:command.ylpApduData timeout:timeout cancellationToken:commandToken];
+    
+    if (!success && !commandToken.isCancelled) {
+        NSError *error = nil;
+        if (self.outputStream.streamError) {
+            error = [self.outputStream.streamError copy];
+        } else {
+            error = [YKFSessionError errorWithCode:YKFSessionErrorWriteTimeoutCode];
+        }
         
-        if (!success && !operation.isCancelled) {
+        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
+        YKFEventRingRecord(YKFEventTypeAPDUFailed, ins, 0, 0);
+        [self.metrics recordCommand:command response:nil duration:executionTime];
+        completion(nil, error, executionTime);
+        return;
+    }
+
+    // Do not wait for the command to process if the operation was canceled.
+    if (commandToken.isCancelled) {
+        return;
+    }
+
+    BOOL keyIsBusyProcesssing = YES;
+    NSData *commandResult = nil;
+
+    while (keyIsBusyProcesssing) {
+        // 2. Wait for the key to process the command.
+        if ([commandToken waitForTimeInterval: YKFAccessoryConnectionCommandTime]) {
+            return;
+        }
+        
+        // 3. Read the command result.
+        success = [self readData:&commandResult timeout:timeout cancellationToken:commandToken];
+
+        if ((!success || commandResult.length == 0) && !commandToken.isCancelled) {
             NSError *error = nil;
-            if (strongSelf.outputStream.streamError) {
-                error = [strongSelf.outputStream.streamError copy];
+            if (self.inputStream.streamError) {
+                error = [self.inputStream.streamError copy];
             } else {
-                error = [YKFSessionError errorWithCode:YKFSessionErrorWriteTimeoutCode];
+                error = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
             }
             
             NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
+            YKFEventRingRecord(YKFEventTypeAPDUFailed, ins, 0, 0);
+            [self.metrics recordCommand:command response:nil duration:executionTime];
             completion(nil, error, executionTime);
             return;
         }
-
-        // Do not wait for the command to process if the operation was canceled.
-        if (operation.isCancelled) {
+        
+        // Do not notify if the operation was canceled.
+        if (commandToken.isCancelled) {
             return;
         }
-
-        BOOL keyIsBusyProcesssing = YES;
-        NSData *commandResult = nil;
-
-        while (keyIsBusyProcesssing) {
-            // 2. Wait for the key to process the command.
-            [NSThread sleepForTimeInterval: YKFAccessoryConnectionCommandTime];
-            
-            // 3. Read the command result.
-            success = [strongSelf readData:&commandResult timeout:timeout parentOperation:operation];
-
-            if ((!success || commandResult.length == 0) && !operation.isCancelled) {
-                NSError *error = nil;
-                if (strongSelf.inputStream.streamError) {
-                    error = [strongSelf.inputStream.streamError copy];
-                } else {
-                    error = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
-                }
-                
-                NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-                completion(nil, error, executionTime);
-                return;
-            }
-            
-            // Do not notify if the operation was canceled.
-            if (operation.isCancelled) {
-                return;
-            }
-            
-            keyIsBusyProcesssing = [strongSelf isKeyBusyProcessingResult:commandResult];
-            if (keyIsBusyProcesssing) {
-                YKFLogVerbose(@"The key is busy, processing the request. Waiting for response...");
-            }
+        
+        keyIsBusyProcesssing = [self isKeyBusyProcessingResult:commandResult];
+        if (keyIsBusyProcesssing) {
+            YKFEventRingRecord(YKFEventTypeWaitingTimeExtension, ins, 0, 0);
+            [self.metrics recordWaitingTimeExtension];
         }
+    }
 
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        YKFLogVerbose(@"Received(IAP): %@", [commandResult ykf_hexadecimalString]);
-        commandResult = [self dataAndStatusFromKeyResponse:commandResult];
+    NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
+    commandResult = [self dataAndStatusFromKeyResponse:commandResult];
+    YKFEventRingRecordResponse(ins, commandResult);
+    [self.metrics recordCommand:command response:commandResult duration:executionTime];
+    [self.timeoutPolicy recordExecutionTime:executionTime forIns:ins];
 
-        completion(commandResult, nil, executionTime);
-        
-        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
-    }];
+    completion(commandResult, nil, executionTime);
 }
 
 - (void)cancelAllCommands {
-    self.communicationQueue.suspended = YES;
-    dispatch_suspend(self.communicationQueue.underlyingQueue);
-    
+    // Queued operations are removed without executing them. The in-flight command is woken up by its token
+    // and returns without waiting for the timeout.
     [self.communicationQueue cancelAllOperations];
+    [self.activeCommandToken cancel];
     
-    NSArray *keys = self.delayedDispatches.allKeys;
-    for (NSString *key in keys) {
-        dispatch_block_t block = self.delayedDispatches[key];
-        dispatch_block_cancel(block);
-    };
-    [self.delayedDispatches removeAllObjects];
-    
-    dispatch_resume(self.communicationQueue.underlyingQueue);
-    self.communicationQueue.suspended = NO;
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    self.cancellationToken = [[YKFCancellationToken alloc] init];
+    [cancellationToken cancel];
 }
 
 #pragma mark - Helpers
@@ -0,0 +1,67 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "EASession+Testing.h"
+#import "YKFConnectionControllerProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class YKFAPDU;
+
+/*
+ Called once when the key is ready, with the time from waitUntilReady... to readiness. ready is NO when the
+ streams did not report they were open within streamOpenTimeout, or when the probe command got no response
+ after maxProbeAttempts; the connection is opened anyway, like it was with the fixed delays. When the probe gave up,
+ a late answer is drained from the input stream first so the first command of the session doesn't read it.
+ */
+typedef void (^YKFAccessoryReadinessCompletionBlock)(BOOL ready, NSTimeInterval timeToReady);
+
+/*
+ Detects when a YubiKey connected over the Lightning port is ready for the first command: the EASession streams
+ are open, and, when a probe command is set, the key answers it. Replaces the fixed delays after the accessory
+ connects and after the session streams are opened.
+ 
+ The probe receives the stream events of the session (set it as the stream delegate or forward the events to it)
+ and runs its checks and retries on the dispatch queue it is created with.
+ */
+@interface YKFAccessoryReadinessProbe: NSObject<NSStreamDelegate>
+
+// The command sent to confirm the key answers. When nil the key is ready as soon as the streams are open.
+@property (nonatomic, nullable) YKFAPDU *probeCommand;
+
+// The number of times the probe command is sent before giving up. Defaults to 4.
+@property (nonatomic) NSUInteger maxProbeAttempts;
+
+// The timeout of each probe command. Defaults to 0.25 seconds.
+@property (nonatomic) NSTimeInterval probeTimeout;
+
+// The delay before the first retry of the probe command, doubled for each further retry. Defaults to 0.02 seconds.
+@property (nonatomic) NSTimeInterval retryInterval;
+
+// The maximum time to wait for the stream open events. Defaults to 1 second.
+@property (nonatomic) NSTimeInterval streamOpenTimeout;
+
+- (instancetype)initWithSession:(id<YKFEASessionProtocol>)session queue:(dispatch_queue_t)queue NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+- (void)waitUntilReadyWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController
+                                    completion:(YKFAccessoryReadinessCompletionBlock)completion;
+
+// Drops the pending checks and retries without calling the completion, e.g. when the key is removed.
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,207 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFAccessoryReadinessProbe.h"
+#import "YKFAPDU.h"
+#import "YKFBlockMacros.h"
+#import "YKFLogger.h"
+#import "YKFAssert.h"
+
+static NSUInteger const YKFAccessoryReadinessDefaultMaxProbeAttempts = 4;
+static NSTimeInterval const YKFAccessoryReadinessDefaultProbeTimeout = 0.25; // seconds
+static NSTimeInterval const YKFAccessoryReadinessDefaultRetryInterval = 0.02; // seconds
+static NSTimeInterval const YKFAccessoryReadinessDefaultStreamOpenTimeout = 1.0; // seconds
+
+static BOOL YKFStreamIsOpen(NSStream *stream) {
+    NSStreamStatus status = stream.streamStatus;
+    return status == NSStreamStatusOpen || status == NSStreamStatusReading || status == NSStreamStatusWriting;
+}
+
+@interface YKFAccessoryReadinessProbe()
+
+@property (nonatomic) id<YKFEASessionProtocol> session;
+@property (nonatomic) dispatch_queue_t queue;
+
+// Accessed on the queue only.
+@property (nonatomic, nullable) id<YKFConnectionControllerProtocol> connectionController;
+@property (nonatomic, nullable) YKFAccessoryReadinessCompletionBlock completion;
+@property (nonatomic) NSDate *startDate;
+@property (nonatomic) BOOL streamsOpen;
+@property (nonatomic) NSUInteger probeAttempts;
+
+@end
+
+@implementation YKFAccessoryReadinessProbe
+
+- (instancetype)initWithSession:(id<YKFEASessionProtocol>)session queue:(dispatch_queue_t)queue {
+    YKFAssertAbortInit(session);
+    YKFAssertAbortInit(queue);
+    
+    self = [super init];
+    if (self) {
+        self.session = session;
+        self.queue = queue;
+        self.maxProbeAttempts = YKFAccessoryReadinessDefaultMaxProbeAttempts;
+        self.probeTimeout = YKFAccessoryReadinessDefaultProbeTimeout;
+        self.retryInterval = YKFAccessoryReadinessDefaultRetryInterval;
+        self.streamOpenTimeout = YKFAccessoryReadinessDefaultStreamOpenTimeout;
+    }
+    return self;
+}
+
+- (void)waitUntilReadyWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController
+                                    completion:(YKFAccessoryReadinessCompletionBlock)completion {
+    YKFParameterAssertReturn(connectionController);
+    YKFParameterAssertReturn(completion);
+    
+    NSDate *startDate = [NSDate date];
+    ykf_weak_self();
+    dispatch_async(self.queue, ^{
+        ykf_safe_strong_self();
+        strongSelf.connectionController = connectionController;
+        strongSelf.completion = completion;
+        strongSelf.startDate = startDate;
+        // The streams may already be open when the events were delivered before the wait started.
+        [strongSelf checkStreams];
+    });
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.streamOpenTimeout * NSEC_PER_SEC)), self.queue, ^{
+        ykf_safe_strong_self();
+        if (!strongSelf.completion || strongSelf.streamsOpen) {
+            return;
+        }
+        YKFLogInfo(@"The accessory session streams did not report they were open after %.2f seconds.", strongSelf.streamOpenTimeout);
+        strongSelf.streamsOpen = YES;
+        if (strongSelf.probeCommand) {
+            [strongSelf sendProbe];
+        } else {
+            [strongSelf finishWithReady:NO];
+        }
+    });
+}
+
+- (void)cancel {
+    ykf_weak_self();
+    dispatch_async(self.queue, ^{
+        ykf_safe_strong_self();
+        strongSelf.completion = nil;
+        strongSelf.connectionController = nil;
+    });
+}
+
+#pragma mark - NSStreamDelegate
+
+- (void)stream:(NSStream *)aStream handleEvent:(NSStreamEvent)eventCode {
+    if (eventCode != NSStreamEventOpenCompleted && eventCode != NSStreamEventHasSpaceAvailable && eventCode != NSStreamEventHasBytesAvailable) {
+        return;
+    }
+    ykf_weak_self();
+    dispatch_async(self.queue, ^{
+        ykf_safe_strong_self();
+        [strongSelf checkStreams];
+    });
+}
+
+#pragma mark - Readiness
+
+- (void)checkStreams {
+    if (!self.completion || self.streamsOpen) {
+        return;
+    }
+    if (!YKFStreamIsOpen(self.session.inputStream) || !YKFStreamIsOpen(self.session.outputStream)) {
+        return;
+    }
+    self.streamsOpen = YES;
+    if (self.probeCommand) {
+        [self sendProbe];
+    } else {
+        [self finishWithReady:YES];
+    }
+}
+
+- (void)sendProbe {
+    self.probeAttempts += 1;
+    NSUInteger attempt = self.probeAttempts;
+    
+    ykf_weak_self();
+    [self.connectionController execute:self.probeCommand timeout:self.probeTimeout completion:^(NSData * _Nullable response, NSError * _Nullable error, NSTimeInterval executionTime) {
+        ykf_safe_strong_self();
+        dispatch_async(strongSelf.queue, ^{
+            if (!strongSelf.completion) {
+                return;
+            }
+            // Any status word means the key processes commands, the probe doesn't need a successful one.
+            if (response) {
+                [strongSelf finishWithReady:YES];
+                return;
+            }
+            if (attempt >= strongSelf.maxProbeAttempts) {
+                YKFLogInfo(@"The YubiKey did not answer the readiness probe after %lu attempts.", (unsigned long)attempt);
+                [strongSelf drainLateProbeAnswer];
+                return;
+            }
+            NSTimeInterval delay = strongSelf.retryInterval * (1 << MIN(attempt - 1, 8));
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), strongSelf.queue, ^{
+                if (strongSelf.completion) {
+                    [strongSelf sendProbe];
+                }
+            });
+        });
+    }];
+}
+
+/*
+ The key may still answer a probe which timed out, and the answer would be read as the response to the first command
+ of the session. The input stream is drained on the communication queue, after waiting one more probe timeout, before
+ the connection is reported open.
+ */
+- (void)drainLateProbeAnswer {
+    ykf_weak_self();
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.probeTimeout * NSEC_PER_SEC)), self.queue, ^{
+        ykf_safe_strong_self();
+        if (!strongSelf.completion) {
+            return;
+        }
+        NSInputStream *inputStream = strongSelf.session.inputStream;
+        [strongSelf.connectionController dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+            UInt8 buffer[64];
+            NSUInteger drainedLength = 0;
+            while (inputStream.hasBytesAvailable) {
+                NSInteger bytesRead = [inputStream read:buffer maxLength:sizeof(buffer)];
+                if (bytesRead <= 0) {
+                    break;
+                }
+                drainedLength += bytesRead;
+            }
+            if (drainedLength > 0) {
+                YKFLogInfo(@"Dropped %lu bytes answering a readiness probe which timed out.", (unsigned long)drainedLength);
+            }
+            dispatch_async(strongSelf.queue, ^{
+                if (strongSelf.completion) {
+                    [strongSelf finishWithReady:NO];
+                }
+            });
+        }];
+    });
+}
+
+- (void)finishWithReady:(BOOL)ready {
+    YKFAccessoryReadinessCompletionBlock completion = self.completion;
+    self.completion = nil;
+    self.connectionController = nil;
+    NSTimeInterval timeToReady = [[NSDate date] timeIntervalSinceDate:self.startDate];
+    YKFLogInfo(@"The YubiKey is ready after %.0f ms.", timeToReady * 1000);
+    completion(ready, timeToReady);
+}
+
+@end
@@ -18,6 +18,7 @@
 #import "YubiKitExternalLocalization.h"
 
 #import "YKFNFCConnectionController.h"
+#import "YKFNFCTagAvailabilityMonitor.h"
 #import "YKFNFCConnection.h"
 #import "YKFNFCConnection+Private.h"
 #import "YKFBlockMacros.h"
@@ -36,6 +37,7 @@
 #import "YKFManagementSession+Private.h"
 #import "YKFSCPSecurityDomainSession+Private.h"
 #import "YKFNFCTagDescription+Private.h"
+#import "YKFNSDataAdditions+Private.h"
 
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
@@ -48,13 +50,14 @@
 @property (nonatomic, readwrite) YKFNFCTagDescription *tagDescription API_AVAILABLE(ios(13.0));
 
 @property (nonatomic) id<YKFConnectionControllerProtocol> connectionController;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
 
 @property (nonatomic) NSOperationQueue *communicationQueue;
 @property (nonatomic) dispatch_queue_t sharedDispatchQueue;
 
 @property (nonatomic) NFCTagReaderSession *nfcTagReaderSession API_AVAILABLE(ios(13.0));
 
-@property (nonatomic) NSTimer *iso7816NfcTagAvailabilityTimer;
+@property (nonatomic) YKFNFCTagAvailabilityMonitor *tagAvailabilityMonitor;
 
 @property (nonatomic, readwrite) id<YKFSessionProtocol> currentSession;
 
@@ -102,6 +105,28 @@
     }];
 }
 
+- (void)oathSessionWithAccessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:nil
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
+- (void)oathSession:(id<YKFSCPKeyParamsProtocol> _Nonnull)scpKeyParams accessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:scpKeyParams
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
 - (void)u2fSession:(YKFU2FSessionCompletionBlock _Nonnull)callback {
     if (@available(iOS 13.0, *)) {
         [self.currentSession clearSessionState];
@@ -125,8 +150,18 @@
 
 - (void)fido2Session:(YKFFIDO2SessionCompletionBlock _Nonnull)callback {
     [self.currentSession clearSessionState];
+    // Every tap creates a new connection controller. The tag identifier, the UID of the key, identifies the key for
+    // the GetInfo cache across taps.
+    NSString *deviceIdentifier = nil;
+    if (@available(iOS 13.0, *)) {
+        NSData *tagIdentifier = self.tagDescription.identifier;
+        if (tagIdentifier.length) {
+            deviceIdentifier = [NSString stringWithFormat:@"nfc/%@", [tagIdentifier ykf_hexadecimalString]];
+        }
+    }
     [YKFFIDO2Session sessionWithConnectionController:self.connectionController
-                                            completion:^(YKFFIDO2Session *_Nullable session, NSError * _Nullable error) {
+                                    deviceIdentifier:deviceIdentifier
+                                          completion:^(YKFFIDO2Session *_Nullable session, NSError * _Nullable error) {
         self.currentSession = session;
         callback(session, error);
     }];
@@ -422,43 +457,56 @@
             [self.nfcTagReaderSession restartPolling];
             break;
             
-        case YKFNFCConnectionStateOpen:
-            [self observeIso7816TagAvailability];
+        case YKFNFCConnectionStateOpen: {
+            YKFNFCConnectionController *connectionController = [[YKFNFCConnectionController alloc] initWithNFCTag:tag operationQueue:self.communicationQueue];
+            [self observeIso7816TagAvailability:tag connectionController:connectionController];
             
-            self.connectionController = [[YKFNFCConnectionController alloc] initWithNFCTag:tag operationQueue:self.communicationQueue];
+            self.connectionController = connectionController;
+            self.metrics = self.connectionController.metrics;
             [self.delegate didConnectNFC:self];
             
             self.tagDescription = [[YKFNFCTagDescription alloc] initWithTag: tag];
             break;
+        }
     }
     
 }
 
 #pragma mark - Tag availability observation
 
-- (void)observeIso7816TagAvailability API_AVAILABLE(ios(13.0)) {
-    // Note: A timer is used because the "available" property is not KVO observable and the tag has no delegate.
-    // This solution is suboptimal but in line with some examples from Apple using a dispatch queue.
+- (void)observeIso7816TagAvailability:(id<NFCISO7816Tag>)tag connectionController:(YKFNFCConnectionController *)connectionController API_AVAILABLE(ios(13.0)) {
+    [self unobserveIso7816TagAvailability];
+    
+    // Note: The "available" property is not KVO observable and the tag has no delegate. The removal is detected
+    // from the command errors and, when the connection is idle, by checking the tag on the communication queue.
     ykf_weak_self();
-    self.iso7816NfcTagAvailabilityTimer = [[NSTimer alloc] initWithFireDate:[NSDate date] interval:0.5 repeats:YES block:^(NSTimer *timer) {
-        ykf_safe_strong_self();
-        BOOL available = strongSelf.nfcTagReaderSession.connectedTag.available;
-        if (available) {
-            YKFLogVerbose(@"NFC tag is available.");
-        } else {
-            YKFLogInfo(@"NFC tag is no longer available.");
+    __block __weak YKFNFCTagAvailabilityMonitor *weakMonitor = nil;
+    YKFNFCTagAvailabilityMonitor *monitor = [[YKFNFCTagAvailabilityMonitor alloc] initWithQueue:self.sharedDispatchQueue availabilityCheck:^BOOL{
+        return tag.isAvailable;
+    } lostHandler:^{
+        dispatch_async(dispatch_get_main_queue(), ^{
+            ykf_safe_strong_self();
+            // Ignore a late notification from the monitor of a tag which was already replaced.
+            if (strongSelf.tagAvailabilityMonitor != weakMonitor) {
+                return;
+            }
             // moving from state of open back to polling/waiting for new tag
             [strongSelf updateServicesForSession:strongSelf.nfcTagReaderSession tag:nil state:YKFNFCConnectionStatePolling errorMessage:nil];
-        }
+        });
     }];
-    [[NSRunLoop mainRunLoop] addTimer:self.iso7816NfcTagAvailabilityTimer forMode:NSDefaultRunLoopMode];
+    weakMonitor = monitor;
+    
+    connectionController.commandResultHandler = ^(BOOL tagLost) {
+        [weakMonitor recordCommandWithTagLost:tagLost];
+    };
+    
+    self.tagAvailabilityMonitor = monitor;
+    [monitor start];
 }
 
 - (void)unobserveIso7816TagAvailability API_AVAILABLE(ios(13.0)) {
-    // Note: A timer is used because the "available" property is not KVO observable and the tag has no delegate.
-    // This solution is suboptimal but in line with some examples from Apple using a dispatch queue.
-    [self.iso7816NfcTagAvailabilityTimer invalidate];
-    self.iso7816NfcTagAvailabilityTimer = nil;
+    [self.tagAvailabilityMonitor stop];
+    self.tagAvailabilityMonitor = nil;
 }
 
 @end
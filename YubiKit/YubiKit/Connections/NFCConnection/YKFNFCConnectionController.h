@@ -23,6 +23,12 @@ API_AVAILABLE(ios(13.0))
 
 - (instancetype)initWithNFCTag:(id<NFCISO7816Tag>)tag operationQueue:(NSOperationQueue *)operationQueue;
 
+/*
+ Called on the communication queue after each command sent to the tag. tagLost is YES when the command
+ failed because the tag is no longer available.
+ */
+@property (nonatomic, copy, nullable) void (^commandResultHandler)(BOOL tagLost);
+
 @end
 
 NS_ASSUME_NONNULL_END
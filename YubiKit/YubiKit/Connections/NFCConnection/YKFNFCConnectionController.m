@@ -15,19 +15,23 @@
 #import "YKFNFCConnectionController.h"
 #import "YKFNSMutableDataAdditions.h"
 #import "YKFBlockMacros.h"
-#import "YKFLogger.h"
 #import "YKFAssert.h"
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFAPDU+Private.h"
-
-static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
 
 @interface YKFNFCConnectionController()
 
 @property (nonatomic) NSOperationQueue *communicationQueue;
-@property (nonatomic) NSMutableDictionary *delayedDispatches;
+
+@property (atomic, readwrite) YKFCancellationToken *cancellationToken;
+// The token of the command currently executed on the communication queue.
+@property (atomic) YKFCancellationToken *activeCommandToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
 
 @property (nonatomic) id<NFCISO7816Tag> tag;
 
@@ -39,86 +43,143 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
     self = [super init];
     if (self) {
         self.tag = tag;
-        self.communicationQueue = operationQueue;        
-        self.delayedDispatches = [[NSMutableDictionary alloc] init];
+        self.communicationQueue = operationQueue;
+        self.cancellationToken = [[YKFCancellationToken alloc] init];
+        self.metrics = [[YKFConnectionMetrics alloc] init];
+        self.timeoutPolicy = [YKFNFCConnectionController sharedTimeoutPolicy];
     }
     return self;
 }
 
++ (YKFTimeoutPolicy *)sharedTimeoutPolicy {
+    static YKFTimeoutPolicy *sharedTimeoutPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedTimeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    });
+    return sharedTimeoutPolicy;
+}
+
 #pragma mark - Commands
 
 - (void)execute:(nonnull YKFAPDU *)command completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
-    [self execute:command timeout:YKFNFCConnectionDefaultTimeout completion:completion];
+    [self execute:command timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
 }
 
 - (void)execute:(nonnull YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)execute:(nonnull YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(nullable YKFCancellationToken *)cancellationToken completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command priority:YKFCommandPriorityNormal deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
     YKFParameterAssertReturn(command);
     YKFParameterAssertReturn(completion);
     
-    YKFLogVerbose(@"NFCConnectionController - Execute command...");
+    // Cancelled by the caller token or by cancelAllCommands while the command is in flight.
+    YKFCancellationToken *commandToken = [[YKFCancellationToken alloc] init];
 
+    NSDate *queuedDate = [NSDate date];
     ykf_weak_self();
-    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+    NSOperation *queuedOperation = [self operationWithBlock:^(NSOperation *operation) {
         ykf_safe_strong_self();
-      
-        // Do not wait for the command to process if the operation was canceled.
-        if (operation.isCancelled) {
+        NSTimeInterval commandTimeout = timeout == YKFTimeoutPolicyAdaptiveTimeout ? [strongSelf.timeoutPolicy timeoutForCommand:command] : timeout;
+        BOOL deadlineExceeded = deadline && deadline.timeIntervalSinceNow <= 0;
+        [strongSelf.metrics recordQueueingDelay:-queuedDate.timeIntervalSinceNow priority:priority deadlineExceeded:deadlineExceeded];
+        if (deadlineExceeded) {
+            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorDeadlineExceededCode], 0);
             return;
         }
-        
-        // Check availability before executing. If the command is queued, the tag may become unavailable at execution time.
-        if (!strongSelf.tag.isAvailable) {
-            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
-            return;
+        strongSelf.activeCommandToken = commandToken;
+        if (!operation.isCancelled) {
+            [strongSelf executeCommand:command timeout:commandTimeout cancellationToken:commandToken completion:completion];
         }
-                
-        NFCISO7816APDU *cnApdu = [[NFCISO7816APDU alloc] initWithData:command.apduData];
-        YKFAssertReturn(cnApdu, @"Could not create a Core NFC APDU object from the command data.");
-
-        __block NSError *executionError = nil;
-        __block NSData *executionResult = nil;
-        NSDate *commandStartDate = [NSDate date];
-        dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
-        YKFLogVerbose(@"Sent(NFC): %@", [command.apduData ykf_hexadecimalString]);
-
-        [strongSelf.tag sendCommandAPDU:cnApdu completionHandler:^(NSData *responseData, uint8_t sw1, uint8_t sw2, NSError *error) {
-            if (error) {
-                executionError = error;
-                dispatch_semaphore_signal(executionSemaphore);
-                return;
-            }
-            
-
-            NSMutableData *fullResponse = [[NSMutableData alloc] initWithData:responseData];
-            [fullResponse ykf_appendByte:sw1];
-            [fullResponse ykf_appendByte:sw2];
-            executionResult = [fullResponse copy];
-
-            YKFLogVerbose(@"Received(NFC): %@", [executionResult ykf_hexadecimalString]);
+        strongSelf.activeCommandToken = nil;
+    }];
+    queuedOperation.queuePriority = YKFOperationQueuePriorityForCommandPriority(priority);
+    
+    __weak NSOperation *weakOperation = queuedOperation;
+    id registration = [cancellationToken addCancellationHandler:^{
+        [weakOperation cancel];
+        [commandToken cancel];
+    }];
+    if (registration) {
+        [queuedOperation setCompletionBlock:^{
+            [cancellationToken removeCancellationHandler:registration];
+        }];
+    }
+    
+    [self.communicationQueue addOperation:queuedOperation];
+}
 
+- (void)executeCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)commandToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    // Do not wait for the command to process if the operation was canceled.
+    if (commandToken.isCancelled) {
+        return;
+    }
+    
+    // Check availability before executing. If the command is queued, the tag may become unavailable at execution time.
+    if (!self.tag.isAvailable) {
+        [self notifyCommandResultWithTagLost:YES];
+        completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
+        return;
+    }
+            
+    NFCISO7816APDU *cnApdu = [[NFCISO7816APDU alloc] initWithData:command.apduData];
+    YKFAssertReturn(cnApdu, @"Could not create a Core NFC APDU object from the command data.");
+
+    __block NSError *executionError = nil;
+    __block NSData *executionResult = nil;
+    NSDate *commandStartDate = [NSDate date];
+    dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
+    UInt8 ins = YKFEventRingIns(command.apduData);
+    YKFEventRingRecord(YKFEventTypeAPDUSent, ins, (UInt32)command.apduData.length, 0);
+
+    [self.tag sendCommandAPDU:cnApdu completionHandler:^(NSData *responseData, uint8_t sw1, uint8_t sw2, NSError *error) {
+        if (error) {
+            executionError = error;
             dispatch_semaphore_signal(executionSemaphore);
-        }];
-        
-        // Lock the async call to enforce the sequential execution using the library dispatch queue.
-        if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
-            executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
-        }
-        
-        // Do not notify if the operation was canceled.
-        if (operation.isCancelled) {
             return;
         }
-
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        if (executionError) {
-            completion(nil, executionError, executionTime);
-        } else {
-            YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
-            completion(executionResult, nil, executionTime);
-        }
         
-        YKFLogVerbose(@"Command execution time: %lf seconds", executionTime);
+
+        NSMutableData *fullResponse = [[NSMutableData alloc] initWithData:responseData];
+        [fullResponse ykf_appendByte:sw1];
+        [fullResponse ykf_appendByte:sw2];
+        executionResult = [fullResponse copy];
+        dispatch_semaphore_signal(executionSemaphore);
     }];
+    
+    // Cancelling the command releases the queue without waiting for the tag response.
+    id registration = [commandToken addCancellationHandler:^{
+        dispatch_semaphore_signal(executionSemaphore);
+    }];
+    
+    // Lock the async call to enforce the sequential execution using the library dispatch queue.
+    if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
+        executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+    }
+    [commandToken removeCancellationHandler:registration];
+    
+    // Do not notify if the operation was canceled.
+    if (commandToken.isCancelled) {
+        return;
+    }
+
+    NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
+    [self.metrics recordCommand:command response:executionError ? nil : executionResult duration:executionTime];
+    [self notifyCommandResultWithTagLost:executionError && [self isTagLostError:executionError]];
+    if (executionError) {
+        YKFEventRingRecord(YKFEventTypeAPDUFailed, ins, 0, 0);
+        completion(nil, executionError, executionTime);
+    } else {
+        YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
+        YKFEventRingRecordResponse(ins, executionResult);
+        [self.timeoutPolicy recordExecutionTime:executionTime forIns:ins];
+        completion(executionResult, nil, executionTime);
+    }
 }
 
 - (void)closeConnectionWithCompletion:(nonnull YKFConnectionControllerCompletionBlock)completion {
@@ -127,27 +188,51 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
 }
 
 - (void)cancelAllCommands {
-    self.communicationQueue.suspended = YES;
-    dispatch_suspend(self.communicationQueue.underlyingQueue);
-    
+    // Queued operations are removed without executing them. The in-flight command is woken up by its token
+    // and returns without waiting for the tag response.
     [self.communicationQueue cancelAllOperations];
+    [self.activeCommandToken cancel];
     
-    NSArray *keys = self.delayedDispatches.allKeys;
-    for (NSString *key in keys) {
-        dispatch_block_t block = self.delayedDispatches[key];
-        dispatch_block_cancel(block);
-    };
-    [self.delayedDispatches removeAllObjects];
-    
-    dispatch_resume(self.communicationQueue.underlyingQueue);
-    self.communicationQueue.suspended = NO;
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    self.cancellationToken = [[YKFCancellationToken alloc] init];
+    [cancellationToken cancel];
 }
 
 #pragma mark - Helpers
 
+- (BOOL)isTagLostError:(NSError *)error {
+    if ([error.domain isEqualToString:NFCErrorDomain]) {
+        switch (error.code) {
+            case NFCReaderTransceiveErrorTagConnectionLost:
+            case NFCReaderTransceiveErrorTagNotConnected:
+                return YES;
+            default:
+                break;
+        }
+    }
+    // Other errors, like a read timeout, may also be caused by the removal of the tag.
+    return !self.tag.isAvailable;
+}
+
+- (void)notifyCommandResultWithTagLost:(BOOL)tagLost {
+    void (^commandResultHandler)(BOOL) = self.commandResultHandler;
+    if (commandResultHandler) {
+        commandResultHandler(tagLost);
+    }
+}
+
 - (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
     YKFParameterAssertReturn(block);
-    
+    NSOperation *operation = [self operationWithBlock:block];
+    // Commands queued later with a higher priority may run before the block, but the block waits for all
+    // the commands already queued.
+    for (NSOperation *queuedOperation in self.communicationQueue.operations) {
+        [operation addDependency:queuedOperation];
+    }
+    [self.communicationQueue addOperation:operation];
+}
+
+- (NSOperation *)operationWithBlock:(YKFConnectionControllerCommunicationQueueBlock)block {
     NSBlockOperation *operation = [[NSBlockOperation alloc] init];
     __weak NSBlockOperation *weakOperation = operation;
     
@@ -159,7 +244,7 @@ static NSTimeInterval const YKFNFCConnectionDefaultTimeout = 10.0;
         block(strongOperation); // Execute the operation if it's still alive and not canceled.
     }];
     
-    [self.communicationQueue addOperation:operation];
+    return operation;
 }
 
 @end
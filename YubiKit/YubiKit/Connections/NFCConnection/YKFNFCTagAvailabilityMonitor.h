@@ -0,0 +1,54 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef BOOL (^YKFNFCTagAvailabilityCheck)(void);
+
+/*
+ Detects when the NFC tag is removed. The connection controller reports the result of every command, so a tag
+ removed during a command is detected from the transceive error. When no commands are sent the monitor reads
+ the availability of the tag on an adaptive interval, short right after a command and growing while the
+ connection is idle. Checks run on the queue the monitor is created with, normally the communication queue,
+ so they never compete with the main thread or interleave with commands.
+ */
+@interface YKFNFCTagAvailabilityMonitor: NSObject
+
+// The check interval right after a command. Defaults to 25 ms.
+@property (nonatomic) NSTimeInterval minimumInterval;
+
+// The check interval the monitor backs off to while the connection is idle. Defaults to 100 ms.
+@property (nonatomic) NSTimeInterval maximumInterval;
+
+/*
+ The lostHandler is called once, on the monitor queue, when the tag is no longer available.
+ */
+- (instancetype)initWithQueue:(dispatch_queue_t)queue
+            availabilityCheck:(YKFNFCTagAvailabilityCheck)availabilityCheck
+                  lostHandler:(dispatch_block_t)lostHandler NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+- (void)start;
+- (void)stop;
+
+/*
+ Called on the monitor queue after each command sent to the tag. Resets the check interval to the minimum.
+ */
+- (void)recordCommandWithTagLost:(BOOL)tagLost;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,135 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFNFCTagAvailabilityMonitor.h"
+#import "YKFBlockMacros.h"
+#import "YKFLogger.h"
+#import "YKFAssert.h"
+
+static NSTimeInterval const YKFNFCTagAvailabilityDefaultMinimumInterval = 0.025; // seconds
+static NSTimeInterval const YKFNFCTagAvailabilityDefaultMaximumInterval = 0.1; // seconds
+
+@interface YKFNFCTagAvailabilityMonitor()
+
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic, copy) YKFNFCTagAvailabilityCheck availabilityCheck;
+@property (nonatomic, copy) dispatch_block_t lostHandler;
+
+// Accessed on the queue only.
+@property (nonatomic, nullable) dispatch_source_t timer;
+@property (nonatomic) NSTimeInterval interval;
+@property (nonatomic) BOOL finished;
+
+@end
+
+@implementation YKFNFCTagAvailabilityMonitor
+
+- (instancetype)initWithQueue:(dispatch_queue_t)queue availabilityCheck:(YKFNFCTagAvailabilityCheck)availabilityCheck lostHandler:(dispatch_block_t)lostHandler {
+    YKFAssertAbortInit(queue);
+    YKFAssertAbortInit(availabilityCheck);
+    YKFAssertAbortInit(lostHandler);
+    
+    self = [super init];
+    if (self) {
+        self.queue = queue;
+        self.availabilityCheck = availabilityCheck;
+        self.lostHandler = lostHandler;
+        self.minimumInterval = YKFNFCTagAvailabilityDefaultMinimumInterval;
+        self.maximumInterval = YKFNFCTagAvailabilityDefaultMaximumInterval;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+- (void)start {
+    ykf_weak_self();
+    dispatch_async(self.queue, ^{
+        ykf_safe_strong_self();
+        if (strongSelf.timer || strongSelf.finished) {
+            return;
+        }
+        strongSelf.timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, strongSelf.queue);
+        dispatch_source_set_event_handler(strongSelf.timer, ^{
+            ykf_safe_strong_self();
+            [strongSelf checkAvailability];
+        });
+        strongSelf.interval = strongSelf.minimumInterval;
+        [strongSelf scheduleCheck];
+        dispatch_resume(strongSelf.timer);
+    });
+}
+
+- (void)stop {
+    ykf_weak_self();
+    dispatch_async(self.queue, ^{
+        ykf_safe_strong_self();
+        [strongSelf finish];
+    });
+}
+
+- (void)recordCommandWithTagLost:(BOOL)tagLost {
+    if (self.finished) {
+        return;
+    }
+    if (tagLost) {
+        [self reportLost];
+        return;
+    }
+    self.interval = self.minimumInterval;
+    [self scheduleCheck];
+}
+
+#pragma mark - Checks
+
+- (void)scheduleCheck {
+    if (!self.timer) {
+        return;
+    }
+    uint64_t interval = (uint64_t)(self.interval * NSEC_PER_SEC);
+    dispatch_source_set_timer(self.timer, dispatch_time(DISPATCH_TIME_NOW, interval), DISPATCH_TIME_FOREVER, interval / 10);
+}
+
+- (void)checkAvailability {
+    if (self.finished) {
+        return;
+    }
+    if (!self.availabilityCheck()) {
+        [self reportLost];
+        return;
+    }
+    self.interval = MIN(self.interval * 2, self.maximumInterval);
+    [self scheduleCheck];
+}
+
+- (void)reportLost {
+    YKFLogInfo(@"NFC tag is no longer available.");
+    dispatch_block_t lostHandler = self.lostHandler;
+    [self finish];
+    lostHandler();
+}
+
+- (void)finish {
+    self.finished = YES;
+    if (self.timer) {
+        dispatch_source_cancel(self.timer);
+        self.timer = nil;
+    }
+}
+
+@end
@@ -35,6 +35,7 @@ typedef void (^YKFSCPProcessorCompletionBlock)(YKFSCPProcessor *_Nullable, NSErr
 
 - (void)executeCommand:(YKFAPDU *)apdu
       sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns
+               timeout:(NSTimeInterval)timeout
                encrypt:(BOOL)encrypt
 usingSmartCardInterface:(YKFSmartCardInterface *)smartCardInterface
             completion:(YKFSmartCardInterfaceResponseBlock)completion;
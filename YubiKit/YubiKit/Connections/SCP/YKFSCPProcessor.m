@@ -27,6 +27,10 @@
 #import "YKFTLVRecord.h"
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
+#import "YKFSecureArena.h"
+#import <CommonCrypto/CommonDigest.h>
 
 @interface YKFSCPProcessor ()
 @property (nonatomic, strong) YKFSCPState *state;
@@ -100,7 +104,7 @@ typedef NS_ENUM(uint8_t, YKFSCPKid) {
             
             YKFAPDU *finalizeApdu = [[YKFAPDU alloc] initWithCla:0x84 ins:0x82 p1:0x33 p2:0x00 data:hostCryptogram type:YKFAPDUTypeExtended];
             
-            [processor executeCommand:finalizeApdu sendRemainingIns:sendRemainingIns encrypt:NO usingSmartCardInterface:smartCardInterface completion:^(NSData * _Nullable result, NSError * _Nullable error) {
+            [processor executeCommand:finalizeApdu sendRemainingIns:sendRemainingIns timeout:YKFTimeoutPolicyAdaptiveTimeout encrypt:NO usingSmartCardInterface:smartCardInterface completion:^(NSData * _Nullable result, NSError * _Nullable error) {
                 if (error) {
                     completion(nil, error);
                     return;
@@ -203,26 +207,33 @@ typedef NS_ENUM(uint8_t, YKFSCPKid) {
             NSData *keyAgreement2 = (__bridge_transfer NSData *)SecKeyCopyKeyExchangeResult(skOceEcka, kSecKeyAlgorithmECDHKeyExchangeStandard, pkSdEcka, (__bridge CFDictionaryRef)@{}, nil);
             CFRelease(pkSdEcka);
             
-            NSMutableData *keyMaterial = [keyAgreement1 mutableCopy];
-            [keyMaterial appendData:keyAgreement2];
-            
-            NSMutableArray *keys = [NSMutableArray array];
-            for (uint32_t counter = 1; counter <= 4; counter++) {
-                NSMutableData *dataToHash = [keyMaterial mutableCopy];
-                uint32_t bigEndianCounter = CFSwapInt32HostToBig(counter);
-                NSData *counterData = [NSData dataWithBytes:&bigEndianCounter length:sizeof(bigEndianCounter)];
-                [dataToHash appendData:counterData];
-                [dataToHash appendData:sharedInfo];
-                NSData *digest = [dataToHash ykf_SHA256];
-                [keys addObject:[digest subdataWithRange:NSMakeRange(0, 16)]];
-                [keys addObject:[digest subdataWithRange:NSMakeRange(16, digest.length - 16)]];
-            }
+            // X9.63 KDF over both shared secrets. The key material and the digests stay in the secure arena; only
+            // the derived keys are copied out, and wiped once the session keys hold them.
+            NSMutableArray<NSMutableData *> *keys = [NSMutableArray array];
+            [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+                NSUInteger keyMaterialLength = keyAgreement1.length + keyAgreement2.length;
+                NSMutableData *dataToHash = [scope mutableDataWithLength:keyMaterialLength + sizeof(uint32_t) + sharedInfo.length];
+                [dataToHash replaceBytesInRange:NSMakeRange(0, keyAgreement1.length) withBytes:keyAgreement1.bytes];
+                [dataToHash replaceBytesInRange:NSMakeRange(keyAgreement1.length, keyAgreement2.length) withBytes:keyAgreement2.bytes];
+                [dataToHash replaceBytesInRange:NSMakeRange(keyMaterialLength + sizeof(uint32_t), sharedInfo.length) withBytes:sharedInfo.bytes];
+                NSMutableData *digest = [scope mutableDataWithLength:CC_SHA256_DIGEST_LENGTH];
+                for (uint32_t counter = 1; counter <= 4; counter++) {
+                    uint32_t bigEndianCounter = CFSwapInt32HostToBig(counter);
+                    [dataToHash replaceBytesInRange:NSMakeRange(keyMaterialLength, sizeof(bigEndianCounter)) withBytes:&bigEndianCounter];
+                    CC_SHA256(dataToHash.bytes, (CC_LONG)dataToHash.length, digest.mutableBytes);
+                    [keys addObject:[NSMutableData dataWithBytes:digest.bytes length:16]];
+                    [keys addObject:[NSMutableData dataWithBytes:(const UInt8 *)digest.bytes + 16 length:16]];
+                }
+            }];
             
             NSData *genReceipt = [keyAgreementData ykf_aesCMACWithKey:keys[0]];
+            YKFSCPSessionKeys *sessionKeys = [[YKFSCPSessionKeys alloc] initWithSenc:keys[1] smac:keys[2] srmac:keys[3] dek:keys[4]];
+            for (NSMutableData *key in keys) {
+                YKFSecureZeroData(key);
+            }
             if (![genReceipt ykf_constantTimeCompareWithData:receipt]) {
                 @throw [NSException exceptionWithName:NSInternalInconsistencyException reason:@"MAC verification failed" userInfo:nil];
             }
-            YKFSCPSessionKeys *sessionKeys = [[YKFSCPSessionKeys alloc] initWithSenc:keys[1] smac:keys[2] srmac:keys[3] dek:keys[4]];
             YKFSCPState *state = [[YKFSCPState alloc] initWithSessionKeys:sessionKeys macChain:receipt];
             
             YKFSCPProcessor *processor = [[YKFSCPProcessor alloc] initWithState:state];
@@ -235,10 +246,12 @@ typedef NS_ENUM(uint8_t, YKFSCPKid) {
 
 - (void)executeCommand:(YKFAPDU *)apdu
       sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns
+               timeout:(NSTimeInterval)timeout
                encrypt:(BOOL)encrypt
 usingSmartCardInterface:(YKFSmartCardInterface *)smartCardInterface
             completion:(YKFSmartCardInterfaceResponseBlock)completion {
     
+    NSDate *wrapStartDate = [NSDate date];
     NSData *data;
     if (encrypt) {
         NSError *error = nil;
@@ -265,14 +278,19 @@ usingSmartCardInterface:(YKFSmartCardInterface *)smartCardInterface
     NSMutableData *dataAndMac = [data mutableCopy];
     [dataAndMac appendData:mac];
     YKFAPDU *processedAPDU = [[YKFAPDU alloc] initWithCla:cla ins:apdu.ins p1:apdu.p1 p2:apdu.p2 data:dataAndMac type:apdu.type];
+    NSTimeInterval wrapDuration = -[wrapStartDate timeIntervalSinceNow];
+    NSUInteger commandOverhead = processedAPDU.apduData.length - apdu.apduData.length;
+    YKFEventRingRecord(YKFEventTypeSCPWrap, apdu.ins, (UInt32)dataAndMac.length, 0);
     
     NSMutableData *resultData = [NSMutableData new];
-    [smartCardInterface executeRecursiveCommand:processedAPDU sendRemainingIns:sendRemainingIns timeout:20 data:resultData completion:^(NSData * _Nullable result, NSError * _Nullable error) {
+    [smartCardInterface executeRecursiveCommand:processedAPDU sendRemainingIns:sendRemainingIns timeout:timeout data:resultData completion:^(NSData * _Nullable result, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
             return;
         }
         
+        NSDate *unwrapStartDate = [NSDate date];
+        NSUInteger wrappedResultLength = result.length;
         if (result.length > 0) {
             NSError *unmacError = nil;
             result = [self.state unmacWithData:result sw:0x9000 error:&unmacError];
@@ -291,6 +309,9 @@ usingSmartCardInterface:(YKFSmartCardInterface *)smartCardInterface
             }
         }
         
+        NSTimeInterval duration = wrapDuration - [unwrapStartDate timeIntervalSinceNow];
+        YKFEventRingRecord(YKFEventTypeSCPUnwrap, apdu.ins, (UInt32)result.length, 0x9000);
+        [smartCardInterface.metrics recordSCPCommandWithOverheadBytes:commandOverhead + wrappedResultLength - result.length duration:duration];
         completion(result, nil);
     }];
 }
@@ -16,6 +16,7 @@
 #import "YKFSCPSecurityDomainSession+Private.h"
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 #import "YKFSession+Private.h"
 #import "YKFTLVRecord.h"
 #import "YKFSCPKeyRef.h"
@@ -33,7 +34,7 @@
     YKFSecurityDomainSession *session = [YKFSecurityDomainSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameSecurityDomain];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameSecurityDomain];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -49,7 +50,7 @@
     YKFSecurityDomainSession *session = [YKFSecurityDomainSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameSecurityDomain];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameSecurityDomain];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -14,20 +14,29 @@
 
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFSCPSessionKeys.h"
+#import "YKFSecureArena.h"
 
 @implementation YKFSCPSessionKeys
 
 - (instancetype)initWithSenc:(NSData *)senc smac:(NSData *)smac srmac:(NSData *)srmac dek:(NSData * _Nullable)dek {
     self = [super init];
     if (self) {
-        _senc = senc;
-        _smac = smac;
-        _srmac = srmac;
-        _dek = dek;
+        // Own copies, so the keys can be zeroed when the session ends.
+        _senc = [senc mutableCopy];
+        _smac = [smac mutableCopy];
+        _srmac = [srmac mutableCopy];
+        _dek = [dek mutableCopy];
     }
     return self;
 }
 
+- (void)dealloc {
+    YKFSecureZeroData(_senc);
+    YKFSecureZeroData(_smac);
+    YKFSecureZeroData(_srmac);
+    YKFSecureZeroData(_dek);
+}
+
 - (NSString *)debugDescription {
     NSString *sencHex = self.senc.ykf_hexadecimalString;
     NSString *smacHex = self.smac.ykf_hexadecimalString;
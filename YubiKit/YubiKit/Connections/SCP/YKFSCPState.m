@@ -15,6 +15,7 @@
 #import "YKFSCPState.h"
 #import "YKFSCPSessionKeys.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "ykf_scp.h"
 
 @implementation YKFSCPState
 
@@ -28,88 +29,64 @@
     return self;
 }
 
-- (NSData *)encrypt:(NSData *)data error:(NSError **)error {    
-    NSData *paddedData = [data ykf_bitPadded];
-    NSMutableData *ivData = [NSMutableData dataWithLength:12];
-    uint32_t encCounterBE = CFSwapInt32HostToBig(self.encCounter);
-    [ivData appendBytes:&encCounterBE length:sizeof(encCounterBE)];
+- (NSData *)encrypt:(NSData *)data error:(NSError **)error {
+    NSData *key = self.sessionKeys.senc;
+    NSMutableData *encrypted = [NSMutableData dataWithLength:ykf_bit_padded_length(data.length)];
+    size_t encryptedLength = 0;
+    ykf_status status = ykf_scp_encrypt(ykf_aes_commoncrypto_ops(), key.bytes, key.length, self.encCounter,
+                                        data.bytes, data.length, encrypted.mutableBytes, encrypted.length, &encryptedLength);
     self.encCounter += 1;
+    if (status != YKF_OK) return nil;
     
-    NSData *iv = [ivData ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeECB key:self.sessionKeys.senc iv:nil];
-    if (!iv) return nil;
-
-    return [paddedData ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:self.sessionKeys.senc iv:iv];
+    return encrypted;
 }
 
 - (NSData *)decrypt:(NSData *)data error:(NSError **)error {
-    NSMutableData *ivData = [NSMutableData data];
-    uint8_t paddingByte = 0x80;
-    [ivData appendBytes:&paddingByte length:1];
-    [ivData appendData:[NSMutableData dataWithLength:11]];
-    uint32_t encCounterBE = CFSwapInt32HostToBig(self.encCounter - 1);
-    [ivData appendBytes:&encCounterBE length:sizeof(encCounterBE)];
-    
-    NSData *iv = [ivData ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeECB key:self.sessionKeys.senc iv:nil];
-    if (!iv) return nil;
+    NSData *key = self.sessionKeys.senc;
+    NSMutableData *decrypted = [NSMutableData dataWithLength:data.length];
+    size_t decryptedLength = 0;
+    ykf_status status = ykf_scp_decrypt(ykf_aes_commoncrypto_ops(), key.bytes, key.length, self.encCounter - 1,
+                                        data.bytes, data.length, decrypted.mutableBytes, decrypted.length, &decryptedLength);
+    if (status != YKF_OK) return nil;
     
-    NSData *decrypted = [data ykf_cryptOperation:kCCDecrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:self.sessionKeys.senc iv:iv];
-
-    if (!decrypted) return nil;
-
-    return [self unpadData:decrypted];
+    decrypted.length = decryptedLength;
+    return decrypted;
 }
 
 - (NSData * _Nullable)unpadData:(NSData *)data {
-    NSInteger lastNonZeroIndex = -1;
-    for (NSInteger i = data.length - 1; i >= 0; i--) {
-        uint8_t byte;
-        [data getBytes:&byte range:NSMakeRange(i, 1)];
-        if (byte != 0x00) {
-            lastNonZeroIndex = i;
-            break;
-        }
-    }
+    size_t unpaddedLength = 0;
+    if (ykf_bit_unpad(data.bytes, data.length, &unpaddedLength) != YKF_OK) return nil;
     
-    if (lastNonZeroIndex == -1) return nil;
-    
-    uint8_t lastByte;
-    [data getBytes:&lastByte range:NSMakeRange(lastNonZeroIndex, 1)];
-    if (lastByte == 0x80) {
-        return [data subdataWithRange:NSMakeRange(0, lastNonZeroIndex)];
-    }
-    
-    return nil;
+    return [data subdataWithRange:NSMakeRange(0, unpaddedLength)];
 }
 
 - (NSData *)macWithData:(NSData *)data error:(NSError **)error {
-    NSMutableData *message = [NSMutableData dataWithData:self.macChain];
-    [message appendData:data];
-
-    self.macChain = [[message ykf_aesCMACWithKey:self.sessionKeys.smac] mutableCopy];
-    if (!self.macChain) return nil;
+    NSData *key = self.sessionKeys.smac;
+    if (self.macChain.length != YKF_AES_BLOCK_SIZE) return nil;
+    
+    UInt8 mac[YKF_SCP_MAC_LENGTH];
+    ykf_status status = ykf_scp_mac(ykf_aes_commoncrypto_ops(), key.bytes, key.length, self.macChain.mutableBytes,
+                                    data.bytes, data.length, mac);
+    if (status != YKF_OK) return nil;
     
-    return [self.macChain subdataWithRange:NSMakeRange(0, 8)];
+    return [NSData dataWithBytes:mac length:YKF_SCP_MAC_LENGTH];
 }
 
 - (NSData *)unmacWithData:(NSData *)data sw:(uint16_t)sw error:(NSError **)error {
-    NSMutableData *message = [NSMutableData dataWithData:[data subdataWithRange:NSMakeRange(0, data.length - 8)]];
-    uint16_t swBigEndian = CFSwapInt16HostToBig(sw);
-    [message appendBytes:&swBigEndian length:sizeof(swBigEndian)];
-
-    NSMutableData *macChainAndMessage = [self.macChain mutableCopy];
-    [macChainAndMessage appendData:message];
-    NSData *rmac = [[macChainAndMessage ykf_aesCMACWithKey:self.sessionKeys.srmac] subdataWithRange:NSMakeRange(0, 8)];
-    if (!rmac) return nil;
+    NSData *key = self.sessionKeys.srmac;
+    if (data.length < YKF_SCP_MAC_LENGTH || self.macChain.length != YKF_AES_BLOCK_SIZE) return nil;
     
-    NSData *expectedMac = [data subdataWithRange:NSMakeRange(data.length - 8, 8)];
-    if (![rmac ykf_constantTimeCompareWithData:expectedMac]) {
+    ykf_status status = ykf_scp_unmac(ykf_aes_commoncrypto_ops(), key.bytes, key.length, self.macChain.bytes,
+                                      data.bytes, data.length, sw);
+    if (status == YKF_ERR_MAC_MISMATCH) {
         if (error) {
             *error = [NSError errorWithDomain:@"SCPStateError" code:101 userInfo:@{NSLocalizedDescriptionKey: @"MAC mismatch"}];
         }
         return nil;
     }
+    if (status != YKF_OK) return nil;
     
-    return [message subdataWithRange:NSMakeRange(0, message.length - 2)];
+    return [data subdataWithRange:NSMakeRange(0, data.length - YKF_SCP_MAC_LENGTH)];
 }
 
 - (NSString *)debugDescription {
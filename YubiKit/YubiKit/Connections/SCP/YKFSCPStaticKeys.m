@@ -14,6 +14,8 @@
 
 #import "YKFSCPStaticKeys.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "YKFSecureArena.h"
+#import "ykf_aes.h"
 
 @implementation YKFSCPStaticKeys
 
@@ -48,7 +50,11 @@ static NSData *defaultKey;
         return nil;
     }
 
-    return [[YKFSCPSessionKeys alloc] initWithSenc:senc smac:smac srmac:srmac dek:self.dek];
+    YKFSCPSessionKeys *sessionKeys = [[YKFSCPSessionKeys alloc] initWithSenc:senc smac:smac srmac:srmac dek:self.dek];
+    YKFSecureZeroData(senc);
+    YKFSecureZeroData(smac);
+    YKFSecureZeroData(srmac);
+    return sessionKeys;
 }
 
 + (instancetype)defaultKeys {
@@ -75,8 +81,14 @@ static NSData *defaultKey;
     [i appendBytes:&oneByte length:sizeof(oneByte)];
     [i appendData:context];
 
-    NSData *digest = [i ykf_aesCMACWithKey:key];
-    return [digest subdataWithRange:NSMakeRange(0, l / 8)];
+    // The CMAC is computed on the stack and only the derived bytes are copied out.
+    UInt8 digest[YKF_AES_BLOCK_SIZE];
+    if (ykf_aes_cmac(ykf_aes_commoncrypto_ops(), key.bytes, key.length, i.bytes, i.length, digest) != YKF_OK) {
+        return nil;
+    }
+    NSMutableData *derivedKey = [NSMutableData dataWithBytes:digest length:l / 8];
+    ykf_secure_zero(digest, sizeof(digest));
+    return derivedKey;
 }
 
 @end
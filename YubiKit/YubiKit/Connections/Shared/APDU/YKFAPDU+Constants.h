@@ -0,0 +1,56 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFAPDU.h"
+#import "YKFSelectApplicationAPDU.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Shared instances of the commands which never change. Each one is encoded once, YLP iAP2 framing included, on
+ first use and then sent as is, so polling and response chaining don't build a new APDU per command. APDUs are
+ immutable and can be sent on any connection and from any queue.
+ */
+@interface YKFAPDU (Constants)
+
+/// GET RESPONSE, 00 C0 00 00 00, continues a response chained with SW 61XX.
+@property (class, nonatomic, readonly) YKFAPDU *getResponseAPDU;
+
+/// OATH SEND REMAINING, 00 A5 00 00 00, continues a chained OATH response.
+@property (class, nonatomic, readonly) YKFAPDU *oathSendRemainingAPDU;
+
+/// OATH LIST.
+@property (class, nonatomic, readonly) YKFAPDU *oathListAPDU;
+
+/// FIDO2 GET RESPONSE, polled while the key waits for touch.
+@property (class, nonatomic, readonly) YKFAPDU *fido2TouchPollingAPDU;
+
+/// The FIDO2 authenticatorGetInfo, authenticatorGetNextAssertion and authenticatorReset commands.
+@property (class, nonatomic, readonly) YKFAPDU *fido2GetInfoAPDU;
+@property (class, nonatomic, readonly) YKFAPDU *fido2GetNextAssertionAPDU;
+@property (class, nonatomic, readonly) YKFAPDU *fido2ResetAPDU;
+
+/// Management DEVICE RESET.
+@property (class, nonatomic, readonly) YKFAPDU *managementDeviceResetAPDU;
+
+/// SELECT of the application.
++ (YKFSelectApplicationAPDU *)selectApplicationAPDUWithName:(YKFSelectApplicationAPDUName)name;
+
+/// Management READ CONFIG of a page of device info. The first pages are shared, later ones are built on demand.
++ (YKFAPDU *)managementReadDeviceInfoAPDUWithPage:(UInt8)page;
+
+@end
+
+NS_ASSUME_NONNULL_END
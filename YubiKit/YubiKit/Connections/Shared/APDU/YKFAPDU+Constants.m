@@ -0,0 +1,102 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFAPDU+Constants.h"
+#import "YKFAPDUCommandInstruction.h"
+#import "YKFFIDO2TouchPoolingAPDU.h"
+#import "YKFFIDO2GetInfoAPDU.h"
+#import "YKFFIDO2GetNextAssertionAPDU.h"
+#import "YKFFIDO2ResetAPDU.h"
+#import "YKFOATHListAPDU.h"
+
+static const UInt8 YKFManagementInsReadConfig = 0x1D;
+static const UInt8 YKFManagementInsDeviceReset = 0x1F;
+
+// Device info fits 1 to 3 pages on current keys.
+static const UInt8 YKFManagementSharedDeviceInfoPages = 4;
+
+// Returns the APDU built by expression on the first call.
+#define YKFReturnSharedAPDU(expression) \
+    static YKFAPDU *apdu = nil; \
+    static dispatch_once_t onceToken; \
+    dispatch_once(&onceToken, ^{ \
+        apdu = (expression); \
+    }); \
+    return apdu;
+
+@implementation YKFAPDU (Constants)
+
++ (YKFAPDU *)getResponseAPDU {
+    YKFReturnSharedAPDU([[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(UInt8[]){0x00, 0xC0, 0x00, 0x00, 0x00} length:5]])
+}
+
++ (YKFAPDU *)oathSendRemainingAPDU {
+    YKFReturnSharedAPDU([[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(UInt8[]){0x00, YKFAPDUCommandInstructionOATHSendRemaining, 0x00, 0x00, 0x00} length:5]])
+}
+
++ (YKFAPDU *)oathListAPDU {
+    YKFReturnSharedAPDU([[YKFOATHListAPDU alloc] init])
+}
+
++ (YKFAPDU *)fido2TouchPollingAPDU {
+    YKFReturnSharedAPDU([[YKFFIDO2TouchPoolingAPDU alloc] init])
+}
+
++ (YKFAPDU *)fido2GetInfoAPDU {
+    YKFReturnSharedAPDU([[YKFFIDO2GetInfoAPDU alloc] init])
+}
+
++ (YKFAPDU *)fido2GetNextAssertionAPDU {
+    YKFReturnSharedAPDU([[YKFFIDO2GetNextAssertionAPDU alloc] init])
+}
+
++ (YKFAPDU *)fido2ResetAPDU {
+    YKFReturnSharedAPDU([[YKFFIDO2ResetAPDU alloc] init])
+}
+
++ (YKFAPDU *)managementDeviceResetAPDU {
+    YKFReturnSharedAPDU([[YKFAPDU alloc] initWithCla:0x00 ins:YKFManagementInsDeviceReset p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeExtended])
+}
+
++ (YKFSelectApplicationAPDU *)selectApplicationAPDUWithName:(YKFSelectApplicationAPDUName)name {
+    static NSArray<YKFSelectApplicationAPDU *> *apdus = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray<YKFSelectApplicationAPDU *> *selectAPDUs = [[NSMutableArray alloc] init];
+        for (NSUInteger application = 0; application <= YKFSelectApplicationAPDUNameSecurityDomain; application++) {
+            [selectAPDUs addObject:[[YKFSelectApplicationAPDU alloc] initWithApplicationName:application]];
+        }
+        apdus = [selectAPDUs copy];
+    });
+    NSParameterAssert(name < apdus.count);
+    return apdus[name];
+}
+
++ (YKFAPDU *)managementReadDeviceInfoAPDUWithPage:(UInt8)page {
+    static NSArray<YKFAPDU *> *apdus = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray<YKFAPDU *> *pageAPDUs = [[NSMutableArray alloc] init];
+        for (UInt8 sharedPage = 0; sharedPage < YKFManagementSharedDeviceInfoPages; sharedPage++) {
+            [pageAPDUs addObject:[[YKFAPDU alloc] initWithCla:0x00 ins:YKFManagementInsReadConfig p1:sharedPage p2:0x00 data:[NSData data] type:YKFAPDUTypeShort]];
+        }
+        apdus = [pageAPDUs copy];
+    });
+    if (page < apdus.count) {
+        return apdus[page];
+    }
+    return [[YKFAPDU alloc] initWithCla:0x00 ins:YKFManagementInsReadConfig p1:page p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+}
+
+@end
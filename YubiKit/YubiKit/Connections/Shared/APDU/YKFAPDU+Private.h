@@ -29,6 +29,11 @@ The APDU raw data.
 */
 @property (nonatomic, readonly) NSData *apduData;
 
+/*!
+ Zeroes the command data and the encoded command. Used for commands carrying PINs and keys once the key has answered.
+ */
+- (void)wipe;
+
 @end
 
 #endif
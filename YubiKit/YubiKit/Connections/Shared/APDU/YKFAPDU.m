@@ -17,6 +17,8 @@
 #import "YKFNSMutableDataAdditions.h"
 #import "YKFAssert.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "YKFSecureArena.h"
+#import "ykf_apdu.h"
 
 @interface YKFAPDU()
 
@@ -59,88 +61,56 @@
 }
 
 - (void)setupApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData*)data {
-    
-    self.cla = cla;
-    self.ins = ins;
-    self.p1 = p1;
-    self.p2 = p2;
-    self.data = data;
     self.type = YKFAPDUTypeShort;
-    
-    NSMutableData *command = [[NSMutableData alloc] init];
-    
-    [command ykf_appendByte:cla];   // APDU CLA
-    [command ykf_appendByte:ins];   // APDU INS
-    [command ykf_appendByte:p1];    // APDU P1
-    [command ykf_appendByte:p2];    // APDU P2
-
-    if (data.length) {
-        UInt8 length = data.length;
-        [command ykf_appendByte:length];    // LenLc
-        [command appendData:data];          // Data
-    }
-    
-    self.apduData = [command copy];
-    
-    NSMutableData *ylpCommand = [[NSMutableData alloc] initWithCapacity:command.length + 1];
-    [ylpCommand ykf_appendByte:0x00]; // YLP iAP2 Signal
-    [ylpCommand appendData:command];
-    self.ylpApduData = [ylpCommand copy];
-    
+    [self encodeWithCla:cla ins:ins p1:p1 p2:p2 data:data type:YKF_APDU_TYPE_SHORT];
 }
 
 - (void)setupExtendedApduWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data {
-    
+    self.type = YKFAPDUTypeExtended;
+    [self encodeWithCla:cla ins:ins p1:p1 p2:p2 data:data type:YKF_APDU_TYPE_EXTENDED];
+}
+
+- (void)encodeWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data type:(ykf_apdu_type)type {
     self.cla = cla;
     self.ins = ins;
     self.p1 = p1;
     self.p2 = p2;
-    self.data = data;
-    self.type = YKFAPDUTypeExtended;
-    
-    NSMutableData *command = [[NSMutableData alloc] init];
+    // The APDU owns its buffers, so callers can wipe the data they built it from and the APDU can be wiped on its own.
+    self.data = [data mutableCopy];
     
-    [command ykf_appendByte:cla];   // APDU CLA
-    [command ykf_appendByte:ins];   // APDU INS
-    [command ykf_appendByte:p1];    // APDU P1
-    [command ykf_appendByte:p2];    // APDU P2
+    // The command is encoded once, after the YLP iAP2 Signal byte, and apduData is the part after the signal.
+    size_t commandLength = ykf_apdu_encoded_length(type, data.length);
+    NSMutableData *ylpCommand = [[NSMutableData alloc] initWithLength:commandLength + 1];
+    size_t encodedLength = 0;
+    ykf_status status = ykf_apdu_encode(cla, ins, p1, p2, data.bytes, data.length, type,
+                                        (UInt8 *)ylpCommand.mutableBytes + 1, commandLength, &encodedLength);
+    YKFAssertReturn(status == YKF_OK, @"APDU - The command could not be encoded.");
     
-    if (data.length) {
-        UInt8 lengthHigh = data.length / 256;
-        UInt8 lengthLow = data.length % 256;
-        [command ykf_appendByte:0x00];           // APDU Zero
-        [command ykf_appendByte:lengthHigh];     // LenH
-        [command ykf_appendByte:lengthLow];      // LenL
-        [command appendData:data];               // Data
-    } else {
-        [command ykf_appendByte:0x00];           // APDU Zero
-        [command ykf_appendByte:0x00];           // LenH
-        [command ykf_appendByte:0x00];           // LenL
-    }
-    
-    self.apduData = [command copy];
-    
-    NSMutableData *ylpCommand = [[NSMutableData alloc] initWithCapacity:command.length + 1];
-    [ylpCommand ykf_appendByte:0x00]; // YLP iAP2 Signal
-    [ylpCommand appendData:command];
-    self.ylpApduData = [ylpCommand copy];
+    self.ylpApduData = ylpCommand;
+    self.apduData = [NSMutableData dataWithBytes:(const UInt8 *)ylpCommand.bytes + 1 length:encodedLength];
 }
 
 - (nullable instancetype)initWithData:(nonnull NSData *)data {
     YKFAssertAbortInit(data.length);
     self = [super init];
     if (self) {
-        self.apduData = [data copy];
+        self.apduData = [data mutableCopy];
         
         // Append the YLP iAP2 Signal for the ylpApduData.
         NSMutableData *tempBuffer = [[NSMutableData alloc] initWithCapacity:data.length + 1];
         [tempBuffer ykf_appendByte:0x00];
         [tempBuffer appendData:data];
-        self.ylpApduData = [tempBuffer copy];
+        self.ylpApduData = tempBuffer;
     }
     return self;
 }
 
+- (void)wipe {
+    YKFSecureZeroData(self.data);
+    YKFSecureZeroData(self.apduData);
+    YKFSecureZeroData(self.ylpApduData);
+}
+
 - (NSString *)debugDescription {
     return [NSString stringWithFormat:@"<YKFAPDU cla:0x%02X, ins:0x%02X, p1:0x%02X, p2:0x%02X, data: %@, type:%@>",
             self.cla, self.ins, self.p1, self.p2, [self.data ykf_hexadecimalString], (self.type == YKFAPDUTypeShort ? @"short" : @"extended")];
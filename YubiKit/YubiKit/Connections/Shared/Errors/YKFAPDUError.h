@@ -21,6 +21,7 @@ typedef NS_ENUM(NSUInteger, YKFAPDUErrorCode) {
     
     YKFAPDUErrorCodeAuthenticationRequired   = 0x6982,
     YKFAPDUErrorCodeDataInvalid              = 0x6984,
+    YKFAPDUErrorCodeNoSpace                  = 0x6A84,
     YKFAPDUErrorCodeWrongLength              = 0x6700,
     YKFAPDUErrorCodeWrongData                = 0x6A80,
     YKFAPDUErrorCodeInsNotSupported          = 0x6D00,
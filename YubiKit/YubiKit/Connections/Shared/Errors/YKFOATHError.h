@@ -60,7 +60,11 @@ typedef NS_ENUM(NSUInteger, YKFOATHErrorCode) {
 
     /*! Object was not found in list of credentials
      */
-    YKFOATHErrorCodeNoSuchObject = 0x00010A
+    YKFOATHErrorCodeNoSuchObject = 0x00010A,
+
+    /*! The key does not have room for the credentials.
+     */
+    YKFOATHErrorCodeNoSpace = 0x00010B
 
 };
 
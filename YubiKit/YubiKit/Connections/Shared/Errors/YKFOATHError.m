@@ -26,6 +26,7 @@ static NSString* const YKFOATHErrorBadCalculateAllResponseDescription = @"The ke
 static NSString* const YKFOATHErrorCodeTouchTimeoutDescription = @"The key did time out, waiting for touch.";
 static NSString* const YKFOATHErrorCodeWrongPasswordDescription = @"Wrong password.";
 static NSString* const YKFOATHErrorCodeNoSuchObjectDescription = @"Credential not found.";
+static NSString* const YKFOATHErrorCodeNoSpaceDescription = @"The key does not have room for the credentials.";
 
 @implementation YKFOATHError
 
@@ -56,7 +57,8 @@ static NSDictionary *errorMap = nil;
       @(YKFOATHErrorCodeBadCalculateAllResponse): YKFOATHErrorBadCalculateAllResponseDescription,
       @(YKFOATHErrorCodeTouchTimeout): YKFOATHErrorCodeTouchTimeoutDescription,
       @(YKFOATHErrorCodeWrongPassword): YKFOATHErrorCodeWrongPasswordDescription,
-      @(YKFOATHErrorCodeNoSuchObject): YKFOATHErrorCodeNoSuchObjectDescription
+      @(YKFOATHErrorCodeNoSuchObject): YKFOATHErrorCodeNoSuchObjectDescription,
+      @(YKFOATHErrorCodeNoSpace): YKFOATHErrorCodeNoSpaceDescription
       };
 }
 
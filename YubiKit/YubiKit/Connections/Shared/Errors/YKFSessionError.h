@@ -75,7 +75,12 @@ typedef NS_ENUM(NSUInteger, YKFSessionErrorCode) {
     
     /*! Unexpected result. This is caused when the YubiKey returns unexpected data.
      */
-    YKFSessionErrorUnexpectedResult = 0x000009
+    YKFSessionErrorUnexpectedResult = 0x000009,
+    
+    /*! A request to the key was not sent because it could not start before its deadline, e.g. while the
+     connection was busy with commands of a higher priority.
+     */
+    YKFSessionErrorDeadlineExceededCode = 0x00000A
 };
 
 /*!
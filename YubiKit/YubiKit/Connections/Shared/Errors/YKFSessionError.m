@@ -26,6 +26,7 @@ static NSString* const YKFSessionErrorConnectionLostDescription = @"Connection l
 static NSString* const YKFSessionErrorNoConnectionDescription = @"Connection is not found.";
 static NSString* const YKFSessionErrorInvalidSessionStateDescription = @"Invalid session state.";
 static NSString* const YKFSessionErrorUnexpectedResultDescription = @"Unexpected data returned by YubiKey.";
+static NSString* const YKFSessionErrorDeadlineExceededDescription = @"The request could not start before its deadline.";
 
 #pragma mark - YKFSessionError
 
@@ -58,6 +59,7 @@ static NSDictionary *errorMap = nil;
       @(YKFSessionErrorNoConnection):                        YKFSessionErrorNoConnectionDescription,
       @(YKFSessionErrorInvalidSessionStateStatusCode):       YKFSessionErrorInvalidSessionStateDescription,
       @(YKFSessionErrorUnexpectedResult):                    YKFSessionErrorUnexpectedResultDescription,
+      @(YKFSessionErrorDeadlineExceededCode):                YKFSessionErrorDeadlineExceededDescription,
     };
 }
 
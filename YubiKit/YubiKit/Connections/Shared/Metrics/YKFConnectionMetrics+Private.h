@@ -0,0 +1,48 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFConnectionMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class YKFAPDU;
+
+@interface YKFConnectionMetrics()
+
+/*
+ Records one APDU exchange with the key. The response is nil when the command failed in the connection controller.
+ */
+- (void)recordCommand:(YKFAPDU *)command response:(nullable NSData *)response duration:(NSTimeInterval)duration;
+
+- (void)recordCommandWithIns:(UInt8)ins duration:(NSTimeInterval)duration bytesSent:(NSUInteger)bytesSent bytesReceived:(NSUInteger)bytesReceived failed:(BOOL)failed;
+
+- (void)recordGetResponseChunk;
+
+- (void)recordWaitingTimeExtension;
+
+- (void)recordTouchWaitWithDuration:(NSTimeInterval)duration;
+
+- (void)recordSCPCommandWithOverheadBytes:(NSUInteger)overheadBytes duration:(NSTimeInterval)duration;
+
+- (void)recordTimeToReady:(NSTimeInterval)timeToReady;
+
+/*
+ Records the time a command waited in the command queue. deadlineExceeded is YES when the command was not sent
+ because it could not start before its deadline.
+ */
+- (void)recordQueueingDelay:(NSTimeInterval)delay priority:(YKFCommandPriority)priority deadlineExceeded:(BOOL)deadlineExceeded;
+
+@end
+
+NS_ASSUME_NONNULL_END
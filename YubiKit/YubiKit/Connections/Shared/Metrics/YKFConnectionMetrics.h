@@ -0,0 +1,169 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFCommandPriority.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFCommandMetrics
+
+ @abstract
+    The metrics recorded for one APDU instruction (INS byte) on a connection.
+ */
+@interface YKFCommandMetrics: NSObject
+
+/// The INS byte of the commands.
+@property (nonatomic, readonly) UInt8 ins;
+
+/// The number of commands sent to the key, including the failed ones.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// The number of commands which failed in the connection controller (e.g. timeout or connection lost).
+@property (nonatomic, readonly) NSUInteger errorCount;
+
+/// The sum and the maximum of the execution times reported by the connection controller.
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+@property (nonatomic, readonly) NSTimeInterval maxDuration;
+
+/// The raw APDU bytes sent to and received from the key, including the status words.
+@property (nonatomic, readonly) UInt64 bytesSent;
+@property (nonatomic, readonly) UInt64 bytesReceived;
+
+/// The number of commands in each latency bucket. Bucket i counts the commands which took less than
+/// latencyBucketUpperBounds[i], the last bucket counts all the slower commands.
+@property (nonatomic, readonly) NSArray<NSNumber *> *latencyHistogram;
+
+/// The upper bounds of the latency buckets, in seconds. There is one bound less than there are buckets.
+@property (class, nonatomic, readonly) NSArray<NSNumber *> *latencyBucketUpperBounds;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*!
+ @class YKFCommandQueueMetrics
+
+ @abstract
+    The time the commands of one priority waited in the command queue of a connection before they started.
+ */
+@interface YKFCommandQueueMetrics: NSObject
+
+/// The priority of the commands.
+@property (nonatomic, readonly) YKFCommandPriority priority;
+
+/// The number of commands which left the queue, including the ones which missed their deadline.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// The sum and the maximum of the queueing delays.
+@property (nonatomic, readonly) NSTimeInterval totalDelay;
+@property (nonatomic, readonly) NSTimeInterval maxDelay;
+
+/// The number of commands which were not sent because they could not start before their deadline.
+@property (nonatomic, readonly) NSUInteger deadlineExceededCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*!
+ @class YKFConnectionMetricsSnapshot
+
+ @abstract
+    A copy of the metrics of a connection at a point in time.
+ */
+@interface YKFConnectionMetricsSnapshot: NSObject
+
+/// The date of the snapshot and the date the metrics started (connection or last reset).
+@property (nonatomic, readonly) NSDate *date;
+@property (nonatomic, readonly) NSDate *startDate;
+
+/// The metrics of every instruction sent to the key at least once, ordered by INS.
+@property (nonatomic, readonly) NSArray<YKFCommandMetrics *> *commands;
+
+/// The number of GET RESPONSE (or OATH SEND REMAINING) commands sent to read 61XX chained responses.
+@property (nonatomic, readonly) NSUInteger getResponseChunkCount;
+
+/// The number of waiting time extensions received while the key was busy processing a command.
+@property (nonatomic, readonly) NSUInteger waitingTimeExtensionCount;
+
+/// The number of operations which waited for the user to touch the key, and the total time spent waiting.
+@property (nonatomic, readonly) NSUInteger touchWaitCount;
+@property (nonatomic, readonly) NSTimeInterval touchWaitDuration;
+
+/// The number of commands sent over a secure channel (SCP), the bytes added by the MAC and the padding,
+/// and the time spent encrypting, MACing and verifying the commands and responses.
+@property (nonatomic, readonly) NSUInteger scpCommandCount;
+@property (nonatomic, readonly) UInt64 scpOverheadBytes;
+@property (nonatomic, readonly) NSTimeInterval scpOverheadDuration;
+
+/// The time from opening the session to the key being ready for the first command, measured on Lightning
+/// connections. 0 when not measured.
+@property (nonatomic, readonly) NSTimeInterval timeToReady;
+
+/// The queueing delays of every priority with at least one command, ordered by priority.
+@property (nonatomic, readonly) NSArray<YKFCommandQueueMetrics *> *queues;
+
+/// Totals over all the instructions.
+@property (nonatomic, readonly) NSUInteger totalCommandCount;
+@property (nonatomic, readonly) UInt64 totalBytesSent;
+@property (nonatomic, readonly) UInt64 totalBytesReceived;
+
+/*!
+ @abstract
+    A property list representation of the snapshot which can be serialized with NSJSONSerialization.
+
+ @discussion
+    Durations are in seconds and dates in seconds since 1970. Instructions are keyed by their hexadecimal INS
+    (e.g. "A4"), each with count, errors, totalDuration, maxDuration, bytesSent, bytesReceived and histogram.
+    Queues are keyed by priority name (e.g. "interactive"), each with count, totalDelay, maxDelay and
+    deadlinesExceeded.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*!
+ @class YKFConnectionMetrics
+
+ @abstract
+    Latency and throughput metrics of the commands sent to a YubiKey over one connection.
+
+ @discussion
+    The connection controllers, the smart card interface and the sessions record into the metrics while the
+    commands are executed. Recording only updates atomic counters and never takes a lock, so it doesn't slow down
+    or serialize the communication. Use snapshot to read the metrics, e.g. when the connection is closed, and
+    dictionaryRepresentation to export them.
+ */
+@interface YKFConnectionMetrics: NSObject
+
+/*!
+ @abstract
+    Returns a copy of the current metrics. The counters are read one by one while the commands may still be
+    recorded, so a snapshot taken during a command can be off by that command.
+ */
+- (YKFConnectionMetricsSnapshot *)snapshot;
+
+/*!
+ @abstract
+    Clears all the metrics and restarts the measurement period.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
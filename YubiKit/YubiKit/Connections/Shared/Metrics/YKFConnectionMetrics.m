@@ -0,0 +1,403 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <stdatomic.h>
+#import "YKFConnectionMetrics.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFAPDU+Private.h"
+
+#define YKFConnectionMetricsInsCount 256
+#define YKFConnectionMetricsBucketCount 12
+#define YKFConnectionMetricsPriorityCount (YKFCommandPriorityContinuation + 1)
+
+// Upper bounds of the latency buckets in microseconds. USB/Lightning commands take a few ms, NFC commands tens of ms
+// and commands which wait for touch or generate keys take seconds.
+static const uint64_t YKFConnectionMetricsBucketBounds[YKFConnectionMetricsBucketCount - 1] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 5000000
+};
+
+typedef struct {
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) errorCount;
+    _Atomic(uint64_t) totalMicroseconds;
+    _Atomic(uint64_t) maxMicroseconds;
+    _Atomic(uint64_t) bytesSent;
+    _Atomic(uint64_t) bytesReceived;
+    _Atomic(uint64_t) buckets[YKFConnectionMetricsBucketCount];
+} YKFCommandCounters;
+
+typedef struct {
+    _Atomic(uint64_t) count;
+    _Atomic(uint64_t) totalMicroseconds;
+    _Atomic(uint64_t) maxMicroseconds;
+    _Atomic(uint64_t) deadlineExceededCount;
+} YKFQueueCounters;
+
+static inline void YKFCounterAdd(_Atomic(uint64_t) *counter, uint64_t value) {
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint64_t YKFCounterLoad(_Atomic(uint64_t) *counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static inline void YKFCounterMax(_Atomic(uint64_t) *counter, uint64_t value) {
+    uint64_t current = atomic_load_explicit(counter, memory_order_relaxed);
+    while (value > current && !atomic_compare_exchange_weak_explicit(counter, &current, value, memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+static inline uint64_t YKFMicroseconds(NSTimeInterval interval) {
+    return interval > 0 ? (uint64_t)(interval * 1000000) : 0;
+}
+
+static inline NSUInteger YKFLatencyBucket(uint64_t microseconds) {
+    NSUInteger bucket = 0;
+    while (bucket < YKFConnectionMetricsBucketCount - 1 && microseconds >= YKFConnectionMetricsBucketBounds[bucket]) {
+        bucket++;
+    }
+    return bucket;
+}
+
+#pragma mark - YKFCommandMetrics
+
+@interface YKFCommandMetrics()
+
+- (instancetype)initWithIns:(UInt8)ins counters:(YKFCommandCounters *)counters NS_DESIGNATED_INITIALIZER;
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+@implementation YKFCommandMetrics
+
++ (NSArray<NSNumber *> *)latencyBucketUpperBounds {
+    NSMutableArray *bounds = [[NSMutableArray alloc] initWithCapacity:YKFConnectionMetricsBucketCount - 1];
+    for (NSUInteger i = 0; i < YKFConnectionMetricsBucketCount - 1; i++) {
+        [bounds addObject:@(YKFConnectionMetricsBucketBounds[i] / 1000000.0)];
+    }
+    return bounds;
+}
+
+- (instancetype)initWithIns:(UInt8)ins counters:(YKFCommandCounters *)counters {
+    self = [super init];
+    if (self) {
+        _ins = ins;
+        _count = (NSUInteger)YKFCounterLoad(&counters->count);
+        _errorCount = (NSUInteger)YKFCounterLoad(&counters->errorCount);
+        _totalDuration = YKFCounterLoad(&counters->totalMicroseconds) / 1000000.0;
+        _maxDuration = YKFCounterLoad(&counters->maxMicroseconds) / 1000000.0;
+        _bytesSent = YKFCounterLoad(&counters->bytesSent);
+        _bytesReceived = YKFCounterLoad(&counters->bytesReceived);
+        NSMutableArray *histogram = [[NSMutableArray alloc] initWithCapacity:YKFConnectionMetricsBucketCount];
+        for (NSUInteger i = 0; i < YKFConnectionMetricsBucketCount; i++) {
+            [histogram addObject:@(YKFCounterLoad(&counters->buckets[i]))];
+        }
+        _latencyHistogram = [histogram copy];
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    return @{
+        @"count": @(self.count),
+        @"errors": @(self.errorCount),
+        @"totalDuration": @(self.totalDuration),
+        @"maxDuration": @(self.maxDuration),
+        @"bytesSent": @(self.bytesSent),
+        @"bytesReceived": @(self.bytesReceived),
+        @"histogram": self.latencyHistogram
+    };
+}
+
+@end
+
+#pragma mark - YKFCommandQueueMetrics
+
+@interface YKFCommandQueueMetrics()
+
+- (instancetype)initWithPriority:(YKFCommandPriority)priority counters:(YKFQueueCounters *)counters NS_DESIGNATED_INITIALIZER;
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+@implementation YKFCommandQueueMetrics
+
++ (NSString *)nameForPriority:(YKFCommandPriority)priority {
+    switch (priority) {
+        case YKFCommandPriorityBackground:
+            return @"background";
+        case YKFCommandPriorityNormal:
+            return @"normal";
+        case YKFCommandPriorityInteractive:
+            return @"interactive";
+        case YKFCommandPriorityContinuation:
+            return @"continuation";
+    }
+    return @"normal";
+}
+
+- (instancetype)initWithPriority:(YKFCommandPriority)priority counters:(YKFQueueCounters *)counters {
+    self = [super init];
+    if (self) {
+        _priority = priority;
+        _count = (NSUInteger)YKFCounterLoad(&counters->count);
+        _totalDelay = YKFCounterLoad(&counters->totalMicroseconds) / 1000000.0;
+        _maxDelay = YKFCounterLoad(&counters->maxMicroseconds) / 1000000.0;
+        _deadlineExceededCount = (NSUInteger)YKFCounterLoad(&counters->deadlineExceededCount);
+    }
+    return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    return @{
+        @"count": @(self.count),
+        @"totalDelay": @(self.totalDelay),
+        @"maxDelay": @(self.maxDelay),
+        @"deadlinesExceeded": @(self.deadlineExceededCount)
+    };
+}
+
+@end
+
+#pragma mark - YKFConnectionMetricsSnapshot
+
+@interface YKFConnectionMetricsSnapshot()
+
+@property (nonatomic, readwrite) NSDate *date;
+@property (nonatomic, readwrite) NSDate *startDate;
+@property (nonatomic, readwrite) NSArray<YKFCommandMetrics *> *commands;
+@property (nonatomic, readwrite) NSUInteger getResponseChunkCount;
+@property (nonatomic, readwrite) NSUInteger waitingTimeExtensionCount;
+@property (nonatomic, readwrite) NSUInteger touchWaitCount;
+@property (nonatomic, readwrite) NSTimeInterval touchWaitDuration;
+@property (nonatomic, readwrite) NSUInteger scpCommandCount;
+@property (nonatomic, readwrite) UInt64 scpOverheadBytes;
+@property (nonatomic, readwrite) NSTimeInterval scpOverheadDuration;
+@property (nonatomic, readwrite) NSTimeInterval timeToReady;
+@property (nonatomic, readwrite) NSArray<YKFCommandQueueMetrics *> *queues;
+
+- (instancetype)initSnapshot NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation YKFConnectionMetricsSnapshot
+
+- (instancetype)initSnapshot {
+    return [super init];
+}
+
+- (NSUInteger)totalCommandCount {
+    NSUInteger count = 0;
+    for (YKFCommandMetrics *command in self.commands) {
+        count += command.count;
+    }
+    return count;
+}
+
+- (UInt64)totalBytesSent {
+    UInt64 bytes = 0;
+    for (YKFCommandMetrics *command in self.commands) {
+        bytes += command.bytesSent;
+    }
+    return bytes;
+}
+
+- (UInt64)totalBytesReceived {
+    UInt64 bytes = 0;
+    for (YKFCommandMetrics *command in self.commands) {
+        bytes += command.bytesReceived;
+    }
+    return bytes;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation {
+    NSMutableDictionary *commands = [[NSMutableDictionary alloc] initWithCapacity:self.commands.count];
+    for (YKFCommandMetrics *command in self.commands) {
+        commands[[NSString stringWithFormat:@"%02X", command.ins]] = [command dictionaryRepresentation];
+    }
+    NSMutableDictionary *queues = [[NSMutableDictionary alloc] initWithCapacity:self.queues.count];
+    for (YKFCommandQueueMetrics *queue in self.queues) {
+        queues[[YKFCommandQueueMetrics nameForPriority:queue.priority]] = [queue dictionaryRepresentation];
+    }
+    return @{
+        @"date": @(self.date.timeIntervalSince1970),
+        @"startDate": @(self.startDate.timeIntervalSince1970),
+        @"latencyBucketUpperBounds": YKFCommandMetrics.latencyBucketUpperBounds,
+        @"commands": commands,
+        @"getResponseChunks": @(self.getResponseChunkCount),
+        @"waitingTimeExtensions": @(self.waitingTimeExtensionCount),
+        @"touchWaits": @(self.touchWaitCount),
+        @"touchWaitDuration": @(self.touchWaitDuration),
+        @"scpCommands": @(self.scpCommandCount),
+        @"scpOverheadBytes": @(self.scpOverheadBytes),
+        @"scpOverheadDuration": @(self.scpOverheadDuration),
+        @"timeToReady": @(self.timeToReady),
+        @"queues": queues
+    };
+}
+
+@end
+
+#pragma mark - YKFConnectionMetrics
+
+@implementation YKFConnectionMetrics {
+    YKFCommandCounters *_commands;
+    YKFQueueCounters _queues[YKFConnectionMetricsPriorityCount];
+    _Atomic(uint64_t) _getResponseChunkCount;
+    _Atomic(uint64_t) _waitingTimeExtensionCount;
+    _Atomic(uint64_t) _touchWaitCount;
+    _Atomic(uint64_t) _touchWaitMicroseconds;
+    _Atomic(uint64_t) _scpCommandCount;
+    _Atomic(uint64_t) _scpOverheadBytes;
+    _Atomic(uint64_t) _scpOverheadMicroseconds;
+    _Atomic(uint64_t) _timeToReadyMicroseconds;
+    _Atomic(double) _startTime;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _commands = calloc(YKFConnectionMetricsInsCount, sizeof(YKFCommandCounters));
+        atomic_init(&_startTime, [NSDate date].timeIntervalSinceReferenceDate);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_commands);
+}
+
+#pragma mark - Recording
+
+- (void)recordCommand:(YKFAPDU *)command response:(NSData *)response duration:(NSTimeInterval)duration {
+    NSData *apduData = command.apduData;
+    UInt8 ins = apduData.length > 1 ? ((const UInt8 *)apduData.bytes)[1] : 0;
+    [self recordCommandWithIns:ins duration:duration bytesSent:apduData.length bytesReceived:response.length failed:response == nil];
+}
+
+- (void)recordCommandWithIns:(UInt8)ins duration:(NSTimeInterval)duration bytesSent:(NSUInteger)bytesSent bytesReceived:(NSUInteger)bytesReceived failed:(BOOL)failed {
+    YKFCommandCounters *counters = &_commands[ins];
+    uint64_t microseconds = YKFMicroseconds(duration);
+    YKFCounterAdd(&counters->count, 1);
+    if (failed) {
+        YKFCounterAdd(&counters->errorCount, 1);
+    }
+    YKFCounterAdd(&counters->totalMicroseconds, microseconds);
+    YKFCounterMax(&counters->maxMicroseconds, microseconds);
+    YKFCounterAdd(&counters->bytesSent, bytesSent);
+    YKFCounterAdd(&counters->bytesReceived, bytesReceived);
+    YKFCounterAdd(&counters->buckets[YKFLatencyBucket(microseconds)], 1);
+}
+
+- (void)recordGetResponseChunk {
+    YKFCounterAdd(&_getResponseChunkCount, 1);
+}
+
+- (void)recordWaitingTimeExtension {
+    YKFCounterAdd(&_waitingTimeExtensionCount, 1);
+}
+
+- (void)recordTouchWaitWithDuration:(NSTimeInterval)duration {
+    YKFCounterAdd(&_touchWaitCount, 1);
+    YKFCounterAdd(&_touchWaitMicroseconds, YKFMicroseconds(duration));
+}
+
+- (void)recordSCPCommandWithOverheadBytes:(NSUInteger)overheadBytes duration:(NSTimeInterval)duration {
+    YKFCounterAdd(&_scpCommandCount, 1);
+    YKFCounterAdd(&_scpOverheadBytes, overheadBytes);
+    YKFCounterAdd(&_scpOverheadMicroseconds, YKFMicroseconds(duration));
+}
+
+- (void)recordTimeToReady:(NSTimeInterval)timeToReady {
+    atomic_store_explicit(&_timeToReadyMicroseconds, YKFMicroseconds(timeToReady), memory_order_relaxed);
+}
+
+- (void)recordQueueingDelay:(NSTimeInterval)delay priority:(YKFCommandPriority)priority deadlineExceeded:(BOOL)deadlineExceeded {
+    if (priority >= YKFConnectionMetricsPriorityCount) {
+        return;
+    }
+    YKFQueueCounters *counters = &_queues[priority];
+    uint64_t microseconds = YKFMicroseconds(delay);
+    YKFCounterAdd(&counters->count, 1);
+    YKFCounterAdd(&counters->totalMicroseconds, microseconds);
+    YKFCounterMax(&counters->maxMicroseconds, microseconds);
+    if (deadlineExceeded) {
+        YKFCounterAdd(&counters->deadlineExceededCount, 1);
+    }
+}
+
+#pragma mark - Snapshot
+
+- (YKFConnectionMetricsSnapshot *)snapshot {
+    YKFConnectionMetricsSnapshot *snapshot = [[YKFConnectionMetricsSnapshot alloc] initSnapshot];
+    snapshot.date = [NSDate date];
+    snapshot.startDate = [NSDate dateWithTimeIntervalSinceReferenceDate:atomic_load_explicit(&_startTime, memory_order_relaxed)];
+
+    NSMutableArray<YKFCommandMetrics *> *commands = [[NSMutableArray alloc] init];
+    for (NSUInteger ins = 0; ins < YKFConnectionMetricsInsCount; ins++) {
+        if (YKFCounterLoad(&_commands[ins].count) > 0) {
+            [commands addObject:[[YKFCommandMetrics alloc] initWithIns:(UInt8)ins counters:&_commands[ins]]];
+        }
+    }
+    snapshot.commands = commands;
+    snapshot.getResponseChunkCount = (NSUInteger)YKFCounterLoad(&_getResponseChunkCount);
+    snapshot.waitingTimeExtensionCount = (NSUInteger)YKFCounterLoad(&_waitingTimeExtensionCount);
+    snapshot.touchWaitCount = (NSUInteger)YKFCounterLoad(&_touchWaitCount);
+    snapshot.touchWaitDuration = YKFCounterLoad(&_touchWaitMicroseconds) / 1000000.0;
+    snapshot.scpCommandCount = (NSUInteger)YKFCounterLoad(&_scpCommandCount);
+    snapshot.scpOverheadBytes = YKFCounterLoad(&_scpOverheadBytes);
+    snapshot.scpOverheadDuration = YKFCounterLoad(&_scpOverheadMicroseconds) / 1000000.0;
+    snapshot.timeToReady = YKFCounterLoad(&_timeToReadyMicroseconds) / 1000000.0;
+    
+    NSMutableArray<YKFCommandQueueMetrics *> *queues = [[NSMutableArray alloc] init];
+    for (NSUInteger priority = 0; priority < YKFConnectionMetricsPriorityCount; priority++) {
+        if (YKFCounterLoad(&_queues[priority].count) > 0) {
+            [queues addObject:[[YKFCommandQueueMetrics alloc] initWithPriority:priority counters:&_queues[priority]]];
+        }
+    }
+    snapshot.queues = queues;
+    return snapshot;
+}
+
+- (void)reset {
+    for (NSUInteger ins = 0; ins < YKFConnectionMetricsInsCount; ins++) {
+        YKFCommandCounters *counters = &_commands[ins];
+        atomic_store_explicit(&counters->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->errorCount, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->totalMicroseconds, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->maxMicroseconds, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->bytesSent, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->bytesReceived, 0, memory_order_relaxed);
+        for (NSUInteger i = 0; i < YKFConnectionMetricsBucketCount; i++) {
+            atomic_store_explicit(&counters->buckets[i], 0, memory_order_relaxed);
+        }
+    }
+    atomic_store_explicit(&_getResponseChunkCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_waitingTimeExtensionCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_touchWaitCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_touchWaitMicroseconds, 0, memory_order_relaxed);
+    atomic_store_explicit(&_scpCommandCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_scpOverheadBytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&_scpOverheadMicroseconds, 0, memory_order_relaxed);
+    atomic_store_explicit(&_timeToReadyMicroseconds, 0, memory_order_relaxed);
+    for (NSUInteger priority = 0; priority < YKFConnectionMetricsPriorityCount; priority++) {
+        YKFQueueCounters *counters = &_queues[priority];
+        atomic_store_explicit(&counters->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->totalMicroseconds, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->maxMicroseconds, 0, memory_order_relaxed);
+        atomic_store_explicit(&counters->deadlineExceededCount, 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&_startTime, [NSDate date].timeIntervalSinceReferenceDate, memory_order_relaxed);
+}
+
+@end
@@ -150,6 +150,16 @@ extern NSString* const YKFFIDO2GetInfoResponseOptionUserVerification;
  */
 @property (nonatomic, readonly) NSUInteger minPinLength;
 
+/*!
+ @abstract
+    The firmware version of the authenticator.
+ 
+ @discussion
+    The value is 0 when not returned by the authenticator. This field was added in CTAP 2.1 and is not reported
+    by older keys.
+ */
+@property (nonatomic, readonly) NSUInteger firmwareVersion;
+
 /*
  Not available: the response will be created by the library.
  */
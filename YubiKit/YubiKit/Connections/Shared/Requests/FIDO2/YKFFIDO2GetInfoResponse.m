@@ -30,7 +30,8 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
     YKFFIDO2GetInfoResponseKeyOptions        = 0x04,
     YKFFIDO2GetInfoResponseKeyMaxMsgSize     = 0x05,
     YKFFIDO2GetInfoResponseKeyPinProtocols   = 0x06,
-    YKFFIDO2GetInfoResponseKeyMinPinLength   = 0x0d
+    YKFFIDO2GetInfoResponseKeyMinPinLength   = 0x0d,
+    YKFFIDO2GetInfoResponseKeyFirmwareVersion = 0x0e
 
 };
 
@@ -43,6 +44,7 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
 @property (nonatomic, assign, readwrite) NSUInteger maxMsgSize;
 @property (nonatomic, readwrite) NSUInteger minPinLength;
 @property (nonatomic, readwrite) NSArray *pinProtocols;
+@property (nonatomic, readwrite) NSUInteger firmwareVersion;
 
 @end
 
@@ -108,6 +110,12 @@ typedef NS_ENUM(NSUInteger, YKFFIDO2GetInfoResponseKey) {
     
     // pin protocols
     self.pinProtocols = response[@(YKFFIDO2GetInfoResponseKeyPinProtocols)];
+    
+    // firmwareVersion
+    NSNumber *firmwareVersion = response[@(YKFFIDO2GetInfoResponseKeyFirmwareVersion)];
+    if (firmwareVersion != nil) {
+        self.firmwareVersion = firmwareVersion.unsignedIntegerValue;
+    }
         
     return YES;
 }
@@ -17,6 +17,7 @@
 #import "YKFChallengeResponseError.h"
 #import "YKFSessionError+Private.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 #import "YKFSCPProcessor.h"
 #import "YKFSCPKeyParamsProtocol.h"
 
@@ -28,7 +29,7 @@
     YKFChallengeResponseSession *session = [YKFChallengeResponseSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameChalResp];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameChalResp];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -44,7 +45,7 @@
     YKFChallengeResponseSession *session = [YKFChallengeResponseSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameChalResp];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameChalResp];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
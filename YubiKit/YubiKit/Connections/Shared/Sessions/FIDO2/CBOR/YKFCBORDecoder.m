@@ -15,6 +15,7 @@
 #import "YKFCBORDecoder.h"
 #import "YKFCBORTag.h"
 #import "YKFAssert.h"
+#import "ykf_cbor.h"
 
 @interface NSInputStream(YKFCBORDecoder)
 
@@ -168,42 +169,16 @@
 + (YKFCBORInteger *)decodeInteger:(nonnull NSData *)data {
     YKFAssertReturnValue(data.length, @"CBOR - Cannot decode from empty data.", nil);
     
-    UInt8 *bytes = (UInt8 *)data.bytes;
+    int64_t value = 0;
+    size_t headLength = 0;
+    ykf_status status = ykf_cbor_decode_integer(data.bytes, data.length, &value, &headLength);
     
-    BOOL isNegative = bytes[0] & YKFCBORNegativeIntegerTagMask;
-    bytes[0] = bytes[0] & ~YKFCBORNegativeIntegerTagMask; // remove sign.
-    
-    NSInteger value = 0;
-    
-    switch (data.length) {
-        case 1:
-            value = bytes[0];
-            break;
-        case 2:
-            value = bytes[1];
-            break;
-        case 3:
-            value = CFSwapInt16BigToHost(*((UInt16 *)(&bytes[1])));
-            break;
-        case 5:
-            value = CFSwapInt32BigToHost(*((UInt32 *)(&bytes[1])));
-            break;
-            
-        case 9: {
-            UInt64 parsedValue = CFSwapInt64BigToHost(*((UInt64 *)(&bytes[1])));
-            
-            // Avoid overflow for values which cannot be represented on a NSInteger.
-            YKFAssertReturnValue(parsedValue <= INT64_MAX, @"CBOR - Cannot decode integer value. The value is too large.", nil);
-            value = (NSInteger)parsedValue;
-        }
-        break;
-            
-        default:
-            return nil;
+    // Avoid overflow for values which cannot be represented on a NSInteger.
+    YKFAssertReturnValue(status == YKF_OK, @"CBOR - Cannot decode integer value.", nil);
+    if (headLength != data.length) {
+        return nil;
     }
-    
-    value = isNegative ? -(value + 1) : value;
-    return YKFCBORInteger(value);
+    return YKFCBORInteger((NSInteger)value);
 }
 
 + (YKFCBORByteString *)decodeByteString:(nonnull NSData *)data {
@@ -15,6 +15,7 @@
 #import "YKFCBOREncoder.h"
 #import "YKFCBORTag.h"
 #import "YKFAssert.h"
+#import "ykf_cbor.h"
 
 @implementation YKFCBOREncoder
 
@@ -23,28 +24,9 @@
 + (NSData *)encodeInteger:(YKFCBORInteger *)cborInteger {
     YKFAssertReturnValue(cborInteger, @"CBOR Encoding - Cannot encode empty CBOR integer.", nil);
     
-    NSInteger value = cborInteger.value;
-    
-    if (labs(value) <= INT8_MAX) {
-        return [self encodeSInt8:(SInt8)value];
-    }
-    if (labs(value) <= UINT8_MAX) {
-        return value < 0 ? [self encodeSInt16:(SInt16)value] : [self encodeUInt8:(UInt8)value];
-    }
-    if (labs(value) <= INT16_MAX) {
-        return [self encodeSInt16:(SInt16)value];
-    }
-    if (labs(value) <= UINT16_MAX) {
-        return value < 0 ? [self encodeSInt32:(SInt32)value] : [self encodeUInt16:(UInt16)value];
-    }
-    if (labs(value) <= INT32_MAX) {
-        return [self encodeSInt32:(SInt32)value];
-    }
-    if (labs(value) <= UINT32_MAX) {
-        return value < 0 ? [self encodeSInt64:(SInt64)value] : [self encodeUInt32:(UInt32)value];
-    }
-
-    return [self encodeSInt64:(SInt64)value];
+    UInt8 head[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t headLength = ykf_cbor_encode_integer(cborInteger.value, head);
+    return [NSData dataWithBytes:head length:headLength];
 }
 
 #pragma mark - Byte String (Major Type 2)
@@ -76,13 +58,9 @@
 
     NSArray *array = cborArray.value;
     
-    YKFCBORInteger *arrayLength = YKFCBORInteger(array.count);
-    NSData *encodedLength = [self encodeInteger:arrayLength];
-    NSMutableData *encodedArray = [[NSMutableData alloc] initWithData:encodedLength];
-    
-    // Set major type 4.
-    UInt8 *encodedValueBytes = encodedArray.mutableBytes;
-    encodedValueBytes[0] = encodedValueBytes[0] | YKFCBORArrayTagMask;
+    UInt8 head[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t headLength = ykf_cbor_encode_head(YKFCBORArrayTagMask, array.count, head);
+    NSMutableData *encodedArray = [[NSMutableData alloc] initWithBytes:head length:headLength];
 
     // Append the elements.
     for (id element in array) {
@@ -106,13 +84,9 @@
     NSDictionary *map = cborMap.value;
     YKFAssertReturnValue(map, @"CBOR Encoding - Cannot encode nil dictionary.", nil);
     
-    YKFCBORInteger *mapPairs = YKFCBORInteger(map.count);
-    NSData *encodedPairs = [self encodeInteger:mapPairs];
-    NSMutableData *encodedMap = [[NSMutableData alloc] initWithData:encodedPairs];
-    
-    // Set major type 5.
-    UInt8 *encodedValueBytes = encodedMap.mutableBytes;
-    encodedValueBytes[0] = encodedValueBytes[0] | YKFCBORMapTagMask;
+    UInt8 head[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t headLength = ykf_cbor_encode_head(YKFCBORMapTagMask, map.count, head);
+    NSMutableData *encodedMap = [[NSMutableData alloc] initWithBytes:head length:headLength];
 
     // Append the pairs sorted by keys.
     NSArray *keys = [map.allKeys sortedArrayUsingSelector:@selector(compare:)];
@@ -150,122 +124,14 @@
 
 #pragma mark - Helpers
 
-+ (NSData *)encodeUInt8:(UInt8)value {
-    if (value < 24) {
-        return [NSData dataWithBytes:&value length:1];
-    }
-    const UInt8 bytes[] = {YKFCBORUInt8Tag, value};
-    return [NSData dataWithBytes:bytes length:2];
-}
-
-+ (NSData *)encodeUInt16:(UInt16)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt16 bigUInt16 = CFSwapInt16HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt16Tag length:1];
-    [buffer appendBytes:&bigUInt16 length:sizeof(UInt16)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeUInt32:(UInt32)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt32 bigUInt32 = CFSwapInt32HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt32Tag length:1];
-    [buffer appendBytes:&bigUInt32 length:sizeof(UInt32)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeUInt64:(UInt64)value {
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt64 bigUInt64 = CFSwapInt64HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORUInt64Tag length:1];
-    [buffer appendBytes:&bigUInt64 length:sizeof(UInt64)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt8:(SInt8)value {
-    if (value >= 0) {
-        return [self encodeUInt8:value];
-    }
-    value = -1 - value;
-    
-    if (value < 24) {
-        value |= YKFCBORNegativeIntegerTagMask;
-        return [NSData dataWithBytes:&value length:1];
-    }
-    
-    const UInt8 bytes[] = {YKFCBORSInt8Tag, value};
-    return [NSData dataWithBytes:bytes length:2];
-}
-
-+ (NSData *)encodeSInt16:(SInt16)value {
-    if (value >= 0) {
-        return [self encodeUInt16:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt16 bigUInt16 = CFSwapInt16HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt16Tag length:1];
-    [buffer appendBytes:&bigUInt16 length:sizeof(UInt16)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt32:(SInt32)value {
-    if (value >= 0) {
-        return [self encodeUInt32:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt32 bigUInt32 = CFSwapInt32HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt32Tag length:1];
-    [buffer appendBytes:&bigUInt32 length:sizeof(UInt32)];
-    
-    return [buffer copy];
-}
-
-+ (NSData *)encodeSInt64:(SInt64)value {
-    if (value >= 0) {
-        return [self encodeUInt64:value];
-    }
-    value = -1 - value;
-    
-    NSMutableData *buffer = [[NSMutableData alloc] init];
-    UInt64 bigUInt64 = CFSwapInt64HostToBig(value);
-    
-    [buffer appendBytes:&YKFCBORSInt64Tag length:1];
-    [buffer appendBytes:&bigUInt64 length:sizeof(UInt64)];
-    
-    return [buffer copy];
-}
-
 + (NSData *)encodeData:(NSData *)value tagMask:(UInt8)tagMask {
     YKFAssertReturnValue(value, @"CBOR Encoding - Cannot encode nil data.", nil);
     
-    YKFCBORInteger *dataLength = YKFCBORInteger(value.length);
-    NSMutableData *encodedValue = nil;
-    if (dataLength) {
-        NSData *encodedLength = [self encodeInteger:dataLength];
-        encodedValue = [[NSMutableData alloc] initWithData:encodedLength];
-        [encodedValue appendData:value];
-        
-        // Set the major type 2.
-        UInt8 *encodedValueBytes = encodedValue.mutableBytes;
-        encodedValueBytes[0] = encodedValueBytes[0] | tagMask;
-    } else {
-        // Set only the major type.
-        encodedValue = [[NSMutableData alloc] initWithCapacity:1];
-        [encodedValue appendBytes:&tagMask length:1];
-    }
+    UInt8 head[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t headLength = ykf_cbor_encode_head(tagMask, value.length, head);
+    NSMutableData *encodedValue = [[NSMutableData alloc] initWithCapacity:headLength + value.length];
+    [encodedValue appendBytes:head length:headLength];
+    [encodedValue appendData:value];
     
     return [encodedValue copy];
 }
@@ -0,0 +1,82 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import <Foundation/Foundation.h>
+#import "YKFCBORType.h"
+#import "YKFSmartCardResponseConsumer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ Called with every top level CBOR object (e.g. YKFCBORMap) as soon as its last byte has been pushed.
+ */
+typedef void (^YKFCBORPushDecoderObjectHandler)(id object);
+
+/*!
+ @abstract
+    CTAP2 CBOR decoder for data arriving in slices of any size.
+ 
+ @discussion
+    Decodes the same types as YKFCBORDecoder, with the same checks, but an item header, argument or string may be
+    split across slices at any byte. The partial header and the arrays and maps still being filled are kept until
+    the next slice instead of failing. The decoder is not thread safe; push the slices from one queue.
+ */
+@interface YKFCBORPushDecoder: NSObject<YKFSmartCardResponseConsumer>
+
+/*!
+ @abstract
+    The longest byte or text string accepted. A larger length fails the decoder before any buffer is allocated.
+    Defaults to 1 MB.
+ */
+@property (nonatomic) NSUInteger maximumStringLength;
+
+/*!
+ @abstract
+    YES when the bytes pushed so far end in the middle of a top level object.
+ */
+@property (nonatomic, readonly) BOOL hasPartialObject;
+
+/*!
+ @abstract
+    Creates a decoder which passes the decoded top level objects to the handler, in order, on the queue the data
+    is pushed on.
+ */
+- (instancetype)initWithObjectHandler:(YKFCBORPushDecoderObjectHandler)objectHandler NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract
+    Decodes the next slice of data.
+ @returns
+    NO when the data is not valid or not supported CBOR. The decoder then rejects all data until it is reset.
+ */
+- (BOOL)pushData:(NSData *)data error:(NSError **)error;
+
+/*!
+ @abstract
+    Ends the data.
+ @returns
+    NO when the data ended in the middle of an object. The decoder is reset either way.
+ */
+- (BOOL)finishWithError:(NSError **)error;
+
+/*!
+ @abstract
+    Drops any partial object and error so the decoder can decode new data.
+ */
+- (void)reset;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,310 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import "YKFCBORPushDecoder.h"
+#import "YKFCBORTag.h"
+#import "YKFSessionError.h"
+#import "YKFSessionError+Private.h"
+
+static NSUInteger const YKFCBORPushDecoderDefaultMaximumStringLength = 1024 * 1024;
+
+typedef NS_ENUM(NSUInteger, YKFCBORPushDecoderState) {
+    YKFCBORPushDecoderStateHead,
+    YKFCBORPushDecoderStateArgument,
+    YKFCBORPushDecoderStateString,
+    YKFCBORPushDecoderStateFailed
+};
+
+#pragma mark - YKFCBORPushDecoderContainer
+
+/*
+ An array or map whose elements are still being decoded.
+ */
+@interface YKFCBORPushDecoderContainer: NSObject
+
+@property (nonatomic, readonly) BOOL isMap;
+@property (nonatomic) UInt64 remainingElements;
+@property (nonatomic, readonly) NSMutableArray *array;
+@property (nonatomic, readonly) NSMutableDictionary *dictionary;
+@property (nonatomic, nullable) id pendingKey;
+
+@end
+
+@implementation YKFCBORPushDecoderContainer
+
+- (instancetype)initWithMap:(BOOL)isMap count:(UInt64)count {
+    self = [super init];
+    if (self) {
+        _isMap = isMap;
+        _remainingElements = count;
+        if (isMap) {
+            _dictionary = [[NSMutableDictionary alloc] init];
+        } else {
+            _array = [[NSMutableArray alloc] init];
+        }
+    }
+    return self;
+}
+
+@end
+
+#pragma mark - YKFCBORPushDecoder
+
+@interface YKFCBORPushDecoder()
+
+@property (nonatomic, copy) YKFCBORPushDecoderObjectHandler objectHandler;
+@property (nonatomic) YKFCBORPushDecoderState state;
+@property (nonatomic) NSMutableArray<YKFCBORPushDecoderContainer *> *containers;
+
+@property (nonatomic) UInt8 head;
+@property (nonatomic) UInt64 argument;
+@property (nonatomic) NSUInteger remainingArgumentBytes;
+@property (nonatomic) NSUInteger stringLength;
+@property (nonatomic, nullable) NSMutableData *string;
+
+@end
+
+@implementation YKFCBORPushDecoder
+
+- (instancetype)initWithObjectHandler:(YKFCBORPushDecoderObjectHandler)objectHandler {
+    self = [super init];
+    if (self) {
+        self.objectHandler = objectHandler;
+        self.maximumStringLength = YKFCBORPushDecoderDefaultMaximumStringLength;
+        self.containers = [[NSMutableArray alloc] init];
+        self.state = YKFCBORPushDecoderStateHead;
+    }
+    return self;
+}
+
+- (BOOL)hasPartialObject {
+    if (self.state == YKFCBORPushDecoderStateFailed) {
+        return NO;
+    }
+    return self.state != YKFCBORPushDecoderStateHead || self.containers.count > 0;
+}
+
+- (void)reset {
+    self.state = YKFCBORPushDecoderStateHead;
+    [self.containers removeAllObjects];
+    [self resetItem];
+}
+
+- (BOOL)pushData:(NSData *)data error:(NSError **)error {
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = 0;
+    
+    if (self.state == YKFCBORPushDecoderStateFailed) {
+        return [self failWithError:error];
+    }
+    
+    while (offset < length) {
+        switch (self.state) {
+            case YKFCBORPushDecoderStateHead: {
+                UInt8 head = bytes[offset++];
+                self.head = head;
+                
+                // Bool
+                if (head == 0xF4 || head == 0xF5) {
+                    if (![self addObject:YKFCBORBool(head == 0xF5)]) {
+                        return [self failWithError:error];
+                    }
+                    break;
+                }
+                // MT 0-5 with the argument in the head or in the next 1, 2, 4 or 8 bytes.
+                UInt8 additionalInfo = head & 0x1F;
+                if (head > 0xBB || additionalInfo > YKFCBORUInt64Tag) {
+                    return [self failWithError:error];
+                }
+                if (additionalInfo < YKFCBORUInt8Tag) {
+                    self.argument = additionalInfo;
+                    if (![self completeArgument]) {
+                        return [self failWithError:error];
+                    }
+                } else {
+                    self.argument = 0;
+                    self.remainingArgumentBytes = 1 << (additionalInfo - YKFCBORUInt8Tag);
+                    self.state = YKFCBORPushDecoderStateArgument;
+                }
+                break;
+            }
+            case YKFCBORPushDecoderStateArgument: {
+                self.argument = (self.argument << 8) | bytes[offset++];
+                self.remainingArgumentBytes--;
+                if (self.remainingArgumentBytes == 0 && ![self completeArgument]) {
+                    return [self failWithError:error];
+                }
+                break;
+            }
+            case YKFCBORPushDecoderStateString: {
+                NSUInteger available = length - offset;
+                NSData *stringData = nil;
+                if (!self.string && available >= self.stringLength) {
+                    // The whole string is in this slice, copy it out without buffering.
+                    stringData = [NSData dataWithBytes:bytes + offset length:self.stringLength];
+                    offset += self.stringLength;
+                } else {
+                    if (!self.string) {
+                        self.string = [[NSMutableData alloc] initWithCapacity:self.stringLength];
+                    }
+                    NSUInteger count = MIN(available, self.stringLength - self.string.length);
+                    [self.string appendBytes:bytes + offset length:count];
+                    offset += count;
+                    if (self.string.length == self.stringLength) {
+                        stringData = [self.string copy];
+                    }
+                }
+                if (stringData && ![self completeStringWithData:stringData]) {
+                    return [self failWithError:error];
+                }
+                break;
+            }
+            case YKFCBORPushDecoderStateFailed:
+                return [self failWithError:error];
+        }
+    }
+    return YES;
+}
+
+- (BOOL)finishWithError:(NSError **)error {
+    BOOL complete = self.state == YKFCBORPushDecoderStateHead && self.containers.count == 0;
+    [self reset];
+    if (!complete) {
+        if (error) {
+            *error = [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+#pragma mark - YKFSmartCardResponseConsumer
+
+- (BOOL)consumeResponseChunk:(NSData *)chunk error:(NSError **)error {
+    return [self pushData:chunk error:error];
+}
+
+- (BOOL)finishResponseWithError:(NSError **)error {
+    return [self finishWithError:error];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)completeArgument {
+    UInt8 majorType = self.head & 0xE0;
+    UInt64 argument = self.argument;
+    
+    switch (majorType) {
+        case 0x00:
+            // Avoid overflow for values which cannot be represented on a NSInteger.
+            if (argument > INT64_MAX) { return NO; }
+            return [self addObject:YKFCBORInteger((NSInteger)argument)];
+            
+        case YKFCBORNegativeIntegerTagMask:
+            if (argument > INT64_MAX) { return NO; }
+            return [self addObject:YKFCBORInteger(-1 - (NSInteger)argument)];
+            
+        case YKFCBORByteStringTagMask:
+        case YKFCBORTextStringTagMask:
+            if (argument > self.maximumStringLength) { return NO; }
+            self.stringLength = (NSUInteger)argument;
+            if (argument == 0) {
+                return [self completeStringWithData:[NSData data]];
+            }
+            self.state = YKFCBORPushDecoderStateString;
+            return YES;
+            
+        case YKFCBORArrayTagMask:
+        case YKFCBORMapTagMask: {
+            if (argument > INT64_MAX) { return NO; }
+            BOOL isMap = majorType == YKFCBORMapTagMask;
+            if (argument == 0) {
+                return [self addObject:isMap ? YKFCBORMap(@{}) : YKFCBORArray(@[])];
+            }
+            [self.containers addObject:[[YKFCBORPushDecoderContainer alloc] initWithMap:isMap count:argument]];
+            [self resetItem];
+            return YES;
+        }
+            
+        default:
+            return NO;
+    }
+}
+
+- (BOOL)completeStringWithData:(NSData *)data {
+    if ((self.head & 0xE0) == YKFCBORByteStringTagMask) {
+        return [self addObject:YKFCBORByteString(data)];
+    }
+    NSString *stringValue = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    if (!stringValue) {
+        return NO;
+    }
+    return [self addObject:YKFCBORTextString(stringValue)];
+}
+
+/*
+ Adds a complete item to the innermost open container, closing every container it completes, or passes it to
+ the handler when it is a top level object.
+ */
+- (BOOL)addObject:(id)object {
+    [self resetItem];
+    
+    while (self.containers.count > 0) {
+        YKFCBORPushDecoderContainer *container = self.containers.lastObject;
+        if (container.isMap) {
+            if (!container.pendingKey) {
+                container.pendingKey = object;
+                return YES;
+            }
+            // Security check: Verify if the key already exists in the decoded map. A map with duplicated keys is invalid.
+            if (container.dictionary[container.pendingKey]) {
+                return NO;
+            }
+            container.dictionary[container.pendingKey] = object;
+            container.pendingKey = nil;
+        } else {
+            [container.array addObject:object];
+        }
+        
+        container.remainingElements--;
+        if (container.remainingElements > 0) {
+            return YES;
+        }
+        [self.containers removeLastObject];
+        object = container.isMap ? YKFCBORMap([container.dictionary copy]) : YKFCBORArray([container.array copy]);
+    }
+    
+    self.objectHandler(object);
+    return YES;
+}
+
+- (void)resetItem {
+    self.state = YKFCBORPushDecoderStateHead;
+    self.head = 0;
+    self.argument = 0;
+    self.remainingArgumentBytes = 0;
+    self.stringLength = 0;
+    self.string = nil;
+}
+
+- (BOOL)failWithError:(NSError **)error {
+    [self reset];
+    self.state = YKFCBORPushDecoderStateFailed;
+    if (error) {
+        *error = [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult];
+    }
+    return NO;
+}
+
+@end
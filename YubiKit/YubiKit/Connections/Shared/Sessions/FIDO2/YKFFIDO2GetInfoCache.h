@@ -0,0 +1,98 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+@class YKFFIDO2GetInfoResponse;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFFIDO2GetInfoCache
+
+ @abstract
+    In-memory cache of authenticatorGetInfo responses used by YKFFIDO2Session to avoid a GetInfo round trip
+    each time a FIDO2 session is created.
+
+ @discussion
+    Responses are stored by the capabilities of the authenticator model: the AAGUID and the firmware version. A
+    device identifier (e.g. serial number and firmware revision when available) or the connection over which the
+    response was received are kept as aliases to the stored response, so that a new session can find the cached
+    capabilities before talking to the key.
+
+    The cache is only used to choose the PIN protocol and to validate the size of the requests. Values which depend
+    on the state of the key, like the options, should be read with YKFFIDO2Session.getInfoWithCompletion:, which
+    always queries the key and refreshes the cache.
+ */
+@interface YKFFIDO2GetInfoCache: NSObject
+
+/*!
+ @abstract
+    The cache used by the FIDO2 sessions created by YubiKit.
+ */
+@property (class, nonatomic, readonly) YKFFIDO2GetInfoCache *sharedInstance;
+
+/*!
+ @abstract
+    The age after which a cached response is refreshed in the background by the session which used it.
+    The default value is 24 hours.
+ */
+@property (nonatomic, assign) NSTimeInterval refreshInterval;
+
+/*!
+ @abstract
+    Stores a response and links it to the device identifier and the connection it was received from.
+
+ @param response
+    The GetInfo response returned by the key.
+ @param deviceIdentifier
+    An optional identifier of the physical key (e.g. serial number and firmware revision, or the NFC tag identifier).
+ @param connection
+    An optional object representing the connection. The cache keeps a weak reference to it.
+ */
+- (void)storeResponse:(YKFFIDO2GetInfoResponse *)response deviceIdentifier:(nullable NSString *)deviceIdentifier connection:(nullable id)connection;
+
+/*!
+ @abstract
+    Returns the cached response for a key, looking up the connection first and the device identifier second.
+ */
+- (nullable YKFFIDO2GetInfoResponse *)responseForDeviceIdentifier:(nullable NSString *)deviceIdentifier connection:(nullable id)connection;
+
+/*!
+ @abstract
+    Returns the cached response for an authenticator model and firmware version.
+ */
+- (nullable YKFFIDO2GetInfoResponse *)responseForAAGUID:(NSData *)aaguid firmwareVersion:(NSUInteger)firmwareVersion;
+
+/*!
+ @abstract
+    Returns YES if the response cached for the key is older than refreshInterval or missing.
+ */
+- (BOOL)needsRefreshForDeviceIdentifier:(nullable NSString *)deviceIdentifier connection:(nullable id)connection;
+
+/*!
+ @abstract
+    Removes the response cached for a key, e.g. after an operation failed because of stale capabilities.
+ */
+- (void)removeResponseForDeviceIdentifier:(nullable NSString *)deviceIdentifier connection:(nullable id)connection;
+
+/*!
+ @abstract
+    Removes all the cached responses.
+ */
+- (void)removeAllResponses;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,181 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFFIDO2GetInfoCache.h"
+#import "YKFFIDO2GetInfoResponse.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFAssert.h"
+
+static const NSTimeInterval YKFFIDO2GetInfoCacheDefaultRefreshInterval = 24 * 60 * 60; // seconds
+static const NSUInteger YKFFIDO2GetInfoCacheMaxEntries = 32;
+
+@interface YKFFIDO2GetInfoCacheEntry: NSObject
+
+@property (nonatomic) YKFFIDO2GetInfoResponse *response;
+@property (nonatomic) NSDate *date;
+
+@end
+
+@implementation YKFFIDO2GetInfoCacheEntry
+@end
+
+@interface YKFFIDO2GetInfoCache()
+
+// AAGUID + firmware version -> entry
+@property (nonatomic) NSMutableDictionary<NSString *, YKFFIDO2GetInfoCacheEntry *> *entries;
+// device identifier -> AAGUID + firmware version
+@property (nonatomic) NSMutableDictionary<NSString *, NSString *> *deviceAliases;
+// connection (weak) -> AAGUID + firmware version
+@property (nonatomic) NSMapTable<id, NSString *> *connectionAliases;
+
+@end
+
+@implementation YKFFIDO2GetInfoCache
+
+static YKFFIDO2GetInfoCache *sharedInstance;
+
++ (YKFFIDO2GetInfoCache *)sharedInstance {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[YKFFIDO2GetInfoCache alloc] init];
+    });
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.refreshInterval = YKFFIDO2GetInfoCacheDefaultRefreshInterval;
+        self.entries = [[NSMutableDictionary alloc] init];
+        self.deviceAliases = [[NSMutableDictionary alloc] init];
+        self.connectionAliases = [NSMapTable weakToStrongObjectsMapTable];
+    }
+    return self;
+}
+
+#pragma mark - Public
+
+- (void)storeResponse:(YKFFIDO2GetInfoResponse *)response deviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    YKFParameterAssertReturn(response);
+
+    NSString *key = [self.class keyForAAGUID:response.aaguid firmwareVersion:response.firmwareVersion deviceIdentifier:deviceIdentifier];
+
+    YKFFIDO2GetInfoCacheEntry *entry = [[YKFFIDO2GetInfoCacheEntry alloc] init];
+    entry.response = response;
+    entry.date = [NSDate date];
+
+    @synchronized (self) {
+        if (!self.entries[key] && self.entries.count >= YKFFIDO2GetInfoCacheMaxEntries) {
+            [self removeOldestEntry];
+        }
+        self.entries[key] = entry;
+        if (deviceIdentifier) {
+            self.deviceAliases[deviceIdentifier] = key;
+        }
+        if (connection) {
+            [self.connectionAliases setObject:key forKey:connection];
+        }
+    }
+}
+
+- (YKFFIDO2GetInfoResponse *)responseForDeviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    @synchronized (self) {
+        return [self entryForDeviceIdentifier:deviceIdentifier connection:connection].response;
+    }
+}
+
+- (YKFFIDO2GetInfoResponse *)responseForAAGUID:(NSData *)aaguid firmwareVersion:(NSUInteger)firmwareVersion {
+    YKFParameterAssertReturnValue(aaguid, nil);
+    NSString *key = [self.class keyForAAGUID:aaguid firmwareVersion:firmwareVersion deviceIdentifier:nil];
+    @synchronized (self) {
+        return self.entries[key].response;
+    }
+}
+
+- (BOOL)needsRefreshForDeviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    @synchronized (self) {
+        YKFFIDO2GetInfoCacheEntry *entry = [self entryForDeviceIdentifier:deviceIdentifier connection:connection];
+        if (!entry) {
+            return YES;
+        }
+        return -[entry.date timeIntervalSinceNow] > self.refreshInterval;
+    }
+}
+
+- (void)removeResponseForDeviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    @synchronized (self) {
+        NSString *key = [self keyForDeviceIdentifier:deviceIdentifier connection:connection];
+        if (key) {
+            [self.entries removeObjectForKey:key];
+        }
+        if (deviceIdentifier) {
+            [self.deviceAliases removeObjectForKey:deviceIdentifier];
+        }
+        if (connection) {
+            [self.connectionAliases removeObjectForKey:connection];
+        }
+    }
+}
+
+- (void)removeAllResponses {
+    @synchronized (self) {
+        [self.entries removeAllObjects];
+        [self.deviceAliases removeAllObjects];
+        [self.connectionAliases removeAllObjects];
+    }
+}
+
+#pragma mark - Helpers
+
+// Must be called while holding the lock.
+- (NSString *)keyForDeviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    NSString *key = connection ? [self.connectionAliases objectForKey:connection] : nil;
+    if (!key && deviceIdentifier) {
+        key = self.deviceAliases[deviceIdentifier];
+    }
+    return key;
+}
+
+// Must be called while holding the lock.
+- (YKFFIDO2GetInfoCacheEntry *)entryForDeviceIdentifier:(NSString *)deviceIdentifier connection:(id)connection {
+    NSString *key = [self keyForDeviceIdentifier:deviceIdentifier connection:connection];
+    return key ? self.entries[key] : nil;
+}
+
+// Must be called while holding the lock.
+- (void)removeOldestEntry {
+    __block NSString *oldestKey = nil;
+    __block NSDate *oldestDate = nil;
+    [self.entries enumerateKeysAndObjectsUsingBlock:^(NSString *key, YKFFIDO2GetInfoCacheEntry *entry, BOOL *stop) {
+        if (!oldestDate || [entry.date compare:oldestDate] == NSOrderedAscending) {
+            oldestDate = entry.date;
+            oldestKey = key;
+        }
+    }];
+    if (oldestKey) {
+        [self.entries removeObjectForKey:oldestKey];
+        // Aliases to the removed entry are left dangling and resolve to a cache miss.
+    }
+}
+
++ (NSString *)keyForAAGUID:(NSData *)aaguid firmwareVersion:(NSUInteger)firmwareVersion deviceIdentifier:(NSString *)deviceIdentifier {
+    // Keys which don't report the firmware version in GetInfo are keyed by the device identifier as well, since the
+    // AAGUID alone does not identify the capabilities of the firmware.
+    if (firmwareVersion == 0 && deviceIdentifier) {
+        return [NSString stringWithFormat:@"%@/%@", [aaguid ykf_hexadecimalString], deviceIdentifier];
+    }
+    return [NSString stringWithFormat:@"%@/%lu", [aaguid ykf_hexadecimalString], (unsigned long)firmwareVersion];
+}
+
+@end
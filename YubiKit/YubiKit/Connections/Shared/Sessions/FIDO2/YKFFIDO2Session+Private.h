@@ -32,6 +32,14 @@ typedef void (^YKFFIDO2SessionCompletion)(YKFFIDO2Session *_Nullable, NSError* _
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                                completion:(YKFFIDO2SessionCompletion _Nonnull)completion;
 
+/*
+ The deviceIdentifier (e.g. serial number and firmware revision, or the NFC tag identifier) is used to look up the cached GetInfo
+ response of the key before the session is created. When nil, the response is looked up by connection.
+ */
++ (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
+                       deviceIdentifier:(nullable NSString *)deviceIdentifier
+                             completion:(YKFFIDO2SessionCompletion _Nonnull)completion;
+
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                            scpKeyParams:(nonnull id<YKFSCPKeyParamsProtocol>)scpKeyParams
                              completion:(YKFFIDO2SessionCompletion _Nonnull)completion;
@@ -36,6 +36,7 @@
 #import "YKFFIDO2ResetAPDU.h"
 
 #import "YKFFIDO2GetInfoResponse+Private.h"
+#import "YKFFIDO2GetInfoCache.h"
 #import "YKFFIDO2MakeCredentialResponse+Private.h"
 #import "YKFFIDO2GetAssertionResponse+Private.h"
 
@@ -48,9 +49,15 @@
 
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 
 #import "YKFSCPProcessor.h"
 #import "YKFSCPKeyParamsProtocol.h"
+#import "YKFCancellationToken.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
+#import "YKFSecureArena.h"
+#import <CommonCrypto/CommonDigest.h>
 
 static const int YKFFIDO2RequestMaxRetries = 30; // times
 static const NSTimeInterval YKFFIDO2RequestRetryTimeInterval = 0.5; // seconds
@@ -83,43 +90,89 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 
 @property (nonatomic, assign, readwrite) YKFFIDO2SessionKeyState keyState;
 
-// The cached authenticator pinToken, assigned after a successful validation.
-@property NSData *pinToken;
+// The cached authenticator pinToken, assigned after a successful validation. Replacing it zeroes the previous token.
+@property (nonatomic) NSData *pinToken;
 // Keeps the state of the application selection to avoid reselecting the application.
 @property BOOL applicationSelected;
 
 @property (nonatomic, readwrite) YKFFIDOPinProtocol pinProtocol;
 
+// The GetInfo capabilities used by the session and whether they were read from YKFFIDO2GetInfoCache.
+@property (nonatomic, nullable) YKFFIDO2GetInfoResponse *info;
+@property (nonatomic) BOOL infoFromCache;
+
+// Used to key the GetInfo cache.
+@property (nonatomic, weak) id<YKFConnectionControllerProtocol> connectionController;
+@property (nonatomic, nullable) NSString *deviceIdentifier;
+
 @end
 
 @implementation YKFFIDO2Session
 
 @synthesize delegate;
+@synthesize pinToken = _pinToken;
+
+- (void)dealloc {
+    YKFSecureZeroData(_pinToken);
+}
+
+- (NSData *)pinToken {
+    @synchronized (self) {
+        return _pinToken;
+    }
+}
+
+- (void)setPinToken:(NSData *)pinToken {
+    @synchronized (self) {
+        if (_pinToken != pinToken) {
+            YKFSecureZeroData(_pinToken);
+        }
+        _pinToken = pinToken;
+    }
+}
 
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                                completion:(YKFFIDO2SessionCompletion _Nonnull)completion {
+    [self sessionWithConnectionController:connectionController deviceIdentifier:nil completion:completion];
+}
+
++ (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
+                       deviceIdentifier:(nullable NSString *)deviceIdentifier
+                             completion:(YKFFIDO2SessionCompletion _Nonnull)completion {
     
     YKFFIDO2Session *session = [YKFFIDO2Session new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
+    session.connectionController = connectionController;
+    session.deviceIdentifier = deviceIdentifier;
 
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameFIDO2];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameFIDO2];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
-        } else {
-            [session getInfoWithCompletion:^(YKFFIDO2GetInfoResponse * _Nullable response, NSError * _Nullable error) {
-                if ([response.pinProtocols containsObject: @2]) {
-                    session.pinProtocol = YKFFIDOPinProtocolV2;
-                } else if ([response.pinProtocols containsObject: @1]) {
-                    session.pinProtocol = YKFFIDOPinProtocolV1;
-                } else {
-                    completion(nil, [YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodeOTHER]);
-                    return;
-                }
-                completion(session, nil);
-                [session updateKeyState:YKFFIDO2SessionKeyStateIdle];
-            }];
+            return;
         }
+        
+        // Skip the GetInfo round trip when the capabilities of the key are known.
+        YKFFIDO2GetInfoCache *cache = YKFFIDO2GetInfoCache.sharedInstance;
+        YKFFIDO2GetInfoResponse *cachedInfo = [cache responseForDeviceIdentifier:deviceIdentifier connection:connectionController];
+        if (cachedInfo && [session applyInfo:cachedInfo]) {
+            session.infoFromCache = YES;
+            completion(session, nil);
+            [session updateKeyState:YKFFIDO2SessionKeyStateIdle];
+            if ([cache needsRefreshForDeviceIdentifier:deviceIdentifier connection:connectionController]) {
+                [session refreshInfo];
+            }
+            return;
+        }
+        
+        [session getInfoWithCompletion:^(YKFFIDO2GetInfoResponse * _Nullable response, NSError * _Nullable error) {
+            if (![session applyInfo:response]) {
+                completion(nil, [YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodeOTHER]);
+                return;
+            }
+            completion(session, nil);
+            [session updateKeyState:YKFFIDO2SessionKeyStateIdle];
+        }];
     }];
 }
 
@@ -129,7 +182,7 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     YKFFIDO2Session *session = [YKFFIDO2Session new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameFIDO2];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameFIDO2];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -165,12 +218,51 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     [self.delegate keyStateChanged:keyState];
 }
 
+#pragma mark - GetInfo Cache
+
+- (BOOL)applyInfo:(YKFFIDO2GetInfoResponse *)info {
+    if ([info.pinProtocols containsObject: @2]) {
+        self.pinProtocol = YKFFIDOPinProtocolV2;
+    } else if ([info.pinProtocols containsObject: @1]) {
+        self.pinProtocol = YKFFIDOPinProtocolV1;
+    } else {
+        return NO;
+    }
+    self.info = info;
+    self.infoFromCache = NO;
+    return YES;
+}
+
+- (void)refreshInfo {
+    ykf_weak_self();
+    [self getInfoWithCompletion:^(YKFFIDO2GetInfoResponse * _Nullable response, NSError * _Nullable error) {
+        ykf_safe_strong_self();
+        if (response) {
+            [strongSelf applyInfo:response];
+        }
+    }];
+}
+
+- (BOOL)isStaleCapabilitiesError:(UInt8)fido2Error {
+    switch (fido2Error) {
+        case YKFFIDO2ErrorCodeINVALID_PARAMETER:
+        case YKFFIDO2ErrorCodeINVALID_LENGTH:
+        case YKFFIDO2ErrorCodeUNSUPPORTED_EXTENSION:
+        case YKFFIDO2ErrorCodeUNSUPPORTED_ALGORITHM:
+        case YKFFIDO2ErrorCodeUNSUPPORTED_OPTION:
+        case YKFFIDO2ErrorCodeREQUEST_TOO_LARGE:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
 #pragma mark - Public Requests
 
 - (void)getInfoWithCompletion:(YKFFIDO2SessionGetInfoCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     
-    YKFAPDU *apdu = [[YKFFIDO2CommandAPDU alloc] initWithCommand:YKFFIDO2CommandGetInfo data:nil];
+    YKFAPDU *apdu = YKFAPDU.fido2GetInfoAPDU;
     
     ykf_weak_self();
     [self executeFIDO2Command:apdu retryCount:0 completion:^(NSData * data, NSError *error) {
@@ -184,6 +276,9 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
         YKFFIDO2GetInfoResponse *getInfoResponse = [[YKFFIDO2GetInfoResponse alloc] initWithCBORData:cborData];
         
         if (getInfoResponse) {
+            [YKFFIDO2GetInfoCache.sharedInstance storeResponse:getInfoResponse
+                                              deviceIdentifier:strongSelf.deviceIdentifier
+                                                    connection:strongSelf.connectionController];
             completion(getInfoResponse, nil);
         } else {
             completion(nil, [YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodeINVALID_CBOR]);
@@ -213,9 +308,10 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
         clientPinGetPinTokenRequest.subCommand = YKFFIDO2ClientPinRequestSubCommandGetPINToken;
         clientPinGetPinTokenRequest.keyAgreement = cosePlatformPublicKey;
         
-        NSData *pinData = [pin dataUsingEncoding:NSUTF8StringEncoding];
-        NSData *pinHash = [[pinData ykf_SHA256] subdataWithRange:NSMakeRange(0, 16)];
-        clientPinGetPinTokenRequest.pinHashEnc = [pinHash ykf_encryptDataWithKey:sharedSecret pinProtocol:self.pinProtocol];
+        [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+            NSData *pinHash = [strongSelf pinHashWithPin:pin scope:scope];
+            clientPinGetPinTokenRequest.pinHashEnc = [pinHash ykf_encryptDataWithKey:sharedSecret pinProtocol:strongSelf.pinProtocol];
+        }];
         
         [strongSelf executeClientPinRequest:clientPinGetPinTokenRequest completion:^(YKFFIDO2ClientPinResponse *response, NSError *error) {
             if (error) {
@@ -268,17 +364,17 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
         
         // Change the PIN
         YKFFIDO2ClientPinRequest *changePinRequest = [[YKFFIDO2ClientPinRequest alloc] init];
-        NSData *oldPinData = [oldPin dataUsingEncoding:NSUTF8StringEncoding];
-        NSData *newPinData = [[newPin dataUsingEncoding:NSUTF8StringEncoding] ykf_fido2PaddedPinData];
-
         changePinRequest.pinProtocol = 1;
         changePinRequest.subCommand = YKFFIDO2ClientPinRequestSubCommandChangePIN;
         changePinRequest.keyAgreement = cosePlatformPublicKey;
 
-        NSData *oldPinHash = [[oldPinData ykf_SHA256] subdataWithRange:NSMakeRange(0, 16)];
-        changePinRequest.pinHashEnc = [oldPinHash ykf_aes256EncryptedDataWithKey:sharedSecret];
+        [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+            NSData *oldPinHash = [strongSelf pinHashWithPin:oldPin scope:scope];
+            changePinRequest.pinHashEnc = [oldPinHash ykf_aes256EncryptedDataWithKey:sharedSecret];
 
-        changePinRequest.pinEnc = [newPinData ykf_aes256EncryptedDataWithKey:sharedSecret];
+            NSData *newPinData = [strongSelf paddedPinDataWithPin:newPin scope:scope];
+            changePinRequest.pinEnc = [newPinData ykf_aes256EncryptedDataWithKey:sharedSecret];
+        }];
         
         NSMutableData *pinAuthData = [NSMutableData dataWithData:changePinRequest.pinEnc];
         [pinAuthData appendData:changePinRequest.pinHashEnc];
@@ -300,9 +396,8 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     YKFParameterAssertReturn(pin);
     YKFParameterAssertReturn(completion);
     
-    NSData *pinData = [[pin dataUsingEncoding:NSUTF8StringEncoding] ykf_fido2PaddedPinData];
-    
-    if (pin.length < 4 || pinData.length > 65) {
+    // Longer PINs don't fit the 64 bytes of padded PIN data.
+    if (pin.length < 4 || [pin lengthOfBytesUsingEncoding:NSUTF8StringEncoding] > 64) {
         completion([YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodePIN_POLICY_VIOLATION]);
         return;
     }
@@ -323,7 +418,10 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
         setPinRequest.subCommand = YKFFIDO2ClientPinRequestSubCommandSetPIN;
         setPinRequest.keyAgreement = cosePlatformPublicKey;
         
-        setPinRequest.pinEnc = [pinData ykf_encryptDataWithKey:sharedSecret pinProtocol:self.pinProtocol];
+        [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+            NSData *pinData = [strongSelf paddedPinDataWithPin:pin scope:scope];
+            setPinRequest.pinEnc = [pinData ykf_encryptDataWithKey:sharedSecret pinProtocol:strongSelf.pinProtocol];
+        }];
         setPinRequest.pinAuth = [setPinRequest.pinEnc ykf_authenticateDataWithKey:sharedSecret pinProtocol:self.pinProtocol];
         
         [strongSelf executeClientPinRequest:setPinRequest completion:^(YKFFIDO2ClientPinResponse *response, NSError *error) {
@@ -459,7 +557,7 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 - (void)getNextAssertionWithCompletion:(YKFFIDO2SessionGetAssertionCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     
-    YKFAPDU *apdu = [[YKFFIDO2GetNextAssertionAPDU alloc] init];
+    YKFAPDU *apdu = YKFAPDU.fido2GetNextAssertionAPDU;
     
     ykf_weak_self();
     [self executeFIDO2Command:apdu retryCount:0 completion:^(NSData *data, NSError *error) {
@@ -483,7 +581,7 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 - (void)resetWithCompletion:(YKFFIDO2SessionGenericCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     
-    YKFAPDU *apdu = [[YKFFIDO2ResetAPDU alloc] init];
+    YKFAPDU *apdu = YKFAPDU.fido2ResetAPDU;
     
     ykf_weak_self();
     [self executeFIDO2Command:apdu retryCount:0 completion:^(NSData *response, NSError *error) {
@@ -603,9 +701,20 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 #pragma mark - Request Execution
 
 - (void)executeFIDO2Command:(YKFAPDU *)apdu retryCount:(int)retryCount completion:(YKFFIDO2SessionResultCompletionBlock)completion {
+    [self executeFIDO2Command:apdu retryCount:retryCount cancellationToken:self.smartCardInterface.cancellationToken completion:completion];
+}
+
+- (void)executeFIDO2Command:(YKFAPDU *)apdu retryCount:(int)retryCount cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFFIDO2SessionResultCompletionBlock)completion {
     YKFParameterAssertReturn(apdu);
     YKFParameterAssertReturn(completion);
     
+    // Reject requests the key is known not to accept without a round trip.
+    NSUInteger maxMsgSize = self.info.maxMsgSize;
+    if (maxMsgSize > 0 && apdu.data.length > maxMsgSize) {
+        completion(nil, [YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodeREQUEST_TOO_LARGE]);
+        return;
+    }
+    
     [self updateKeyState:YKFFIDO2SessionKeyStateProcessingRequest];
     
     ykf_weak_self();
@@ -615,6 +724,13 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
         if (data) {
             UInt8 fido2Error = [self fido2ErrorCodeFromResponseData:data];
             if (fido2Error != YKFFIDO2ErrorCodeSUCCESS) {
+                // The cached capabilities may be outdated (e.g. after a firmware update), refresh them for the next request.
+                if (strongSelf.infoFromCache && [strongSelf isStaleCapabilitiesError:fido2Error]) {
+                    [YKFFIDO2GetInfoCache.sharedInstance removeResponseForDeviceIdentifier:strongSelf.deviceIdentifier
+                                                                                 connection:strongSelf.connectionController];
+                    strongSelf.infoFromCache = NO;
+                    [strongSelf refreshInfo];
+                }
                 completion(nil, [YKFFIDO2Error errorWithCode:fido2Error]);
             } else {
                 completion(data, nil);
@@ -622,7 +738,7 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
             [strongSelf updateKeyState:YKFFIDO2SessionKeyStateIdle];
         } else {
             if (error.code == YKFAPDUErrorCodeFIDO2TouchRequired) {
-                [strongSelf handleTouchRequired:apdu retryCount:retryCount completion:completion];
+                [strongSelf handleTouchRequired:apdu retryCount:retryCount cancellationToken:cancellationToken completion:completion];
             } else {
                 [strongSelf updateKeyState:YKFFIDO2SessionKeyStateIdle];
                 completion(nil, error);
@@ -633,6 +749,23 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
 
 #pragma mark - Helpers
 
+// LEFT(SHA-256(PIN), 16), computed in the secure arena.
+- (NSData *)pinHashWithPin:(NSString *)pin scope:(YKFSecureArenaScope *)scope {
+    NSData *pinData = [scope UTF8DataWithString:pin paddedToLength:0 padding:0x00];
+    NSMutableData *digest = [scope mutableDataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(pinData.bytes, (CC_LONG)pinData.length, digest.mutableBytes);
+    NSMutableData *pinHash = [scope mutableDataWithLength:16];
+    memcpy(pinHash.mutableBytes, digest.bytes, 16);
+    return pinHash;
+}
+
+// The PIN padded with zeros to 64 bytes, or to a multiple of 16 bytes when longer, in the secure arena.
+- (NSData *)paddedPinDataWithPin:(NSString *)pin scope:(YKFSecureArenaScope *)scope {
+    NSUInteger pinLength = [pin lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    NSUInteger paddedLength = pinLength <= 64 ? 64 : (pinLength + 15) / 16 * 16;
+    return [scope UTF8DataWithString:pin paddedToLength:paddedLength padding:0x00];
+}
+
 - (UInt8)fido2ErrorCodeFromResponseData:(NSData *)data {
     YKFAssertReturnValue(data.length >= 1, @"Cannot extract FIDO2 error code from the key response.", YKFFIDO2ErrorCodeOTHER);
     UInt8 *payloadBytes = (UInt8 *)data.bytes;
@@ -646,10 +779,42 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     return [data subdataWithRange:NSMakeRange(1, data.length - 1)];
 }
 
-- (void)handleTouchRequired:(YKFAPDU *)apdu  retryCount:(int)retryCount completion:(YKFFIDO2SessionResultCompletionBlock)completion {
+- (void)handleTouchRequired:(YKFAPDU *)apdu retryCount:(int)retryCount cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFFIDO2SessionResultCompletionBlock)completion {
     YKFParameterAssertReturn(apdu);
     YKFParameterAssertReturn(completion);
     
+    if (retryCount == 0) {
+        // Stop waiting for touch as soon as the commands are cancelled. The in-flight poll is dropped by the
+        // connection controller, so the request is completed here, once, with whichever result comes first.
+        NSObject *lock = [[NSObject alloc] init];
+        __block BOOL completed = NO;
+        __block id registration = nil;
+        NSDate *touchStartDate = [NSDate date];
+        YKFConnectionMetrics *metrics = self.smartCardInterface.metrics;
+        YKFFIDO2SessionResultCompletionBlock originalCompletion = completion;
+        completion = ^(NSData *data, NSError *error) {
+            @synchronized (lock) {
+                if (completed) {
+                    return;
+                }
+                completed = YES;
+            }
+            [cancellationToken removeCancellationHandler:registration];
+            [metrics recordTouchWaitWithDuration:-[touchStartDate timeIntervalSinceNow]];
+            originalCompletion(data, error);
+        };
+        ykf_weak_self();
+        YKFFIDO2SessionResultCompletionBlock cancelCompletion = completion;
+        registration = [cancellationToken addCancellationHandler:^{
+            [weakSelf updateKeyState:YKFFIDO2SessionKeyStateIdle];
+            cancelCompletion(nil, [YKFFIDO2Error errorWithCode:YKFFIDO2ErrorCodeKEEPALIVE_CANCEL]);
+        }];
+    }
+    
+    if (cancellationToken.isCancelled) {
+        return;
+    }
+    
     if (retryCount >= YKFFIDO2RequestMaxRetries) {
         YKFSessionError *timeoutError = [YKFSessionError errorWithCode:YKFSessionErrorTouchTimeoutCode];
         completion(nil, timeoutError);
@@ -665,8 +830,13 @@ typedef void (^YKFFIDO2SessionClientPinSharedSecretCompletionBlock)
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, YKFFIDO2RequestRetryTimeInterval * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
         ykf_safe_strong_self();
 
-        YKFAPDU* apdu = [[YKFFIDO2TouchPoolingAPDU alloc] init];
-        [strongSelf executeFIDO2Command:apdu retryCount:retryCount completion:completion];
+        if (cancellationToken.isCancelled) {
+            return;
+        }
+
+        YKFAPDU* apdu = YKFAPDU.fido2TouchPollingAPDU;
+        YKFEventRingRecord(YKFEventTypeTouchPoll, apdu.ins, retryCount, 0);
+        [strongSelf executeFIDO2Command:apdu retryCount:retryCount cancellationToken:cancellationToken completion:completion];
     });
 }
 
@@ -20,6 +20,7 @@
 #import "YKFAPDUError.h"
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 #import "YKFFeature.h"
 #import "NSArray+YKFTLVRecord.h"
 #import "YKFTLVRecord.h"
@@ -46,7 +47,7 @@ NSString* const YKFManagementErrorDomain = @"com.yubico.management";
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     session.features = [YKFManagementSessionFeatures new];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameManagement];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -63,7 +64,7 @@ NSString* const YKFManagementErrorDomain = @"com.yubico.management";
     YKFManagementSession *session = [YKFManagementSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameManagement];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -105,7 +106,7 @@ typedef void (^YKFManagementSessionReadPagedDeviceInfoBlock)
     (NSMutableArray<YKFTLVRecord *>* result, NSError* _Nullable error);
 
 - (void)readPagedDeviceInfoWithCompletion:(YKFManagementSessionReadPagedDeviceInfoBlock)completion result:(NSMutableArray<YKFTLVRecord *>* _Nonnull)result page:(UInt8)page {
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0x1D p1:page p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    YKFAPDU *apdu = [YKFAPDU managementReadDeviceInfoAPDUWithPage:page];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -154,7 +155,7 @@ typedef void (^YKFManagementSessionReadPagedDeviceInfoBlock)
         completion([[NSError alloc] initWithDomain:YKFManagementErrorDomain code:YKFManagementErrorCodeUnsupportedOperation userInfo:@{NSLocalizedDescriptionKey: @"Device reset not supported by this YubiKey."}]);
         return;
     }
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:0x1f p1:0 p2:0 data:[NSData data] type:YKFAPDUTypeExtended];
+    YKFAPDU *apdu = YKFAPDU.managementDeviceResetAPDU;
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         completion(error);
     }];
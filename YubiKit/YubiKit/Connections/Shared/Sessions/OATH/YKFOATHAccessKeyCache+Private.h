@@ -0,0 +1,40 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFOATHAccessKeyCache.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface YKFOATHAccessKeyCache()
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*
+ Remembers the salt of a key selected in a session so its access keys can be pre-derived.
+ */
+- (void)rememberSalt:(NSData *)salt forDeviceId:(NSString *)deviceId;
+
+/*
+ Returns the cached access key or derives and caches it.
+ */
+- (nullable NSData *)accessKeyForPassword:(NSString *)password salt:(NSData *)salt;
+
+/*
+ Removes and zeroes the access key, e.g. when the key rejected it.
+ */
+- (void)removeAccessKeyForPassword:(NSString *)password salt:(NSData *)salt;
+
+@end
+
+NS_ASSUME_NONNULL_END
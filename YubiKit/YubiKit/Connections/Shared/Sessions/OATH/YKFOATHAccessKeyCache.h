@@ -0,0 +1,83 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFOATHAccessKeyCache
+
+ @abstract
+    A bounded in-memory cache of the access keys derived from OATH passwords.
+
+ @discussion
+    Deriving the access key from a password runs PBKDF2 with the salt sent by the key when the OATH application is
+    selected. YKFOATHSession unlockWithPassword:completion: and setPassword:completion: look up the access key in
+    this cache first, so a password which was already used or pre-derived for the key doesn't need to be derived again
+    while the NFC session is running. Entries are keyed by the salt and a digest of the password, the least recently
+    used entries are evicted first and the memory of removed entries is overwritten with zeros. Access keys which fail
+    to unlock the key are removed.
+
+    The cache also remembers the salt of the last keys used in a session, by deviceId, so the app can pre-derive the
+    access key, e.g. while the user types the password, before the key is tapped.
+ */
+@interface YKFOATHAccessKeyCache: NSObject
+
+/*!
+ @abstract
+    The cache used by the OATH sessions.
+ */
+@property (class, nonatomic, readonly) YKFOATHAccessKeyCache *sharedCache;
+
+/*!
+ @abstract
+    The maximum number of access keys and device salts kept by the cache. Defaults to 8. Setting 0 disables the cache.
+ */
+@property (nonatomic) NSUInteger capacity;
+
+/// The number of access keys in the cache.
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ @abstract
+    Derives the access key for a password in the background and stores it in the cache.
+
+ @param password
+    The password being entered by the user.
+
+ @param deviceId
+    The deviceId of the YKFOATHSession the password is for. If nil, the access key is derived for every key
+    remembered by the cache. Keys which were not seen in a session since the app started are ignored.
+
+ @param completion
+    Called on a background thread after the derivation, with the number of derived access keys.
+ */
+- (void)prederiveAccessKeyForPassword:(NSString *)password deviceId:(nullable NSString *)deviceId completion:(nullable void (^)(NSUInteger count))completion;
+
+/*!
+ @abstract
+    Removes and zeroes the access keys derived for a key, e.g. after its password was changed on another device.
+ */
+- (void)invalidateDeviceId:(NSString *)deviceId;
+
+/*!
+ @abstract
+    Removes and zeroes all the access keys and forgets the remembered keys.
+ */
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
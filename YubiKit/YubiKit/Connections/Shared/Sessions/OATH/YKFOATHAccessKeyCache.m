@@ -0,0 +1,250 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <CommonCrypto/CommonCrypto.h>
+#import "YKFOATHAccessKeyCache.h"
+#import "YKFOATHAccessKeyCache+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFAssert.h"
+#import "YKFSecureArena.h"
+
+static const NSUInteger YKFOATHAccessKeyCacheDefaultCapacity = 8;
+
+@interface YKFOATHAccessKeyCache()
+
+// Entry ids are the salt followed by SHA256(salt | password), so the entries of a key share the salt prefix.
+// A map table doesn't copy the keys, so the entry ids can be zeroed like the access keys.
+@property (nonatomic) NSMapTable<NSMutableData *, NSMutableData *> *accessKeys;
+// Least recently used first.
+@property (nonatomic) NSMutableArray<NSMutableData *> *entryIds;
+
+@property (nonatomic) NSMutableDictionary<NSString *, NSData *> *salts;
+@property (nonatomic) NSMutableArray<NSString *> *deviceIds;
+
+@end
+
+@implementation YKFOATHAccessKeyCache
+
++ (YKFOATHAccessKeyCache *)sharedCache {
+    static YKFOATHAccessKeyCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [[YKFOATHAccessKeyCache alloc] initWithCapacity:YKFOATHAccessKeyCacheDefaultCapacity];
+    });
+    return sharedCache;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:YKFOATHAccessKeyCacheDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _accessKeys = [NSMapTable strongToStrongObjectsMapTable];
+        _entryIds = [[NSMutableArray alloc] init];
+        _salts = [[NSMutableDictionary alloc] init];
+        _deviceIds = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self invalidate];
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)capacity {
+    @synchronized (self) {
+        return _capacity;
+    }
+}
+
+- (void)setCapacity:(NSUInteger)capacity {
+    @synchronized (self) {
+        _capacity = capacity;
+        [self trimToCapacity];
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.accessKeys.count;
+    }
+}
+
+#pragma mark - Public
+
+- (void)prederiveAccessKeyForPassword:(NSString *)password deviceId:(NSString *)deviceId completion:(void (^)(NSUInteger))completion {
+    YKFParameterAssertReturn(password);
+    NSArray<NSData *> *salts = nil;
+    @synchronized (self) {
+        if (deviceId) {
+            NSData *salt = self.salts[deviceId];
+            salts = salt ? @[salt] : @[];
+        } else {
+            salts = [self.salts.allValues copy];
+        }
+    }
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSUInteger count = 0;
+        for (NSData *salt in salts) {
+            count += [self accessKeyForPassword:password salt:salt] ? 1 : 0;
+        }
+        if (completion) {
+            completion(count);
+        }
+    });
+}
+
+- (void)invalidateDeviceId:(NSString *)deviceId {
+    YKFParameterAssertReturn(deviceId);
+    @synchronized (self) {
+        NSData *salt = self.salts[deviceId];
+        if (!salt) {
+            return;
+        }
+        NSIndexSet *indexes = [self.entryIds indexesOfObjectsPassingTest:^BOOL(NSMutableData *entryId, NSUInteger index, BOOL *stop) {
+            return entryId.length > salt.length && memcmp(entryId.bytes, salt.bytes, salt.length) == 0;
+        }];
+        [self removeEntriesAtIndexes:indexes];
+    }
+}
+
+- (void)invalidate {
+    @synchronized (self) {
+        [self removeEntriesAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.entryIds.count)]];
+        [self.salts removeAllObjects];
+        [self.deviceIds removeAllObjects];
+    }
+}
+
+#pragma mark - Private
+
+- (void)rememberSalt:(NSData *)salt forDeviceId:(NSString *)deviceId {
+    YKFParameterAssertReturn(salt);
+    YKFParameterAssertReturn(deviceId);
+    @synchronized (self) {
+        if (self.capacity == 0) {
+            return;
+        }
+        [self.deviceIds removeObject:deviceId];
+        [self.deviceIds addObject:deviceId];
+        self.salts[deviceId] = [salt copy];
+        [self trimToCapacity];
+    }
+}
+
+- (NSData *)accessKeyForPassword:(NSString *)password salt:(NSData *)salt {
+    YKFParameterAssertReturnValue(password, nil);
+    YKFParameterAssertReturnValue(salt, nil);
+
+    // The password bytes only live in the secure arena.
+    __block NSData *accessKey = nil;
+    [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSData *passwordData = [scope UTF8DataWithString:password paddedToLength:0 padding:0x00];
+        accessKey = [self accessKeyForPasswordData:passwordData salt:salt];
+    }];
+    return accessKey;
+}
+
+- (void)removeAccessKeyForPassword:(NSString *)password salt:(NSData *)salt {
+    YKFParameterAssertReturn(password);
+    YKFParameterAssertReturn(salt);
+    __block NSMutableData *entryId = nil;
+    [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSData *passwordData = [scope UTF8DataWithString:password paddedToLength:0 padding:0x00];
+        entryId = [self entryIdForPasswordData:passwordData salt:salt];
+    }];
+    @synchronized (self) {
+        NSUInteger index = [self.entryIds indexOfObject:entryId];
+        if (index != NSNotFound) {
+            [self removeEntriesAtIndexes:[NSIndexSet indexSetWithIndex:index]];
+        }
+    }
+    YKFSecureZeroData(entryId);
+}
+
+#pragma mark - Helpers
+
+- (NSData *)accessKeyForPasswordData:(NSData *)passwordData salt:(NSData *)salt {
+    NSMutableData *entryId = [self entryIdForPasswordData:passwordData salt:salt];
+    @synchronized (self) {
+        NSMutableData *accessKey = [self.accessKeys objectForKey:entryId];
+        if (accessKey) {
+            NSUInteger index = [self.entryIds indexOfObject:entryId];
+            NSMutableData *storedEntryId = self.entryIds[index];
+            [self.entryIds removeObjectAtIndex:index];
+            [self.entryIds addObject:storedEntryId];
+            YKFSecureZeroData(entryId);
+            return [accessKey copy];
+        }
+    }
+
+    // Derive outside of the lock, the cache stays usable by the other sessions while PBKDF2 runs.
+    NSData *accessKey = [passwordData ykf_deriveOATHKeyWithSalt:salt];
+    if (!accessKey) {
+        YKFSecureZeroData(entryId);
+        return nil;
+    }
+    @synchronized (self) {
+        if (self.capacity > 0 && ![self.accessKeys objectForKey:entryId]) {
+            [self.accessKeys setObject:[accessKey mutableCopy] forKey:entryId];
+            [self.entryIds addObject:entryId];
+            [self trimToCapacity];
+        } else {
+            YKFSecureZeroData(entryId);
+        }
+    }
+    return accessKey;
+}
+
+- (NSMutableData *)entryIdForPasswordData:(NSData *)passwordData salt:(NSData *)salt {
+    NSMutableData *entryId = [[NSMutableData alloc] initWithLength:salt.length + CC_SHA256_DIGEST_LENGTH];
+    memcpy(entryId.mutableBytes, salt.bytes, salt.length);
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    CC_SHA256_Update(&context, salt.bytes, (CC_LONG)salt.length);
+    CC_SHA256_Update(&context, passwordData.bytes, (CC_LONG)passwordData.length);
+    CC_SHA256_Final((UInt8 *)entryId.mutableBytes + salt.length, &context);
+    memset_s(&context, sizeof(context), 0, sizeof(context));
+    return entryId;
+}
+
+// Must be called while synchronized.
+- (void)removeEntriesAtIndexes:(NSIndexSet *)indexes {
+    [indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        NSMutableData *entryId = self.entryIds[index];
+        NSMutableData *accessKey = [self.accessKeys objectForKey:entryId];
+        [self.accessKeys removeObjectForKey:entryId];
+        YKFSecureZeroData(accessKey);
+        YKFSecureZeroData(entryId);
+    }];
+    [self.entryIds removeObjectsAtIndexes:indexes];
+}
+
+// Must be called while synchronized.
+- (void)trimToCapacity {
+    if (self.entryIds.count > _capacity) {
+        [self removeEntriesAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.entryIds.count - _capacity)]];
+    }
+    while (self.deviceIds.count > _capacity) {
+        [self.salts removeObjectForKey:self.deviceIds.firstObject];
+        [self.deviceIds removeObjectAtIndex:0];
+    }
+}
+
+@end
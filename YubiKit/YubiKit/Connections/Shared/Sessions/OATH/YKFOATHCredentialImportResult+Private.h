@@ -0,0 +1,29 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFOATHCredentialImportResult.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface YKFOATHCredentialImportResult()
+
+@property (nonatomic, readwrite, nullable) YKFOATHCredentialTemplate *credentialTemplate;
+@property (nonatomic, readwrite, nullable) YKFOATHCredential *credential;
+@property (nonatomic, readwrite, nullable) NSError *error;
+
+- (instancetype)initWithURL:(NSURL *)url NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,45 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+@class YKFOATHCredential, YKFOATHCredentialTemplate;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFOATHCredentialImportResult
+
+ @abstract
+    The result of importing one otpauth:// URL with [YKFOATHSession importCredentialsFromURLs:requiresTouch:completion:].
+ */
+@interface YKFOATHCredentialImportResult: NSObject
+
+/// The imported URL.
+@property (nonatomic, readonly) NSURL *url;
+
+/// The credential template parsed from the URL. Nil if the URL is not a valid credential.
+@property (nonatomic, readonly, nullable) YKFOATHCredentialTemplate *credentialTemplate;
+
+/// The credential stored on the key, as it would be returned by listing the credentials. Nil if the import failed.
+@property (nonatomic, readonly, nullable) YKFOATHCredential *credential;
+
+/// The parsing or the put error. Nil if the credential was stored on the key.
+@property (nonatomic, readonly, nullable) NSError *error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -19,6 +19,7 @@
 #import <Foundation/Foundation.h>
 #import "YKFSessionProtocol+Private.h"
 #import "YKFOATHSession.h"
+#import "YKFConnectionProtocol.h"
 
 @protocol YKFConnectionControllerProtocol, YKFSCPKeyParamsProtocol;
 
@@ -33,6 +34,17 @@ typedef void (^YKFOATHSessionCompletion)(YKFOATHSession *_Nullable, NSError* _Nu
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                            scpKeyParams:(nonnull id<YKFSCPKeyParamsProtocol>)scpKeyParams
                              completion:(YKFOATHSessionCompletion _Nonnull)completion;
+
+/*
+ Selects the application and, if it's password protected, unlocks it with the key from the provider before
+ calculating all credentials. Each command is queued from the completion of the previous one so the app is only
+ called back once. The session is passed to the completion as soon as the application is selected, also on error.
+ */
++ (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
+                           scpKeyParams:(nullable id<YKFSCPKeyParamsProtocol>)scpKeyParams
+                      accessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider
+                             completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion;
+
 /*
  Call this to force an applet selection on the next OATH operation.
  */
@@ -20,6 +20,7 @@
        YKFOATHCredential,
        YKFOATHCredentialWithCode,
        YKFOATHCredentialTemplate,
+       YKFOATHCredentialImportResult,
        YKFOATHSelectApplicationResponse;
 
 /**
@@ -115,6 +116,22 @@ typedef void (^YKFOATHSelectApplicationCompletionBlock)
 typedef void (^YKFOATHSessionCalculateResponseCompletionBlock)
     (NSData* _Nullable response, NSError* _Nullable error);
 
+/*!
+ @abstract
+    Response block for [importCredentialsFromURLs:requiresTouch:completion:] which provides the result for each
+    imported URL.
+ 
+ @param results
+    One result per URL, in the order of the URLs. In case of error this parameter is nil.
+ 
+ @param error
+    In case the import could not start, e.g. when the key does not have room for the credentials or the OATH
+    application is password protected and locked, this parameter contains the error. Otherwise it is nil and
+    the per URL errors are reported in the results.
+ */
+typedef void (^YKFOATHSessionImportCompletionBlock)
+    (NSArray<YKFOATHCredentialImportResult*>* _Nullable results, NSError* _Nullable error);
+
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -161,6 +178,36 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)putCredentialTemplate:(YKFOATHCredentialTemplate *)credentialTemplate requiresTouch:(BOOL)requiresTouch completion:(YKFOATHSessionGenericCompletionBlock)completion;
 
+/*!
+ @method importCredentialsFromURLs:requiresTouch:completion:
+ 
+ @abstract
+    Adds the credentials from a list of otpauth:// URLs to the key in a single batch.
+ 
+ @discussion
+    The URLs are parsed and validated in parallel. The credentials on the key are listed once to check that the
+    new credentials fit; if they don't, nothing is written and the completion receives YKFOATHErrorCodeNoSpace.
+    The put requests are then queued back to back and the completion is called once, after the last one, with
+    the result of each URL. Credentials with the same name as an existing credential replace it, like with
+    putCredentialTemplate:requiresTouch:completion:. The results contain the stored credentials, so the
+    credentials don't need to be listed again after the import.
+ 
+ @param urls
+    The otpauth:// URLs of the credentials, as defined in:
+    https://github.com/google/google-authenticator/wiki/Key-Uri-Format
+ 
+ @param requiresTouch
+    Whether the imported credentials require touch to calculate a code.
+ 
+ @param completion
+    The response block which is executed after all the requests were processed by the key. The completion
+    block will be executed on a background thread.
+ 
+ @note:
+    This method is thread safe and can be invoked from any thread (main or a background thread).
+ */
+- (void)importCredentialsFromURLs:(NSArray<NSURL *> *)urls requiresTouch:(BOOL)requiresTouch completion:(YKFOATHSessionImportCompletionBlock)completion;
+
 /*!
  @method deleteCredential:completion:
  
@@ -433,6 +480,8 @@ NS_ASSUME_NONNULL_BEGIN
  @abstract
     Derives an access key from a password and the device-specific salt.
     The key is derived by running 1000 rounds of PBKDF2 using the password and salt as inputs, with a 16 byte output.
+    Derived keys are kept in YKFOATHAccessKeyCache.sharedCache and returned from the cache when the same password
+    is used again with the same key.
  
  @param password
     A user-supplied password, encoded as UTF-8 bytes.
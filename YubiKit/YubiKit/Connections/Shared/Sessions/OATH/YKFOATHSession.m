@@ -47,6 +47,9 @@
 #import "YKFOATHCode.h"
 #import "YKFOATHCredentialUtils.h"
 #import "YKFOATHCredentialTemplate.h"
+#import "YKFOATHCredential+Private.h"
+#import "YKFOATHCredentialImportResult+Private.h"
+#import "YKFOATHAccessKeyCache+Private.h"
 #import "YKFOATHListResponse.h"
 #import "YKFOATHSelectApplicationResponse.h"
 #import "YKFOATHSelectApplicationResponse.h"
@@ -54,9 +57,11 @@
 
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 
 #import "YKFSCPProcessor.h"
 #import "YKFSCPKeyParamsProtocol.h"
+#import "YKFConnectionMetrics+Private.h"
 
 #import "YKFAPDUCommandInstruction.h"
 #import "YKFAPDU.h"
@@ -68,6 +73,10 @@ static const NSUInteger YKFOATHCalculateIns = 0xa2;
 
 static const NSTimeInterval YKFOATHServiceTimeoutThreshold = 10; // seconds
 
+// Number of credentials the OATH application can store, 64 since firmware 5.7.
+static const NSUInteger YKFOATHCredentialCapacity = 32;
+static const NSUInteger YKFOATHExtendedCredentialCapacity = 64;
+
 typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, NSError* _Nullable error);
 
 @interface YKFOATHSession()
@@ -88,12 +97,20 @@ typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, N
     return self.cachedSelectApplicationResponse != nil;
 }
 
+- (void)setCachedSelectApplicationResponse:(YKFOATHSelectApplicationResponse *)cachedSelectApplicationResponse {
+    _cachedSelectApplicationResponse = cachedSelectApplicationResponse;
+    // Remember the salt so the app can pre-derive the access key before the next session with this key.
+    if (cachedSelectApplicationResponse.selectID.length) {
+        [YKFOATHAccessKeyCache.sharedCache rememberSalt:cachedSelectApplicationResponse.selectID forDeviceId:self.deviceId];
+    }
+}
+
 + (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
                                completion:(YKFOATHSessionCompletion _Nonnull)completion {
     YKFOATHSession *session = [YKFOATHSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameOATH];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameOATH];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -110,7 +127,7 @@ typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, N
     YKFOATHSession *session = [YKFOATHSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameOATH];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameOATH];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -132,6 +149,53 @@ typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, N
     }];
 }
 
++ (void)sessionWithConnectionController:(nonnull id<YKFConnectionControllerProtocol>)connectionController
+                           scpKeyParams:(id<YKFSCPKeyParamsProtocol>)scpKeyParams
+                      accessKeyProvider:(YKFOATHAccessKeyProvider)accessKeyProvider
+                             completion:(YKFOATHUnlockedSessionCompletionBlock)completion {
+    YKFParameterAssertReturn(accessKeyProvider);
+    YKFParameterAssertReturn(completion);
+    
+    YKFOATHSessionCompletion selectCompletion = ^(YKFOATHSession * _Nullable session, NSError * _Nullable error) {
+        if (error) {
+            completion(nil, nil, error);
+            return;
+        }
+        // Called on the communication queue, the next commands are queued right after the select.
+        [session unlockWithAccessKeyProvider:accessKeyProvider calculateAllWithCompletion:^(NSArray<YKFOATHCredentialWithCode *> * _Nullable credentials, NSError * _Nullable error) {
+            completion(session, credentials, error);
+        }];
+    };
+    if (scpKeyParams) {
+        [self sessionWithConnectionController:connectionController scpKeyParams:scpKeyParams completion:selectCompletion];
+    } else {
+        [self sessionWithConnectionController:connectionController completion:selectCompletion];
+    }
+}
+
+- (void)unlockWithAccessKeyProvider:(YKFOATHAccessKeyProvider)accessKeyProvider calculateAllWithCompletion:(YKFOATHSessionCalculateAllCompletionBlock)completion {
+    NSDate *timestamp = [NSDate date];
+    // No challenge in the select response means the application is not password protected.
+    if (!self.cachedSelectApplicationResponse.challenge) {
+        [self calculateAllWithTimestamp:timestamp completion:completion];
+        return;
+    }
+    NSData *accessKey = accessKeyProvider(self);
+    if (!accessKey) {
+        completion(nil, [YKFOATHError errorWithCode:YKFOATHErrorCodeAuthenticationRequired]);
+        return;
+    }
+    ykf_weak_self();
+    [self unlockWithAccessKey:accessKey completion:^(NSError * _Nullable error) {
+        ykf_safe_strong_self();
+        if (error) {
+            completion(nil, error);
+            return;
+        }
+        [strongSelf calculateAllWithTimestamp:timestamp completion:completion];
+    }];
+}
+
 - (NSString *)deviceId {
     NSData *hash = [_cachedSelectApplicationResponse.selectID ykf_SHA256];
     NSString *deviceId = [hash base64EncodedStringWithOptions: 0];
@@ -156,6 +220,78 @@ typedef void (^YKFOATHServiceResultCompletionBlock)(NSData* _Nullable  result, N
     }];
 }
 
+- (void)importCredentialsFromURLs:(NSArray<NSURL *> *)urls requiresTouch:(BOOL)requiresTouch completion:(YKFOATHSessionImportCompletionBlock)completion {
+    YKFParameterAssertReturn(urls);
+    YKFParameterAssertReturn(completion);
+    
+    // 1. Parse and validate the URLs in parallel. Each iteration only touches its own result.
+    NSMutableArray<YKFOATHCredentialImportResult *> *results = [[NSMutableArray alloc] initWithCapacity:urls.count];
+    for (NSURL *url in urls) {
+        [results addObject:[[YKFOATHCredentialImportResult alloc] initWithURL:url]];
+    }
+    dispatch_apply(results.count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        YKFOATHCredentialImportResult *result = results[index];
+        NSError *error = nil;
+        result.credentialTemplate = [[YKFOATHCredentialTemplate alloc] initWithURL:result.url error:&error];
+        result.error = result.credentialTemplate ? nil : error;
+    });
+    
+    // 2. Check once that the new credentials fit next to the ones already on the key.
+    NSUInteger capacity = [self.version compare:[[YKFVersion alloc] initWithBytes:5 minor:7 micro:0]] == NSOrderedAscending ? YKFOATHCredentialCapacity : YKFOATHExtendedCredentialCapacity;
+    ykf_weak_self();
+    [self listCredentialsWithCompletion:^(NSArray<YKFOATHCredential *> * _Nullable credentials, NSError * _Nullable error) {
+        ykf_safe_strong_self();
+        if (error) {
+            completion(nil, error);
+            return;
+        }
+        NSMutableSet<NSString *> *names = [[NSMutableSet alloc] initWithCapacity:credentials.count + results.count];
+        for (YKFOATHCredential *credential in credentials) {
+            [names addObject:credential.key];
+        }
+        for (YKFOATHCredentialImportResult *result in results) {
+            YKFOATHCredentialTemplate *credentialTemplate = result.credentialTemplate;
+            if (credentialTemplate) {
+                [names addObject:[YKFOATHCredentialUtils keyFromAccountName:credentialTemplate.accountName issuer:credentialTemplate.issuer period:credentialTemplate.period type:credentialTemplate.type]];
+            }
+        }
+        if (names.count > capacity) {
+            completion(nil, [YKFOATHError errorWithCode:YKFOATHErrorCodeNoSpace]);
+            return;
+        }
+        
+        // 3. Queue all the puts without waiting for each response and complete once, after the last one.
+        dispatch_group_t group = dispatch_group_create();
+        for (YKFOATHCredentialImportResult *result in results) {
+            YKFOATHCredentialTemplate *credentialTemplate = result.credentialTemplate;
+            if (!credentialTemplate) {
+                continue;
+            }
+            dispatch_group_enter(group);
+            YKFOATHPutAPDU *apdu = [[YKFOATHPutAPDU alloc] initWithCredentialTemplate:credentialTemplate requriesTouch:requiresTouch];
+            [strongSelf executeOATHCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+                if (error.code == YKFAPDUErrorCodeNoSpace) {
+                    result.error = [YKFOATHError errorWithCode:YKFOATHErrorCodeNoSpace];
+                } else if (error) {
+                    result.error = error;
+                } else {
+                    YKFOATHCredential *credential = [[YKFOATHCredential alloc] init];
+                    credential.type = credentialTemplate.type;
+                    credential.period = credentialTemplate.period;
+                    credential.issuer = credentialTemplate.issuer;
+                    credential.accountName = credentialTemplate.accountName;
+                    credential.requiresTouch = requiresTouch;
+                    result.credential = credential;
+                }
+                dispatch_group_leave(group);
+            }];
+        }
+        dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+            completion([results copy], nil);
+        });
+    }];
+}
+
 - (void)deleteCredential:(YKFOATHCredential *)credential completion:(YKFOATHSessionGenericCompletionBlock)completion {
     YKFParameterAssertReturn(credential);
     YKFParameterAssertReturn(completion);
@@ -212,7 +348,13 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
     
     YKFAPDU *apdu = [[YKFOATHCalculateAPDU alloc] initWithCredential:credential timestamp:timestamp];
     
+    // The key blocks the calculation until it's touched.
+    NSDate *touchStartDate = credential.requiresTouch ? [NSDate date] : nil;
+    YKFConnectionMetrics *metrics = self.smartCardInterface.metrics;
     [self executeOATHCommand:apdu completion:^(NSData * _Nullable result, NSError * _Nullable error) {
+        if (touchStartDate) {
+            [metrics recordTouchWaitWithDuration:-[touchStartDate timeIntervalSinceNow]];
+        }
         if (error) {
             completion(nil, error);
             return;
@@ -258,7 +400,7 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
 
 - (void)listCredentialsWithCompletion:(YKFOATHSessionListCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0xA1 p1:0x00 p2:0x00 data:[NSData data] type:YKFAPDUTypeShort];
+    YKFAPDU *apdu = YKFAPDU.oathListAPDU;
     
     [self executeOATHCommand:apdu completion:^(NSData * _Nullable result, NSError * _Nullable error) {
         if (error) {
@@ -284,11 +426,13 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
         return;
     }
     
+    // The reset changes the salt, the access keys derived for this key can't be used anymore.
+    [YKFOATHAccessKeyCache.sharedCache invalidateDeviceId:self.deviceId];
     self.cachedSelectApplicationResponse = nil;
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0x00 ins:0x04 p1:0xDE p2:0xAD data:[NSData data] type:YKFAPDUTypeShort];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (!error) {
-            YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameOATH];
+            YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameOATH];
             [self.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
                 if (error) {
                     completion(error);
@@ -317,7 +461,11 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
 }
 
 - (NSData *)deriveAccessKey:(NSString *)password {
-    return [[password dataUsingEncoding:NSUTF8StringEncoding] ykf_deriveOATHKeyWithSalt:self.cachedSelectApplicationResponse.selectID];
+    NSData *salt = self.cachedSelectApplicationResponse.selectID;
+    if (!salt.length) {
+        return nil;
+    }
+    return [YKFOATHAccessKeyCache.sharedCache accessKeyForPassword:password salt:salt];
 }
 
 - (void)setAccessKey:(NSData *)accessKey completion:(YKFOATHSessionGenericCompletionBlock)completion {
@@ -368,8 +516,14 @@ static const UInt8 YKFOATHRenameAPDUNameTag = 0x71;
         completion([YKFSessionError errorWithCode:YKFSessionErrorInvalidSessionStateStatusCode]);
         return;
     }
+    NSData *salt = self.cachedSelectApplicationResponse.selectID;
     NSData *accessKey = [self deriveAccessKey:password];
-    [self unlockWithAccessKey:accessKey completion:completion];
+    [self unlockWithAccessKey:accessKey completion:^(NSError * _Nullable error) {
+        if (error.code == YKFOATHErrorCodeWrongPassword && [error isKindOfClass:[YKFOATHError class]]) {
+            [YKFOATHAccessKeyCache.sharedCache removeAccessKeyForPassword:password salt:salt];
+        }
+        completion(error);
+    }];
 }
 
 - (void)unlockWithAccessKey:(NSData *)accessKey completion:(YKFOATHSessionGenericCompletionBlock)completion {
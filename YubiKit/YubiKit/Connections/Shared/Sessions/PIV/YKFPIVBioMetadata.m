@@ -35,4 +35,16 @@
     return self;
 }
 
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[YKFPIVBioMetadata class]]) {
+        return NO;
+    }
+    YKFPIVBioMetadata *other = (YKFPIVBioMetadata *)object;
+    return self.isConfigured == other.isConfigured && self.attemptsRemaining == other.attemptsRemaining && self.temporaryPin == other.temporaryPin;
+}
+
+- (NSUInteger)hash {
+    return (self.isConfigured << 16) | (self.temporaryPin << 8) | (self.attemptsRemaining & 0xff);
+}
+
 @end
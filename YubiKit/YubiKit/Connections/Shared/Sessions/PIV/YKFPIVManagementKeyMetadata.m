@@ -14,6 +14,7 @@
 
 #import <Foundation/Foundation.h>
 #import "YKFPIVManagementKeyMetadata.h"
+#import "YKFPIVManagementKeyType.h"
 
 
 @interface YKFPIVManagementKeyMetadata()
@@ -36,4 +37,16 @@
     return self;
 };
 
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[YKFPIVManagementKeyMetadata class]]) {
+        return NO;
+    }
+    YKFPIVManagementKeyMetadata *other = (YKFPIVManagementKeyMetadata *)object;
+    return self.keyType.value == other.keyType.value && self.touchPolicy == other.touchPolicy && self.isDefault == other.isDefault;
+}
+
+- (NSUInteger)hash {
+    return (self.keyType.value << 16) | (self.touchPolicy << 8) | self.isDefault;
+}
+
 @end
@@ -0,0 +1,36 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFPIVMetadataSnapshot_Private_h
+#define YKFPIVMetadataSnapshot_Private_h
+
+#import "YKFPIVMetadataSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface YKFPIVMetadataSnapshot()
+
+- (instancetype)initWithVersion:(YKFVersion *)version
+                   serialNumber:(nullable NSNumber *)serialNumber
+                    pinMetadata:(nullable YKFPIVPinPukMetadata *)pinMetadata
+                    pukMetadata:(nullable YKFPIVPinPukMetadata *)pukMetadata
+          managementKeyMetadata:(nullable YKFPIVManagementKeyMetadata *)managementKeyMetadata
+                    bioMetadata:(nullable YKFPIVBioMetadata *)bioMetadata
+                   slotMetadata:(NSDictionary<NSNumber *, YKFPIVSlotMetadata *> *)slotMetadata NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFPIVMetadataSnapshot_Private_h */
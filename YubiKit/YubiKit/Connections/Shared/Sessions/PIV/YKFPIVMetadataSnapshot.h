@@ -0,0 +1,82 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+@class YKFVersion, YKFPIVPinPukMetadata, YKFPIVManagementKeyMetadata, YKFPIVSlotMetadata, YKFPIVBioMetadata;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFPIVMetadataSnapshot
+
+ @abstract
+    The metadata of a whole PIV application, read by [YKFPIVSession getMetadataSnapshotWithCompletion:].
+
+ @discussion
+    The snapshot is immutable and can be kept after the session is closed. Two snapshots of the same YubiKey are
+    equal when none of the metadata has changed, and slotsChangedFromSnapshot: returns the slots which differ.
+    The values which the firmware of the YubiKey can't report, e.g. all the metadata on firmware older than 5.3,
+    are nil.
+ */
+@interface YKFPIVMetadataSnapshot : NSObject
+
+/// The firmware version of the YubiKey.
+@property (nonatomic, readonly) YKFVersion *version;
+
+/// The serial number of the YubiKey, or nil if the serial number is not supported or not visible.
+@property (nonatomic, readonly, nullable) NSNumber *serialNumber;
+
+/// The PIN metadata.
+@property (nonatomic, readonly, nullable) YKFPIVPinPukMetadata *pinMetadata;
+
+/// The PUK metadata.
+@property (nonatomic, readonly, nullable) YKFPIVPinPukMetadata *pukMetadata;
+
+/// The card management key metadata.
+@property (nonatomic, readonly, nullable) YKFPIVManagementKeyMetadata *managementKeyMetadata;
+
+/// The bio metadata, only available on the YubiKey Bio multi-protocol.
+@property (nonatomic, readonly, nullable) YKFPIVBioMetadata *bioMetadata;
+
+/*!
+ @abstract
+    The metadata of the slots holding a private key, keyed by slot. This includes the retired key management
+    slots 0x82 to 0x95. Empty slots are not in the dictionary.
+ */
+@property (nonatomic, readonly) NSDictionary<NSNumber *, YKFPIVSlotMetadata *> *slotMetadata;
+
+/*!
+ @abstract
+    The metadata of the key in a slot, or nil if the slot is empty or the metadata is not supported.
+ */
+- (nullable YKFPIVSlotMetadata *)metadataForSlot:(NSUInteger)slot;
+
+/*!
+ @abstract
+    Returns the slots where a key was added, removed or replaced, or where the policies changed, sorted by slot.
+ */
+- (NSArray<NSNumber *> *)slotsChangedFromSnapshot:(YKFPIVMetadataSnapshot *)snapshot;
+
+/*!
+ @abstract
+    Returns true if all the metadata of the two snapshots is equal.
+ */
+- (BOOL)isEqualToSnapshot:(YKFPIVMetadataSnapshot *)snapshot;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,98 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFPIVMetadataSnapshot.h"
+#import "YKFPIVMetadataSnapshot+Private.h"
+#import "YKFVersion.h"
+#import "YKFPIVPinPukMetadata.h"
+#import "YKFPIVManagementKeyMetadata.h"
+#import "YKFPIVSlotMetadata.h"
+#import "YKFPIVBioMetadata.h"
+
+static BOOL YKFPIVMetadataEqual(id _Nullable first, id _Nullable second) {
+    return first == second || [first isEqual:second];
+}
+
+@interface YKFPIVMetadataSnapshot()
+
+@property (nonatomic, readwrite) YKFVersion *version;
+@property (nonatomic, readwrite, nullable) NSNumber *serialNumber;
+@property (nonatomic, readwrite, nullable) YKFPIVPinPukMetadata *pinMetadata;
+@property (nonatomic, readwrite, nullable) YKFPIVPinPukMetadata *pukMetadata;
+@property (nonatomic, readwrite, nullable) YKFPIVManagementKeyMetadata *managementKeyMetadata;
+@property (nonatomic, readwrite, nullable) YKFPIVBioMetadata *bioMetadata;
+@property (nonatomic, readwrite) NSDictionary<NSNumber *, YKFPIVSlotMetadata *> *slotMetadata;
+
+@end
+
+@implementation YKFPIVMetadataSnapshot
+
+- (instancetype)initWithVersion:(YKFVersion *)version
+                   serialNumber:(NSNumber *)serialNumber
+                    pinMetadata:(YKFPIVPinPukMetadata *)pinMetadata
+                    pukMetadata:(YKFPIVPinPukMetadata *)pukMetadata
+          managementKeyMetadata:(YKFPIVManagementKeyMetadata *)managementKeyMetadata
+                    bioMetadata:(YKFPIVBioMetadata *)bioMetadata
+                   slotMetadata:(NSDictionary<NSNumber *, YKFPIVSlotMetadata *> *)slotMetadata {
+    self = [super init];
+    if (self) {
+        self.version = version;
+        self.serialNumber = serialNumber;
+        self.pinMetadata = pinMetadata;
+        self.pukMetadata = pukMetadata;
+        self.managementKeyMetadata = managementKeyMetadata;
+        self.bioMetadata = bioMetadata;
+        self.slotMetadata = [slotMetadata copy];
+    }
+    return self;
+}
+
+- (YKFPIVSlotMetadata *)metadataForSlot:(NSUInteger)slot {
+    return self.slotMetadata[@(slot)];
+}
+
+- (NSArray<NSNumber *> *)slotsChangedFromSnapshot:(YKFPIVMetadataSnapshot *)snapshot {
+    NSMutableSet<NSNumber *> *slots = [NSMutableSet setWithArray:self.slotMetadata.allKeys];
+    [slots addObjectsFromArray:snapshot.slotMetadata.allKeys];
+    NSMutableArray<NSNumber *> *changedSlots = [NSMutableArray new];
+    for (NSNumber *slot in slots) {
+        if (!YKFPIVMetadataEqual(self.slotMetadata[slot], snapshot.slotMetadata[slot])) {
+            [changedSlots addObject:slot];
+        }
+    }
+    return [changedSlots sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (BOOL)isEqualToSnapshot:(YKFPIVMetadataSnapshot *)snapshot {
+    return [self.version compare:snapshot.version] == NSOrderedSame
+        && YKFPIVMetadataEqual(self.serialNumber, snapshot.serialNumber)
+        && YKFPIVMetadataEqual(self.pinMetadata, snapshot.pinMetadata)
+        && YKFPIVMetadataEqual(self.pukMetadata, snapshot.pukMetadata)
+        && YKFPIVMetadataEqual(self.managementKeyMetadata, snapshot.managementKeyMetadata)
+        && YKFPIVMetadataEqual(self.bioMetadata, snapshot.bioMetadata)
+        && [self.slotMetadata isEqualToDictionary:snapshot.slotMetadata];
+}
+
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[YKFPIVMetadataSnapshot class]]) {
+        return NO;
+    }
+    return [self isEqualToSnapshot:(YKFPIVMetadataSnapshot *)object];
+}
+
+- (NSUInteger)hash {
+    return self.serialNumber.hash ^ self.pinMetadata.hash ^ (self.pukMetadata.hash << 1) ^ self.managementKeyMetadata.hash ^ self.slotMetadata.count;
+}
+
+@end
@@ -0,0 +1,42 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Security/Security.h>
+#import "YKFPIVObjectCache.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface YKFPIVObjectCache()
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*
+ Returns the certificate cached for the object, or nil.
+ */
+- (nullable SecCertificateRef)copyCertificateForSerialNumber:(UInt32)serialNumber objectId:(NSData *)objectId CF_RETURNS_RETAINED;
+
+/*
+ Stores the object data and its parsed certificate. If the cached object has the same content its certificate is kept
+ and returned, otherwise the given certificate is returned.
+ */
+- (SecCertificateRef)storeObject:(NSData *)object certificate:(SecCertificateRef)certificate serialNumber:(UInt32)serialNumber objectId:(NSData *)objectId CF_RETURNS_RETAINED;
+
+/*
+ Removes an object. If the serial number is nil the object is removed for all the keys.
+ */
+- (void)removeObjectId:(NSData *)objectId serialNumber:(nullable NSNumber *)serialNumber;
+
+@end
+
+NS_ASSUME_NONNULL_END
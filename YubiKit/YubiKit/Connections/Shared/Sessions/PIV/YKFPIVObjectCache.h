@@ -0,0 +1,66 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFPIVObjectCache
+
+ @abstract
+    A bounded in-memory cache of the data objects read from the PIV application, like the slot certificates.
+
+ @discussion
+    YKFPIVSession getCertificateInSlot:completion: looks up the certificate in this cache before sending GET DATA.
+    Entries are keyed by the serial number of the YubiKey and the object ID, so a session only reads the serial number
+    to confirm which key it talks to. Each entry keeps a SHA256 digest of the object data, an object which is read
+    again with the same content reuses the parsed certificate. The entries are removed when the session writes the
+    object, moves, generates, imports or deletes the key of the slot, or resets the PIV application. Changes made to
+    the key outside of YubiKit, e.g. with ykman, are not detected: call invalidateSerialNumber: after them.
+
+    Keys which don't report their serial number (firmware older than 5.0) are never cached.
+ */
+@interface YKFPIVObjectCache: NSObject
+
+/*!
+ @abstract
+    The cache used by the PIV sessions.
+ */
+@property (class, nonatomic, readonly) YKFPIVObjectCache *sharedCache;
+
+/*!
+ @abstract
+    The maximum number of objects kept by the cache. Defaults to 16. Setting 0 disables the cache.
+ */
+@property (nonatomic) NSUInteger capacity;
+
+/// The number of objects in the cache.
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ @abstract
+    Removes the objects read from a YubiKey.
+ */
+- (void)invalidateSerialNumber:(UInt32)serialNumber;
+
+/*!
+ @abstract
+    Removes all the objects.
+ */
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,181 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFPIVObjectCache.h"
+#import "YKFPIVObjectCache+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFAssert.h"
+
+static const NSUInteger YKFPIVObjectCacheDefaultCapacity = 16;
+
+@interface YKFPIVObjectCacheEntry: NSObject
+
+// SHA256 of the object data.
+@property (nonatomic) NSData *digest;
+@property (nonatomic) id certificate;
+
+@end
+
+@implementation YKFPIVObjectCacheEntry
+@end
+
+@interface YKFPIVObjectCache()
+
+// serial number/object ID -> entry
+@property (nonatomic) NSMutableDictionary<NSString *, YKFPIVObjectCacheEntry *> *entries;
+// Least recently used first.
+@property (nonatomic) NSMutableArray<NSString *> *entryIds;
+
+@end
+
+@implementation YKFPIVObjectCache
+
++ (YKFPIVObjectCache *)sharedCache {
+    static YKFPIVObjectCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [[YKFPIVObjectCache alloc] initWithCapacity:YKFPIVObjectCacheDefaultCapacity];
+    });
+    return sharedCache;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:YKFPIVObjectCacheDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _entries = [[NSMutableDictionary alloc] init];
+        _entryIds = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)capacity {
+    @synchronized (self) {
+        return _capacity;
+    }
+}
+
+- (void)setCapacity:(NSUInteger)capacity {
+    @synchronized (self) {
+        _capacity = capacity;
+        [self trimToCapacity];
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.entries.count;
+    }
+}
+
+#pragma mark - Public
+
+- (void)invalidateSerialNumber:(UInt32)serialNumber {
+    NSString *prefix = [NSString stringWithFormat:@"%u/", (unsigned int)serialNumber];
+    @synchronized (self) {
+        NSIndexSet *indexes = [self.entryIds indexesOfObjectsPassingTest:^BOOL(NSString *entryId, NSUInteger index, BOOL *stop) {
+            return [entryId hasPrefix:prefix];
+        }];
+        [self removeEntriesAtIndexes:indexes];
+    }
+}
+
+- (void)invalidate {
+    @synchronized (self) {
+        [self.entries removeAllObjects];
+        [self.entryIds removeAllObjects];
+    }
+}
+
+#pragma mark - Private
+
+- (SecCertificateRef)copyCertificateForSerialNumber:(UInt32)serialNumber objectId:(NSData *)objectId {
+    YKFParameterAssertReturnValue(objectId, nil);
+    NSString *entryId = [self.class entryIdForSerialNumber:serialNumber objectId:objectId];
+    @synchronized (self) {
+        YKFPIVObjectCacheEntry *entry = self.entries[entryId];
+        if (!entry.certificate) {
+            return nil;
+        }
+        [self.entryIds removeObject:entryId];
+        [self.entryIds addObject:entryId];
+        return (SecCertificateRef)CFRetain((__bridge CFTypeRef)entry.certificate);
+    }
+}
+
+- (SecCertificateRef)storeObject:(NSData *)object certificate:(SecCertificateRef)certificate serialNumber:(UInt32)serialNumber objectId:(NSData *)objectId {
+    YKFParameterAssertReturnValue(object, nil);
+    YKFParameterAssertReturnValue(certificate, nil);
+    YKFParameterAssertReturnValue(objectId, nil);
+    NSString *entryId = [self.class entryIdForSerialNumber:serialNumber objectId:objectId];
+    NSData *digest = [object ykf_SHA256];
+    @synchronized (self) {
+        YKFPIVObjectCacheEntry *entry = self.entries[entryId];
+        if (entry && [entry.digest isEqualToData:digest]) {
+            // Same content, hand out the certificate which is already parsed.
+            [self.entryIds removeObject:entryId];
+            [self.entryIds addObject:entryId];
+            return (SecCertificateRef)CFRetain((__bridge CFTypeRef)entry.certificate);
+        }
+        if (self.capacity > 0) {
+            entry = [[YKFPIVObjectCacheEntry alloc] init];
+            entry.digest = digest;
+            entry.certificate = (__bridge id)certificate;
+            self.entries[entryId] = entry;
+            [self.entryIds removeObject:entryId];
+            [self.entryIds addObject:entryId];
+            [self trimToCapacity];
+        }
+        return (SecCertificateRef)CFRetain(certificate);
+    }
+}
+
+- (void)removeObjectId:(NSData *)objectId serialNumber:(NSNumber *)serialNumber {
+    YKFParameterAssertReturn(objectId);
+    NSString *suffix = [@"/" stringByAppendingString:[objectId ykf_hexadecimalString]];
+    NSString *entryId = serialNumber ? [self.class entryIdForSerialNumber:serialNumber.unsignedIntValue objectId:objectId] : nil;
+    @synchronized (self) {
+        NSIndexSet *indexes = [self.entryIds indexesOfObjectsPassingTest:^BOOL(NSString *candidate, NSUInteger index, BOOL *stop) {
+            return entryId ? [candidate isEqualToString:entryId] : [candidate hasSuffix:suffix];
+        }];
+        [self removeEntriesAtIndexes:indexes];
+    }
+}
+
+#pragma mark - Helpers
+
++ (NSString *)entryIdForSerialNumber:(UInt32)serialNumber objectId:(NSData *)objectId {
+    return [NSString stringWithFormat:@"%u/%@", (unsigned int)serialNumber, [objectId ykf_hexadecimalString]];
+}
+
+// Must be called while synchronized.
+- (void)removeEntriesAtIndexes:(NSIndexSet *)indexes {
+    [self.entries removeObjectsForKeys:[self.entryIds objectsAtIndexes:indexes]];
+    [self.entryIds removeObjectsAtIndexes:indexes];
+}
+
+// Must be called while synchronized.
+- (void)trimToCapacity {
+    if (self.entryIds.count > _capacity) {
+        [self removeEntriesAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.entryIds.count - _capacity)]];
+    }
+}
+
+@end
@@ -15,6 +15,7 @@
 #import <Foundation/Foundation.h>
 #import "YKFPIVPadding+Private.h"
 #import <CommonCrypto/CommonDigest.h>
+#import "ykf_piv.h"
 
 @implementation YKFPIVPadding
 
@@ -76,24 +77,13 @@
             [(__bridge NSString *)algorithm isEqualToString:(__bridge NSString *)kSecKeyAlgorithmECDSASignatureDigestX962SHA512]) {
             hash = [data mutableCopy];
         }
-        if (hash.length == keySize) {
-            return hash;
-        }
-        if (hash.length > keySize) {
-            return [hash subdataWithRange:NSMakeRange(0, keySize)];
-        }
-        if (hash.length < keySize) {
-            NSMutableData *paddedHash = [NSMutableData data];
-            UInt8 padding = 0x00;
-            int paddingSize = keySize - (int)hash.length;
-            for (int i = 0; i < paddingSize; i++) {
-                [paddedHash appendBytes:&padding length:1];
-            }
-            [paddedHash appendData:hash];
-            return paddedHash;
+        if (!hash) {
+            *error = [[NSError alloc] initWithDomain:@"com.yubico.piv" code:1 userInfo:@{NSLocalizedDescriptionKey: @"EC padding algorithm not supported."}];
+            return nil;
         }
-        *error = [[NSError alloc] initWithDomain:@"com.yubico.piv" code:1 userInfo:@{NSLocalizedDescriptionKey: @"EC padding algorithm not supported."}];
-        return nil;
+        NSMutableData *paddedHash = [NSMutableData dataWithLength:keySize];
+        ykf_piv_pad_ec_hash(hash.bytes, hash.length, keySize, paddedHash.mutableBytes);
+        return paddedHash;
     } else {
         *error = [[NSError alloc] initWithDomain:@"com.yubico.piv" code:1 userInfo:@{NSLocalizedDescriptionKey: @"Unknown key type."}];
         return nil;
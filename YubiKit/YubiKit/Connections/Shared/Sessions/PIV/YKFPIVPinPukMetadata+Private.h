@@ -0,0 +1,26 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFPIVPinPukMetadata_Private_h
+#define YKFPIVPinPukMetadata_Private_h
+
+#import "YKFPIVPinPukMetadata.h"
+
+@interface YKFPIVPinPukMetadata()
+
+- (instancetype)initWithIsDefault:(bool)isDefault retriesTotal:(int)retriesTotal retriesRemaining:(int)retriesRemaining NS_DESIGNATED_INITIALIZER;
+
+@end
+
+#endif /* YKFPIVPinPukMetadata_Private_h */
@@ -0,0 +1,33 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// @abstract The metadata of the PIN or the PUK, as read by [YKFPIVSession getMetadataSnapshotWithCompletion:].
+@interface YKFPIVPinPukMetadata : NSObject
+
+/// True if the PIN or PUK has not been changed from the default value.
+@property (nonatomic, readonly) bool isDefault;
+/// The total number of retries configured.
+@property (nonatomic, readonly) int retriesTotal;
+/// The number of retries left.
+@property (nonatomic, readonly) int retriesRemaining;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
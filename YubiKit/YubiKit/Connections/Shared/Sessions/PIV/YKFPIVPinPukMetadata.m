@@ -0,0 +1,50 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFPIVPinPukMetadata.h"
+#import "YKFPIVPinPukMetadata+Private.h"
+
+@interface YKFPIVPinPukMetadata()
+
+@property (nonatomic, readwrite) bool isDefault;
+@property (nonatomic, readwrite) int retriesTotal;
+@property (nonatomic, readwrite) int retriesRemaining;
+
+@end
+
+@implementation YKFPIVPinPukMetadata
+
+- (instancetype)initWithIsDefault:(bool)isDefault retriesTotal:(int)retriesTotal retriesRemaining:(int)retriesRemaining {
+    self = [super init];
+    if (self) {
+        self.isDefault = isDefault;
+        self.retriesTotal = retriesTotal;
+        self.retriesRemaining = retriesRemaining;
+    }
+    return self;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[YKFPIVPinPukMetadata class]]) {
+        return NO;
+    }
+    YKFPIVPinPukMetadata *other = (YKFPIVPinPukMetadata *)object;
+    return self.isDefault == other.isDefault && self.retriesTotal == other.retriesTotal && self.retriesRemaining == other.retriesRemaining;
+}
+
+- (NSUInteger)hash {
+    return (self.isDefault << 16) | ((self.retriesTotal & 0xff) << 8) | (self.retriesRemaining & 0xff);
+}
+
+@end
@@ -62,7 +62,7 @@ typedef NS_ENUM(NSUInteger, YKFPIVErrorCode) {
     YKFPIVErrorCodeIllegalArgument = 9
 };
 
-@class YKFPIVSessionFeatures, YKFPIVManagementKeyType, YKFPIVManagementKeyMetadata, YKFPIVSlotMetadata, YKFPIVBioMetadata;
+@class YKFPIVSessionFeatures, YKFPIVManagementKeyType, YKFPIVManagementKeyMetadata, YKFPIVSlotMetadata, YKFPIVBioMetadata, YKFPIVMetadataSnapshot;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -78,6 +78,13 @@ typedef void (^YKFPIVSessionGenericCompletionBlock)
 typedef void (^YKFPIVSessionSignCompletionBlock)
     (NSData* _Nullable signature, NSError* _Nullable error);
 
+/// @abstract Response block for [signWithKeyInSlot:type:algorithm:messages:pin:completion:] which provides the
+///           signatures, in the order of the messages, or an error.
+///  @param signatures The signatures, one per message.
+///  @param error An error object that indicates why the request failed, or nil if the request was successful.
+typedef void (^YKFPIVSessionBatchSignCompletionBlock)
+    (NSArray<NSData*>* _Nullable signatures, NSError* _Nullable error);
+
 /// @abstract Response block for [decryptWithKeyInSlot:algorithm:encrypted:completion:] which provides the decrypted data or an error.
 /// @param decrypted The decrypted data.
 /// @param error An error object that indicates why the request failed, or nil if the request was successful.
@@ -159,6 +166,12 @@ typedef void (^YKFPIVSessionManagementKeyMetadataCompletionBlock)
 typedef void (^YKFPIVSessionBioMetadataCompletionBlock)
     (YKFPIVBioMetadata* _Nullable metaData, NSError* _Nullable error);
 
+/// @abstract Response block for [getMetadataSnapshotWithCompletion:] which provides the metadata snapshot or an error.
+/// @param snapshot The metadata of the PIN, PUK, management key, bio and key slots.
+/// @param error An error object that indicates why the request failed, or nil if the request was successful.
+typedef void (^YKFPIVSessionMetadataSnapshotCompletionBlock)
+    (YKFPIVMetadataSnapshot* _Nullable snapshot, NSError* _Nullable error);
+
 typedef void (^YKFPIVSessionBioVerifyUvCompletionBlock)
     (NSData* _Nullable data, NSError* _Nullable error);
 
@@ -187,6 +200,22 @@ typedef void (^YKFPIVSessionBioVerifyUvCompletionBlock)
 /// @note This method is thread safe and can be invoked from any thread (main or a background thread).
 - (void)signWithKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)keyType algorithm:(SecKeyAlgorithm)algorithm message:(nonnull NSData *)message completion:(nonnull YKFPIVSessionSignCompletionBlock)completion;
 
+/// @abstract Create signatures for a list of messages with the same key.
+/// @discussion The PIN is verified once, then the messages are padded on a background queue and each GENERAL
+///             AUTHENTICATE is queued as soon as its message is padded, without waiting for the previous signature.
+///             The padding of a message overlaps with the YubiKey signing the previous one. The first error stops the
+///             batch and the commands which are still queued are dropped.
+/// @param slot The slot containing the private key to use.
+/// @param keyType The type of the key stored in the slot.
+/// @param algorithm The signing algorithm to use.
+/// @param messages The messages to hash, or the digests for the digest algorithms.
+/// @param pin The PIN to verify before signing, or nil if it was already verified in this session.
+/// @param completion The completion handler that gets called once all the messages are signed or the batch failed.
+///                   This handler is executend on a background queue.
+/// @note This method is thread safe and can be invoked from any thread (main or a background thread).
+- (void)signWithKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)keyType algorithm:(SecKeyAlgorithm)algorithm messages:(nonnull NSArray<NSData *> *)messages pin:(nullable NSString *)pin completion:(nonnull YKFPIVSessionBatchSignCompletionBlock)completion
+        NS_SWIFT_NAME(signWithKeyInSlot(_:type:algorithm:messages:pin:completion:));
+
 /// @abstract Decrypt a RSA-encrypted message.
 /// @param slot The slot containing the private key to use.
 /// @param algorithm The algorithm used for encryption.
@@ -325,6 +354,8 @@ typedef void (^YKFPIVSessionBioVerifyUvCompletionBlock)
         NS_SWIFT_NAME(putCertificate(_:inSlot:compress:completion:));
 
 /// @abstract Reads the X.509 certificate stored in the specified slot on the YubiKey.
+/// @discussion Certificates are kept in YKFPIVObjectCache.sharedCache by the serial number of the YubiKey. A cached
+///             certificate is returned after reading the serial number, once per session, without reading the slot.
 /// @param slot The slot where the certificate is stored.
 /// @param completion The completion handler that gets called once the YubiKey has finished processing the request.
 ///                   This handler is executed on a background queue.
@@ -459,6 +490,16 @@ typedef void (^YKFPIVSessionBioVerifyUvCompletionBlock)
 ///                   This handler is executed on a background queue.
 - (void)getBioMetadataWithCompletion:(nonnull YKFPIVSessionBioMetadataCompletionBlock)completion;
 
+/// @abstract Reads the serial number and the metadata of the PIN, PUK, management key, bio and all the key slots
+///           into one immutable snapshot.
+/// @discussion All the commands are queued at once and sent back to back. Commands the firmware doesn't support,
+///             according to the session features, are not sent and the matching values of the snapshot are nil.
+///             Empty slots are left out of the snapshot.
+/// @param completion The completion handler that gets called once the YubiKey has finished processing the request.
+///                   This handler is executed on a background queue.
+/// @note This method is thread safe and can be invoked from any thread (main or a background thread).
+- (void)getMetadataSnapshotWithCompletion:(nonnull YKFPIVSessionMetadataSnapshotCompletionBlock)completion;
+
 /// @abstract Authenticate with YubiKey Bio multi-protocol capabilities.
 ///
 /// @discussion Before calling this method, clients must verify that the authenticator is bio-capable and
@@ -19,6 +19,7 @@
 #import "YKFSession+Private.h"
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 #import "YKFVersion.h"
 #import "YKFFeature.h"
 #import "YKFPIVSessionFeatures.h"
@@ -35,9 +36,16 @@
 #import "YKFPIVSlotMetadata+Private.h"
 #import "YKFPIVBioMetadata+Private.h"
 #import "YKFPIVManagementKeyMetadata+Private.h"
+#import "YKFPIVPinPukMetadata+Private.h"
+#import "YKFPIVMetadataSnapshot+Private.h"
 #import "YKFPIVPadding+Private.h"
+#import "YKFPIVObjectCache+Private.h"
+#import "YKFCancellationToken.h"
+#import "YKFAssert.h"
 #import "TKTLVRecordAdditions+Private.h"
 #import "YKFTLVRecord.h"
+#import "YKFSecureArena.h"
+#import "ykf_tlv.h"
 #import "NSData+GZIP.h"
 #import "YKFSCPProcessor.h"
 #import "YKFSCPKeyParamsProtocol.h"
@@ -92,6 +100,9 @@ static const NSUInteger YKFPIVTagMetadataTemporaryPIN = 0x08;
 
 static const NSUInteger YKFPIVSlotOCCAuth = 0x96;
 
+static const NSUInteger YKFPIVSlotRetiredFirst = 0x82;
+static const NSUInteger YKFPIVSlotRetiredLast = 0x95;
+
 // P2
 static const NSUInteger YKFPIVP2Pin = 0x80;
 static const NSUInteger YKFPIVP2Puk = 0x81;
@@ -99,11 +110,34 @@ static const NSUInteger YKFPIVP2Puk = 0x81;
 typedef void (^YKFPIVSessionDataCompletionBlock)
     (NSData* _Nullable data, NSError* _Nullable error);
 
+// Writes the header of a TLV with a one byte tag to bytes and returns its size. Pass NULL to only get the size.
+static NSUInteger YKFPIVWriteTLVHeader(UInt8 *bytes, UInt8 tag, NSUInteger length) {
+    NSUInteger lengthOfLength = 0;
+    for (NSUInteger remaining = length; remaining > 0; remaining >>= 8) {
+        lengthOfLength++;
+    }
+    NSUInteger headerLength = length < 0x80 ? 2 : 2 + lengthOfLength;
+    if (bytes) {
+        bytes[0] = tag;
+        if (length < 0x80) {
+            bytes[1] = length;
+        } else {
+            bytes[1] = 0x80 | lengthOfLength;
+            for (NSUInteger i = 0; i < lengthOfLength; i++) {
+                bytes[2 + i] = (length >> (8 * (lengthOfLength - 1 - i))) & 0xff;
+            }
+        }
+    }
+    return headerLength;
+}
+
 @interface YKFPIVSession()
 
 @property (nonatomic, readonly) BOOL isValid;
 @property (nonatomic, readwrite) YKFVersion * _Nonnull version;
 @property (nonatomic, readwrite) YKFPIVSessionFeatures * _Nonnull features;
+// The serial number read by the session, used to look up the object cache.
+@property (nonatomic, nullable) NSNumber *serialNumber;
 
 @end
 
@@ -127,6 +161,36 @@ typedef void (^YKFPIVSessionDataCompletionBlock)
     }
 }
 
+- (void)invalidateCachedObjectId:(NSData *)objectId {
+    // Without the serial number the object is removed for all the keys.
+    [YKFPIVObjectCache.sharedCache removeObjectId:objectId serialNumber:self.serialNumber];
+}
+
+- (void)invalidateCachedCertificateInSlot:(YKFPIVSlot)slot {
+    switch (slot) {
+        case YKFPIVSlotAuthentication:
+        case YKFPIVSlotSignature:
+        case YKFPIVSlotKeyManagement:
+        case YKFPIVSlotCardAuth:
+        case YKFPIVSlotAttestation:
+            [self invalidateCachedObjectId:[self objectIdForSlot:slot]];
+            break;
+        default:
+            // Retired slots don't have a cached certificate.
+            break;
+    }
+}
+
+- (void)serialNumberForObjectCacheWithCompletion:(void (^)(NSNumber * _Nullable serialNumber))completion {
+    if (self.serialNumber || ![self.features.serial isSupportedBySession:self] || YKFPIVObjectCache.sharedCache.capacity == 0) {
+        completion(self.serialNumber);
+        return;
+    }
+    [self getSerialNumberWithCompletion:^(int serialNumber, NSError * _Nullable error) {
+        completion(error ? nil : @((UInt32)serialNumber));
+    }];
+}
+
 
 int currentPinAttempts = 3;
 int maxPinAttempts = 3;
@@ -137,7 +201,7 @@ int maxPinAttempts = 3;
     session.features = [YKFPIVSessionFeatures new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNamePIV];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNamePIV];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -166,7 +230,7 @@ int maxPinAttempts = 3;
     YKFPIVSession *session = [YKFPIVSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNamePIV];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNamePIV];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -201,7 +265,7 @@ int maxPinAttempts = 3;
 }
 
 - (void)clearSessionState {
-    // Do nothing for now
+    self.serialNumber = nil;
 }
 
 - (void)signWithKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)keyType algorithm:(SecKeyAlgorithm)algorithm message:(nonnull NSData *)message completion:(nonnull YKFPIVSessionSignCompletionBlock)completion {
@@ -216,6 +280,73 @@ int maxPinAttempts = 3;
     }];
 }
 
+- (void)signWithKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)keyType algorithm:(SecKeyAlgorithm)algorithm messages:(nonnull NSArray<NSData *> *)messages pin:(nullable NSString *)pin completion:(nonnull YKFPIVSessionBatchSignCompletionBlock)completion {
+    YKFParameterAssertReturn(messages);
+    YKFParameterAssertReturn(completion);
+    if (messages.count == 0) {
+        completion(@[], nil);
+        return;
+    }
+    
+    NSMutableArray *signatures = [[NSMutableArray alloc] initWithCapacity:messages.count];
+    for (NSUInteger i = 0; i < messages.count; i++) {
+        [signatures addObject:[NSNull null]];
+    }
+    // Drops the queued commands after the first error.
+    YKFCancellationToken *cancellationToken = [[YKFCancellationToken alloc] init];
+    __block NSUInteger remaining = messages.count;
+    __block BOOL finished = NO;
+    NSObject *lock = [[NSObject alloc] init];
+    void (^finish)(NSUInteger, NSData *, NSError *) = ^(NSUInteger index, NSData *signature, NSError *error) {
+        NSArray<NSData *> *result = nil;
+        @synchronized (lock) {
+            if (finished) {
+                return;
+            }
+            if (!error) {
+                signatures[index] = signature;
+                if (--remaining > 0) {
+                    return;
+                }
+                result = [signatures copy];
+            }
+            finished = YES;
+        }
+        if (error) {
+            [cancellationToken cancel];
+        }
+        completion(result, error);
+    };
+    
+    if (pin) {
+        [self verifyPin:pin completion:^(int retries, NSError * _Nullable error) {
+            if (error) {
+                finish(0, nil, error);
+            }
+        }];
+    }
+    
+    // Messages are padded in order on a serial queue, so the commands are queued in order while the key works on the
+    // previous ones.
+    dispatch_queue_t paddingQueue = dispatch_queue_create("com.yubico.piv.padding", DISPATCH_QUEUE_SERIAL);
+    [messages enumerateObjectsUsingBlock:^(NSData *message, NSUInteger index, BOOL *stop) {
+        dispatch_async(paddingQueue, ^{
+            if (cancellationToken.isCancelled) {
+                return;
+            }
+            NSError *padError = nil;
+            NSData *payload = [YKFPIVPadding padData:message keyType:keyType algorithm:algorithm error:&padError];
+            if (padError != nil) {
+                finish(index, nil, padError);
+                return;
+            }
+            [self usePrivateKeyInSlot:slot type:keyType message:payload exponentiation:false cancellationToken:cancellationToken completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+                finish(index, data, error);
+            }];
+        });
+    }];
+}
+
 - (void)decryptWithKeyInSlot:(YKFPIVSlot)slot algorithm:(SecKeyAlgorithm)algorithm encrypted:(NSData *)encrypted completion:(nonnull YKFPIVSessionDecryptCompletionBlock)completion {
     YKFPIVKeyType keyType;
     switch (encrypted.length) {
@@ -251,12 +382,16 @@ int maxPinAttempts = 3;
 }
 
 - (void)usePrivateKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)type message:(NSData *)message exponentiation:(BOOL)exponentiation completion:(YKFPIVSessionDataCompletionBlock)completion {
+    [self usePrivateKeyInSlot:slot type:type message:message exponentiation:exponentiation cancellationToken:nil completion:completion];
+}
+
+- (void)usePrivateKeyInSlot:(YKFPIVSlot)slot type:(YKFPIVKeyType)type message:(NSData *)message exponentiation:(BOOL)exponentiation cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFPIVSessionDataCompletionBlock)completion {
     NSMutableData *recordsData = [NSMutableData data];
     [recordsData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagAuthResponse value:[NSData data]].data];
     [recordsData appendData:[[YKFTLVRecord alloc] initWithTag:exponentiation ? YKFPIVTagExponentiation : YKFPIVTagChallenge value:message].data];
     NSData *data = [[YKFTLVRecord alloc] initWithTag:YKFPIVTagDynAuth value:recordsData].data;
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsAuthenticate p1:type p2:slot data:data type:YKFAPDUTypeExtended];
-    [self.smartCardInterface executeCommand:apdu timeout:120.0  completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+    [self.smartCardInterface executeCommand:apdu sendRemainingIns:YKFSmartCardInterfaceSendRemainingInsNormal timeout:YKFTimeoutPolicyAdaptiveTimeout cancellationToken:cancellationToken completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
             return;
@@ -357,7 +492,9 @@ int maxPinAttempts = 3;
         YKFTLVRecord *tlvsContainer = [[YKFTLVRecord alloc] initWithTag:0xac value:tlv.data];
         NSData *tlvsData = tlvsContainer.data;
         YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsGenerateAsymetric p1:0 p2:slot data:tlvsData type:YKFAPDUTypeExtended];
-        [self.smartCardInterface executeCommand:apdu timeout:120.0 completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [self invalidateCachedCertificateInSlot:slot];
+        [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+            [self invalidateCachedCertificateInSlot:slot];
             NSData *keyData = [[YKFTLVRecord sequenceOfRecordsFromData:data] ykfTLVRecordWithTag:(UInt64)0x7F49].value;
             NSError *keyError;
             SecKeyRef publicKey = [self secKeyFromYubiKeyData:keyData keyType:type error:&keyError];
@@ -481,7 +618,9 @@ int maxPinAttempts = 3;
         }
         
         YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsImportKey p1:keyType p2:slot data:mutableData type:YKFAPDUTypeExtended];
+        [self invalidateCachedCertificateInSlot:slot];
         [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+            [self invalidateCachedCertificateInSlot:slot];
             completion(keyType, error);
         }];
     }];
@@ -501,7 +640,11 @@ int maxPinAttempts = 3;
         return;
     }
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsMoveKey p1:destinationSlot p2:sourceSlot data:[NSData data] type:YKFAPDUTypeExtended];
+    [self invalidateCachedCertificateInSlot:sourceSlot];
+    [self invalidateCachedCertificateInSlot:destinationSlot];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [self invalidateCachedCertificateInSlot:sourceSlot];
+        [self invalidateCachedCertificateInSlot:destinationSlot];
         completion(error);
     }];
 }
@@ -512,7 +655,9 @@ int maxPinAttempts = 3;
         return;
     }
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsMoveKey p1:0xff p2:slot data:[NSData data] type:YKFAPDUTypeExtended];
+    [self invalidateCachedCertificateInSlot:slot];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [self invalidateCachedCertificateInSlot:slot];
         completion(error);
     }];
 }
@@ -523,33 +668,94 @@ int maxPinAttempts = 3;
 }
 
 - (void)putCertificate:(SecCertificateRef)certificate inSlot:(YKFPIVSlot)slot compress:(bool)compress completion:(YKFPIVSessionGenericCompletionBlock)completion {
-    NSMutableData *mutableData = [NSMutableData data];
-    NSData *certData = (__bridge NSData *)SecCertificateCopyData(certificate);
+    NSData *certData = (__bridge_transfer NSData *)SecCertificateCopyData(certificate);
+    NSData *objectId = [self objectIdForSlot:slot];
+    NSData *putData = [self putDataWithCertificate:certData objectId:objectId compress:compress];
+    if (!putData) {
+        completion([[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeIllegalArgument userInfo:@{NSLocalizedDescriptionKey: @"Failed to compress certificate."}]);
+        return;
+    }
+    [self putData:putData objectId:objectId completion:completion];
+}
+
+// Builds the PUT DATA command data for a certificate object in one buffer. The certificate is compressed straight
+// into the buffer after room for the largest possible headers, and the headers are written once its size is known.
+- (nullable NSData *)putDataWithCertificate:(NSData *)certData objectId:(NSData *)objectId compress:(bool)compress {
+    UInt8 trailer[] = {YKFPIVTagCertificateInfo, 0x01, compress ? 0x01 : 0x00, YKFPIVTagLRC, 0x00};
+    NSUInteger maxCertLength = compress ? [NSData gzippedLengthBoundForLength:certData.length] : certData.length;
+    NSUInteger maxObjectLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagCertificate, maxCertLength) + maxCertLength + sizeof(trailer);
+    NSUInteger maxHeaderLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectId, objectId.length) + objectId.length
+        + YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectData, maxObjectLength)
+        + YKFPIVWriteTLVHeader(NULL, YKFPIVTagCertificate, maxCertLength);
+    
+    NSMutableData *buffer = [NSMutableData dataWithCapacity:maxHeaderLength + maxCertLength + sizeof(trailer)];
+    buffer.length = maxHeaderLength;
     if (compress) {
-        certData = [certData gzippedData];
+        if (![certData appendGzippedDataToData:buffer compressionLevel:-1.0f]) {
+            return nil;
+        }
+    } else {
+        [buffer appendData:certData];
     }
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagCertificate value:certData].data];
-    UInt8 isCompressed = compress ? 1 : 0;
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagCertificateInfo value:[NSData dataWithBytes:&isCompressed length:1]].data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagLRC value:[NSData data]].data];
-    [self putObject:mutableData objectId:[self objectIdForSlot:slot] completion:^(NSError * _Nullable error) {
-        completion(error);
-    }];
+    NSUInteger certLength = buffer.length - maxHeaderLength;
+    [buffer appendBytes:trailer length:sizeof(trailer)];
+    
+    NSUInteger objectLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagCertificate, certLength) + certLength + sizeof(trailer);
+    NSUInteger headerLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectId, objectId.length) + objectId.length
+        + YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectData, objectLength)
+        + YKFPIVWriteTLVHeader(NULL, YKFPIVTagCertificate, certLength);
+    NSUInteger unused = maxHeaderLength - headerLength;
+    UInt8 *bytes = (UInt8 *)buffer.mutableBytes + unused;
+    bytes += YKFPIVWriteTLVHeader(bytes, YKFPIVTagObjectId, objectId.length);
+    memcpy(bytes, objectId.bytes, objectId.length);
+    bytes += objectId.length;
+    bytes += YKFPIVWriteTLVHeader(bytes, YKFPIVTagObjectData, objectLength);
+    YKFPIVWriteTLVHeader(bytes, YKFPIVTagCertificate, certLength);
+    if (unused > 0) {
+        memmove(buffer.mutableBytes, (UInt8 *)buffer.mutableBytes + unused, buffer.length - unused);
+        buffer.length -= unused;
+    }
+    return buffer;
 }
 
 - (void)putObject:(NSData *)object objectId:(NSData *)objectId completion:(YKFPIVSessionGenericCompletionBlock)completion  {
-    NSMutableData *mutableData = [NSMutableData data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectId value:objectId].data];
-    [mutableData appendData:[[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectData value:object].data];
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsPutData p1:0x3f p2:0xff data:mutableData type:YKFAPDUTypeExtended];
+    NSUInteger objectIdHeaderLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectId, objectId.length);
+    NSUInteger objectHeaderLength = YKFPIVWriteTLVHeader(NULL, YKFPIVTagObjectData, object.length);
+    NSMutableData *mutableData = [NSMutableData dataWithLength:objectIdHeaderLength + objectId.length + objectHeaderLength];
+    UInt8 *bytes = mutableData.mutableBytes;
+    bytes += YKFPIVWriteTLVHeader(bytes, YKFPIVTagObjectId, objectId.length);
+    memcpy(bytes, objectId.bytes, objectId.length);
+    YKFPIVWriteTLVHeader(bytes + objectId.length, YKFPIVTagObjectData, object.length);
+    [mutableData appendData:object];
+    [self putData:mutableData objectId:objectId completion:completion];
+}
+
+- (void)putData:(NSData *)data objectId:(NSData *)objectId completion:(YKFPIVSessionGenericCompletionBlock)completion  {
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsPutData p1:0x3f p2:0xff data:data type:YKFAPDUTypeExtended];
+    // Invalidated before the command so reads queued after it miss the cache, and after it in case a read queued
+    // before it stored the old object in the meantime.
+    [self invalidateCachedObjectId:objectId];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [self invalidateCachedObjectId:objectId];
         completion(error);
     }];
 }
 
 - (void)getCertificateInSlot:(YKFPIVSlot)slot completion:(nonnull YKFPIVSessionReadCertCompletionBlock)completion {
-    NSData *data = [self objectIdForSlot:slot];
-    YKFTLVRecord *tlv = [[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectId value:data];
+    NSData *objectId = [self objectIdForSlot:slot];
+    [self serialNumberForObjectCacheWithCompletion:^(NSNumber * _Nullable serialNumber) {
+        self.serialNumber = serialNumber;
+        SecCertificateRef cachedCertificate = serialNumber ? [YKFPIVObjectCache.sharedCache copyCertificateForSerialNumber:serialNumber.unsignedIntValue objectId:objectId] : nil;
+        if (cachedCertificate) {
+            completion(cachedCertificate, nil);
+            return;
+        }
+        [self readCertificateWithObjectId:objectId serialNumber:serialNumber completion:completion];
+    }];
+}
+
+- (void)readCertificateWithObjectId:(NSData *)objectId serialNumber:(nullable NSNumber *)serialNumber completion:(nonnull YKFPIVSessionReadCertCompletionBlock)completion {
+    YKFTLVRecord *tlv = [[YKFTLVRecord alloc] initWithTag:YKFPIVTagObjectId value:objectId];
     YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsGetData p1:0x3f p2:0xff data:tlv.data type:YKFAPDUTypeExtended];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error != nil) {
@@ -562,13 +768,19 @@ int maxPinAttempts = 3;
             NSData *certificateData = [subRecords ykfTLVRecordWithTag:YKFPIVTagCertificate].value;
             NSData *certificateInfo = [subRecords ykfTLVRecordWithTag:YKFPIVTagCertificateInfo].value;
 
-            if (certificateInfo && certificateInfo.length > 0 && ((UInt8 *)(certificateInfo.bytes))[0] == 1 && [certificateData isGzippedData]) {
+            if (certificateInfo && certificateInfo.length > 0 && ((UInt8 *)(certificateInfo.bytes))[0] == 1) {
+                // Inflated into a buffer sized from the gzip trailer, data which is not gzipped is used as is.
                 certificateData = [certificateData gunzippedData];
             }
             
             CFDataRef cfCertDataRef =  (__bridge CFDataRef)certificateData;
-            SecCertificateRef certificate = SecCertificateCreateWithData(nil, cfCertDataRef);
+            SecCertificateRef certificate = certificateData ? SecCertificateCreateWithData(nil, cfCertDataRef) : nil;
             if (certificate != nil) {
+                if (serialNumber) {
+                    SecCertificateRef storedCertificate = [YKFPIVObjectCache.sharedCache storeObject:objectData certificate:certificate serialNumber:serialNumber.unsignedIntValue objectId:objectId];
+                    CFRelease(certificate);
+                    certificate = storedCertificate;
+                }
                 completion(certificate, nil);
             } else {
                 completion(nil, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeDataParseError userInfo:@{NSLocalizedDescriptionKey: @"Failed to parse certificate."}]);
@@ -592,14 +804,22 @@ int maxPinAttempts = 3;
         completion([[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeUnsupportedOperation userInfo:@{NSLocalizedDescriptionKey: @"AES management key not supported by this YubiKey."}]);
         return;
     }
-    YKFTLVRecord *tlv = [[YKFTLVRecord alloc] initWithTag:YKFPIVSlotCardManagement value:managementKey];
-    
-    UInt8 typeValue = type.value;
-    NSMutableData *data = [NSMutableData dataWithBytes:&typeValue length:1];
-    [data appendData:tlv.data];
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsSetManagementKey p1:0xff p2:requiresTouch ? 0xfe : 0xff data:data type:YKFAPDUTypeShort];
+    // The key is written straight into a secure buffer: the algorithm, the TLV header and the key. The APDU keeps its
+    // own copy, which is wiped once the key has answered.
+    __block YKFAPDU *apdu = nil;
+    [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+        UInt8 header[YKF_TLV_MAX_HEADER_LENGTH];
+        size_t headerLength = ykf_tlv_encode_header(YKFPIVSlotCardManagement, managementKey.length, header);
+        NSMutableData *data = [scope mutableDataWithLength:1 + headerLength + managementKey.length];
+        UInt8 *bytes = data.mutableBytes;
+        bytes[0] = type.value;
+        memcpy(bytes + 1, header, headerLength);
+        memcpy(bytes + 1 + headerLength, managementKey.bytes, managementKey.length);
+        apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsSetManagementKey p1:0xff p2:requiresTouch ? 0xfe : 0xff data:data type:YKFAPDUTypeShort];
+    }];
 
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [apdu wipe];
         completion(error);
     }];
 }
@@ -682,12 +902,21 @@ int maxPinAttempts = 3;
             }
             YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsReset p1:0 p2:0 data:[NSData data] type:YKFAPDUTypeShort];
             [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+                [self invalidateObjectCache];
                 completion(error);
             }];
         }];
     }];
 }
 
+- (void)invalidateObjectCache {
+    if (self.serialNumber) {
+        [YKFPIVObjectCache.sharedCache invalidateSerialNumber:self.serialNumber.unsignedIntValue];
+    } else {
+        [YKFPIVObjectCache.sharedCache invalidate];
+    }
+}
+
 - (void)getSerialNumberWithCompletion:(YKFPIVSessionSerialNumberCompletionBlock)completion {
     if (![self.features.serial isSupportedBySession:self]) {
         completion(-1, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeUnsupportedOperation userInfo:@{NSLocalizedDescriptionKey: @"Read serial number not supported by this YubiKey."}]);
@@ -710,9 +939,13 @@ int maxPinAttempts = 3;
 }
 
 - (void)verifyPin:(nonnull NSString *)pin completion:(nonnull YKFPIVSessionVerifyPinCompletionBlock)completion {
-    NSData *data = [self paddedDataWithPin:pin];
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsVerify p1:0 p2:0x80 data:data type:YKFAPDUTypeShort];
+    __block YKFAPDU *apdu = nil;
+    [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSData *data = [self paddedDataWithPin:pin scope:scope];
+        apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsVerify p1:0 p2:0x80 data:data type:YKFAPDUTypeShort];
+    }];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [apdu wipe];
         if (error == nil) {
             currentPinAttempts = maxPinAttempts;
             completion(currentPinAttempts, nil);
@@ -767,14 +1000,19 @@ int maxPinAttempts = 3;
             completion(0, 0, 0, error);
             return;
         }
-        NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
-        UInt8 isDefault = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataIsDefault].value.bytes)[0];
-        UInt8 retriesTotal = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.bytes)[0];
-        UInt8 retriesRemaining = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.bytes)[1];
-        completion(isDefault, retriesTotal, retriesRemaining, nil);
+        YKFPIVPinPukMetadata *metadata = [self pinPukMetadataFromData:data];
+        completion(metadata.isDefault, metadata.retriesTotal, metadata.retriesRemaining, nil);
     }];
 }
 
+- (YKFPIVPinPukMetadata *)pinPukMetadataFromData:(NSData *)data {
+    NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
+    UInt8 isDefault = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataIsDefault].value.bytes)[0];
+    UInt8 retriesTotal = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.bytes)[0];
+    UInt8 retriesRemaining = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.bytes)[1];
+    return [[YKFPIVPinPukMetadata alloc] initWithIsDefault:isDefault retriesTotal:retriesTotal retriesRemaining:retriesRemaining];
+}
+
 - (void)getMetadataForSlot:(YKFPIVSlot)slot completion:(nonnull YKFPIVSessionSlotMetadataCompletionBlock)completion {
     if (![self.features.metadata isSupportedBySession:self]) {
         completion(nil, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeUnsupportedOperation userInfo:@{NSLocalizedDescriptionKey: @"Read metadata not supported by this YubiKey."}]);
@@ -786,30 +1024,36 @@ int maxPinAttempts = 3;
             completion(nil, error);
             return;
         }
-        NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
-        NSData *keyTypeData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataAlgorithm].value;
-        NSData *policyData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataPolicy].value;
-        NSData *originData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataOrigin].value;
-        NSData *publicKeyData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataPublicKey].value;
-        
-        if (keyTypeData && policyData && originData && publicKeyData) {
-            YKFPIVKeyType keyType = [keyTypeData ykf_integerValue];
-            YKFPIVPinPolicy pinPolicy = ((UInt8 *)policyData.bytes)[0];
-            YKFPIVTouchPolicy touchPolicy = ((UInt8 *)policyData.bytes)[1];
-            bool origin = [originData ykf_integerValue];
-            NSError *keyError;
-            SecKeyRef publicKey = [self secKeyFromYubiKeyData:publicKeyData keyType:keyType error:&error];
-            if (error) {
-                completion(nil, keyError);
-            }
-            YKFPIVSlotMetadata *metadata = [[YKFPIVSlotMetadata alloc] initWithKeyType:keyType publicKey:publicKey pinPolicy:pinPolicy touchPolicy:touchPolicy generated:origin];
-            completion(metadata, nil);
-        } else {
-            completion(nil, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeDataParseError userInfo:@{NSLocalizedDescriptionKey: @"Failed parsing data returned from YubiKey."}]);
-        }
+        NSError *parseError;
+        YKFPIVSlotMetadata *metadata = [self slotMetadataFromData:data error:&parseError];
+        completion(metadata, parseError);
     }];
 }
 
+- (YKFPIVSlotMetadata *)slotMetadataFromData:(NSData *)data error:(NSError **)error {
+    NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
+    NSData *keyTypeData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataAlgorithm].value;
+    NSData *policyData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataPolicy].value;
+    NSData *originData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataOrigin].value;
+    NSData *publicKeyData = [records ykfTLVRecordWithTag:YKFPIVTagMetadataPublicKey].value;
+    
+    if (!keyTypeData || !policyData || !originData || !publicKeyData) {
+        *error = [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeDataParseError userInfo:@{NSLocalizedDescriptionKey: @"Failed parsing data returned from YubiKey."}];
+        return nil;
+    }
+    YKFPIVKeyType keyType = [keyTypeData ykf_integerValue];
+    YKFPIVPinPolicy pinPolicy = ((UInt8 *)policyData.bytes)[0];
+    YKFPIVTouchPolicy touchPolicy = ((UInt8 *)policyData.bytes)[1];
+    bool origin = [originData ykf_integerValue];
+    NSError *keyError;
+    SecKeyRef publicKey = [self secKeyFromYubiKeyData:publicKeyData keyType:keyType error:&keyError];
+    if (keyError) {
+        *error = keyError;
+        return nil;
+    }
+    return [[YKFPIVSlotMetadata alloc] initWithKeyType:keyType publicKey:publicKey pinPolicy:pinPolicy touchPolicy:touchPolicy generated:origin];
+}
+
 - (void)getManagementKeyMetadataWithCompletion:(nonnull YKFPIVSessionManagementKeyMetadataCompletionBlock)completion {
     if (![self.features.metadata isSupportedBySession:self]) {
         completion(nil, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeUnsupportedOperation userInfo:@{NSLocalizedDescriptionKey: @"Read metadata not supported by this YubiKey."}]);
@@ -821,22 +1065,25 @@ int maxPinAttempts = 3;
             completion(nil, error);
             return;
         }
-        NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
-        YKFTLVRecord *algorithmRecord = [records ykfTLVRecordWithTag:YKFPIVTagMetadataAlgorithm];
-        YKFPIVManagementKeyType *keyType;
-        if (algorithmRecord) {
-            keyType = [YKFPIVManagementKeyType fromValue:((UInt8 *)algorithmRecord.value.bytes)[0]];
-        } else {
-            keyType = [YKFPIVManagementKeyType TripleDES];
-        }
-        bool isDefault = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataIsDefault].value.bytes)[0] != 0;
-        YKFPIVTouchPolicy touchPolicy = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataPolicy].value.bytes)[1];
-        
-        YKFPIVManagementKeyMetadata *metaData = [[YKFPIVManagementKeyMetadata alloc] initWithKeyType:keyType touchPolicy:touchPolicy isDefault:isDefault];
-        completion(metaData, nil);
+        completion([self managementKeyMetadataFromData:data], nil);
     }];
 }
 
+- (YKFPIVManagementKeyMetadata *)managementKeyMetadataFromData:(NSData *)data {
+    NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
+    YKFTLVRecord *algorithmRecord = [records ykfTLVRecordWithTag:YKFPIVTagMetadataAlgorithm];
+    YKFPIVManagementKeyType *keyType;
+    if (algorithmRecord) {
+        keyType = [YKFPIVManagementKeyType fromValue:((UInt8 *)algorithmRecord.value.bytes)[0]];
+    } else {
+        keyType = [YKFPIVManagementKeyType TripleDES];
+    }
+    bool isDefault = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataIsDefault].value.bytes)[0] != 0;
+    YKFPIVTouchPolicy touchPolicy = ((UInt8 *)[records ykfTLVRecordWithTag:YKFPIVTagMetadataPolicy].value.bytes)[1];
+    
+    return [[YKFPIVManagementKeyMetadata alloc] initWithKeyType:keyType touchPolicy:touchPolicy isDefault:isDefault];
+}
+
 
 - (void)getPinMetadataWithCompletion:(nonnull YKFPIVSessionPinPukMetadataCompletionBlock)completion {
     [self getPinPukMetadata:YKFPIVP2Pin completion:completion];
@@ -934,15 +1181,123 @@ int maxPinAttempts = 3;
             }
             return;
         }
-        NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
-        bool isConfigured = [records ykfTLVRecordWithTag:YKFPIVTagMetadataBioConfigured].value.ykf_integerValue;
-        bool temporaryPin = [records ykfTLVRecordWithTag:YKFPIVTagMetadataTemporaryPIN].value.ykf_integerValue;
-        int retries = (int)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.ykf_integerValue;
-        YKFPIVBioMetadata *metadata = [[YKFPIVBioMetadata alloc] initWithIsConfigured:isConfigured attemptsRemaining:retries temporaryPin:temporaryPin];
-        completion(metadata, nil);
+        completion([self bioMetadataFromData:data], nil);
     }];
 }
 
+- (YKFPIVBioMetadata *)bioMetadataFromData:(NSData *)data {
+    NSArray<YKFTLVRecord*> *records = [YKFTLVRecord sequenceOfRecordsFromData:data];
+    bool isConfigured = [records ykfTLVRecordWithTag:YKFPIVTagMetadataBioConfigured].value.ykf_integerValue;
+    bool temporaryPin = [records ykfTLVRecordWithTag:YKFPIVTagMetadataTemporaryPIN].value.ykf_integerValue;
+    int retries = (int)[records ykfTLVRecordWithTag:YKFPIVTagMetadataRetries].value.ykf_integerValue;
+    return [[YKFPIVBioMetadata alloc] initWithIsConfigured:isConfigured attemptsRemaining:retries temporaryPin:temporaryPin];
+}
+
+- (void)getMetadataSnapshotWithCompletion:(nonnull YKFPIVSessionMetadataSnapshotCompletionBlock)completion {
+    YKFParameterAssertReturn(completion);
+    
+    // All the commands are queued right away and run back to back on the communication queue.
+    dispatch_group_t group = dispatch_group_create();
+    NSObject *lock = [NSObject new];
+    __block NSNumber *serialNumber = nil;
+    __block YKFPIVPinPukMetadata *pinMetadata = nil;
+    __block YKFPIVPinPukMetadata *pukMetadata = nil;
+    __block YKFPIVManagementKeyMetadata *managementKeyMetadata = nil;
+    __block YKFPIVBioMetadata *bioMetadata = nil;
+    NSMutableDictionary<NSNumber *, YKFPIVSlotMetadata *> *slotMetadata = [NSMutableDictionary new];
+    __block NSError *snapshotError = nil;
+    
+    void (^fail)(NSError *) = ^(NSError *error) {
+        @synchronized (lock) {
+            if (!snapshotError) {
+                snapshotError = error;
+            }
+        }
+    };
+    
+    if ([self.features.serial isSupportedBySession:self]) {
+        dispatch_group_enter(group);
+        [self getSerialNumberWithCompletion:^(int serial, NSError * _Nullable error) {
+            if (error) {
+                // The serial number is not visible over this transport when the key is configured to hide it.
+                if (!(error.domain == YKFSessionErrorDomain && error.code == YKFAPDUErrorCodeInsNotSupported)) {
+                    fail(error);
+                }
+            } else {
+                @synchronized (lock) {
+                    serialNumber = @((UInt32)serial);
+                }
+            }
+            dispatch_group_leave(group);
+        }];
+    }
+    
+    if ([self.features.metadata isSupportedBySession:self]) {
+        void (^getMetadata)(UInt8, void (^)(NSData *)) = ^(UInt8 p2, void (^parse)(NSData *)) {
+            dispatch_group_enter(group);
+            YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:YKFPIVInsGetMetadata p1:0 p2:p2 data:[NSData data] type:YKFAPDUTypeShort];
+            [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+                if (error) {
+                    // Empty slots and the OCC slot of non bio keys return referenced data not found.
+                    if (!(error.domain == YKFSessionErrorDomain && (error.code == YKFAPDUErrorCodeReferencedDataNotFound || (p2 == YKFPIVSlotOCCAuth && error.code == YKFAPDUErrorCodeInsNotSupported)))) {
+                        fail(error);
+                    }
+                } else {
+                    @synchronized (lock) {
+                        parse(data);
+                    }
+                }
+                dispatch_group_leave(group);
+            }];
+        };
+        
+        getMetadata(YKFPIVP2Pin, ^(NSData *data) {
+            pinMetadata = [self pinPukMetadataFromData:data];
+        });
+        getMetadata(YKFPIVP2Puk, ^(NSData *data) {
+            pukMetadata = [self pinPukMetadataFromData:data];
+        });
+        getMetadata(YKFPIVSlotCardManagement, ^(NSData *data) {
+            managementKeyMetadata = [self managementKeyMetadataFromData:data];
+        });
+        NSMutableArray<NSNumber *> *slots = [@[@(YKFPIVSlotAuthentication), @(YKFPIVSlotSignature), @(YKFPIVSlotKeyManagement), @(YKFPIVSlotCardAuth)] mutableCopy];
+        for (NSUInteger slot = YKFPIVSlotRetiredFirst; slot <= YKFPIVSlotRetiredLast; slot++) {
+            [slots addObject:@(slot)];
+        }
+        [slots addObject:@(YKFPIVSlotAttestation)];
+        for (NSNumber *slot in slots) {
+            getMetadata(slot.unsignedCharValue, ^(NSData *data) {
+                NSError *parseError;
+                YKFPIVSlotMetadata *metadata = [self slotMetadataFromData:data error:&parseError];
+                if (metadata) {
+                    slotMetadata[slot] = metadata;
+                } else if (!snapshotError) {
+                    snapshotError = parseError;
+                }
+            });
+        }
+        getMetadata(YKFPIVSlotOCCAuth, ^(NSData *data) {
+            bioMetadata = [self bioMetadataFromData:data];
+        });
+    }
+    
+    YKFVersion *version = self.version;
+    dispatch_group_notify(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        if (snapshotError) {
+            completion(nil, snapshotError);
+            return;
+        }
+        YKFPIVMetadataSnapshot *snapshot = [[YKFPIVMetadataSnapshot alloc] initWithVersion:version
+                                                                              serialNumber:serialNumber
+                                                                               pinMetadata:pinMetadata
+                                                                               pukMetadata:pukMetadata
+                                                                     managementKeyMetadata:managementKeyMetadata
+                                                                               bioMetadata:bioMetadata
+                                                                              slotMetadata:slotMetadata];
+        completion(snapshot, nil);
+    });
+}
+
 - (void)verifyUvRequestTemporaryPin:(bool)requestTemporaryPin checkOnly:(bool)checkOnly completion:(nonnull YKFPIVSessionBioVerifyUvCompletionBlock)completion {
     if (requestTemporaryPin && checkOnly) {
         completion(nil, [[NSError alloc] initWithDomain:YKFPIVErrorDomain code:YKFPIVErrorCodeIllegalArgument userInfo:@{NSLocalizedDescriptionKey: @"It's not possible to request a temporary pin and do a check only."}]);
@@ -1006,10 +1361,17 @@ int maxPinAttempts = 3;
 }
 
 - (void)changeReference:(UInt8)ins p2:(UInt8)p2 valueOne:(NSString *)valueOne valueTwo:(NSString *)valueTwo completion:(nonnull YKFPIVSessionVerifyPinCompletionBlock)completion {
-    NSMutableData *data = [self paddedDataWithPin:valueOne].mutableCopy;
-    [data appendData:[self paddedDataWithPin:valueTwo]];
-    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:ins p1:0 p2:p2 data:data type:YKFAPDUTypeShort];
+    __block YKFAPDU *apdu = nil;
+    [YKFSecureArena.sharedArena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSData *first = [self paddedDataWithPin:valueOne scope:scope];
+        NSData *second = [self paddedDataWithPin:valueTwo scope:scope];
+        NSMutableData *data = [scope mutableDataWithLength:first.length + second.length];
+        [data replaceBytesInRange:NSMakeRange(0, first.length) withBytes:first.bytes];
+        [data replaceBytesInRange:NSMakeRange(first.length, second.length) withBytes:second.bytes];
+        apdu = [[YKFAPDU alloc] initWithCla:0 ins:ins p1:0 p2:p2 data:data type:YKFAPDUTypeShort];
+    }];
     [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        [apdu wipe];
         if (error != nil) {
             int retries = [self getRetriesFromStatusCode:(int)error.code];
             if (retries >= 0) {
@@ -1024,14 +1386,8 @@ int maxPinAttempts = 3;
     }];
 }
 
-- (nonnull NSData *)paddedDataWithPin:(nonnull NSString *)pin {
-    NSMutableData *mutableData = [[pin dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
-    UInt8 padding = 0xff;
-    int paddingSize = 8 - (int)mutableData.length;
-    for (int i = 0; i < paddingSize; i++) {
-        [mutableData appendBytes:&padding length:1];
-    }
-    return mutableData;
+- (nonnull NSData *)paddedDataWithPin:(nonnull NSString *)pin scope:(nonnull YKFSecureArenaScope *)scope {
+    return [scope UTF8DataWithString:pin paddedToLength:8 padding:0xff];
 }
 
 @end
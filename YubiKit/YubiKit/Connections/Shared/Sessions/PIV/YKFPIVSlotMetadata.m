@@ -39,4 +39,24 @@
     return self;
 };
 
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[YKFPIVSlotMetadata class]]) {
+        return NO;
+    }
+    YKFPIVSlotMetadata *other = (YKFPIVSlotMetadata *)object;
+    if (self.keyType != other.keyType || self.pinPolicy != other.pinPolicy || self.touchPolicy != other.touchPolicy || self.generated != other.generated) {
+        return NO;
+    }
+    if (self.publicKey == nil || other.publicKey == nil) {
+        return self.publicKey == other.publicKey;
+    }
+    NSData *publicKeyData = (__bridge_transfer NSData *)SecKeyCopyExternalRepresentation(self.publicKey, nil);
+    NSData *otherPublicKeyData = (__bridge_transfer NSData *)SecKeyCopyExternalRepresentation(other.publicKey, nil);
+    return publicKeyData != nil && [publicKeyData isEqualToData:otherPublicKeyData];
+}
+
+- (NSUInteger)hash {
+    return (self.keyType << 24) | (self.pinPolicy << 16) | (self.touchPolicy << 8) | self.generated;
+}
+
 @end
@@ -22,6 +22,8 @@
 
 #import "YKFSessionError+Private.h"
 #import "YKFU2FSession+Private.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
 #import "YKFU2FSignResponse.h"
 #import "YKFU2FRegisterResponse.h"
 
@@ -34,6 +36,7 @@
 
 #import "YKFSmartCardInterface.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 
 #import "YKFSCPProcessor.h"
 #import "YKFSCPKeyParamsProtocol.h"
@@ -58,7 +61,7 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
     YKFU2FSession *session = [YKFU2FSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameU2F];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameU2F];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -74,7 +77,7 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
     YKFU2FSession *session = [YKFU2FSession new];
     session.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
     
-    YKFSelectApplicationAPDU *apdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameU2F];
+    YKFSelectApplicationAPDU *apdu = [YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameU2F];
     [session.smartCardInterface selectApplication:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             completion(nil, error);
@@ -194,6 +197,17 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
 - (void)handleTouchRequired:(YKFAPDU *)apdu retryCount:(int)retryCount completion:(YKFU2FServiceResultCompletionBlock)completion {
     YKFParameterAssertReturn(completion);
     
+    if (retryCount == 0) {
+        // Record the time from the first touch required status until the key answers, once per request.
+        NSDate *touchStartDate = [NSDate date];
+        YKFConnectionMetrics *metrics = self.smartCardInterface.metrics;
+        YKFU2FServiceResultCompletionBlock originalCompletion = completion;
+        completion = ^(NSData *data, NSError *error) {
+            [metrics recordTouchWaitWithDuration:-[touchStartDate timeIntervalSinceNow]];
+            originalCompletion(data, error);
+        };
+    }
+    
     if (retryCount >= YKFU2FMaxRetries) {
         YKFSessionError *timeoutError = [YKFSessionError errorWithCode:YKFSessionErrorTouchTimeoutCode];
         completion(nil, timeoutError);
@@ -208,6 +222,7 @@ static const NSTimeInterval YKFU2FRetryTimeInterval = 0.5; // seconds
     ykf_weak_self();
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, YKFU2FRetryTimeInterval * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
         ykf_safe_strong_self();
+        YKFEventRingRecord(YKFEventTypeTouchPoll, apdu.ins, retryCount, 0);
         [strongSelf executeU2FCommand:apdu retryCount:retryCount completion:completion];
     });
 }
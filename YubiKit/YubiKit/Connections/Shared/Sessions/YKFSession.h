@@ -14,6 +14,7 @@
 
 #import <Foundation/Foundation.h>
 #import "YKFRequest.h"
+#import "YKFCommandPriority.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -25,6 +26,14 @@ typedef void (^YKFSessionCommandBlock)(void);
 /// @param block The block that gets called.
 - (void)dispatchAfterCurrentCommands:(YKFSessionCommandBlock)block NS_SWIFT_NAME(dispatchAfterCurrentCommands(block:));
 
+/// @abstract Run a code block with the commands it sends to the key at a priority.
+/// @discussion The commands sent by the operations started in the block, including the follow-up commands of the
+///             operations, run ahead of the queued commands with a lower priority. Use YKFCommandPriorityBackground
+///             for work like syncing certificates so it doesn't delay the operations the user is waiting for.
+/// @param priority The priority of the commands.
+/// @param block The block that gets called immediately.
+- (void)performWithCommandPriority:(YKFCommandPriority)priority block:(YKFSessionCommandBlock)block NS_SWIFT_NAME(perform(withCommandPriority:block:));
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -27,4 +27,13 @@
     [self.smartCardInterface dispatchAfterCurrentCommands:block];
 }
 
+- (void)performWithCommandPriority:(YKFCommandPriority)priority block:(YKFSessionCommandBlock)block {
+    YKFParameterAssertReturn(block);
+    if (!self.smartCardInterface) {
+        block();
+        return;
+    }
+    [self.smartCardInterface performWithCommandPriority:priority block:block];
+}
+
 @end
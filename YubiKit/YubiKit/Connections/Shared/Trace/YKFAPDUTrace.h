@@ -0,0 +1,82 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFAPDUTraceEntry
+
+ @abstract
+    One command sent to the key together with the response or the error returned by the connection controller.
+ */
+@interface YKFAPDUTraceEntry: NSObject
+
+/// The raw command APDU.
+@property (nonatomic, readonly) NSData *command;
+
+/// The raw response APDU, including the status code. Nil if the command failed.
+@property (nonatomic, readonly, nullable) NSData *response;
+
+/// The error returned by the connection controller. Only the domain and the code are recorded.
+@property (nonatomic, readonly, nullable) NSError *error;
+
+/// The time from the start of the recording to the start of the command.
+@property (nonatomic, readonly) NSTimeInterval offset;
+
+/// The execution time reported by the connection controller.
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+- (instancetype)initWithCommand:(NSData *)command response:(nullable NSData *)response error:(nullable NSError *)error offset:(NSTimeInterval)offset duration:(NSTimeInterval)duration NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*!
+ @class YKFAPDUTrace
+
+ @abstract
+    An ordered list of APDU exchanges recorded by YKFTraceRecordingConnectionController.
+
+ @discussion
+    The trace has a compact binary representation which can be stored next to the tests and loaded by
+    YKFTraceReplayConnectionController. The format is the "YKTR" magic followed by a version byte and the entries.
+    Each entry is encoded as LEB128 varints: offset and duration in microseconds, a kind (0 response, 1 error), the
+    command length and bytes, then either the response length and bytes or the error code and the UTF-8 domain.
+ */
+@interface YKFAPDUTrace: NSObject
+
+@property (nonatomic, readonly) NSArray<YKFAPDUTraceEntry *> *entries;
+
+- (instancetype)initWithEntries:(NSArray<YKFAPDUTraceEntry *> *)entries NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract
+    Parses a trace from its binary representation. Returns nil if the data is not a valid trace.
+ */
+- (nullable instancetype)initWithData:(NSData *)data;
+
+/*!
+ @abstract
+    The binary representation of the trace.
+ */
+- (NSData *)dataRepresentation;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,185 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFAPDUTrace.h"
+#import "YKFAssert.h"
+
+static const UInt8 YKFAPDUTraceMagic[] = {'Y', 'K', 'T', 'R'};
+static const UInt8 YKFAPDUTraceVersion = 1;
+
+typedef NS_ENUM(UInt8, YKFAPDUTraceEntryKind) {
+    YKFAPDUTraceEntryKindResponse = 0,
+    YKFAPDUTraceEntryKindError = 1
+};
+
+#pragma mark - YKFAPDUTraceEntry
+
+@implementation YKFAPDUTraceEntry
+
+- (instancetype)initWithCommand:(NSData *)command response:(NSData *)response error:(NSError *)error offset:(NSTimeInterval)offset duration:(NSTimeInterval)duration {
+    YKFAssertAbortInit(command);
+    YKFAssertAbortInit(response || error);
+
+    self = [super init];
+    if (self) {
+        _command = [command copy];
+        _response = [response copy];
+        // Only the domain and the code survive serialization, so keep the entry identical before and after.
+        _error = response ? nil : [NSError errorWithDomain:error.domain code:error.code userInfo:nil];
+        _offset = MAX(offset, 0);
+        _duration = MAX(duration, 0);
+    }
+    return self;
+}
+
+@end
+
+#pragma mark - Varint helpers
+
+static void YKFAPDUTraceAppendVarint(NSMutableData *data, UInt64 value) {
+    UInt8 buffer[10];
+    NSUInteger length = 0;
+    do {
+        UInt8 byte = value & 0x7F;
+        value >>= 7;
+        buffer[length++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    [data appendBytes:buffer length:length];
+}
+
+static BOOL YKFAPDUTraceReadVarint(const UInt8 *bytes, NSUInteger length, NSUInteger *position, UInt64 *value) {
+    UInt64 result = 0;
+    for (NSUInteger shift = 0; shift < 64; shift += 7) {
+        if (*position >= length) {
+            return NO;
+        }
+        UInt8 byte = bytes[(*position)++];
+        result |= (UInt64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+static NSData *YKFAPDUTraceReadBytes(const UInt8 *bytes, NSUInteger length, NSUInteger *position) {
+    UInt64 size = 0;
+    if (!YKFAPDUTraceReadVarint(bytes, length, position, &size) || size > length - *position) {
+        return nil;
+    }
+    NSData *data = [NSData dataWithBytes:bytes + *position length:(NSUInteger)size];
+    *position += (NSUInteger)size;
+    return data;
+}
+
+static UInt64 YKFAPDUTraceMicroseconds(NSTimeInterval interval) {
+    return (UInt64)llround(interval * 1000000);
+}
+
+#pragma mark - YKFAPDUTrace
+
+@implementation YKFAPDUTrace
+
+- (instancetype)initWithEntries:(NSArray<YKFAPDUTraceEntry *> *)entries {
+    YKFAssertAbortInit(entries);
+    self = [super init];
+    if (self) {
+        _entries = [entries copy];
+    }
+    return self;
+}
+
+- (instancetype)initWithData:(NSData *)data {
+    YKFAssertAbortInit(data);
+
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger position = sizeof(YKFAPDUTraceMagic) + 1;
+    if (length < position || memcmp(bytes, YKFAPDUTraceMagic, sizeof(YKFAPDUTraceMagic)) != 0 || bytes[position - 1] != YKFAPDUTraceVersion) {
+        return nil;
+    }
+
+    NSMutableArray<YKFAPDUTraceEntry *> *entries = [[NSMutableArray alloc] init];
+    while (position < length) {
+        UInt64 offset = 0, duration = 0, kind = 0;
+        if (!YKFAPDUTraceReadVarint(bytes, length, &position, &offset) ||
+            !YKFAPDUTraceReadVarint(bytes, length, &position, &duration) ||
+            !YKFAPDUTraceReadVarint(bytes, length, &position, &kind)) {
+            return nil;
+        }
+        NSData *command = YKFAPDUTraceReadBytes(bytes, length, &position);
+        if (!command) {
+            return nil;
+        }
+
+        NSData *response = nil;
+        NSError *error = nil;
+        if (kind == YKFAPDUTraceEntryKindResponse) {
+            response = YKFAPDUTraceReadBytes(bytes, length, &position);
+            if (!response) {
+                return nil;
+            }
+        } else if (kind == YKFAPDUTraceEntryKindError) {
+            UInt64 zigzagCode = 0;
+            if (!YKFAPDUTraceReadVarint(bytes, length, &position, &zigzagCode)) {
+                return nil;
+            }
+            NSData *domain = YKFAPDUTraceReadBytes(bytes, length, &position);
+            NSString *domainString = domain ? [[NSString alloc] initWithData:domain encoding:NSUTF8StringEncoding] : nil;
+            if (!domainString) {
+                return nil;
+            }
+            NSInteger code = (NSInteger)((zigzagCode >> 1) ^ -(zigzagCode & 1));
+            error = [NSError errorWithDomain:domainString code:code userInfo:nil];
+        } else {
+            return nil;
+        }
+
+        [entries addObject:[[YKFAPDUTraceEntry alloc] initWithCommand:command
+                                                             response:response
+                                                                error:error
+                                                               offset:offset / 1000000.0
+                                                             duration:duration / 1000000.0]];
+    }
+    return [self initWithEntries:entries];
+}
+
+- (NSData *)dataRepresentation {
+    NSMutableData *data = [[NSMutableData alloc] initWithBytes:YKFAPDUTraceMagic length:sizeof(YKFAPDUTraceMagic)];
+    [data appendBytes:&YKFAPDUTraceVersion length:1];
+
+    for (YKFAPDUTraceEntry *entry in self.entries) {
+        YKFAPDUTraceAppendVarint(data, YKFAPDUTraceMicroseconds(entry.offset));
+        YKFAPDUTraceAppendVarint(data, YKFAPDUTraceMicroseconds(entry.duration));
+        YKFAPDUTraceAppendVarint(data, entry.response ? YKFAPDUTraceEntryKindResponse : YKFAPDUTraceEntryKindError);
+        YKFAPDUTraceAppendVarint(data, entry.command.length);
+        [data appendData:entry.command];
+
+        if (entry.response) {
+            YKFAPDUTraceAppendVarint(data, entry.response.length);
+            [data appendData:entry.response];
+        } else {
+            // Zigzag encoding keeps negative error codes (e.g. CryptoTokenKit errors) short.
+            SInt64 code = entry.error.code;
+            YKFAPDUTraceAppendVarint(data, ((UInt64)code << 1) ^ (UInt64)(code >> 63));
+            NSData *domain = [entry.error.domain dataUsingEncoding:NSUTF8StringEncoding];
+            YKFAPDUTraceAppendVarint(data, domain.length);
+            [data appendData:domain];
+        }
+    }
+    return [data copy];
+}
+
+@end
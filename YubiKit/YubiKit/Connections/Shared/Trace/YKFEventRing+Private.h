@@ -0,0 +1,36 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFEventRing.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Records an event in the ring. Lock free and safe to call from any thread.
+ */
+void YKFEventRingRecord(YKFEventType type, UInt8 ins, UInt32 length, UInt16 sw);
+
+/*
+ Records the response to a command, taking the length and the status word from the raw response.
+ */
+void YKFEventRingRecordResponse(UInt8 ins, NSData *_Nullable response);
+
+/*
+ The INS byte of a raw command APDU.
+ */
+static inline UInt8 YKFEventRingIns(NSData *_Nullable apduData) {
+    return apduData.length > 1 ? ((const UInt8 *)apduData.bytes)[1] : 0;
+}
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,113 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @enum YKFEventType
+
+ @abstract
+    The kinds of events recorded by the library on the command path.
+ */
+typedef NS_ENUM(UInt8, YKFEventType) {
+    /// An APDU was sent to the key. Length is the APDU length.
+    YKFEventTypeAPDUSent = 1,
+    /// A response was received from the key. Length is the response length including the status word.
+    YKFEventTypeAPDUReceived = 2,
+    /// The command failed in the connection controller (e.g. timeout or connection lost).
+    YKFEventTypeAPDUFailed = 3,
+    /// The key sent a waiting time extension while processing the command.
+    YKFEventTypeWaitingTimeExtension = 4,
+    /// A GET RESPONSE (or OATH SEND REMAINING) was sent to read a chained response. SW is the 61XX status.
+    YKFEventTypeGetResponse = 5,
+    /// A command was wrapped for a secure channel. Length is the wrapped data length.
+    YKFEventTypeSCPWrap = 6,
+    /// A secure channel response was verified and decrypted. Length is the decrypted data length.
+    YKFEventTypeSCPUnwrap = 7,
+    /// A session polled the key while waiting for touch. Length is the number of the poll.
+    YKFEventTypeTouchPoll = 8,
+    /// A session selected an application. Length is the AID length.
+    YKFEventTypeSelectApplication = 9
+};
+
+/*!
+ @class YKFEvent
+
+ @abstract
+    One event read from the event ring.
+ */
+@interface YKFEvent: NSObject
+
+/// The sequence number of the event, increasing since the application started.
+@property (nonatomic, readonly) UInt64 sequenceNumber;
+
+/// The time of the event, in seconds since the device booted (not counting sleep).
+@property (nonatomic, readonly) NSTimeInterval timestamp;
+
+@property (nonatomic, readonly) YKFEventType type;
+
+/// The INS byte of the command the event belongs to.
+@property (nonatomic, readonly) UInt8 ins;
+
+/// The length of the data, see YKFEventType.
+@property (nonatomic, readonly) UInt32 length;
+
+/// The status word of the response, or 0 when the event has none.
+@property (nonatomic, readonly) UInt16 sw;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/*!
+ @class YKFEventRing
+
+ @abstract
+    A fixed size, in memory ring of the last command events, always recorded for field diagnostics.
+
+ @discussion
+    The connection controllers, the smart card interface and the sessions record a small binary event for each APDU,
+    waiting time extension, chained response, secure channel operation, touch poll and application selection. Recording
+    writes a few atomic words and never formats strings or takes a lock, so it stays on in release builds. The newest
+    events overwrite the oldest ones. Call dump, e.g. when a command fails, to read the events which are still in the
+    ring. No APDU payload is recorded.
+ */
+@interface YKFEventRing: NSObject
+
+/// The number of events kept in the ring.
+@property (class, nonatomic, readonly) NSUInteger capacity;
+
+/*!
+ @abstract
+    Returns the events in the ring, oldest first. Events overwritten while they are read are skipped.
+ */
++ (NSArray<YKFEvent *> *)dump;
+
+/*!
+ @abstract
+    Returns the events in the ring as text, one event per line, with the times relative to the first event.
+ */
++ (NSString *)dumpDescription;
+
+/*!
+ @abstract
+    Removes all the events from the ring.
+ */
++ (void)clear;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,157 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <stdatomic.h>
+#import <mach/mach_time.h>
+#import "YKFEventRing.h"
+#import "YKFEventRing+Private.h"
+
+// Must be a power of two.
+#define YKFEventRingCapacity 1024
+
+/*
+ Each slot is a small seqlock: the writer marks the slot odd while it stores the words and even (derived from the
+ event sequence number) when done, so the reader can detect events which were overwritten while it was copying them.
+ */
+typedef struct {
+    _Atomic(uint64_t) sequence;
+    _Atomic(uint64_t) timestamp;
+    _Atomic(uint64_t) packedEvent; // type | ins | sw | length
+} YKFEventRingSlot;
+
+static YKFEventRingSlot YKFEventRingSlots[YKFEventRingCapacity];
+static _Atomic(uint64_t) YKFEventRingHead = 0;
+static _Atomic(uint64_t) YKFEventRingTail = 0;
+
+void YKFEventRingRecord(YKFEventType type, UInt8 ins, UInt32 length, UInt16 sw) {
+    uint64_t sequenceNumber = atomic_fetch_add_explicit(&YKFEventRingHead, 1, memory_order_relaxed);
+    YKFEventRingSlot *slot = &YKFEventRingSlots[sequenceNumber & (YKFEventRingCapacity - 1)];
+    uint64_t packedEvent = (uint64_t)type << 56 | (uint64_t)ins << 48 | (uint64_t)sw << 32 | length;
+
+    atomic_store_explicit(&slot->sequence, sequenceNumber * 2 + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->timestamp, mach_absolute_time(), memory_order_relaxed);
+    atomic_store_explicit(&slot->packedEvent, packedEvent, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, sequenceNumber * 2 + 2, memory_order_release);
+}
+
+void YKFEventRingRecordResponse(UInt8 ins, NSData *response) {
+    NSUInteger length = response.length;
+    UInt16 sw = 0;
+    if (length >= 2) {
+        const UInt8 *bytes = response.bytes;
+        sw = (UInt16)(bytes[length - 2] << 8 | bytes[length - 1]);
+    }
+    YKFEventRingRecord(YKFEventTypeAPDUReceived, ins, (UInt32)MIN(length, UINT32_MAX), sw);
+}
+
+static NSString *YKFEventTypeName(YKFEventType type) {
+    switch (type) {
+        case YKFEventTypeAPDUSent: return @"APDU sent";
+        case YKFEventTypeAPDUReceived: return @"APDU received";
+        case YKFEventTypeAPDUFailed: return @"APDU failed";
+        case YKFEventTypeWaitingTimeExtension: return @"WTX";
+        case YKFEventTypeGetResponse: return @"GET RESPONSE";
+        case YKFEventTypeSCPWrap: return @"SCP wrap";
+        case YKFEventTypeSCPUnwrap: return @"SCP unwrap";
+        case YKFEventTypeTouchPoll: return @"Touch poll";
+        case YKFEventTypeSelectApplication: return @"Select";
+    }
+    return [NSString stringWithFormat:@"Event %d", type];
+}
+
+#pragma mark - YKFEvent
+
+@interface YKFEvent()
+
+- (instancetype)initWithSequenceNumber:(UInt64)sequenceNumber timestamp:(NSTimeInterval)timestamp packedEvent:(UInt64)packedEvent;
+
+@end
+
+@implementation YKFEvent
+
+- (instancetype)initWithSequenceNumber:(UInt64)sequenceNumber timestamp:(NSTimeInterval)timestamp packedEvent:(UInt64)packedEvent {
+    self = [super init];
+    if (self) {
+        _sequenceNumber = sequenceNumber;
+        _timestamp = timestamp;
+        _type = (YKFEventType)(packedEvent >> 56);
+        _ins = (UInt8)(packedEvent >> 48);
+        _sw = (UInt16)(packedEvent >> 32);
+        _length = (UInt32)packedEvent;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%@ ins=%02X length=%u sw=%04X", YKFEventTypeName(self.type), self.ins, (unsigned)self.length, self.sw];
+}
+
+@end
+
+#pragma mark - YKFEventRing
+
+@implementation YKFEventRing
+
++ (NSUInteger)capacity {
+    return YKFEventRingCapacity;
+}
+
++ (NSArray<YKFEvent *> *)dump {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+
+    uint64_t head = atomic_load_explicit(&YKFEventRingHead, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&YKFEventRingTail, memory_order_relaxed);
+    if (head > YKFEventRingCapacity) {
+        tail = MAX(tail, head - YKFEventRingCapacity);
+    }
+
+    NSMutableArray<YKFEvent *> *events = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)(head > tail ? head - tail : 0)];
+    for (uint64_t sequenceNumber = tail; sequenceNumber < head; sequenceNumber++) {
+        YKFEventRingSlot *slot = &YKFEventRingSlots[sequenceNumber & (YKFEventRingCapacity - 1)];
+        uint64_t expectedSequence = sequenceNumber * 2 + 2;
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != expectedSequence) {
+            continue; // Still being written or already overwritten.
+        }
+        uint64_t timestamp = atomic_load_explicit(&slot->timestamp, memory_order_relaxed);
+        uint64_t packedEvent = atomic_load_explicit(&slot->packedEvent, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != expectedSequence) {
+            continue;
+        }
+        NSTimeInterval seconds = (double)timestamp * timebase.numer / timebase.denom / NSEC_PER_SEC;
+        [events addObject:[[YKFEvent alloc] initWithSequenceNumber:sequenceNumber timestamp:seconds packedEvent:packedEvent]];
+    }
+    return events;
+}
+
++ (NSString *)dumpDescription {
+    NSArray<YKFEvent *> *events = [self dump];
+    NSTimeInterval start = events.firstObject.timestamp;
+    NSMutableString *description = [[NSMutableString alloc] init];
+    for (YKFEvent *event in events) {
+        [description appendFormat:@"#%llu +%.6f %@\n", event.sequenceNumber, event.timestamp - start, event];
+    }
+    return description;
+}
+
++ (void)clear {
+    atomic_store_explicit(&YKFEventRingTail, atomic_load_explicit(&YKFEventRingHead, memory_order_relaxed), memory_order_relaxed);
+}
+
+@end
@@ -0,0 +1,79 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFConnectionControllerProtocol.h"
+#import "YKFAPDUTrace.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Returns the entry which is added to the trace in place of the recorded one.
+typedef YKFAPDUTraceEntry * _Nonnull (^YKFAPDUTraceRedactionBlock)(YKFAPDUTraceEntry *entry);
+
+/*!
+ @class YKFTraceRecordingConnectionController
+
+ @abstract
+    Connection controller decorator which forwards all commands to another controller and records every command and
+    response APDU with its timing.
+
+ @discussion
+    Sessions created with the recording controller behave exactly as with the wrapped controller. Cancelled commands
+    are not recorded since their completion is never called.
+
+    Traces are meant to be shared, so secrets are redacted by default, see defaultRedactionBlock. Redacted commands
+    keep their length and header, which means a replay only matches them when the same bytes are zeroed again.
+ */
+@interface YKFTraceRecordingConnectionController: NSObject<YKFConnectionControllerProtocol>
+
+@property (nonatomic, readonly) id<YKFConnectionControllerProtocol> connectionController;
+
+/*!
+ @abstract
+    A snapshot of the commands completed so far.
+ */
+@property (nonatomic, readonly) YKFAPDUTrace *trace;
+
+/*!
+ @abstract
+    Called for every completed command before it is added to the trace. Defaults to defaultRedactionBlock.
+    Set to nil to record all commands and responses in clear.
+ */
+@property (nonatomic, copy, nullable) YKFAPDUTraceRedactionBlock redactionBlock;
+
+/*!
+ @abstract
+    Zeroes the data of PIV VERIFY, CHANGE REFERENCE DATA, RESET RETRY COUNTER, IMPORT ASYMMETRIC KEY and SET
+    MANAGEMENT KEY, of PUT KEY, of OATH PUT, SET CODE and VALIDATE and of FIDO2 ClientPIN commands, and the response
+    data of OATH VALIDATE and FIDO2 ClientPIN. Every chunk of a chained command is zeroed. The CTAP command byte
+    and the status codes are kept.
+
+ @discussion
+    Each call returns a new block which tracks the command chains of one recording.
+ */
+@property (class, nonatomic, readonly) YKFAPDUTraceRedactionBlock defaultRedactionBlock;
+
+- (instancetype)initWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract
+    Removes the recorded entries and restarts the recording clock.
+ */
+- (void)resetTrace;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
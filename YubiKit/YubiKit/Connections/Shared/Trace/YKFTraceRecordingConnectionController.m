@@ -0,0 +1,223 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <objc/runtime.h>
+#import "YKFTraceRecordingConnectionController.h"
+#import "YKFAPDU+Private.h"
+#import "YKFAssert.h"
+
+static const UInt8 YKFTraceClassChaining = 0x10;
+
+static const UInt8 YKFTraceInstructionVerify = 0x20;
+static const UInt8 YKFTraceInstructionChangeReference = 0x24;
+static const UInt8 YKFTraceInstructionResetRetryCounter = 0x2C;
+static const UInt8 YKFTraceInstructionImportKey = 0xFE;
+static const UInt8 YKFTraceInstructionSetManagementKey = 0xFF;
+static const UInt8 YKFTraceInstructionPutKey = 0xD8;
+static const UInt8 YKFTraceInstructionOATHPut = 0x01;
+static const UInt8 YKFTraceInstructionOATHSetCode = 0x03;
+static const UInt8 YKFTraceInstructionOATHValidate = 0xA3;
+static const UInt8 YKFTraceInstructionFIDO2 = 0x10;
+static const UInt8 YKFTraceCTAPCommandClientPIN = 0x06;
+
+@interface YKFTraceRecordingConnectionController()
+
+@property (nonatomic, readwrite) id<YKFConnectionControllerProtocol> connectionController;
+@property (nonatomic) NSMutableArray<YKFAPDUTraceEntry *> *entries;
+@property (nonatomic) NSDate *startDate;
+
+@end
+
+@implementation YKFTraceRecordingConnectionController
+
+- (instancetype)initWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController {
+    YKFAssertAbortInit(connectionController);
+    self = [super init];
+    if (self) {
+        self.connectionController = connectionController;
+        self.entries = [[NSMutableArray alloc] init];
+        self.startDate = [NSDate date];
+        self.redactionBlock = YKFTraceRecordingConnectionController.defaultRedactionBlock;
+    }
+    return self;
+}
+
++ (YKFAPDUTraceRedactionBlock)defaultRedactionBlock {
+    // Set while a redacted command is chained, so the following chunks are redacted as well.
+    __block BOOL redactsChain = NO;
+    return ^YKFAPDUTraceEntry *(YKFAPDUTraceEntry *entry) {
+        BOOL continuesChain = redactsChain;
+        redactsChain = NO;
+        NSData *command = entry.command;
+        if (command.length < 5) {
+            return entry;
+        }
+        const UInt8 *bytes = command.bytes;
+        // Extended length commands have a zero byte followed by a two byte Lc.
+        BOOL extended = bytes[4] == 0 && command.length >= 7;
+        NSUInteger dataOffset = extended ? 7 : 5;
+        NSUInteger dataLength = extended ? (bytes[5] << 8) | bytes[6] : bytes[4];
+        dataLength = MIN(dataLength, command.length > dataOffset ? command.length - dataOffset : 0);
+
+        BOOL redactsResponse = NO;
+        switch (bytes[1]) {
+            case YKFTraceInstructionVerify:
+            case YKFTraceInstructionChangeReference:
+            case YKFTraceInstructionResetRetryCounter:
+            case YKFTraceInstructionImportKey:
+            case YKFTraceInstructionSetManagementKey:
+            case YKFTraceInstructionPutKey:
+            case YKFTraceInstructionOATHPut:
+            case YKFTraceInstructionOATHSetCode:
+                break;
+            case YKFTraceInstructionOATHValidate:
+                redactsResponse = YES;
+                break;
+            case YKFTraceInstructionFIDO2:
+                // Only the first chunk of a chained command starts with the CTAP command byte.
+                if (!continuesChain) {
+                    if (dataLength == 0 || bytes[dataOffset] != YKFTraceCTAPCommandClientPIN) {
+                        return entry;
+                    }
+                    dataOffset += 1;
+                    dataLength -= 1;
+                }
+                redactsResponse = YES;
+                break;
+            default:
+                if (!continuesChain) {
+                    return entry;
+                }
+                break;
+        }
+        redactsChain = (bytes[0] & YKFTraceClassChaining) != 0;
+
+        NSMutableData *redactedCommand = [command mutableCopy];
+        [redactedCommand resetBytesInRange:NSMakeRange(dataOffset, dataLength)];
+        NSData *redactedResponse = entry.response;
+        if (redactsResponse && redactedResponse.length > 2) {
+            NSMutableData *response = [redactedResponse mutableCopy];
+            [response resetBytesInRange:NSMakeRange(0, response.length - 2)];
+            redactedResponse = response;
+        }
+        return [[YKFAPDUTraceEntry alloc] initWithCommand:redactedCommand
+                                                 response:redactedResponse
+                                                    error:entry.error
+                                                   offset:entry.offset
+                                                 duration:entry.duration];
+    };
+}
+
+- (YKFAPDUTrace *)trace {
+    @synchronized (self) {
+        return [[YKFAPDUTrace alloc] initWithEntries:self.entries];
+    }
+}
+
+- (void)resetTrace {
+    @synchronized (self) {
+        [self.entries removeAllObjects];
+        self.startDate = [NSDate date];
+    }
+}
+
+#pragma mark - YKFConnectionControllerProtocol
+
+// The optional members are available when the wrapped controller implements them.
+- (BOOL)respondsToSelector:(SEL)aSelector {
+    if (protocol_getMethodDescription(@protocol(YKFConnectionControllerProtocol), aSelector, NO, YES).name) {
+        return [self.connectionController respondsToSelector:aSelector];
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+- (YKFCancellationToken *)cancellationToken {
+    return self.connectionController.cancellationToken;
+}
+
+- (YKFConnectionMetrics *)metrics {
+    return self.connectionController.metrics;
+}
+
+- (YKFTimeoutPolicy *)timeoutPolicy {
+    return self.connectionController.timeoutPolicy;
+}
+
+- (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFParameterAssertReturn(command);
+    YKFParameterAssertReturn(completion);
+    [self.connectionController execute:command completion:[self recordingCompletionForCommand:command completion:completion]];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFParameterAssertReturn(command);
+    YKFParameterAssertReturn(completion);
+    [self.connectionController execute:command timeout:timeout completion:[self recordingCompletionForCommand:command completion:completion]];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFParameterAssertReturn(command);
+    YKFParameterAssertReturn(completion);
+    [self.connectionController execute:command timeout:timeout cancellationToken:cancellationToken completion:[self recordingCompletionForCommand:command completion:completion]];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFParameterAssertReturn(command);
+    YKFParameterAssertReturn(completion);
+    [self.connectionController execute:command priority:priority deadline:deadline timeout:timeout cancellationToken:cancellationToken completion:[self recordingCompletionForCommand:command completion:completion]];
+}
+
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
+    [self.connectionController dispatchBlockOnCommunicationQueue:block];
+}
+
+- (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion {
+    [self.connectionController closeConnectionWithCompletion:completion];
+}
+
+- (void)cancelAllCommands {
+    [self.connectionController cancelAllCommands];
+}
+
+#pragma mark - Helpers
+
+- (YKFConnectionControllerCommandResponseBlock)recordingCompletionForCommand:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    // Sessions may wipe the command buffer once it was sent.
+    NSData *commandData = [command.apduData copy];
+    return ^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        [self recordCommand:commandData response:response error:error executionTime:executionTime];
+        completion(response, error, executionTime);
+    };
+}
+
+- (void)recordCommand:(NSData *)command response:(NSData *)response error:(NSError *)error executionTime:(NSTimeInterval)executionTime {
+    if (!response && !error) {
+        return;
+    }
+    @synchronized (self) {
+        // The completion is called when the command finished, so the start is derived from the execution time.
+        NSTimeInterval offset = -[self.startDate timeIntervalSinceNow] - executionTime;
+        YKFAPDUTraceEntry *entry = [[YKFAPDUTraceEntry alloc] initWithCommand:command
+                                                                      response:error ? nil : response
+                                                                         error:error
+                                                                        offset:offset
+                                                                      duration:executionTime];
+        if (self.redactionBlock) {
+            entry = self.redactionBlock(entry);
+        }
+        [self.entries addObject:entry];
+    }
+}
+
+@end
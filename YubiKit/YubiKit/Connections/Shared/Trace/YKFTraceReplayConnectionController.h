@@ -0,0 +1,71 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFConnectionControllerProtocol.h"
+#import "YKFAPDUTrace.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFTraceReplayConnectionController
+
+ @abstract
+    Connection controller which answers the commands with the responses from a recorded trace, in order.
+
+ @discussion
+    Any session can be created on top of the replay controller to run a recorded flow without a key, which makes the
+    session logic and parsing measurable in unit tests. The commands are executed sequentially on a private queue
+    like on the real connections.
+
+    When matchesCommands is YES a command which differs from the recorded one fails with
+    YKFSessionErrorUnexpectedResult. Commands sent after the end of the trace fail with YKFSessionErrorConnectionLost.
+ */
+@interface YKFTraceReplayConnectionController: NSObject<YKFConnectionControllerProtocol>
+
+@property (nonatomic, readonly) YKFAPDUTrace *trace;
+
+/*!
+ @abstract
+    Scale applied to the recorded durations before the response is returned. 0 (the default) returns the responses
+    immediately, 1 replays the trace with the recorded timing.
+ */
+@property (atomic) double timeScale;
+
+/*!
+ @abstract
+    When YES (the default) each command is compared with the recorded one. Set it to NO for flows which send
+    random data, like the FIDO2 key agreement or the SCP host challenge.
+ */
+@property (atomic) BOOL matchesCommands;
+
+/*!
+ @abstract
+    The number of recorded entries not yet served.
+ */
+@property (atomic, readonly) NSUInteger remainingEntryCount;
+
+- (instancetype)initWithTrace:(YKFAPDUTrace *)trace NS_DESIGNATED_INITIALIZER;
+
+/*!
+ @abstract
+    Restarts the replay from the first entry of the trace.
+ */
+- (void)rewind;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,159 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFTraceReplayConnectionController.h"
+#import "YKFAPDU+Private.h"
+#import "YKFBlockMacros.h"
+#import "YKFSessionError.h"
+#import "YKFSessionError+Private.h"
+#import "YKFAssert.h"
+#import "YKFConnectionMetrics+Private.h"
+
+@interface YKFTraceReplayConnectionController()
+
+@property (nonatomic, readwrite) YKFAPDUTrace *trace;
+@property (nonatomic) NSOperationQueue *communicationQueue;
+@property (atomic, readwrite) YKFCancellationToken *cancellationToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
+@property (atomic) NSUInteger nextEntryIndex;
+
+@end
+
+@implementation YKFTraceReplayConnectionController
+
+- (instancetype)initWithTrace:(YKFAPDUTrace *)trace {
+    YKFAssertAbortInit(trace);
+    self = [super init];
+    if (self) {
+        self.trace = trace;
+        self.matchesCommands = YES;
+        self.communicationQueue = [[NSOperationQueue alloc] init];
+        self.communicationQueue.maxConcurrentOperationCount = 1;
+        self.communicationQueue.underlyingQueue = dispatch_queue_create("com.yubico.TraceReplay", DISPATCH_QUEUE_SERIAL);
+        self.cancellationToken = [[YKFCancellationToken alloc] init];
+        self.metrics = [[YKFConnectionMetrics alloc] init];
+        self.timeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    }
+    return self;
+}
+
+- (NSUInteger)remainingEntryCount {
+    return self.trace.entries.count - MIN(self.nextEntryIndex, self.trace.entries.count);
+}
+
+- (void)rewind {
+    self.nextEntryIndex = 0;
+}
+
+#pragma mark - YKFConnectionControllerProtocol
+
+- (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command priority:YKFCommandPriorityNormal deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFParameterAssertReturn(command);
+    YKFParameterAssertReturn(completion);
+
+    // The timeout, priority and deadline are ignored: the replay either serves the recorded response or fails
+    // immediately, in the order of the recording.
+    YKFCancellationToken *generationToken = self.cancellationToken;
+    ykf_weak_self();
+    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        ykf_safe_strong_self();
+        if (cancellationToken.isCancelled || generationToken.isCancelled) {
+            return;
+        }
+        [strongSelf replayCommand:command cancellationToken:cancellationToken generationToken:generationToken completion:completion];
+    }];
+}
+
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
+    YKFParameterAssertReturn(block);
+
+    NSBlockOperation *operation = [[NSBlockOperation alloc] init];
+    __weak NSBlockOperation *weakOperation = operation;
+    [operation addExecutionBlock:^{
+        __strong NSBlockOperation *strongOperation = weakOperation;
+        if (!strongOperation || strongOperation.isCancelled) {
+            return;
+        }
+        block(strongOperation);
+    }];
+    [self.communicationQueue addOperation:operation];
+}
+
+- (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion {
+    completion();
+}
+
+- (void)cancelAllCommands {
+    [self.communicationQueue cancelAllOperations];
+
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    self.cancellationToken = [[YKFCancellationToken alloc] init];
+    [cancellationToken cancel];
+}
+
+#pragma mark - Replay
+
+- (void)replayCommand:(YKFAPDU *)command cancellationToken:(YKFCancellationToken *)cancellationToken generationToken:(YKFCancellationToken *)generationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    NSArray<YKFAPDUTraceEntry *> *entries = self.trace.entries;
+    if (self.nextEntryIndex >= entries.count) {
+        completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
+        return;
+    }
+
+    YKFAPDUTraceEntry *entry = entries[self.nextEntryIndex];
+    if (self.matchesCommands && ![entry.command isEqualToData:command.apduData]) {
+        // The entry is not consumed so the caller can inspect which command diverged from the trace.
+        completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult], 0);
+        return;
+    }
+    self.nextEntryIndex++;
+
+    NSTimeInterval delay = entry.duration * self.timeScale;
+    if (delay > 0) {
+        // Wake up early if either the command or the current generation of commands is cancelled.
+        YKFCancellationToken *waitToken = [[YKFCancellationToken alloc] init];
+        id registration = [cancellationToken addCancellationHandler:^{
+            [waitToken cancel];
+        }];
+        id generationRegistration = [generationToken addCancellationHandler:^{
+            [waitToken cancel];
+        }];
+        BOOL cancelled = [waitToken waitForTimeInterval:delay];
+        [cancellationToken removeCancellationHandler:registration];
+        [generationToken removeCancellationHandler:generationRegistration];
+        if (cancelled) {
+            return;
+        }
+    }
+    if (cancellationToken.isCancelled || generationToken.isCancelled) {
+        return;
+    }
+    [self.metrics recordCommand:command response:entry.response duration:entry.duration];
+    completion(entry.response, entry.error, entry.duration);
+}
+
+@end
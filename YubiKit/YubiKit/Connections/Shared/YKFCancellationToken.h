@@ -0,0 +1,74 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @class YKFCancellationToken
+
+ @abstract
+    A thread safe, one shot cancellation signal passed along with a command to the connection controller.
+
+ @discussion
+    Cancelling a token wakes up any thread waiting on it and runs the registered cancellation handlers. The
+    connection controllers use it to cancel a queued command without suspending the communication queue and to
+    stop polling the key immediately when the in-flight command is cancelled.
+ */
+@interface YKFCancellationToken: NSObject
+
+/*!
+ @abstract
+    YES once cancel was called. The value never goes back to NO.
+ */
+@property (nonatomic, readonly, getter=isCancelled) BOOL cancelled;
+
+/*!
+ @abstract
+    Cancels the token, wakes up the waiting threads and runs the cancellation handlers on the calling thread.
+    Subsequent calls have no effect.
+ */
+- (void)cancel;
+
+/*!
+ @abstract
+    Blocks the calling thread until the time interval elapsed or the token was cancelled.
+
+ @returns
+    YES if the token was cancelled.
+ */
+- (BOOL)waitForTimeInterval:(NSTimeInterval)timeInterval;
+
+/*!
+ @abstract
+    Registers a block to be called when the token is cancelled.
+
+ @discussion
+    If the token is already cancelled the handler is called immediately and nil is returned.
+
+ @returns
+    An opaque registration which can be passed to removeCancellationHandler: when the handler is no longer needed.
+ */
+- (nullable id)addCancellationHandler:(dispatch_block_t)handler;
+
+/*!
+ @abstract
+    Removes a handler added with addCancellationHandler:. Passing nil does nothing.
+ */
+- (void)removeCancellationHandler:(nullable id)registration;
+
+@end
+
+NS_ASSUME_NONNULL_END
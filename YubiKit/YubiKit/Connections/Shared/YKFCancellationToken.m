@@ -0,0 +1,98 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFCancellationToken.h"
+#import "YKFAssert.h"
+
+@interface YKFCancellationToken()
+
+@property (nonatomic) NSCondition *condition;
+@property (nonatomic) NSMutableDictionary<NSUUID *, dispatch_block_t> *handlers;
+
+@end
+
+@implementation YKFCancellationToken {
+    BOOL _cancelled;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.condition = [[NSCondition alloc] init];
+        self.handlers = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (BOOL)isCancelled {
+    [self.condition lock];
+    BOOL cancelled = _cancelled;
+    [self.condition unlock];
+    return cancelled;
+}
+
+- (void)cancel {
+    [self.condition lock];
+    if (_cancelled) {
+        [self.condition unlock];
+        return;
+    }
+    _cancelled = YES;
+    NSArray<dispatch_block_t> *handlers = self.handlers.allValues;
+    [self.handlers removeAllObjects];
+    [self.condition broadcast];
+    [self.condition unlock];
+
+    // Handlers are called outside the lock so they can use the token.
+    for (dispatch_block_t handler in handlers) {
+        handler();
+    }
+}
+
+- (BOOL)waitForTimeInterval:(NSTimeInterval)timeInterval {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeInterval];
+    [self.condition lock];
+    while (!_cancelled && [self.condition waitUntilDate:deadline]) {
+        // Spurious wakeup, keep waiting until the deadline.
+    }
+    BOOL cancelled = _cancelled;
+    [self.condition unlock];
+    return cancelled;
+}
+
+- (id)addCancellationHandler:(dispatch_block_t)handler {
+    YKFParameterAssertReturnValue(handler, nil);
+
+    [self.condition lock];
+    if (_cancelled) {
+        [self.condition unlock];
+        handler();
+        return nil;
+    }
+    NSUUID *registration = [NSUUID UUID];
+    self.handlers[registration] = [handler copy];
+    [self.condition unlock];
+    return registration;
+}
+
+- (void)removeCancellationHandler:(id)registration {
+    if (!registration) {
+        return;
+    }
+    [self.condition lock];
+    [self.handlers removeObjectForKey:registration];
+    [self.condition unlock];
+}
+
+@end
@@ -0,0 +1,57 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+/*!
+ @abstract
+    The priority of a command sent to the key.
+
+ @discussion
+    The commands of a connection run one at a time. When a command completes, the queued command with the
+    highest priority runs next, and commands with the same priority run in the order they were queued. A
+    running command is never interrupted, so a priority only takes effect at command boundaries.
+ */
+typedef NS_ENUM(NSUInteger, YKFCommandPriority) {
+    /// Work the user is not waiting for, like syncing certificates or refreshing a credential list.
+    YKFCommandPriorityBackground = 0,
+
+    /// The default priority.
+    YKFCommandPriorityNormal = 1,
+
+    /// Work the user is waiting for, like a signature after a tap.
+    YKFCommandPriorityInteractive = 2,
+
+    /// A command continuing the command which just completed, like a GET RESPONSE reading the rest of a
+    /// chained response. It runs before any other queued command so multi-APDU sequences are not split.
+    YKFCommandPriorityContinuation = 3
+};
+
+/*!
+ @abstract
+    The NSOperation queue priority used by the connection controllers for a command priority.
+ */
+NS_INLINE NSOperationQueuePriority YKFOperationQueuePriorityForCommandPriority(YKFCommandPriority priority) {
+    switch (priority) {
+        case YKFCommandPriorityBackground:
+            return NSOperationQueuePriorityLow;
+        case YKFCommandPriorityNormal:
+            return NSOperationQueuePriorityNormal;
+        case YKFCommandPriorityInteractive:
+            return NSOperationQueuePriorityHigh;
+        case YKFCommandPriorityContinuation:
+            return NSOperationQueuePriorityVeryHigh;
+    }
+    return NSOperationQueuePriorityNormal;
+}
@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #import "YKFAPDU.h"
+#import "YKFCancellationToken.h"
+#import "YKFCommandPriority.h"
+#import "YKFConnectionMetrics.h"
+#import "YKFTimeoutPolicy.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -20,16 +24,62 @@ typedef void (^YKFConnectionControllerCommandResponseBlock)(NSData* _Nullable, N
 typedef void (^YKFConnectionControllerCompletionBlock)(void);
 typedef void (^YKFConnectionControllerCommunicationQueueBlock)(NSOperation *operation);
 
-@protocol YKFConnectionControllerProtocol
+@protocol YKFConnectionControllerProtocol<NSObject>
 
+/*
+ Commands executed without a timeout, or with YKFTimeoutPolicyAdaptiveTimeout, get their timeout from the timeout
+ policy when they start.
+ */
 - (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion;
 - (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion;
 
+/*
+ The block runs after all the commands queued before it, whatever their priority.
+ */
 - (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block;
 
 - (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion;
 - (void)cancelAllCommands;
 
+/*
+ The members below are implemented by the controllers of the library. They are optional so that existing
+ implementations of the protocol keep working: YKFSmartCardInterface sends the commands with
+ execute:timeout:completion: to a controller which doesn't implement them, without priorities, deadlines or
+ cancellation, and has no metrics or timeout policy for it.
+ */
+@optional
+
+/*
+ Cancelling the token removes the command from the queue, or wakes up and aborts the command if it's in flight.
+ The completion is not called for cancelled commands.
+ */
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(nullable YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion;
+
+/*
+ Queues the command ahead of the queued commands with a lower priority. A command which has not started by the
+ deadline fails with YKFSessionErrorDeadlineExceededCode without being sent to the key. The deadline only gates
+ the start: a started command runs with the full timeout, since cutting an exchange short leaves the key with a
+ half-processed command. The other methods use the normal priority and no deadline.
+ */
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(nullable NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(nullable YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion;
+
+/*
+ The token cancelled by the next call to cancelAllCommands. A new token is created after each cancellation, so
+ multi-command flows (e.g. polling for touch) should read it once when they start.
+ */
+@property (nonatomic, readonly) YKFCancellationToken *cancellationToken;
+
+/*
+ The metrics of the commands executed by the controller. The controller records every APDU exchange, the smart card
+ interface and the sessions record the response chaining, the secure channel overhead and the touch waits.
+ */
+@property (nonatomic, readonly) YKFConnectionMetrics *metrics;
+
+/*
+ The timeout policy of the transport. The controller records the execution time of every successful command.
+ */
+@property (nonatomic, readonly) YKFTimeoutPolicy *timeoutPolicy;
+
 @end
 
 NS_ASSUME_NONNULL_END
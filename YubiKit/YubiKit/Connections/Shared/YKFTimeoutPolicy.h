@@ -0,0 +1,101 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+@class YKFAPDU;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @abstract
+    Passed as the timeout of a command to let the connection controller pick it from its timeout policy
+    when the command starts.
+ */
+static NSTimeInterval const YKFTimeoutPolicyAdaptiveTimeout = -1;
+
+/*!
+ @class YKFTimeoutPolicy
+
+ @abstract
+    Picks the timeout of the commands sent without an explicit timeout from the latency observed for their
+    instruction (INS byte).
+
+ @discussion
+    The policy keeps the execution times of the last successful commands of every instruction. Once an
+    instruction has minimumSampleCount samples, its timeout is the 99th percentile of the samples multiplied by
+    latencyFactor, clamped between minimumTimeout and maximumTimeout, so a key which stopped answering is
+    detected after about a second instead of the default timeout. Until then the default timeout is used.
+
+    The instructions which wait for touch or generate keys take as long as the user or the key need, their
+    timeout is set explicitly with setTimeout:forIns: and never learned. An instruction has the same timeout in
+    all the applications, e.g. 0x01 is both the OATH PUT and the challenge-response instruction. 0xA4 is both
+    SELECT and OATH CALCULATE ALL, whose time grows with the number of credentials, and PUT DATA (0xDB), IMPORT
+    (0xFE) and ATTEST (0xF9) take longer with larger objects and keys, so they have fixed timeouts.
+
+    The connection controllers of one transport share a policy, so the latency learned on a connection is used
+    by the next one. The policy is thread safe.
+ */
+@interface YKFTimeoutPolicy : NSObject
+
+/// The timeout of an instruction with too few samples. Defaults to 10 seconds.
+@property (atomic) NSTimeInterval defaultTimeout;
+
+/// The lower bound of a learned timeout. Defaults to 1 second.
+@property (atomic) NSTimeInterval minimumTimeout;
+
+/// The upper bound of a learned timeout. Defaults to 10 seconds.
+@property (atomic) NSTimeInterval maximumTimeout;
+
+/// The factor applied to the 99th percentile of the execution times. Defaults to 4.
+@property (atomic) double latencyFactor;
+
+/// The number of samples an instruction needs before its timeout is learned. Defaults to 8.
+@property (atomic) NSUInteger minimumSampleCount;
+
+/// When NO the policy returns the explicit timeouts or the default timeout. Defaults to YES.
+@property (atomic, getter=isLearningEnabled) BOOL learningEnabled;
+
+/*!
+ @abstract
+    Returns a policy with the timeouts of the instructions which wait for touch or generate keys set:
+    30 seconds for FIDO2 (0x10), OATH CALCULATE (0xA2), challenge-response and U2F (0x01, 0x02), and
+    120 seconds for the PIV GENERATE ASYMMETRIC (0x47) and GENERAL AUTHENTICATE (0x87) instructions and the
+    security domain GENERATE KEY (0xF1) instruction, and 10 seconds for SELECT and OATH CALCULATE ALL (0xA4),
+    PUT DATA (0xDB), IMPORT (0xFE) and ATTEST (0xF9).
+ */
+- (instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/// Sets a fixed timeout for the instruction, used instead of the learned one.
+- (void)setTimeout:(NSTimeInterval)timeout forIns:(UInt8)ins;
+
+/// Removes the fixed timeout of the instruction.
+- (void)removeTimeoutForIns:(UInt8)ins;
+
+/// The timeout of the next command with the instruction.
+- (NSTimeInterval)timeoutForIns:(UInt8)ins;
+
+/// The timeout of the next command with the instruction of the APDU.
+- (NSTimeInterval)timeoutForCommand:(YKFAPDU *)command;
+
+/// Records the execution time of a successful command. Failed commands must not be recorded, a timed out command
+/// would otherwise raise the timeout of its instruction.
+- (void)recordExecutionTime:(NSTimeInterval)executionTime forIns:(UInt8)ins;
+
+/// Clears the learned latencies. The fixed timeouts are kept.
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,138 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFTimeoutPolicy.h"
+#import "YKFAPDU.h"
+#import "YKFAPDUCommandInstruction.h"
+
+#define YKFTimeoutPolicyInsCount 256
+#define YKFTimeoutPolicySampleCount 32
+
+static NSTimeInterval const YKFTimeoutPolicyTouchTimeout = 30.0;
+static NSTimeInterval const YKFTimeoutPolicyKeyGenerationTimeout = 120.0;
+// The time of these instructions depends on the application or the payload more than on the connection, so the fast
+// samples of one application or of small payloads would time out the slow ones. SELECT and OATH CALCULATE ALL share
+// 0xA4 and CALCULATE ALL gets slower with every credential. PUT DATA, IMPORT and ATTEST grow with the object or key
+// size and are sent to several applications.
+static NSTimeInterval const YKFTimeoutPolicyVariableLatencyTimeout = 10.0;
+
+static UInt8 const YKFTimeoutPolicyPIVInsGenerateAsymmetric = 0x47;
+static UInt8 const YKFTimeoutPolicyPIVInsAuthenticate = 0x87;
+static UInt8 const YKFTimeoutPolicySecurityDomainInsGenerateKey = 0xF1;
+static UInt8 const YKFTimeoutPolicyInsPutData = 0xDB;
+static UInt8 const YKFTimeoutPolicyInsImportKey = 0xFE;
+static UInt8 const YKFTimeoutPolicyInsAttest = 0xF9;
+
+// The last execution times of an instruction, in a ring.
+typedef struct {
+    NSTimeInterval values[YKFTimeoutPolicySampleCount];
+    NSUInteger count;
+    NSUInteger next;
+} YKFLatencySamples;
+
+static int YKFCompareTimeIntervals(const void *a, const void *b) {
+    NSTimeInterval lhs = *(const NSTimeInterval *)a;
+    NSTimeInterval rhs = *(const NSTimeInterval *)b;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+@implementation YKFTimeoutPolicy {
+    YKFLatencySamples _samples[YKFTimeoutPolicyInsCount];
+    // 0 when the instruction has no fixed timeout.
+    NSTimeInterval _fixedTimeouts[YKFTimeoutPolicyInsCount];
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _defaultTimeout = 10.0;
+        _minimumTimeout = 1.0;
+        _maximumTimeout = 10.0;
+        _latencyFactor = 4.0;
+        _minimumSampleCount = 8;
+        _learningEnabled = YES;
+        
+        _fixedTimeouts[YKFAPDUCommandInstructionFIDO2Msg] = YKFTimeoutPolicyTouchTimeout;
+        _fixedTimeouts[YKFAPDUCommandInstructionOATHCalculate] = YKFTimeoutPolicyTouchTimeout;
+        _fixedTimeouts[YKFAPDUCommandInstructionChalRespSend] = YKFTimeoutPolicyTouchTimeout;
+        _fixedTimeouts[YKFAPDUCommandInstructionU2FSign] = YKFTimeoutPolicyTouchTimeout;
+        _fixedTimeouts[YKFTimeoutPolicyPIVInsGenerateAsymmetric] = YKFTimeoutPolicyKeyGenerationTimeout;
+        _fixedTimeouts[YKFTimeoutPolicyPIVInsAuthenticate] = YKFTimeoutPolicyKeyGenerationTimeout;
+        _fixedTimeouts[YKFTimeoutPolicySecurityDomainInsGenerateKey] = YKFTimeoutPolicyKeyGenerationTimeout;
+        _fixedTimeouts[YKFAPDUCommandInstructionSelectApplication] = YKFTimeoutPolicyVariableLatencyTimeout;
+        _fixedTimeouts[YKFTimeoutPolicyInsPutData] = YKFTimeoutPolicyVariableLatencyTimeout;
+        _fixedTimeouts[YKFTimeoutPolicyInsImportKey] = YKFTimeoutPolicyVariableLatencyTimeout;
+        _fixedTimeouts[YKFTimeoutPolicyInsAttest] = YKFTimeoutPolicyVariableLatencyTimeout;
+    }
+    return self;
+}
+
+- (void)setTimeout:(NSTimeInterval)timeout forIns:(UInt8)ins {
+    @synchronized (self) {
+        _fixedTimeouts[ins] = MAX(timeout, 0);
+    }
+}
+
+- (void)removeTimeoutForIns:(UInt8)ins {
+    [self setTimeout:0 forIns:ins];
+}
+
+- (NSTimeInterval)timeoutForCommand:(YKFAPDU *)command {
+    return [self timeoutForIns:command.ins];
+}
+
+- (NSTimeInterval)timeoutForIns:(UInt8)ins {
+    NSTimeInterval defaultTimeout = self.defaultTimeout;
+    NSUInteger minimumSampleCount = MIN(MAX(self.minimumSampleCount, 1), YKFTimeoutPolicySampleCount);
+    BOOL learningEnabled = self.learningEnabled;
+    
+    NSTimeInterval sorted[YKFTimeoutPolicySampleCount];
+    NSUInteger count;
+    @synchronized (self) {
+        if (_fixedTimeouts[ins] > 0) {
+            return _fixedTimeouts[ins];
+        }
+        count = _samples[ins].count;
+        if (!learningEnabled || count < minimumSampleCount) {
+            return defaultTimeout;
+        }
+        memcpy(sorted, _samples[ins].values, count * sizeof(NSTimeInterval));
+    }
+    
+    qsort(sorted, count, sizeof(NSTimeInterval), YKFCompareTimeIntervals);
+    // Nearest rank, which is the slowest sample until the ring holds 100 samples.
+    NSUInteger rank = (NSUInteger)ceil(0.99 * count);
+    NSTimeInterval p99 = sorted[rank - 1];
+    return MIN(MAX(p99 * self.latencyFactor, self.minimumTimeout), self.maximumTimeout);
+}
+
+- (void)recordExecutionTime:(NSTimeInterval)executionTime forIns:(UInt8)ins {
+    if (executionTime < 0) {
+        return;
+    }
+    @synchronized (self) {
+        YKFLatencySamples *samples = &_samples[ins];
+        samples->values[samples->next] = executionTime;
+        samples->next = (samples->next + 1) % YKFTimeoutPolicySampleCount;
+        samples->count = MIN(samples->count + 1, YKFTimeoutPolicySampleCount);
+    }
+}
+
+- (void)reset {
+    @synchronized (self) {
+        memset(_samples, 0, sizeof(_samples));
+    }
+}
+
+@end
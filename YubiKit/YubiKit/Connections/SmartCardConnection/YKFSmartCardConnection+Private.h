@@ -14,6 +14,8 @@
 
 #import "YKFSmartCardConnection.h"
 
+@class YKFSmartCardConnectionController;
+
 #ifndef YKFSmartCardConnecton_Private_h
 #define YKFSmartCardConnecton_Private_h
 
@@ -35,6 +37,17 @@
  */
 - (nullable instancetype)initWithDelegate:(nonnull id<YKFSmartCardConnectionDelegate>)delegate;
 
+/*
+ Creates an open connection bound to one slot, used by YKFSmartCardConnectionRegistry. The registry tracks the
+ slots so start and stop do not observe the slot manager.
+ */
+- (nonnull instancetype)initWithSlotName:(nonnull NSString *)slotName connectionController:(nonnull YKFSmartCardConnectionController *)connectionController;
+
+/*
+ Ends the smart card session of a connection created by the registry when its slot is removed or the registry stops.
+ */
+- (void)close;
+
 @end
 
 #endif /* YKFSmartCardConnecton_Private_h */
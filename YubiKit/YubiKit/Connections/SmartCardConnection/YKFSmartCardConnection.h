@@ -34,6 +34,9 @@ typedef NS_ENUM(NSUInteger, YKFSmartCardConnectionErrorCode) {
 
 @interface YKFSmartCardConnection : NSObject<YKFConnectionProtocol>
 
+/// The name of the smart card slot of the connected YubiKey.
+@property (nonatomic, readonly, nullable) NSString *slotName;
+
 - (void)start API_AVAILABLE(ios(16.0));
 
 - (void)stop API_AVAILABLE(ios(16.0));
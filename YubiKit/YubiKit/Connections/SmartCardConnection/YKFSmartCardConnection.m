@@ -31,7 +31,11 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
 @interface YKFSmartCardConnection()
 
 @property (nonatomic) YKFSmartCardConnectionController *connectionController;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
 @property (nonatomic) bool isActive;
+// YES when the connection was created by the registry for a single slot.
+@property (nonatomic) bool isBoundToSlot;
+@property (nonatomic, readwrite) NSString *slotName;
 @property (nonatomic, readwrite) id<YKFSessionProtocol> currentSession;
 
 @end
@@ -47,6 +51,17 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
     return self;
 }
 
+- (instancetype)initWithSlotName:(NSString *)slotName connectionController:(YKFSmartCardConnectionController *)connectionController {
+    self = [super init];
+    if (self) {
+        self.isBoundToSlot = YES;
+        self.slotName = slotName;
+        self.connectionController = connectionController;
+        self.metrics = connectionController.metrics;
+    }
+    return self;
+}
+
 - (YKFSmartCardConnectionState)state {
     return self.connectionController != nil ? YKFSmartCardConnectionStateOpen : YKFSmartCardConnectionStateClosed;
 }
@@ -55,7 +70,11 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
     // creating the smart card has to be done on the main thread and after a slight delay
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 0.1 * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
         TKSmartCardSlotManager *manager = [TKSmartCardSlotManager defaultManager];
-        NSString *slotName = manager.slotNames.firstObject; // iPads only have one usb-c port
+        // Keep the open connection when other slots are added or removed.
+        if (self.connectionController != nil && [manager.slotNames containsObject:self.slotName]) {
+            return;
+        }
+        NSString *slotName = manager.slotNames.firstObject; // iPads only have one usb-c port, use YKFSmartCardConnectionRegistry for more keys
         if (slotName != nil) {
             TKSmartCardSlot *slot = [manager slotNamed:slotName];
             TKSmartCard *smartCard = [slot makeSmartCard];
@@ -64,7 +83,9 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
             }
             [YKFSmartCardConnectionController smartCardControllerWithSmartCard:smartCard completion:^(YKFSmartCardConnectionController * controller, NSError * error) {
                 if (controller != nil) {
+                    self.slotName = slotName;
                     self.connectionController = controller;
+                    self.metrics = self.connectionController.metrics;
                     [self.delegate didConnectSmartCard:self];
                 } else {
                     [self.delegate didFailConnectingSmartCard:error];
@@ -72,6 +93,7 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
             }];
         } else if (self.connectionController != nil) {
             self.connectionController = nil;
+            self.slotName = nil;
             [self.delegate didDisconnectSmartCard:self error:nil];
             [self.currentSession clearSessionState];
             self.currentSession = nil;
@@ -80,7 +102,9 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
 }
 
 - (void)dealloc {
-    if (@available(iOS 16.0, *)) {
+    if (self.isBoundToSlot) {
+        [self close];
+    } else if (@available(iOS 16.0, *)) {
         [self stop];
     }
 }
@@ -93,7 +117,7 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
 }
 
 - (void)start {
-    if (self.isActive == YES) {
+    if (self.isActive == YES || self.isBoundToSlot) {
         return;
     }
     
@@ -103,12 +127,24 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
 }
 
 - (void)stop {
+    if (self.isBoundToSlot) {
+        [self close];
+        return;
+    }
     if (self.isActive == NO) {
         return;
     }
     
     self.isActive = NO;
     [[TKSmartCardSlotManager defaultManager] removeObserver:self forKeyPath:@"slotNames"];
+    [self.connectionController endSession];
+    self.connectionController = nil;
+    self.slotName = nil;
+    [self.currentSession clearSessionState];
+    self.currentSession = nil;
+}
+
+- (void)close {
     [self.connectionController endSession];
     self.connectionController = nil;
     [self.currentSession clearSessionState];
@@ -188,6 +224,28 @@ NSString* const YKFSmartCardConnectionErrorDomain = @"com.yubico.smart-card-conn
     }];
 }
 
+- (void)oathSessionWithAccessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:nil
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
+- (void)oathSession:(id<YKFSCPKeyParamsProtocol> _Nonnull)scpKeyParams accessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion {
+    [self.currentSession clearSessionState];
+    [YKFOATHSession sessionWithConnectionController:self.connectionController
+                                       scpKeyParams:scpKeyParams
+                                  accessKeyProvider:accessKeyProvider
+                                         completion:^(YKFOATHSession *_Nullable session, NSArray<YKFOATHCredentialWithCode *> *_Nullable credentials, NSError * _Nullable error) {
+        self.currentSession = session;
+        completion(session, credentials, error);
+    }];
+}
+
 - (void)pivSession:(YKFPIVSessionCompletionBlock _Nonnull)completion {
     [self.currentSession clearSessionState];
     [YKFPIVSession sessionWithConnectionController:self.connectionController
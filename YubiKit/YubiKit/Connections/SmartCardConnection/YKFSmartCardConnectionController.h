@@ -19,11 +19,29 @@
 
 @class TKSmartCard;
 
+/*
+ The subset of TKSmartCard used by the controller. Each controller owns one smart card and its own serial
+ communication queue, so commands to different keys run in parallel while the order of the APDUs sent to
+ a key is kept.
+ */
+@protocol YKFSmartCardTransport <NSObject>
+
+@property (readonly) BOOL valid;
+
+- (void)beginSessionWithReply:(void(^_Nonnull)(BOOL success, NSError *_Nullable error))reply;
+- (void)transmitRequest:(NSData *_Nonnull)request reply:(void(^_Nonnull)(NSData *_Nullable response, NSError *_Nullable error))reply;
+- (void)endSession;
+
+@end
+
 @interface YKFSmartCardConnectionController: NSObject<YKFConnectionControllerProtocol>
 
 typedef void (^YKFSmartCardConnectionControllerCompletionBlock)(YKFSmartCardConnectionController *_Nullable, NSError* _Nullable);
 + (void)smartCardControllerWithSmartCard:(TKSmartCard *_Nonnull)smartCard                                                                                      completion:(YKFSmartCardConnectionControllerCompletionBlock _Nonnull)completion;
 
++ (void)smartCardControllerWithTransport:(id<YKFSmartCardTransport> _Nonnull)transport
+                              completion:(YKFSmartCardConnectionControllerCompletionBlock _Nonnull)completion;
+
 - (void)endSession;
 
 @end
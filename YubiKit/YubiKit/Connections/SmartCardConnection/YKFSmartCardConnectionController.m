@@ -20,14 +20,26 @@
 #import "YKFSessionError.h"
 #import "YKFSessionError+Private.h"
 #import "YKFAssert.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
 
-static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
+@interface TKSmartCard (YKFSmartCardTransport)<YKFSmartCardTransport>
+@end
+
+@implementation TKSmartCard (YKFSmartCardTransport)
+@end
 
 @interface YKFSmartCardConnectionController()
 
-@property (nonatomic, readwrite) TKSmartCard *smartCard;
+@property (nonatomic, readwrite) id<YKFSmartCardTransport> smartCard;
 @property (nonatomic) NSOperationQueue *communicationQueue;
 
+@property (atomic, readwrite) YKFCancellationToken *cancellationToken;
+// The token of the command currently executed on the communication queue.
+@property (atomic) YKFCancellationToken *activeCommandToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
+
 @end
 
 @implementation YKFSmartCardConnectionController
@@ -40,16 +52,36 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
         dispatch_queue_attr_t dispatchQueueAttributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, DISPATCH_QUEUE_PRIORITY_HIGH, -1);
         dispatch_queue_t dispatchQueue = dispatch_queue_create("com.yubico.SmartCard", dispatchQueueAttributes);
         self.communicationQueue.underlyingQueue = dispatchQueue;
+        self.cancellationToken = [[YKFCancellationToken alloc] init];
+        self.metrics = [[YKFConnectionMetrics alloc] init];
+        self.timeoutPolicy = [YKFSmartCardConnectionController sharedTimeoutPolicy];
     }
     return self;
 }
 
++ (YKFTimeoutPolicy *)sharedTimeoutPolicy {
+    static YKFTimeoutPolicy *sharedTimeoutPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedTimeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    });
+    return sharedTimeoutPolicy;
+}
+
 + (void)smartCardControllerWithSmartCard:(TKSmartCard *)smartCard
                               completion:(YKFSmartCardConnectionControllerCompletionBlock _Nonnull)completion {
-    YKFSmartCardConnectionController *controller = [YKFSmartCardConnectionController new];
     if (smartCard == nil) {
         [NSException raise:@"Nonnull object is null" format:@"TKSmartCard can not be null."];
     }
+    [self smartCardControllerWithTransport:smartCard completion:completion];
+}
+
++ (void)smartCardControllerWithTransport:(id<YKFSmartCardTransport>)smartCard
+                              completion:(YKFSmartCardConnectionControllerCompletionBlock _Nonnull)completion {
+    YKFSmartCardConnectionController *controller = [YKFSmartCardConnectionController new];
+    if (smartCard == nil) {
+        [NSException raise:@"Nonnull object is null" format:@"The smart card can not be null."];
+    }
     controller.smartCard = smartCard;
     [smartCard beginSessionWithReply:^(BOOL success, NSError * _Nullable error) {
         if (error == nil) {
@@ -65,11 +97,14 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
 }
 
 - (void)cancelAllCommands {
-    self.communicationQueue.suspended = YES;
-    dispatch_suspend(self.communicationQueue.underlyingQueue);
+    // Queued operations are removed without executing them. The in-flight command is woken up by its token
+    // and returns without waiting for the smart card response.
     [self.communicationQueue cancelAllOperations];
-    dispatch_resume(self.communicationQueue.underlyingQueue);
-    self.communicationQueue.suspended = NO;
+    [self.activeCommandToken cancel];
+    
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    self.cancellationToken = [[YKFCancellationToken alloc] init];
+    [cancellationToken cancel];
 }
 
 - (void)closeConnectionWithCompletion:(nonnull YKFConnectionControllerCompletionBlock)completion {
@@ -78,7 +113,16 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
 
 - (void)dispatchBlockOnCommunicationQueue:(nonnull YKFConnectionControllerCommunicationQueueBlock)block {
     YKFParameterAssertReturn(block);
-    
+    NSOperation *operation = [self operationWithBlock:block];
+    // Commands queued later with a higher priority may run before the block, but the block waits for all
+    // the commands already queued.
+    for (NSOperation *queuedOperation in self.communicationQueue.operations) {
+        [operation addDependency:queuedOperation];
+    }
+    [self.communicationQueue addOperation:operation];
+}
+
+- (NSOperation *)operationWithBlock:(YKFConnectionControllerCommunicationQueueBlock)block {
     NSBlockOperation *operation = [[NSBlockOperation alloc] init];
     __weak NSBlockOperation *weakOperation = operation;
     
@@ -90,64 +134,116 @@ static NSTimeInterval const YKFSmartCardConnectionDefaultTimeout = 10.0;
         block(strongOperation); // Execute the operation if it's still alive and not canceled.
     }];
     
-    [self.communicationQueue addOperation:operation];;
+    return operation;
 }
 
 - (void)execute:(nonnull YKFAPDU *)command completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
-    [self execute:command timeout:YKFSmartCardConnectionDefaultTimeout completion:completion];
+    [self execute:command timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
 }
 
 - (void)execute:(nonnull YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)execute:(nonnull YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(nullable YKFCancellationToken *)cancellationToken completion:(nonnull YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command priority:YKFCommandPriorityNormal deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    
+    // Cancelled by the caller token or by cancelAllCommands while the command is in flight.
+    YKFCancellationToken *commandToken = [[YKFCancellationToken alloc] init];
     
+    NSDate *queuedDate = [NSDate date];
     ykf_weak_self();
-    [self dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+    NSOperation *queuedOperation = [self operationWithBlock:^(NSOperation *operation) {
         ykf_safe_strong_self();
-        
-        // Do not wait for the command to process if the operation was canceled.
-        if (operation.isCancelled) {
+        NSTimeInterval commandTimeout = timeout == YKFTimeoutPolicyAdaptiveTimeout ? [strongSelf.timeoutPolicy timeoutForCommand:command] : timeout;
+        BOOL deadlineExceeded = deadline && deadline.timeIntervalSinceNow <= 0;
+        [strongSelf.metrics recordQueueingDelay:-queuedDate.timeIntervalSinceNow priority:priority deadlineExceeded:deadlineExceeded];
+        if (deadlineExceeded) {
+            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorDeadlineExceededCode], 0);
             return;
         }
-        
-        // Verify that the smart card is still valid
-        if (!strongSelf.smartCard.valid) {
-            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
-            return;
+        strongSelf.activeCommandToken = commandToken;
+        if (!operation.isCancelled) {
+            [strongSelf executeCommand:command timeout:commandTimeout cancellationToken:commandToken completion:completion];
         }
-        
-        __block NSError *executionError = nil;
-        __block NSData *executionResult = nil;
-        NSDate *commandStartDate = [NSDate date];
-        dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
-
-        [strongSelf.smartCard transmitRequest:[command apduData] reply:^(NSData * _Nullable response, NSError * _Nullable error) {
-            if (error) {
-                executionError = error;
-                dispatch_semaphore_signal(executionSemaphore);
-                return;
-            }
-            
-            executionResult = [response copy];
-            dispatch_semaphore_signal(executionSemaphore);
+        strongSelf.activeCommandToken = nil;
+    }];
+    queuedOperation.queuePriority = YKFOperationQueuePriorityForCommandPriority(priority);
+    
+    __weak NSOperation *weakOperation = queuedOperation;
+    id registration = [cancellationToken addCancellationHandler:^{
+        [weakOperation cancel];
+        [commandToken cancel];
+    }];
+    if (registration) {
+        [queuedOperation setCompletionBlock:^{
+            [cancellationToken removeCancellationHandler:registration];
         }];
-        
-        // Lock the async call to enforce the sequential execution using the library dispatch queue.
-        if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
-            executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
-        }
-        
-        // Do not notify if the operation was canceled.
-        if (operation.isCancelled) {
+    }
+    
+    [self.communicationQueue addOperation:queuedOperation];
+}
+
+- (void)executeCommand:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)commandToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    // Do not wait for the command to process if the operation was canceled.
+    if (commandToken.isCancelled) {
+        return;
+    }
+    
+    // Verify that the smart card is still valid
+    if (!self.smartCard.valid) {
+        completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorConnectionLost], 0);
+        return;
+    }
+    
+    __block NSError *executionError = nil;
+    __block NSData *executionResult = nil;
+    NSDate *commandStartDate = [NSDate date];
+    dispatch_semaphore_t executionSemaphore = dispatch_semaphore_create(0);
+    UInt8 ins = YKFEventRingIns(command.apduData);
+    YKFEventRingRecord(YKFEventTypeAPDUSent, ins, (UInt32)command.apduData.length, 0);
+
+    [self.smartCard transmitRequest:[command apduData] reply:^(NSData * _Nullable response, NSError * _Nullable error) {
+        if (error) {
+            executionError = error;
+            dispatch_semaphore_signal(executionSemaphore);
             return;
         }
         
-        NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
-        if (executionError) {
-            completion(nil, executionError, executionTime);
-        } else {
-            YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
-            completion(executionResult, nil, executionTime);
-        }
+        executionResult = [response copy];
+        dispatch_semaphore_signal(executionSemaphore);
+    }];
+    
+    // Cancelling the command releases the queue without waiting for the smart card response.
+    id registration = [commandToken addCancellationHandler:^{
+        dispatch_semaphore_signal(executionSemaphore);
     }];
+    
+    // Lock the async call to enforce the sequential execution using the library dispatch queue.
+    if(dispatch_semaphore_wait(executionSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) != 0) {
+        executionError = [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode];
+    }
+    [commandToken removeCancellationHandler:registration];
+    
+    // Do not notify if the operation was canceled.
+    if (commandToken.isCancelled) {
+        return;
+    }
+    
+    NSTimeInterval executionTime = [[NSDate date] timeIntervalSinceDate: commandStartDate];
+    [self.metrics recordCommand:command response:executionError ? nil : executionResult duration:executionTime];
+    if (executionError) {
+        YKFEventRingRecord(YKFEventTypeAPDUFailed, ins, 0, 0);
+        completion(nil, executionError, executionTime);
+    } else {
+        YKFAssertReturn(executionResult, @"The command did not return any response data when error was not nil.");
+        YKFEventRingRecordResponse(ins, executionResult);
+        [self.timeoutPolicy recordExecutionTime:executionTime forIns:ins];
+        completion(executionResult, nil, executionTime);
+    }
 }
 
 - (void)dealloc {
@@ -0,0 +1,55 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFSmartCardConnectionRegistry_Private_h
+#define YKFSmartCardConnectionRegistry_Private_h
+
+#import "YKFSmartCardConnectionRegistry.h"
+#import "YKFSmartCardConnectionController.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ The source of the smart card slots tracked by the registry. The default source wraps TKSmartCardSlotManager.
+ */
+@protocol YKFSmartCardSlotSource <NSObject>
+
+@property (nonatomic, readonly) NSArray<NSString *> *slotNames;
+
+/*
+ The handler is called on the main thread when the slot names change.
+ */
+- (void)startObservingSlotNamesWithHandler:(dispatch_block_t)handler;
+- (void)stopObservingSlotNames;
+
+- (nullable id<YKFSmartCardTransport>)makeSmartCardForSlotNamed:(NSString *)slotName;
+
+@end
+
+API_AVAILABLE(ios(16.0))
+@interface YKFTokenKitSlotSource: NSObject<YKFSmartCardSlotSource>
+@end
+
+@interface YKFSmartCardConnectionRegistry()
+
+/*
+ Hidden initializer to avoid the creation of multiple instances outside YubiKit.
+ */
+- (instancetype)initWithSlotSource:(id<YKFSmartCardSlotSource>)slotSource NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFSmartCardConnectionRegistry_Private_h */
@@ -0,0 +1,101 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFSmartCardConnectionRegistry_h
+#define YKFSmartCardConnectionRegistry_h
+
+#import <Foundation/Foundation.h>
+#import "YKFSmartCardConnection.h"
+
+@class YKFSmartCardConnectionRegistry;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @protocol YKFSmartCardConnectionRegistryDelegate
+ 
+ @abstract
+    Implement this protocol to get notifications when a YubiKey is attached to or removed from a smart card slot.
+ */
+@protocol YKFSmartCardConnectionRegistryDelegate <NSObject>
+
+/*!
+ @abstract
+    A YubiKey was attached to a smart card slot and its connection is open.
+ */
+- (void)smartCardConnectionRegistry:(YKFSmartCardConnectionRegistry *)registry didConnect:(YKFSmartCardConnection *)connection;
+
+/*!
+ @abstract
+    The YubiKey of the connection was removed from its slot or the registry was stopped.
+ */
+- (void)smartCardConnectionRegistry:(YKFSmartCardConnectionRegistry *)registry didDisconnect:(YKFSmartCardConnection *)connection error:(NSError *_Nullable)error;
+
+@optional
+
+/*!
+ @abstract
+    The TKSmartCard session for the key in the slot could not be started.
+ */
+- (void)smartCardConnectionRegistry:(YKFSmartCardConnectionRegistry *)registry didFailConnectingSlotNamed:(NSString *)slotName error:(NSError *)error;
+
+@end
+
+/*!
+ @class YKFSmartCardConnectionRegistry
+ 
+ @abstract
+    Tracks every attached smart card slot and keeps one YKFSmartCardConnection for each YubiKey.
+ 
+ @discussion
+    YKFSmartCardConnection connects to the first smart card slot only. The registry is used when several keys
+    are attached at the same time, like on a provisioning station with a USB-C hub. Every connection has its
+    own connection controller and serial command queue: operations on different keys run in parallel while
+    the commands sent to one key keep their order. The registry is accessed on the main thread.
+ */
+@interface YKFSmartCardConnectionRegistry: NSObject
+
+@property (nonatomic, weak, nullable) id<YKFSmartCardConnectionRegistryDelegate> delegate;
+
+/*!
+ @abstract
+    The open connections, sorted by slot name.
+ */
+@property (nonatomic, readonly) NSArray<YKFSmartCardConnection *> *connections;
+
+/*!
+ @abstract
+    Returns the open connection to the key in the slot or nil if there is none.
+ */
+- (nullable YKFSmartCardConnection *)connectionForSlotName:(NSString *)slotName;
+
+/*!
+ @abstract
+    Starts tracking the smart card slots and opens a connection to the keys already attached.
+ */
+- (void)start;
+
+/*!
+ @abstract
+    Stops tracking the smart card slots and closes all connections.
+ */
+- (void)stop;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* YKFSmartCardConnectionRegistry_h */
@@ -0,0 +1,211 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <CryptoTokenKit/CryptoTokenKit.h>
+#import "YKFSmartCardConnectionRegistry+Private.h"
+#import "YKFSmartCardConnection+Private.h"
+#import "YKFBlockMacros.h"
+#import "YKFLogger.h"
+#import "YKFAssert.h"
+
+#pragma mark - YKFTokenKitSlotSource
+
+@interface YKFTokenKitSlotSource()
+
+@property (nonatomic, copy, nullable) dispatch_block_t slotNamesHandler;
+
+@end
+
+@implementation YKFTokenKitSlotSource
+
+- (NSArray<NSString *> *)slotNames {
+    return [TKSmartCardSlotManager defaultManager].slotNames;
+}
+
+- (void)startObservingSlotNamesWithHandler:(dispatch_block_t)handler {
+    if (self.slotNamesHandler) {
+        return;
+    }
+    self.slotNamesHandler = handler;
+    [[TKSmartCardSlotManager defaultManager] addObserver:self forKeyPath:@"slotNames" options:0 context:nil];
+}
+
+- (void)stopObservingSlotNames {
+    if (!self.slotNamesHandler) {
+        return;
+    }
+    self.slotNamesHandler = nil;
+    [[TKSmartCardSlotManager defaultManager] removeObserver:self forKeyPath:@"slotNames"];
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
+    // creating the smart card has to be done on the main thread and after a slight delay
+    ykf_weak_self();
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 0.1 * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
+        ykf_safe_strong_self();
+        dispatch_block_t handler = strongSelf.slotNamesHandler;
+        if (handler) {
+            handler();
+        }
+    });
+}
+
+- (id<YKFSmartCardTransport>)makeSmartCardForSlotNamed:(NSString *)slotName {
+    TKSmartCardSlot *slot = [[TKSmartCardSlotManager defaultManager] slotNamed:slotName];
+    return [slot makeSmartCard];
+}
+
+- (void)dealloc {
+    [self stopObservingSlotNames];
+}
+
+@end
+
+#pragma mark - YKFSmartCardConnectionRegistry
+
+@interface YKFSmartCardConnectionRegistry()
+
+@property (nonatomic) id<YKFSmartCardSlotSource> slotSource;
+@property (nonatomic) BOOL isActive;
+
+@property (nonatomic) NSMutableDictionary<NSString *, YKFSmartCardConnection *> *connectionsBySlotName;
+// Slots with a smart card session being started.
+@property (nonatomic) NSMutableSet<NSString *> *pendingSlotNames;
+
+@end
+
+@implementation YKFSmartCardConnectionRegistry
+
+- (instancetype)initWithSlotSource:(id<YKFSmartCardSlotSource>)slotSource {
+    YKFAssertAbortInit(slotSource);
+    
+    self = [super init];
+    if (self) {
+        self.slotSource = slotSource;
+        self.connectionsBySlotName = [[NSMutableDictionary alloc] init];
+        self.pendingSlotNames = [[NSMutableSet alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self.slotSource stopObservingSlotNames];
+    for (YKFSmartCardConnection *connection in self.connectionsBySlotName.allValues) {
+        [connection close];
+    }
+}
+
+- (NSArray<YKFSmartCardConnection *> *)connections {
+    NSArray *slotNames = [self.connectionsBySlotName.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    return [self.connectionsBySlotName objectsForKeys:slotNames notFoundMarker:[NSNull null]];
+}
+
+- (YKFSmartCardConnection *)connectionForSlotName:(NSString *)slotName {
+    YKFParameterAssertReturnValue(slotName, nil);
+    return self.connectionsBySlotName[slotName];
+}
+
+- (void)start {
+    if (self.isActive) {
+        return;
+    }
+    self.isActive = YES;
+    
+    ykf_weak_self();
+    [self.slotSource startObservingSlotNamesWithHandler:^{
+        ykf_safe_strong_self();
+        [strongSelf updateConnections];
+    }];
+    [self updateConnections];
+}
+
+- (void)stop {
+    if (!self.isActive) {
+        return;
+    }
+    self.isActive = NO;
+    
+    [self.slotSource stopObservingSlotNames];
+    [self.pendingSlotNames removeAllObjects];
+    for (NSString *slotName in [self.connectionsBySlotName.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        [self removeConnectionForSlotName:slotName];
+    }
+}
+
+#pragma mark - Slots
+
+- (void)updateConnections {
+    if (!self.isActive) {
+        return;
+    }
+    NSSet<NSString *> *slotNames = [NSSet setWithArray:self.slotSource.slotNames ?: @[]];
+    
+    for (NSString *slotName in self.connectionsBySlotName.allKeys) {
+        if (![slotNames containsObject:slotName]) {
+            [self removeConnectionForSlotName:slotName];
+        }
+    }
+    [self.pendingSlotNames intersectSet:slotNames];
+    
+    for (NSString *slotName in slotNames) {
+        if (self.connectionsBySlotName[slotName] || [self.pendingSlotNames containsObject:slotName]) {
+            continue;
+        }
+        [self openConnectionForSlotName:slotName];
+    }
+}
+
+- (void)openConnectionForSlotName:(NSString *)slotName {
+    id<YKFSmartCardTransport> smartCard = [self.slotSource makeSmartCardForSlotNamed:slotName];
+    if (!smartCard) {
+        return;
+    }
+    [self.pendingSlotNames addObject:slotName];
+    
+    ykf_weak_self();
+    [YKFSmartCardConnectionController smartCardControllerWithTransport:smartCard completion:^(YKFSmartCardConnectionController *controller, NSError *error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            // The slot was removed or the registry stopped while the session was starting.
+            if (!strongSelf || ![strongSelf.pendingSlotNames containsObject:slotName]) {
+                [controller endSession];
+                return;
+            }
+            [strongSelf.pendingSlotNames removeObject:slotName];
+            
+            if (!controller) {
+                YKFLogInfo(@"Could not start the smart card session for slot %@.", slotName);
+                if ([strongSelf.delegate respondsToSelector:@selector(smartCardConnectionRegistry:didFailConnectingSlotNamed:error:)]) {
+                    [strongSelf.delegate smartCardConnectionRegistry:strongSelf didFailConnectingSlotNamed:slotName error:error];
+                }
+                return;
+            }
+            YKFSmartCardConnection *connection = [[YKFSmartCardConnection alloc] initWithSlotName:slotName connectionController:controller];
+            strongSelf.connectionsBySlotName[slotName] = connection;
+            [strongSelf.delegate smartCardConnectionRegistry:strongSelf didConnect:connection];
+        });
+    }];
+}
+
+- (void)removeConnectionForSlotName:(NSString *)slotName {
+    YKFSmartCardConnection *connection = self.connectionsBySlotName[slotName];
+    if (!connection) {
+        return;
+    }
+    [self.connectionsBySlotName removeObjectForKey:slotName];
+    [connection close];
+    [self.delegate smartCardConnectionRegistry:self didDisconnect:connection error:nil];
+}
+
+@end
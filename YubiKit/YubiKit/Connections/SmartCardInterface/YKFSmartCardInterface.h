@@ -14,11 +14,14 @@
 
 
 #import <Foundation/Foundation.h>
+#import "YKFCommandPriority.h"
+#import "YKFTimeoutPolicy.h"
+#import "YKFSmartCardResponseConsumer.h"
 
 #ifndef YKFSmartCardInterface_h
 #define YKFSmartCardInterface_h
 
-@class YKFAPDU, YKFSelectApplicationAPDU, YKFSCPProcessor;
+@class YKFAPDU, YKFSelectApplicationAPDU, YKFSCPProcessor, YKFCancellationToken, YKFConnectionMetrics;
 @protocol YKFConnectionControllerProtocol;
 
 typedef void (^YKFSmartCardInterfaceResponseBlock)
@@ -26,6 +29,8 @@ typedef void (^YKFSmartCardInterfaceResponseBlock)
 
 typedef void (^YKFSmartCardInterfaceCommandBlock)(void);
 
+typedef void (^YKFSmartCardInterfaceConsumerCompletionBlock)(NSError* _Nullable error);
+
 typedef NS_ENUM(NSUInteger, YKFSmartCardInterfaceSendRemainingIns) {
     
     /// The APDU instruction to read the remaining data from the Yubikey.
@@ -41,6 +46,18 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, readwrite, nullable) YKFSCPProcessor *scpProcessor;
 
+/// The token cancelled by the next cancelAllCommands of the connection. Read it once at the start of a
+/// multi-command flow (e.g. waiting for touch) to stop the flow when the commands are cancelled. Nil when the
+/// connection controller doesn't support cancellation.
+@property (nonatomic, readonly, nullable) YKFCancellationToken *cancellationToken;
+
+/// The metrics of the connection the commands are sent over, nil when the connection controller doesn't record any.
+@property (nonatomic, readonly, nullable) YKFConnectionMetrics *metrics;
+
+/// The timeout policy of the connection. The commands sent without a timeout, or with
+/// YKFTimeoutPolicyAdaptiveTimeout, get their timeout from it. Nil when the connection controller has none.
+@property (nonatomic, readonly, nullable) YKFTimeoutPolicy *timeoutPolicy;
+
 - (instancetype)init NS_UNAVAILABLE;
 
 - (instancetype)initWithConnectionController:(id<YKFConnectionControllerProtocol>)connectionController NS_DESIGNATED_INITIALIZER;
@@ -55,8 +72,22 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion;
 
+/// Cancelling the token drops the command, and any remaining GET RESPONSE commands, without calling the completion.
+- (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout cancellationToken:(nullable YKFCancellationToken *)cancellationToken completion:(YKFSmartCardInterfaceResponseBlock)completion;
+
+/// Passes the response to the consumer chunk by chunk as the GET RESPONSE commands complete, so parsing overlaps with
+/// reading the rest of the response and the response is never buffered in full. The completion is called after the
+/// consumer finished, with nil on success. Over a secure channel (SCP) the response is unwrapped as a whole and passed
+/// in a single chunk.
+- (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout consumer:(id<YKFSmartCardResponseConsumer>)consumer completion:(YKFSmartCardInterfaceConsumerCompletionBlock)completion;
+
 - (void)executeRecursiveCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout data:(NSMutableData *)data completion:(YKFSmartCardInterfaceResponseBlock)completion;
 
+/// Runs the block with the commands it queues at the priority. The commands queued by the completion of a
+/// command inherit the priority of the command, so multi-command operations started in the block keep it.
+/// The priority is ignored over a secure channel (SCP) since the commands must reach the key in order.
+- (void)performWithCommandPriority:(YKFCommandPriority)priority block:(YKFSmartCardInterfaceCommandBlock)block;
+
 - (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block;
 
 NS_ASSUME_NONNULL_END
@@ -25,7 +25,6 @@
 #import "YKFSessionError.h"
 #import "YKFBlockMacros.h"
 #import "YKFAssert.h"
-#import "YKFLogger.h"
 #import "YKFAPDUError.h"
 
 #import "YKFAPDU+Private.h"
@@ -34,15 +33,64 @@
 #import "YKFNSDataAdditions+Private.h"
 #import "YKFOATHSendRemainingAPDU.h"
 #import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Constants.h"
 #import "YKFSCPProcessor.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFEventRing+Private.h"
 
-static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
+// The priority of the commands queued by the current thread, set while running a performWithCommandPriority block
+// or the completion of a command.
+static __thread BOOL YKFHasScopedCommandPriority = NO;
+static __thread YKFCommandPriority YKFScopedCommandPriority = YKFCommandPriorityNormal;
+
+static YKFCommandPriority YKFCurrentCommandPriority(void) {
+    return YKFHasScopedCommandPriority ? YKFScopedCommandPriority : YKFCommandPriorityNormal;
+}
+
+static void YKFPerformWithCommandPriority(YKFCommandPriority priority, void (^block)(void)) {
+    BOOL hadScopedPriority = YKFHasScopedCommandPriority;
+    YKFCommandPriority previousPriority = YKFScopedCommandPriority;
+    YKFHasScopedCommandPriority = YES;
+    YKFScopedCommandPriority = priority;
+    block();
+    YKFHasScopedCommandPriority = hadScopedPriority;
+    YKFScopedCommandPriority = previousPriority;
+}
+
+// Appends the chunks of a response for the commands completed with the whole response.
+@interface YKFSmartCardResponseBuffer: NSObject<YKFSmartCardResponseConsumer>
+
+@property (nonatomic, readonly) NSMutableData *data;
+
+- (instancetype)initWithData:(NSMutableData *)data;
+
+@end
+
+@implementation YKFSmartCardResponseBuffer
+
+- (instancetype)initWithData:(NSMutableData *)data {
+    self = [super init];
+    if (self) {
+        _data = data;
+    }
+    return self;
+}
+
+- (BOOL)consumeResponseChunk:(NSData *)chunk error:(NSError **)error {
+    [self.data appendData:chunk];
+    return YES;
+}
+
+- (BOOL)finishResponseWithError:(NSError **)error {
+    return YES;
+}
+
+@end
 
 @interface YKFSmartCardInterface()
 
 @property (nonatomic, readwrite) id<YKFConnectionControllerProtocol> connectionController;
 
-- (NSData *)dataFromKeyResponse:(NSData *)response;
 - (UInt16)statusCodeFromKeyResponse:(NSData *)response;
 
 @end
@@ -58,6 +106,7 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
 }
 
 - (void)selectApplication:(YKFSelectApplicationAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion {
+    YKFEventRingRecord(YKFEventTypeSelectApplication, apdu.ins, (UInt32)apdu.data.length, 0);
     [self executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
         if (error) {
             if ([error isKindOfClass:[YKFSessionError class]]) {
@@ -79,45 +128,98 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
     }];
 }
 
+- (YKFCancellationToken *)cancellationToken {
+    if (![self.connectionController respondsToSelector:@selector(cancellationToken)]) {
+        return nil;
+    }
+    return self.connectionController.cancellationToken;
+}
+
+- (YKFConnectionMetrics *)metrics {
+    if (![self.connectionController respondsToSelector:@selector(metrics)]) {
+        return nil;
+    }
+    return self.connectionController.metrics;
+}
+
+- (YKFTimeoutPolicy *)timeoutPolicy {
+    if (![self.connectionController respondsToSelector:@selector(timeoutPolicy)]) {
+        return nil;
+    }
+    return self.connectionController.timeoutPolicy;
+}
+
 - (void)executeRecursiveCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout data:(NSMutableData *)data completion:(YKFSmartCardInterfaceResponseBlock)completion {
-    [self.connectionController execute:apdu
-                         timeout:timeout
-                            completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+    YKFCommandPriority priority = YKFCurrentCommandPriority();
+    YKFSmartCardResponseBuffer *buffer = [[YKFSmartCardResponseBuffer alloc] initWithData:data];
+    [self executeRecursiveCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout priority:priority queuePriority:priority cancellationToken:nil consumer:buffer completion:^(NSError *error) {
+        completion(error ? nil : data, error);
+    }];
+}
+
+- (void)executeRecursiveCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout priority:(YKFCommandPriority)priority queuePriority:(YKFCommandPriority)queuePriority cancellationToken:(YKFCancellationToken *)cancellationToken consumer:(id<YKFSmartCardResponseConsumer>)consumer completion:(YKFSmartCardInterfaceConsumerCompletionBlock)completion {
+    // A secure channel MACs every command with a counter when it's wrapped, so the commands must reach the key
+    // in the order they were wrapped.
+    if (self.scpProcessor && queuePriority != YKFCommandPriorityContinuation) {
+        queuePriority = YKFCommandPriorityNormal;
+    }
+    [self executeOnConnectionController:apdu priority:queuePriority timeout:timeout cancellationToken:cancellationToken completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
         if (error) {
-            completion(nil, error);
+            YKFPerformWithCommandPriority(priority, ^{
+                completion(error);
+            });
             return;
         }
 
-        [data appendData:[self dataFromKeyResponse:response]];
         UInt16 statusCode = [self statusCodeFromKeyResponse:response];
+        BOOL moreData = statusCode >> 8 == YKFAPDUErrorCodeMoreData;
+        NSError *consumerError = nil;
+        if ((moreData || statusCode == 0x9000) && response.length > 2) {
+            // The chunk is only valid during the call, so it's not copied out of the response.
+            NSData *chunk = [NSData dataWithBytesNoCopy:(void *)response.bytes length:response.length - 2 freeWhenDone:NO];
+            if (![consumer consumeResponseChunk:chunk error:&consumerError]) {
+                YKFPerformWithCommandPriority(priority, ^{
+                    completion(consumerError ?: [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult]);
+                });
+                return;
+            }
+        }
         
-        if (statusCode >> 8 == YKFAPDUErrorCodeMoreData) {
-            YKFLogInfo(@"Key has more data to send. Requesting for remaining data...");
-            UInt16 ins;
+        if (moreData) {
+            UInt8 ins;
+            YKFAPDU *sendRemainingApdu;
             switch (sendRemainingIns) {
                 case YKFSmartCardInterfaceSendRemainingInsNormal:
                     ins = 0xC0;
+                    sendRemainingApdu = YKFAPDU.getResponseAPDU;
                     break;
                 case YKFSmartCardInterfaceSendRemainingInsOATH:
                     ins = 0xA5;
+                    sendRemainingApdu = YKFAPDU.oathSendRemainingAPDU;
                     break;
             }
-            YKFAPDU *sendRemainingApdu = [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(unsigned char[]){0x00, ins, 0x00, 0x00, 0x00} length:5]];
-            // Queue a new request recursively
-            [self executeRecursiveCommand:sendRemainingApdu sendRemainingIns:sendRemainingIns timeout:timeout data:data completion:completion];
+            [self.metrics recordGetResponseChunk];
+            YKFEventRingRecord(YKFEventTypeGetResponse, ins, 0, statusCode);
+            // Queue a new request recursively, ahead of the other queued commands so the chain is not split.
+            [self executeRecursiveCommand:sendRemainingApdu sendRemainingIns:sendRemainingIns timeout:timeout priority:priority queuePriority:YKFCommandPriorityContinuation cancellationToken:cancellationToken consumer:consumer completion:completion];
             return;
-        } else if (statusCode == 0x9000) {
-            completion(data, nil);
-            return;
-        } else {
-            YKFSessionError *error = [YKFSessionError errorWithCode:statusCode];
-            completion(nil, error);
         }
+        
+        if (statusCode != 0x9000) {
+            consumerError = [YKFSessionError errorWithCode:statusCode];
+        } else if (![consumer finishResponseWithError:&consumerError]) {
+            consumerError = consumerError ?: [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult];
+        }
+        
+        // The commands queued by the completion inherit the priority of the command.
+        YKFPerformWithCommandPriority(priority, ^{
+            completion(consumerError);
+        });
     }];
 }
 
 - (void)executeCommand:(YKFAPDU *)apdu completion:(YKFSmartCardInterfaceResponseBlock)completion {
-    [self executeCommand:apdu sendRemainingIns:YKFSmartCardInterfaceSendRemainingInsNormal timeout:YKFSmartCardInterfaceDefaultTimeout completion:completion];
+    [self executeCommand:apdu sendRemainingIns:YKFSmartCardInterfaceSendRemainingInsNormal timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
 }
 
 - (void)executeCommand:(YKFAPDU *)apdu timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion {
@@ -125,21 +227,60 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
 }
 
 - (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns completion:(YKFSmartCardInterfaceResponseBlock)completion {
-    [self executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:YKFSmartCardInterfaceDefaultTimeout completion:completion];
+    [self executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
 }
 
 - (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout completion:(YKFSmartCardInterfaceResponseBlock)completion {
+    [self executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFSmartCardInterfaceResponseBlock)completion {
     YKFParameterAssertReturn(apdu);
     YKFParameterAssertReturn(completion);
     
     if (_scpProcessor) {
-        [_scpProcessor executeCommand:apdu sendRemainingIns:sendRemainingIns encrypt:YES usingSmartCardInterface:self completion:completion];
+        // The SCP processor wraps the command and drives its own GET RESPONSE chain, it's only cancelled by cancelAllCommands.
+        [_scpProcessor executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout encrypt:YES usingSmartCardInterface:self completion:completion];
     } else {
         NSMutableData *data = [NSMutableData new];
-        [self executeRecursiveCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout data:data completion:completion];
+        YKFCommandPriority priority = YKFCurrentCommandPriority();
+        YKFSmartCardResponseBuffer *buffer = [[YKFSmartCardResponseBuffer alloc] initWithData:data];
+        [self executeRecursiveCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout priority:priority queuePriority:priority cancellationToken:cancellationToken consumer:buffer completion:^(NSError *error) {
+            completion(error ? nil : data, error);
+        }];
     }
 }
 
+- (void)executeCommand:(YKFAPDU *)apdu sendRemainingIns:(YKFSmartCardInterfaceSendRemainingIns)sendRemainingIns timeout:(NSTimeInterval)timeout consumer:(id<YKFSmartCardResponseConsumer>)consumer completion:(YKFSmartCardInterfaceConsumerCompletionBlock)completion {
+    YKFParameterAssertReturn(apdu);
+    YKFParameterAssertReturn(consumer);
+    YKFParameterAssertReturn(completion);
+    
+    if (_scpProcessor) {
+        // The response MAC covers the whole response, so it's unwrapped before any of it is passed on.
+        [_scpProcessor executeCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout encrypt:YES usingSmartCardInterface:self completion:^(NSData *data, NSError *error) {
+            if (error) {
+                completion(error);
+                return;
+            }
+            NSError *consumerError = nil;
+            if ((data.length > 0 && ![consumer consumeResponseChunk:data error:&consumerError]) || ![consumer finishResponseWithError:&consumerError]) {
+                completion(consumerError ?: [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult]);
+                return;
+            }
+            completion(nil);
+        }];
+    } else {
+        YKFCommandPriority priority = YKFCurrentCommandPriority();
+        [self executeRecursiveCommand:apdu sendRemainingIns:sendRemainingIns timeout:timeout priority:priority queuePriority:priority cancellationToken:nil consumer:consumer completion:completion];
+    }
+}
+
+- (void)performWithCommandPriority:(YKFCommandPriority)priority block:(YKFSmartCardInterfaceCommandBlock)block {
+    YKFParameterAssertReturn(block);
+    YKFPerformWithCommandPriority(priority, block);
+}
+
 - (void)dispatchAfterCurrentCommands:(YKFSmartCardInterfaceCommandBlock)block {
     [self.connectionController dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
         // Return if operation is cancelled
@@ -152,15 +293,22 @@ static NSTimeInterval const YKFSmartCardInterfaceDefaultTimeout = 10.0;
 
 #pragma mark - Helpers
 
-- (NSData *)dataFromKeyResponse:(NSData *)response {
-    YKFParameterAssertReturnValue(response, [NSData data]);
-    YKFAssertReturnValue(response.length >= 2, @"Key response data is too short.", [NSData data]);
-    
-    if (response.length == 2) {
-        return [NSData data];
+- (void)executeOnConnectionController:(YKFAPDU *)apdu priority:(YKFCommandPriority)priority timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    id<YKFConnectionControllerProtocol> connectionController = self.connectionController;
+    if ([connectionController respondsToSelector:@selector(execute:priority:deadline:timeout:cancellationToken:completion:)]) {
+        [connectionController execute:apdu priority:priority deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+        return;
+    }
+    // Controllers implementing only the required methods run the commands in order and don't know the adaptive timeout.
+    YKFConnectionControllerCommandResponseBlock tokenCheckingCompletion = ^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        if (!cancellationToken.isCancelled) {
+            completion(response, error, executionTime);
+        }
+    };
+    if (timeout == YKFTimeoutPolicyAdaptiveTimeout) {
+        [connectionController execute:apdu completion:tokenCheckingCompletion];
     } else {
-        NSRange range = {0, response.length - 2};
-        return [response subdataWithRange:range];
+        [connectionController execute:apdu timeout:timeout completion:tokenCheckingCompletion];
     }
 }
 
@@ -0,0 +1,49 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @protocol YKFSmartCardResponseConsumer
+
+ @abstract
+    Receives the data of a response chunk by chunk, as the GET RESPONSE commands reading it complete, instead of
+    the whole response once it has been buffered.
+
+ @discussion
+    The chunks are passed in order, without the status word, on the queue the responses are received on. A chunk
+    ends wherever the key split the response, usually in the middle of an element, so the consumer keeps the partial
+    element until the next chunk. The chunks are only valid during the call.
+ */
+@protocol YKFSmartCardResponseConsumer <NSObject>
+
+/*!
+ @abstract
+    Consumes the next chunk of the response. Returning NO stops reading the response: the remaining chunks are not
+    requested and the command completes with the error.
+ */
+- (BOOL)consumeResponseChunk:(NSData *)chunk error:(NSError **)error;
+
+/*!
+ @abstract
+    Called after the last chunk of a successful response. Returning NO, e.g. when the response ended in the middle
+    of an element, completes the command with the error.
+ */
+- (BOOL)finishResponseWithError:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
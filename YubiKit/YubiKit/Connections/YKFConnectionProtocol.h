@@ -15,7 +15,7 @@
 #ifndef YKFConnectionProtocol_h
 #define YKFConnectionProtocol_h
 
-@class YKFOATHSession, YKFU2FSession, YKFFIDO2Session, YKFPIVSession, YKFChallengeResponseSession, YKFManagementSession, YKFSecurityDomainSession, YKFSmartCardInterface, YKFAPDU;
+@class YKFOATHSession, YKFOATHCredentialWithCode, YKFU2FSession, YKFFIDO2Session, YKFPIVSession, YKFChallengeResponseSession, YKFManagementSession, YKFSecurityDomainSession, YKFSmartCardInterface, YKFAPDU, YKFConnectionMetrics;
 @protocol YKFSCPKeyParamsProtocol;
 
 @protocol YKFConnectionProtocol<NSObject>
@@ -33,6 +33,29 @@ typedef void (^YKFOATHSessionCompletionBlock)(YKFOATHSession *_Nullable, NSError
 ///                   the YubiKey. This handler is executed on a background thread.
 - (void)oathSession:(id<YKFSCPKeyParamsProtocol> _Nonnull)scpKeyParams completion:(YKFOATHSessionCompletionBlock _Nonnull)completion;
 
+/// @abstract Returns the access key used to unlock a password protected OATH application, or nil if it is not known.
+///           The provider is called on the communication queue with the selected session, e.g. to look up the key
+///           by the deviceId of the session or to derive it with deriveAccessKey:, and must not block.
+typedef NSData *_Nullable (^YKFOATHAccessKeyProvider)(YKFOATHSession *_Nonnull);
+typedef void (^YKFOATHUnlockedSessionCompletionBlock)(YKFOATHSession *_Nullable, NSArray<YKFOATHCredentialWithCode *> *_Nullable, NSError* _Nullable);
+
+/// @abstract Returns a YKFOATHSession which is already unlocked, together with the codes of all its credentials.
+/// @discussion The VALIDATE and CALCULATE ALL commands are sent right after the application is selected, without
+///             returning to the app in between. The access key provider is only called if the OATH application
+///             is password protected. If the provider returns nil or the access key is wrong, the locked session is
+///             returned together with the error so it can be unlocked with unlockWithPassword:completion:.
+/// @param accessKeyProvider Provides the access key for the selected OATH application.
+/// @param completion The completion handler that gets called once the credentials are calculated or the unlock
+///                   failed. This handler is executed on a background thread.
+- (void)oathSessionWithAccessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion;
+
+/// @abstract Returns a YKFOATHSession which is already unlocked, together with the codes of all its credentials.
+/// @param scpKeyParams SCP key params for the session.
+/// @param accessKeyProvider Provides the access key for the selected OATH application.
+/// @param completion The completion handler that gets called once the credentials are calculated or the unlock
+///                   failed. This handler is executed on a background thread.
+- (void)oathSession:(id<YKFSCPKeyParamsProtocol> _Nonnull)scpKeyParams accessKeyProvider:(YKFOATHAccessKeyProvider _Nonnull)accessKeyProvider completion:(YKFOATHUnlockedSessionCompletionBlock _Nonnull)completion;
+
 typedef void (^YKFU2FSessionCompletionBlock)(YKFU2FSession *_Nullable, NSError* _Nullable);
 
 /// @abstract Returns a YKFU2FSession for interacting with the U2F application on the YubiKey.
@@ -113,6 +136,11 @@ typedef void (^YKFSecurityDomainSessionCompletion)(YKFSecurityDomainSession *_Nu
 ///             when none of the supplied sessions can be used.
 @property (nonatomic, readonly) YKFSmartCardInterface *_Nullable smartCardInterface;
 
+/// @abstract Latency and throughput metrics of the commands sent over the current connection.
+/// @discussion A new instance is created every time the YubiKey connects. The metrics of the last connection stay
+///             available after it's closed, until the next key connects. Nil if no key has connected yet.
+@property (nonatomic, readonly) YKFConnectionMetrics *_Nullable metrics;
+
 typedef void (^YKFRawComandCompletion)(NSData *_Nullable, NSError *_Nullable);
 
 /// @abstract Send a APDU and get the unparsed result as an NSData from the YubiKey.
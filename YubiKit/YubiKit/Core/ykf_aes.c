@@ -0,0 +1,211 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "ykf_aes.h"
+
+// The CBC calls go through a small stack buffer so long messages need no allocation.
+#define YKF_AES_CMAC_CHUNK_SIZE (16 * YKF_AES_BLOCK_SIZE)
+
+static void ykf_aes_shift_left(const uint8_t in[YKF_AES_BLOCK_SIZE], uint8_t out[YKF_AES_BLOCK_SIZE]) {
+    uint8_t carry = 0;
+    for (int i = YKF_AES_BLOCK_SIZE - 1; i >= 0; i--) {
+        uint8_t byte = in[i];
+        out[i] = (uint8_t)(byte << 1) | carry;
+        carry = byte >> 7;
+    }
+}
+
+static void ykf_aes_cmac_subkey(const uint8_t in[YKF_AES_BLOCK_SIZE], uint8_t out[YKF_AES_BLOCK_SIZE]) {
+    uint8_t msb = in[0] & 0x80;
+    ykf_aes_shift_left(in, out);
+    if (msb) {
+        out[YKF_AES_BLOCK_SIZE - 1] ^= 0x87;
+    }
+}
+
+/* CBC-MACs whole blocks into the state. */
+static ykf_status ykf_aes_cmac_process(ykf_aes_cmac_context *context, const uint8_t *data, size_t length) {
+    uint8_t chunk[YKF_AES_CMAC_CHUNK_SIZE];
+    while (length) {
+        size_t count = length < sizeof(chunk) ? length : sizeof(chunk);
+        ykf_status status = context->ops->cbc_encrypt(context->ops->context, context->key, context->key_length,
+                                                      context->state, data, count, chunk);
+        if (status != YKF_OK) {
+            ykf_secure_zero(chunk, sizeof(chunk));
+            return status;
+        }
+        memcpy(context->state, chunk + count - YKF_AES_BLOCK_SIZE, YKF_AES_BLOCK_SIZE);
+        data += count;
+        length -= count;
+    }
+    ykf_secure_zero(chunk, sizeof(chunk));
+    return YKF_OK;
+}
+
+ykf_status ykf_aes_cmac_init(ykf_aes_cmac_context *context, const ykf_aes_ops *ops, const uint8_t *key, size_t key_length) {
+    if (!context || !ops || !key || (key_length != 16 && key_length != 24 && key_length != 32)) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    context->ops = ops;
+    context->key = key;
+    context->key_length = key_length;
+    memset(context->state, 0, sizeof(context->state));
+    context->block_length = 0;
+    return YKF_OK;
+}
+
+ykf_status ykf_aes_cmac_update(ykf_aes_cmac_context *context, const uint8_t *data, size_t length) {
+    if (!context || (length && !data)) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    ykf_status status;
+    
+    // Complete the pending block, unless it may be the last one.
+    if (context->block_length) {
+        size_t count = YKF_AES_BLOCK_SIZE - context->block_length;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(context->block + context->block_length, data, count);
+        context->block_length += count;
+        data += count;
+        length -= count;
+        if (length == 0) {
+            return YKF_OK;
+        }
+        status = ykf_aes_cmac_process(context, context->block, YKF_AES_BLOCK_SIZE);
+        if (status != YKF_OK) {
+            return status;
+        }
+        context->block_length = 0;
+    }
+    
+    // Process the whole blocks but keep the last, possibly complete, block for the final step.
+    size_t tail = length % YKF_AES_BLOCK_SIZE;
+    if (tail == 0 && length) {
+        tail = YKF_AES_BLOCK_SIZE;
+    }
+    status = ykf_aes_cmac_process(context, data, length - tail);
+    if (status != YKF_OK) {
+        return status;
+    }
+    memcpy(context->block, data + length - tail, tail);
+    context->block_length = tail;
+    return YKF_OK;
+}
+
+ykf_status ykf_aes_cmac_final(ykf_aes_cmac_context *context, uint8_t mac[YKF_AES_BLOCK_SIZE]) {
+    if (!context || !mac) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    uint8_t l[YKF_AES_BLOCK_SIZE] = {0};
+    uint8_t subkey[YKF_AES_BLOCK_SIZE];
+    
+    ykf_status status = context->ops->cbc_encrypt(context->ops->context, context->key, context->key_length, NULL, l, YKF_AES_BLOCK_SIZE, l);
+    if (status == YKF_OK) {
+        ykf_aes_cmac_subkey(l, subkey);
+        if (context->block_length < YKF_AES_BLOCK_SIZE) {
+            ykf_aes_cmac_subkey(subkey, subkey);
+            context->block[context->block_length] = 0x80;
+            memset(context->block + context->block_length + 1, 0, YKF_AES_BLOCK_SIZE - context->block_length - 1);
+        }
+        for (int i = 0; i < YKF_AES_BLOCK_SIZE; i++) {
+            context->block[i] ^= subkey[i];
+        }
+        status = ykf_aes_cmac_process(context, context->block, YKF_AES_BLOCK_SIZE);
+    }
+    if (status == YKF_OK) {
+        memcpy(mac, context->state, YKF_AES_BLOCK_SIZE);
+    }
+    
+    ykf_secure_zero(l, sizeof(l));
+    ykf_secure_zero(subkey, sizeof(subkey));
+    ykf_secure_zero(context, sizeof(*context));
+    return status;
+}
+
+ykf_status ykf_aes_cmac(const ykf_aes_ops *ops, const uint8_t *key, size_t key_length,
+                        const uint8_t *data, size_t length, uint8_t mac[YKF_AES_BLOCK_SIZE]) {
+    ykf_aes_cmac_context context;
+    ykf_status status = ykf_aes_cmac_init(&context, ops, key, key_length);
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, data, length);
+    }
+    if (status == YKF_OK) {
+        return ykf_aes_cmac_final(&context, mac);
+    }
+    ykf_secure_zero(&context, sizeof(context));
+    return status;
+}
+
+size_t ykf_bit_padded_length(size_t length) {
+    return length - length % YKF_AES_BLOCK_SIZE + YKF_AES_BLOCK_SIZE;
+}
+
+ykf_status ykf_bit_pad(const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length) {
+    if ((length && !data) || !out || !out_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t padded_length = ykf_bit_padded_length(length);
+    if (out_capacity < padded_length) {
+        return YKF_ERR_BUFFER_TOO_SMALL;
+    }
+    if (length && out != data) {
+        memmove(out, data, length);
+    }
+    out[length] = 0x80;
+    memset(out + length + 1, 0, padded_length - length - 1);
+    *out_length = padded_length;
+    return YKF_OK;
+}
+
+ykf_status ykf_bit_unpad(const uint8_t *data, size_t length, size_t *unpadded_length) {
+    if ((length && !data) || !unpadded_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t index = length;
+    while (index > 0 && data[index - 1] == 0x00) {
+        index--;
+    }
+    if (index == 0 || data[index - 1] != 0x80) {
+        return YKF_ERR_INVALID_DATA;
+    }
+    *unpadded_length = index - 1;
+    return YKF_OK;
+}
+
+int ykf_constant_time_equal(const uint8_t *a, const uint8_t *b, size_t length) {
+    uint8_t result = 0;
+    for (size_t i = 0; i < length; i++) {
+        result |= a[i] ^ b[i];
+    }
+    return result == 0;
+}
+
+void ykf_secure_zero(void *buffer, size_t length) {
+    if (!buffer || !length) {
+        return;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    // A plain memset, which is vectorized, and a barrier telling the compiler the memory is read afterwards.
+    memset(buffer, 0, length);
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+#else
+    volatile uint8_t *bytes = (volatile uint8_t *)buffer;
+    while (length--) {
+        *bytes++ = 0;
+    }
+#endif
+}
@@ -0,0 +1,92 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_aes_h
+#define ykf_aes_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YKF_AES_BLOCK_SIZE 16
+
+/*
+ The AES primitive the core builds on, supplied by the platform: CommonCrypto on Apple platforms, any other
+ implementation (e.g. OpenSSL) elsewhere. Both functions process whole blocks in CBC mode without padding, with a
+ 16, 24 or 32 byte key. A NULL iv is a zero iv. in and out may be the same buffer.
+ */
+typedef struct {
+    void *context;
+    ykf_status (*cbc_encrypt)(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                              const uint8_t *in, size_t length, uint8_t *out);
+    ykf_status (*cbc_decrypt)(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                              const uint8_t *in, size_t length, uint8_t *out);
+} ykf_aes_ops;
+
+/*
+ AES-CMAC (RFC 4493) which can be fed in parts, so a MAC chain and a message are MACed without concatenating them.
+ Complete blocks are encrypted as they arrive; the last block is kept until ykf_aes_cmac_final.
+ */
+typedef struct {
+    const ykf_aes_ops *ops;
+    const uint8_t *key;
+    size_t key_length;
+    uint8_t state[YKF_AES_BLOCK_SIZE];
+    uint8_t block[YKF_AES_BLOCK_SIZE];
+    size_t block_length;
+} ykf_aes_cmac_context;
+
+ykf_status ykf_aes_cmac_init(ykf_aes_cmac_context *context, const ykf_aes_ops *ops, const uint8_t *key, size_t key_length);
+ykf_status ykf_aes_cmac_update(ykf_aes_cmac_context *context, const uint8_t *data, size_t length);
+ykf_status ykf_aes_cmac_final(ykf_aes_cmac_context *context, uint8_t mac[YKF_AES_BLOCK_SIZE]);
+
+ykf_status ykf_aes_cmac(const ykf_aes_ops *ops, const uint8_t *key, size_t key_length,
+                        const uint8_t *data, size_t length, uint8_t mac[YKF_AES_BLOCK_SIZE]);
+
+/*
+ ISO/IEC 9797-1 padding method 2: 0x80 and zero bytes up to the next block boundary. A full block is added when the
+ data already ends on a boundary.
+ */
+size_t ykf_bit_padded_length(size_t length);
+ykf_status ykf_bit_pad(const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length);
+
+/*
+ Finds the 0x80 byte which starts the padding and returns the length of the data before it.
+ */
+ykf_status ykf_bit_unpad(const uint8_t *data, size_t length, size_t *unpadded_length);
+
+/*
+ Compares two buffers in time independent of their contents. Returns 1 when they are equal.
+ */
+int ykf_constant_time_equal(const uint8_t *a, const uint8_t *b, size_t length);
+
+/*
+ Overwrites a buffer in a way the compiler does not remove as a dead store.
+ */
+void ykf_secure_zero(void *buffer, size_t length);
+
+#if defined(__APPLE__)
+/* AES operations on CommonCrypto. */
+const ykf_aes_ops *ykf_aes_commoncrypto_ops(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_aes_h */
@@ -0,0 +1,53 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ykf_aes.h"
+
+#if defined(__APPLE__)
+
+#include <CommonCrypto/CommonCrypto.h>
+
+static ykf_status ykf_commoncrypto_cbc(CCOperation operation, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                       const uint8_t *in, size_t length, uint8_t *out) {
+    if (length % YKF_AES_BLOCK_SIZE) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t moved = 0;
+    // No options: CBC without padding.
+    CCCryptorStatus status = CCCrypt(operation, kCCAlgorithmAES, 0, key, key_length, iv, in, length, out, length, &moved);
+    return status == kCCSuccess && moved == length ? YKF_OK : YKF_ERR_CRYPTO;
+}
+
+static ykf_status ykf_commoncrypto_cbc_encrypt(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                               const uint8_t *in, size_t length, uint8_t *out) {
+    (void)context;
+    return ykf_commoncrypto_cbc(kCCEncrypt, key, key_length, iv, in, length, out);
+}
+
+static ykf_status ykf_commoncrypto_cbc_decrypt(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                               const uint8_t *in, size_t length, uint8_t *out) {
+    (void)context;
+    return ykf_commoncrypto_cbc(kCCDecrypt, key, key_length, iv, in, length, out);
+}
+
+const ykf_aes_ops *ykf_aes_commoncrypto_ops(void) {
+    static const ykf_aes_ops ops = {
+        .context = NULL,
+        .cbc_encrypt = ykf_commoncrypto_cbc_encrypt,
+        .cbc_decrypt = ykf_commoncrypto_cbc_decrypt
+    };
+    return &ops;
+}
+
+#endif
@@ -0,0 +1,61 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "ykf_apdu.h"
+
+size_t ykf_apdu_encoded_length(ykf_apdu_type type, size_t data_length) {
+    if (type == YKF_APDU_TYPE_SHORT) {
+        return 4 + (data_length ? 1 + data_length : 0);
+    }
+    return 4 + 3 + data_length;
+}
+
+ykf_status ykf_apdu_encode(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2,
+                           const uint8_t *data, size_t data_length, ykf_apdu_type type,
+                           uint8_t *out, size_t out_capacity, size_t *out_length) {
+    if ((data_length && !data) || !out || !out_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (data_length > (type == YKF_APDU_TYPE_SHORT ? UINT8_MAX : UINT16_MAX)) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t length = ykf_apdu_encoded_length(type, data_length);
+    if (out_capacity < length) {
+        return YKF_ERR_BUFFER_TOO_SMALL;
+    }
+    
+    size_t offset = 0;
+    out[offset++] = cla;
+    out[offset++] = ins;
+    out[offset++] = p1;
+    out[offset++] = p2;
+    
+    if (type == YKF_APDU_TYPE_SHORT) {
+        if (data_length) {
+            out[offset++] = (uint8_t)data_length;
+        }
+    } else {
+        out[offset++] = 0x00;
+        out[offset++] = (uint8_t)(data_length >> 8);
+        out[offset++] = (uint8_t)data_length;
+    }
+    if (data_length) {
+        memcpy(out + offset, data, data_length);
+        offset += data_length;
+    }
+    
+    *out_length = offset;
+    return YKF_OK;
+}
@@ -0,0 +1,48 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_apdu_h
+#define ykf_apdu_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    YKF_APDU_TYPE_SHORT = 0,
+    YKF_APDU_TYPE_EXTENDED = 1
+} ykf_apdu_type;
+
+/*
+ The length of the encoded command: the 4 byte header, then Lc and the data when there is data. Extended commands
+ always have the 3 byte Lc, which is 0 without data.
+ */
+size_t ykf_apdu_encoded_length(ykf_apdu_type type, size_t data_length);
+
+/*
+ Encodes a command APDU into out. Short commands take at most 255 bytes of data, extended commands 65535.
+ */
+ykf_status ykf_apdu_encode(uint8_t cla, uint8_t ins, uint8_t p1, uint8_t p2,
+                           const uint8_t *data, size_t data_length, ykf_apdu_type type,
+                           uint8_t *out, size_t out_capacity, size_t *out_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_apdu_h */
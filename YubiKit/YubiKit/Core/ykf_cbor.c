@@ -0,0 +1,102 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ykf_cbor.h"
+
+size_t ykf_cbor_encode_head(uint8_t major_type, uint64_t argument, uint8_t *out) {
+    major_type &= 0xE0;
+    if (argument < 24) {
+        out[0] = major_type | (uint8_t)argument;
+        return 1;
+    }
+    
+    size_t count;
+    uint8_t additional_info;
+    if (argument <= UINT8_MAX) {
+        count = 1;
+        additional_info = 24;
+    } else if (argument <= UINT16_MAX) {
+        count = 2;
+        additional_info = 25;
+    } else if (argument <= UINT32_MAX) {
+        count = 4;
+        additional_info = 26;
+    } else {
+        count = 8;
+        additional_info = 27;
+    }
+    out[0] = major_type | additional_info;
+    for (size_t i = 0; i < count; i++) {
+        out[1 + i] = (uint8_t)(argument >> (8 * (count - 1 - i)));
+    }
+    return 1 + count;
+}
+
+size_t ykf_cbor_encode_integer(int64_t value, uint8_t *out) {
+    if (value >= 0) {
+        return ykf_cbor_encode_head(YKF_CBOR_MAJOR_TYPE_UNSIGNED, (uint64_t)value, out);
+    }
+    // -1 - value without overflowing for INT64_MIN.
+    return ykf_cbor_encode_head(YKF_CBOR_MAJOR_TYPE_NEGATIVE, ~(uint64_t)value, out);
+}
+
+ykf_status ykf_cbor_decode_head(const uint8_t *buffer, size_t length,
+                                uint8_t *major_type, uint64_t *argument, size_t *head_length) {
+    if ((length && !buffer) || !major_type || !argument || !head_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (length == 0) {
+        return YKF_ERR_NEED_MORE_DATA;
+    }
+    
+    uint8_t additional_info = buffer[0] & 0x1F;
+    uint64_t value = 0;
+    size_t count = 0;
+    
+    if (additional_info < 24) {
+        value = additional_info;
+    } else if (additional_info <= 27) {
+        count = (size_t)1 << (additional_info - 24);
+        if (length - 1 < count) {
+            return YKF_ERR_NEED_MORE_DATA;
+        }
+        for (size_t i = 0; i < count; i++) {
+            value = (value << 8) | buffer[1 + i];
+        }
+    } else {
+        return YKF_ERR_INVALID_DATA;
+    }
+    
+    *major_type = buffer[0] & 0xE0;
+    *argument = value;
+    *head_length = 1 + count;
+    return YKF_OK;
+}
+
+ykf_status ykf_cbor_decode_integer(const uint8_t *buffer, size_t length, int64_t *value, size_t *head_length) {
+    uint8_t major_type;
+    uint64_t argument;
+    if (!value) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    ykf_status status = ykf_cbor_decode_head(buffer, length, &major_type, &argument, head_length);
+    if (status != YKF_OK) {
+        return status;
+    }
+    if ((major_type != YKF_CBOR_MAJOR_TYPE_UNSIGNED && major_type != YKF_CBOR_MAJOR_TYPE_NEGATIVE) || argument > INT64_MAX) {
+        return YKF_ERR_INVALID_DATA;
+    }
+    *value = major_type == YKF_CBOR_MAJOR_TYPE_NEGATIVE ? -1 - (int64_t)argument : (int64_t)argument;
+    return YKF_OK;
+}
@@ -0,0 +1,66 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_cbor_h
+#define ykf_cbor_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The major types supported by CTAP2 canonical CBOR, already shifted into the top 3 bits of the head. */
+#define YKF_CBOR_MAJOR_TYPE_UNSIGNED        0x00
+#define YKF_CBOR_MAJOR_TYPE_NEGATIVE        0x20
+#define YKF_CBOR_MAJOR_TYPE_BYTE_STRING     0x40
+#define YKF_CBOR_MAJOR_TYPE_TEXT_STRING     0x60
+#define YKF_CBOR_MAJOR_TYPE_ARRAY           0x80
+#define YKF_CBOR_MAJOR_TYPE_MAP             0xA0
+#define YKF_CBOR_MAJOR_TYPE_SIMPLE          0xE0
+
+/* A head is the initial byte and up to 8 argument bytes. */
+#define YKF_CBOR_MAX_HEAD_LENGTH 9
+
+/*
+ Encodes the head of an item in the shortest form, as required by CTAP2 canonical CBOR. The argument is the value of
+ an unsigned integer, the encoded -1 - value of a negative integer, the length of a string or the number of elements
+ of an array or map. out must hold YKF_CBOR_MAX_HEAD_LENGTH bytes. Returns the number of bytes written.
+ */
+size_t ykf_cbor_encode_head(uint8_t major_type, uint64_t argument, uint8_t *out);
+
+/*
+ Encodes a signed integer as major type 0 or 1 in the shortest form. Returns the number of bytes written.
+ */
+size_t ykf_cbor_encode_integer(int64_t value, uint8_t *out);
+
+/*
+ Decodes the head of an item. Indefinite lengths and the reserved additional information values 28-30 are rejected.
+ Returns YKF_ERR_NEED_MORE_DATA when the buffer ends inside the head.
+ */
+ykf_status ykf_cbor_decode_head(const uint8_t *buffer, size_t length,
+                                uint8_t *major_type, uint64_t *argument, size_t *head_length);
+
+/*
+ Decodes an integer of major type 0 or 1 whose value fits an int64_t.
+ */
+ykf_status ykf_cbor_decode_integer(const uint8_t *buffer, size_t length, int64_t *value, size_t *head_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_cbor_h */
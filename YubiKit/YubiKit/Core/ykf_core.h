@@ -0,0 +1,34 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_core_h
+#define ykf_core_h
+
+/*
+ Portable C core of YubiKit: APDU encoding, BER-TLV, CBOR heads, AES-CMAC and the SCP03 secure messaging
+ transforms, OATH code formatting, PIV EC padding and a locked arena for secrets. It builds with the library on
+ Apple platforms and with CMake (see YubiKitCore) on any platform, where it is tested and benchmarked.
+ */
+
+#include "ykf_status.h"
+#include "ykf_apdu.h"
+#include "ykf_tlv.h"
+#include "ykf_cbor.h"
+#include "ykf_aes.h"
+#include "ykf_scp.h"
+#include "ykf_oath.h"
+#include "ykf_piv.h"
+#include "ykf_secure_arena.h"
+
+#endif /* ykf_core_h */
@@ -0,0 +1,37 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ykf_oath.h"
+
+ykf_status ykf_oath_format_code(const uint8_t *truncated, size_t length, uint8_t digits, char *out, size_t out_capacity) {
+    if (!truncated || !out) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (length < 4 || digits < 6 || digits > 8) {
+        return YKF_ERR_INVALID_DATA;
+    }
+    if (out_capacity < (size_t)digits + 1) {
+        return YKF_ERR_BUFFER_TOO_SMALL;
+    }
+    
+    // Remove the sign bit and keep the last [digits] digits.
+    uint32_t value = ((uint32_t)(truncated[0] & 0x7F) << 24) | ((uint32_t)truncated[1] << 16) |
+                     ((uint32_t)truncated[2] << 8) | truncated[3];
+    for (int i = digits - 1; i >= 0; i--) {
+        out[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    out[digits] = '\0';
+    return YKF_OK;
+}
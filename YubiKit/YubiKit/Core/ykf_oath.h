@@ -0,0 +1,39 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_oath_h
+#define ykf_oath_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An 8 digit code and the terminating zero. */
+#define YKF_OATH_MAX_CODE_LENGTH 9
+
+/*
+ Formats a truncated OATH response, the 4 big endian bytes after the digits byte, as a zero padded code of 6, 7 or
+ 8 digits. out must hold digits + 1 bytes.
+ */
+ykf_status ykf_oath_format_code(const uint8_t *truncated, size_t length, uint8_t digits, char *out, size_t out_capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_oath_h */
@@ -0,0 +1,30 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "ykf_piv.h"
+
+ykf_status ykf_piv_pad_ec_hash(const uint8_t *hash, size_t hash_length, size_t key_size, uint8_t *out) {
+    if ((hash_length && !hash) || !out || key_size == 0) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (hash_length >= key_size) {
+        memmove(out, hash, key_size);
+    } else {
+        size_t padding = key_size - hash_length;
+        memmove(out + padding, hash, hash_length);
+        memset(out, 0, padding);
+    }
+    return YKF_OK;
+}
@@ -0,0 +1,36 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_piv_h
+#define ykf_piv_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ Fits a hash to the size of an EC key before signing: a longer hash keeps its leftmost key_size bytes and a
+ shorter one is padded with leading zeros. out must hold key_size bytes.
+ */
+ykf_status ykf_piv_pad_ec_hash(const uint8_t *hash, size_t hash_length, size_t key_size, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_piv_h */
@@ -0,0 +1,140 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "ykf_scp.h"
+
+static ykf_status ykf_scp_iv(const ykf_aes_ops *ops, const uint8_t *senc, size_t key_length, uint8_t first_byte,
+                             uint32_t counter, uint8_t iv[YKF_AES_BLOCK_SIZE]) {
+    memset(iv, 0, YKF_AES_BLOCK_SIZE);
+    iv[0] = first_byte;
+    iv[12] = (uint8_t)(counter >> 24);
+    iv[13] = (uint8_t)(counter >> 16);
+    iv[14] = (uint8_t)(counter >> 8);
+    iv[15] = (uint8_t)counter;
+    return ops->cbc_encrypt(ops->context, senc, key_length, NULL, iv, YKF_AES_BLOCK_SIZE, iv);
+}
+
+ykf_status ykf_scp_encrypt(const ykf_aes_ops *ops, const uint8_t *senc, size_t key_length, uint32_t counter,
+                           const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length) {
+    if (!ops || !senc || !out_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t padded_length;
+    ykf_status status = ykf_bit_pad(data, length, out, out_capacity, &padded_length);
+    if (status != YKF_OK) {
+        return status;
+    }
+    
+    uint8_t iv[YKF_AES_BLOCK_SIZE];
+    status = ykf_scp_iv(ops, senc, key_length, 0x00, counter, iv);
+    if (status == YKF_OK) {
+        status = ops->cbc_encrypt(ops->context, senc, key_length, iv, out, padded_length, out);
+    }
+    ykf_secure_zero(iv, sizeof(iv));
+    if (status != YKF_OK) {
+        ykf_secure_zero(out, padded_length);
+        return status;
+    }
+    *out_length = padded_length;
+    return YKF_OK;
+}
+
+ykf_status ykf_scp_decrypt(const ykf_aes_ops *ops, const uint8_t *senc, size_t key_length, uint32_t counter,
+                           const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length) {
+    if (!ops || !senc || (length && !data) || !out || !out_length) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (length % YKF_AES_BLOCK_SIZE) {
+        return YKF_ERR_INVALID_DATA;
+    }
+    if (out_capacity < length) {
+        return YKF_ERR_BUFFER_TOO_SMALL;
+    }
+    
+    uint8_t iv[YKF_AES_BLOCK_SIZE];
+    ykf_status status = ykf_scp_iv(ops, senc, key_length, 0x80, counter, iv);
+    if (status == YKF_OK) {
+        status = ops->cbc_decrypt(ops->context, senc, key_length, iv, data, length, out);
+    }
+    ykf_secure_zero(iv, sizeof(iv));
+    if (status == YKF_OK) {
+        status = ykf_bit_unpad(out, length, out_length);
+    }
+    if (status != YKF_OK) {
+        ykf_secure_zero(out, length);
+    }
+    return status;
+}
+
+ykf_status ykf_scp_mac(const ykf_aes_ops *ops, const uint8_t *smac, size_t key_length,
+                       uint8_t mac_chain[YKF_AES_BLOCK_SIZE], const uint8_t *data, size_t length,
+                       uint8_t mac[YKF_SCP_MAC_LENGTH]) {
+    if (!mac_chain || !mac) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    ykf_aes_cmac_context context;
+    uint8_t chain[YKF_AES_BLOCK_SIZE];
+    ykf_status status = ykf_aes_cmac_init(&context, ops, smac, key_length);
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, mac_chain, YKF_AES_BLOCK_SIZE);
+    }
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, data, length);
+    }
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_final(&context, chain);
+    }
+    if (status == YKF_OK) {
+        memcpy(mac_chain, chain, YKF_AES_BLOCK_SIZE);
+        memcpy(mac, chain, YKF_SCP_MAC_LENGTH);
+    }
+    ykf_secure_zero(&context, sizeof(context));
+    ykf_secure_zero(chain, sizeof(chain));
+    return status;
+}
+
+ykf_status ykf_scp_unmac(const ykf_aes_ops *ops, const uint8_t *srmac, size_t key_length,
+                         const uint8_t mac_chain[YKF_AES_BLOCK_SIZE], const uint8_t *data, size_t length, uint16_t sw) {
+    if (!mac_chain || !data) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    if (length < YKF_SCP_MAC_LENGTH) {
+        return YKF_ERR_INVALID_DATA;
+    }
+    size_t message_length = length - YKF_SCP_MAC_LENGTH;
+    uint8_t sw_bytes[2] = {(uint8_t)(sw >> 8), (uint8_t)sw};
+    
+    ykf_aes_cmac_context context;
+    uint8_t rmac[YKF_AES_BLOCK_SIZE];
+    ykf_status status = ykf_aes_cmac_init(&context, ops, srmac, key_length);
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, mac_chain, YKF_AES_BLOCK_SIZE);
+    }
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, data, message_length);
+    }
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_update(&context, sw_bytes, sizeof(sw_bytes));
+    }
+    if (status == YKF_OK) {
+        status = ykf_aes_cmac_final(&context, rmac);
+    }
+    if (status == YKF_OK && !ykf_constant_time_equal(rmac, data + message_length, YKF_SCP_MAC_LENGTH)) {
+        status = YKF_ERR_MAC_MISMATCH;
+    }
+    ykf_secure_zero(&context, sizeof(context));
+    ykf_secure_zero(rmac, sizeof(rmac));
+    return status;
+}
@@ -0,0 +1,62 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_scp_h
+#define ykf_scp_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+#include "ykf_aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YKF_SCP_MAC_LENGTH 8
+
+/*
+ Encrypts command data with S-ENC: bit padding, then AES-CBC with the encrypted counter as the iv. out must hold
+ ykf_bit_padded_length(length) bytes. The caller increments the counter after each command.
+ */
+ykf_status ykf_scp_encrypt(const ykf_aes_ops *ops, const uint8_t *senc, size_t key_length, uint32_t counter,
+                           const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length);
+
+/*
+ Decrypts response data with S-ENC, using the counter of the command the response belongs to, and removes the
+ padding. out must hold length bytes.
+ */
+ykf_status ykf_scp_decrypt(const ykf_aes_ops *ops, const uint8_t *senc, size_t key_length, uint32_t counter,
+                           const uint8_t *data, size_t length, uint8_t *out, size_t out_capacity, size_t *out_length);
+
+/*
+ Computes the C-MAC of a command: mac_chain is replaced by the CMAC of mac_chain || data with S-MAC, and its first
+ 8 bytes are the MAC.
+ */
+ykf_status ykf_scp_mac(const ykf_aes_ops *ops, const uint8_t *smac, size_t key_length,
+                       uint8_t mac_chain[YKF_AES_BLOCK_SIZE], const uint8_t *data, size_t length,
+                       uint8_t mac[YKF_SCP_MAC_LENGTH]);
+
+/*
+ Verifies the R-MAC at the end of response data: the CMAC of mac_chain || data || sw with S-RMAC. The response data
+ is the first length - YKF_SCP_MAC_LENGTH bytes. Returns YKF_ERR_MAC_MISMATCH when the MAC is wrong.
+ */
+ykf_status ykf_scp_unmac(const ykf_aes_ops *ops, const uint8_t *srmac, size_t key_length,
+                         const uint8_t mac_chain[YKF_AES_BLOCK_SIZE], const uint8_t *data, size_t length, uint16_t sw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_scp_h */
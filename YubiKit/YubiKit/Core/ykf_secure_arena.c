@@ -0,0 +1,99 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ykf_secure_arena.h"
+#include "ykf_aes.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+ykf_status ykf_secure_arena_init(ykf_secure_arena *arena, size_t capacity) {
+    if (!arena || !capacity) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t page = page_size > 0 ? (size_t)page_size : 4096;
+    if (capacity > SIZE_MAX - page) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t mapped = (capacity + page - 1) / page * page;
+    
+    void *base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return YKF_ERR_OUT_OF_MEMORY;
+    }
+#if defined(MADV_DONTDUMP)
+    // Keep the secrets out of core dumps where the platform supports it.
+    madvise(base, mapped, MADV_DONTDUMP);
+#endif
+    
+    arena->base = base;
+    arena->capacity = mapped;
+    arena->used = 0;
+    // Locking fails when RLIMIT_MEMLOCK is exhausted; the arena still zeroes, it may just be paged out.
+    arena->locked = mlock(base, mapped) == 0;
+    return YKF_OK;
+}
+
+void ykf_secure_arena_destroy(ykf_secure_arena *arena) {
+    if (!arena || !arena->base) {
+        return;
+    }
+    ykf_secure_zero(arena->base, arena->used);
+    if (arena->locked) {
+        munlock(arena->base, arena->capacity);
+    }
+    munmap(arena->base, arena->capacity);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+    arena->locked = 0;
+}
+
+size_t ykf_secure_arena_mark(const ykf_secure_arena *arena) {
+    return arena ? arena->used : 0;
+}
+
+void *ykf_secure_arena_alloc(ykf_secure_arena *arena, size_t length) {
+    if (!arena || !arena->base || !length) {
+        return NULL;
+    }
+    size_t start = (arena->used + YKF_SECURE_ARENA_ALIGNMENT - 1) & ~(size_t)(YKF_SECURE_ARENA_ALIGNMENT - 1);
+    if (start > arena->capacity || length > arena->capacity - start) {
+        return NULL;
+    }
+    arena->used = start + length;
+    // Released memory is zeroed and fresh pages are zero filled, so the bytes are already zero.
+    return arena->base + start;
+}
+
+void ykf_secure_arena_release(ykf_secure_arena *arena, size_t mark) {
+    if (!arena || !arena->base || mark >= arena->used) {
+        return;
+    }
+    ykf_secure_zero(arena->base + mark, arena->used - mark);
+    arena->used = mark;
+}
+
+int ykf_secure_arena_contains(const ykf_secure_arena *arena, const void *pointer) {
+    if (!arena || !arena->base || !pointer) {
+        return 0;
+    }
+    uintptr_t address = (uintptr_t)pointer;
+    uintptr_t base = (uintptr_t)arena->base;
+    return address >= base && address - base < arena->capacity;
+}
@@ -0,0 +1,65 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_secure_arena_h
+#define ykf_secure_arena_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Allocations are aligned to this many bytes. */
+#define YKF_SECURE_ARENA_ALIGNMENT 16
+
+/*
+ A bump allocator for PINs, keys and session secrets. The memory is mapped once, locked so that it is not paged
+ out when the platform allows it, and never returned to the system allocator while the arena lives. Scopes are
+ LIFO: take a mark, allocate, and release to the mark, which zeroes everything allocated since in a single pass.
+ The arena is not thread safe.
+ */
+typedef struct {
+    uint8_t *base;
+    size_t capacity;
+    size_t used;
+    /* Non zero when the pages could be locked in memory. */
+    int locked;
+} ykf_secure_arena;
+
+/* Maps at least capacity bytes, rounded up to whole pages, and tries to lock them. */
+ykf_status ykf_secure_arena_init(ykf_secure_arena *arena, size_t capacity);
+
+/* Zeroes, unlocks and unmaps the arena. */
+void ykf_secure_arena_destroy(ykf_secure_arena *arena);
+
+/* The current top of the arena, to be passed to ykf_secure_arena_release at the end of a scope. */
+size_t ykf_secure_arena_mark(const ykf_secure_arena *arena);
+
+/* Returns length zeroed bytes, or NULL when the arena is exhausted. */
+void *ykf_secure_arena_alloc(ykf_secure_arena *arena, size_t length);
+
+/* Zeroes everything allocated since mark and makes it available again. */
+void ykf_secure_arena_release(ykf_secure_arena *arena, size_t mark);
+
+/* Non zero when pointer points into the arena. */
+int ykf_secure_arena_contains(const ykf_secure_arena *arena, const void *pointer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_secure_arena_h */
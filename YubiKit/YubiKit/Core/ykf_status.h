@@ -0,0 +1,34 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_status_h
+#define ykf_status_h
+
+/*
+ Result codes of the portable protocol core. The core has no dependencies beyond the C standard library and, for
+ the secure arena, POSIX memory mapping; the Objective-C classes wrap these functions and turn the failures into
+ nil results or NSErrors.
+ */
+typedef enum {
+    YKF_OK = 0,
+    YKF_ERR_INVALID_ARGUMENT = -1,
+    YKF_ERR_BUFFER_TOO_SMALL = -2,
+    YKF_ERR_INVALID_DATA = -3,
+    YKF_ERR_NEED_MORE_DATA = -4,
+    YKF_ERR_CRYPTO = -5,
+    YKF_ERR_MAC_MISMATCH = -6,
+    YKF_ERR_OUT_OF_MEMORY = -7
+} ykf_status;
+
+#endif /* ykf_status_h */
@@ -0,0 +1,101 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ykf_tlv.h"
+
+ykf_status ykf_tlv_parse_header(const uint8_t *buffer, size_t length, ykf_tlv_header *header) {
+    if ((length && !buffer) || !header) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    size_t offset = 0;
+    
+    // tag
+    if (length == 0) {
+        return YKF_ERR_NEED_MORE_DATA;
+    }
+    ykf_tlv_tag tag = buffer[offset++];
+    if ((tag & 0x1F) == 0x1F) {
+        uint8_t byte;
+        do {
+            if (offset >= sizeof(ykf_tlv_tag)) {
+                return YKF_ERR_INVALID_DATA;
+            }
+            if (offset >= length) {
+                return YKF_ERR_NEED_MORE_DATA;
+            }
+            byte = buffer[offset++];
+            tag = (tag << 8) | byte;
+        } while (byte & 0x80);
+    }
+    
+    // length
+    if (offset >= length) {
+        return YKF_ERR_NEED_MORE_DATA;
+    }
+    size_t value_length = buffer[offset++];
+    if (value_length == 0x80) {
+        return YKF_ERR_INVALID_DATA;
+    } else if (value_length > 0x80) {
+        size_t length_of_length = value_length - 0x80;
+        if (length_of_length > sizeof(size_t)) {
+            return YKF_ERR_INVALID_DATA;
+        }
+        if (length - offset < length_of_length) {
+            return YKF_ERR_NEED_MORE_DATA;
+        }
+        value_length = 0;
+        for (size_t i = 0; i < length_of_length; i++) {
+            value_length = (value_length << 8) | buffer[offset++];
+        }
+    }
+    
+    header->tag = tag;
+    header->header_length = offset;
+    header->value_length = value_length;
+    return YKF_OK;
+}
+
+ykf_status ykf_tlv_parse_record(const uint8_t *buffer, size_t length, ykf_tlv_header *header) {
+    ykf_status status = ykf_tlv_parse_header(buffer, length, header);
+    if (status != YKF_OK) {
+        return status;
+    }
+    if (length - header->header_length < header->value_length) {
+        return YKF_ERR_NEED_MORE_DATA;
+    }
+    return YKF_OK;
+}
+
+static size_t ykf_encode_stripped(uint64_t value, uint8_t *out) {
+    size_t count = 1;
+    while (count < sizeof(value) && (value >> (8 * count))) {
+        count++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (uint8_t)(value >> (8 * (count - 1 - i)));
+    }
+    return count;
+}
+
+size_t ykf_tlv_encode_header(ykf_tlv_tag tag, size_t value_length, uint8_t *out) {
+    size_t offset = ykf_encode_stripped(tag, out);
+    if (value_length < 0x80) {
+        out[offset++] = (uint8_t)value_length;
+    } else {
+        size_t count = ykf_encode_stripped(value_length, out + offset + 1);
+        out[offset] = (uint8_t)(0x80 | count);
+        offset += 1 + count;
+    }
+    return offset;
+}
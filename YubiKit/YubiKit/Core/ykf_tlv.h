@@ -0,0 +1,60 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ykf_tlv_h
+#define ykf_tlv_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ykf_status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint64_t ykf_tlv_tag;
+
+/* The longest header: an 8 byte tag and a length with 8 length bytes. */
+#define YKF_TLV_MAX_HEADER_LENGTH (8 + 1 + 8)
+
+typedef struct {
+    ykf_tlv_tag tag;
+    /* The length of the tag and length fields; the value starts at this offset. */
+    size_t header_length;
+    size_t value_length;
+} ykf_tlv_header;
+
+/*
+ Parses the tag and length of a BER-TLV record. Tags are at most 8 bytes and lengths must be definite and fit a
+ size_t. Returns YKF_ERR_NEED_MORE_DATA when the buffer ends inside the header.
+ */
+ykf_status ykf_tlv_parse_header(const uint8_t *buffer, size_t length, ykf_tlv_header *header);
+
+/*
+ Parses the header of a record and checks that its value is within the buffer. Returns YKF_ERR_NEED_MORE_DATA when
+ the buffer ends inside the record.
+ */
+ykf_status ykf_tlv_parse_record(const uint8_t *buffer, size_t length, ykf_tlv_header *header);
+
+/*
+ Encodes the tag and length of a record into out, which must hold YKF_TLV_MAX_HEADER_LENGTH bytes, with the tag
+ and long form length stripped of leading zero bytes. Returns the number of bytes written.
+ */
+size_t ykf_tlv_encode_header(ykf_tlv_tag tag, size_t value_length, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ykf_tlv_h */
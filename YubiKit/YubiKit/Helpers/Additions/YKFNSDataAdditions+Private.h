@@ -39,8 +39,6 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSData *)ykf_aes256DecryptedDataWithKey:(NSData *)key;
 - (nullable NSData *)ykf_aes256Operation:(CCOperation)operation withKey:(NSData *)key;
 
-- (nullable NSData *)ykf_fido2PaddedPinData;
-
 @end
 
 @interface NSData (NSDATA_PIVAdditions)
@@ -85,6 +83,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSString *)ykf_hexadecimalString;
 
+/*!
+ @method ykf_dataWithHexadecimalString:
+ 
+ @return
+    A data object from a string of hex symbols (upper or lower case) or nil if the string is not valid hex.
+ */
++ (nullable NSData *)ykf_dataWithHexadecimalString:(NSString *)hexString;
+
 @end
 
 
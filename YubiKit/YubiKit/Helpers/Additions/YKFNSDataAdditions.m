@@ -15,7 +15,9 @@
 #import <Foundation/Foundation.h>
 #import "YKFNSDataAdditions.h"
 #import "YKFNSDataAdditions+Private.h"
-#import "MF_Base32Additions.h"
+#import "YKFCodec.h"
+#import "ykf_aes.h"
+#import "ykf_oath.h"
 
 #pragma mark - SHA
 
@@ -53,7 +55,9 @@
     UInt8 keyLength = 16; // use only 16 bytes
     UInt8 key[keyLength];
     CCKeyDerivationPBKDF(kCCPBKDF2, self.bytes, self.length, salt.bytes, salt.length, kCCPRFHmacAlgSHA1, 1000, key, keyLength);
-    return [NSData dataWithBytes:key length:keyLength];
+    NSMutableData *derivedKey = [NSMutableData dataWithBytes:key length:keyLength];
+    ykf_secure_zero(key, keyLength);
+    return derivedKey;
 }
 
 - (NSData *)ykf_oathHMACWithKey:(NSData *)key {
@@ -76,26 +80,11 @@
         return nil;
     }
     
-    UInt32 otpResponseValue = CFSwapInt32BigToHost(*((UInt32 *)&self.bytes[index]));
-    otpResponseValue &= 0x7FFFFFFF; // remove first bit (sign bit)
-    
-    UInt32 modMask = pow(10, digits); // get last [digits] only
-    otpResponseValue = otpResponseValue % modMask;
-    
-    NSString *otp = nil;
-    
-    // Format with 0 paddigs up to [digits] number
-    if (digits == 6) {
-        otp = [NSString stringWithFormat:@"%06d", (unsigned int)otpResponseValue];
-    } else if (digits == 7){
-        otp = [NSString stringWithFormat:@"%07d", (unsigned int)otpResponseValue];
-    } else if (digits == 8){
-        otp = [NSString stringWithFormat:@"%08d", (unsigned int)otpResponseValue];
-    } else {
+    char otp[YKF_OATH_MAX_CODE_LENGTH];
+    if (ykf_oath_format_code((const UInt8 *)self.bytes + index, sizeof(UInt32), digits, otp, sizeof(otp)) != YKF_OK) {
         return nil;
     }
-    
-    return otp;
+    return [NSString stringWithUTF8String:otp];
 }
 
 @end
@@ -150,32 +139,6 @@
     return nil;
 }
 
-- (NSData *)ykf_fido2PaddedPinData {
-    if (!self.length) {
-        return nil;
-    }
-    if (self.length == 64) {
-        return self;
-    }
-    if ((self.length > 64) && (self.length % 16 == 0)) {
-        return self;
-    }
-    
-    NSMutableData *mutableData = [[NSMutableData alloc] initWithData:self];
-    NSUInteger lengthToIncrease = 0;
-    if (self.length < 64) {
-        lengthToIncrease = 64 - self.length;
-    } else {
-        lengthToIncrease = 16 - self.length % 16;
-    }
-    
-    if (lengthToIncrease) {
-        [mutableData increaseLengthBy:lengthToIncrease];
-    }
-    
-    return [mutableData copy];
-}
-
 @end
 
 #pragma mark - PIV
@@ -278,43 +241,11 @@
 @implementation NSData(NSDATA_AESCMAC)
 
 - (NSData *)ykf_aesCMACWithKey:(NSData *)key {
-    NSData *constZero = [NSData dataWithBytes:(UInt8[]){0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00} length:16];
-    NSData *constRb = [NSData dataWithBytes:(UInt8[]){0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x87} length:16];
-    NSInteger blockSize = 16;
-    CCAlgorithm algorithm = kCCAlgorithmAES128;
-    NSData *iv = constZero.copy;
-    
-    NSData *l = [constZero ykf_cryptOperation:kCCEncrypt algorithm:algorithm mode:kCCModeCBC key:key iv:iv];
-    NSData *subKey1 = [l ykf_shiftedLeftByOne];
-    if (((const uint8_t *)l.bytes)[0] & 0x80) {
-        subKey1 = [constRb ykf_xorWithKey:subKey1];
-    }
-    NSData *subKey2 = [subKey1 ykf_shiftedLeftByOne];
-    if (((const uint8_t *)subKey1.bytes)[0] & 0x80) {
-        subKey2 = [constRb ykf_xorWithKey:subKey2];
-    }
-    
-    BOOL lastBlockIsComplete = (self.length % blockSize == 0) && (self.length > 0);
-    
-    NSData *paddedData;
-    NSData *lastIv;
-    if (lastBlockIsComplete) {
-        lastIv = subKey1;
-        paddedData = self;
-    } else {
-        lastIv = subKey2;
-        paddedData = [self ykf_bitPadded];
-    }
-    NSData *messageSkippingLastBlock = [paddedData subdataWithRange:NSMakeRange(0, paddedData.length - blockSize)];
-    NSData *lastBlock = [paddedData subdataWithRange:NSMakeRange(messageSkippingLastBlock.length, paddedData.length - messageSkippingLastBlock.length)];
-    if (messageSkippingLastBlock.length != 0) {
-        // CBC encrypt the message (minus the last block) with a zero IV, and keep only the last block:
-        NSData *encryptedData = [messageSkippingLastBlock ykf_cryptOperation:kCCEncrypt algorithm:algorithm mode:kCCModeCBC key:key iv:iv];
-        NSData *encryptedBlock = [encryptedData subdataWithRange:NSMakeRange(messageSkippingLastBlock.length - blockSize, blockSize)];
-        lastIv = [lastIv ykf_xorWithKey:encryptedBlock];
+    UInt8 mac[YKF_AES_BLOCK_SIZE];
+    if (ykf_aes_cmac(ykf_aes_commoncrypto_ops(), key.bytes, key.length, self.bytes, self.length, mac) != YKF_OK) {
+        return nil;
     }
-    
-    return [lastBlock ykf_cryptOperation:kCCEncrypt algorithm:algorithm mode:kCCModeCBC key:key iv:lastIv];
+    return [NSData dataWithBytes:mac length:YKF_AES_BLOCK_SIZE];
 }
 
 - (NSData *)ykf_cryptOperation:(CCOperation)operation algorithm:(CCAlgorithm)algorithm mode:(CCMode)mode key:(NSData *)key iv:(NSData *)iv {
@@ -406,36 +337,15 @@
 }
 
 - (NSData *)ykf_bitPadded {
-    NSUInteger msgLength = self.length;
-    NSUInteger blockSize = 16;
-    
-    NSMutableData *paddedData = [self mutableCopy];
-    uint8_t paddingByte = 0x80;
-    [paddedData appendBytes:&paddingByte length:1];
-    NSUInteger paddingLength;
-    if (msgLength % blockSize < blockSize) {
-        paddingLength = blockSize - 1 - (msgLength % blockSize);
-    } else {
-        paddingLength = (blockSize * 2) - 1 - (msgLength % blockSize);
-    }
-    [paddedData increaseLengthBy:paddingLength];
-
+    NSMutableData *paddedData = [NSMutableData dataWithLength:ykf_bit_padded_length(self.length)];
+    size_t paddedLength = 0;
+    ykf_bit_pad(self.bytes, self.length, paddedData.mutableBytes, paddedData.length, &paddedLength);
     return [NSData dataWithData:paddedData];
 }
 
-
 - (BOOL)ykf_constantTimeCompareWithData:(NSData *)data {
     if (self.length != data.length) return NO;
-    
-    uint8_t result = 0;
-    const uint8_t *d1 = self.bytes;
-    const uint8_t *d2 = data.bytes;
-    
-    for (NSUInteger i = 0; i < self.length; i++) {
-        result |= d1[i] ^ d2[i];
-    }
-    
-    return result == 0;
+    return ykf_constant_time_equal(self.bytes, data.bytes, self.length);
 }
 
 @end
@@ -460,33 +370,47 @@
 
 @end
 
+#pragma mark - Encoding helpers
+
+/*
+ Runs an encoding kernel into a single buffer which is handed over to the string without copying it.
+ */
+static NSString *YKFEncodedString(NSData *data, size_t encodedLength, void (*encode)(const uint8_t *, size_t, char *)) {
+    if (encodedLength == 0) {
+        return @"";
+    }
+    char *buffer = malloc(encodedLength);
+    if (!buffer) {
+        return @"";
+    }
+    encode(data.bytes, data.length, buffer);
+    return [[NSString alloc] initWithBytesNoCopy:buffer length:encodedLength encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
+
 #pragma mark - WebSafe Base64
 
 @implementation NSData(NSData_WebSafeBase64)
 
 - (instancetype)ykf_initWithWebsafeBase64EncodedString:(NSString *)websafeBase64EncodedData dataLength:(NSUInteger)dataLen {
-    if (!websafeBase64EncodedData) {
+    const char *characters = [websafeBase64EncodedData cStringUsingEncoding:NSASCIIStringEncoding];
+    if (!characters) {
         return nil;
     }
-    NSMutableString *base64EncodedString = [[NSMutableString alloc] initWithString:websafeBase64EncodedData];
-    [base64EncodedString replaceOccurrencesOfString:@"-" withString:@"+" options:0 range:NSMakeRange(0, [base64EncodedString length])];
-    [base64EncodedString replaceOccurrencesOfString:@"_" withString:@"/" options:0 range:NSMakeRange(0, [base64EncodedString length])];
-    if ((dataLen % 3) == 1){
-        [base64EncodedString appendString:@"=="];
+    NSUInteger length = websafeBase64EncodedData.length;
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:YKFBase64URLDecodedMaxLength(length)];
+    size_t decodedLength = 0;
+    if (!YKFBase64URLDecode(characters, length, data.mutableBytes, &decodedLength)) {
+        return nil;
     }
-    else if ((dataLen % 3) == 2) {
-        [base64EncodedString appendString:@"="];
+    // The padding used to be derived from the expected length, so strings which do not match it are rejected.
+    if (decodedLength % 3 != dataLen % 3) {
+        return nil;
     }
-    return [self initWithBase64EncodedString:base64EncodedString options:0];
+    return [self initWithBytes:data.bytes length:decodedLength];
 }
 
 - (NSString *)ykf_websafeBase64EncodedString {
-    NSMutableString *base64 = [[NSMutableString alloc] initWithString:[self base64EncodedStringWithOptions:0]];
-    [base64 replaceOccurrencesOfString:@"+" withString:@"-" options:0 range:NSMakeRange(0, [base64 length])];
-    [base64 replaceOccurrencesOfString:@"/" withString:@"_" options:0 range:NSMakeRange(0, [base64 length])];
-    [base64 replaceOccurrencesOfString:@"=" withString:@"" options:0 range:NSMakeRange(0, [base64 length])];
-    
-    return [NSString stringWithString:base64];
+    return YKFEncodedString(self, YKFBase64URLEncodedLength(self.length), YKFBase64URLEncode);
 }
 
 @end
@@ -510,17 +434,22 @@
 @implementation NSData(NSData_Base32Additions)
 
 + (NSData *)ykf_dataWithBase32String:(NSString *)base32String {
-    NSRange range = NSMakeRange(0, [base32String length]);
-    NSError *error = NULL;
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern: @"[A-Za-z2-7=]*" options: 0 error: &error];
-    NSRange foundRange = [regex rangeOfFirstMatchInString: base32String options: 0 range: range];
-    if (!NSEqualRanges(range, foundRange)) return nil;
-    
-    return [self dataWithBase32String: base32String];
+    const char *characters = [base32String cStringUsingEncoding:NSASCIIStringEncoding];
+    if (!characters) {
+        return nil;
+    }
+    NSUInteger length = base32String.length;
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:YKFBase32DecodedMaxLength(length)];
+    size_t decodedLength = 0;
+    if (!YKFBase32Decode(characters, length, data.mutableBytes, &decodedLength)) {
+        return nil;
+    }
+    data.length = decodedLength;
+    return data;
 }
 
 - (NSString *)ykf_base32String {
-    return [self base32String];
+    return YKFEncodedString(self, YKFBase32EncodedLength(self.length), YKFBase32Encode);
 }
 
 @end
@@ -529,21 +458,21 @@
 
 @implementation NSData (NSData_HexConversion)
 
-- (NSString *)ykf_hexadecimalString
-{
-    /* Returns hexadecimal string of NSData. Empty string if data is empty. */
-    const unsigned char *dataBuffer = (const unsigned char *)[self bytes];
-    if (!dataBuffer) {
-        return [NSString string];
-    }
+- (NSString *)ykf_hexadecimalString {
+    return YKFEncodedString(self, YKFHexEncodedLength(self.length), YKFHexEncode);
+}
 
-    NSUInteger          dataLength  = [self length];
-    NSMutableString     *hexString  = [NSMutableString stringWithCapacity:(dataLength * 2)];
-    for (int i = 0; i < dataLength; ++i) {
-        [hexString appendFormat:@"%02x", (unsigned int)dataBuffer[i]];
++ (NSData *)ykf_dataWithHexadecimalString:(NSString *)hexString {
+    const char *characters = [hexString cStringUsingEncoding:NSASCIIStringEncoding];
+    if (!characters) {
+        return nil;
     }
-
-    return [NSString stringWithString:hexString];
+    NSUInteger length = hexString.length;
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:length / 2];
+    if (!YKFHexDecode(characters, length, data.mutableBytes)) {
+        return nil;
+    }
+    return data;
 }
 
 @end
@@ -0,0 +1,76 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef YKFCodec_h
+#define YKFCodec_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ Table driven hex, Base32 (RFC 4648) and websafe Base64 (base64url without padding) kernels working on raw buffers.
+
+ The encoders write exactly the number of characters returned by the matching length function and do not
+ NUL-terminate the output. The decoders write at most the number of bytes returned by the matching maximum length
+ function, set the decoded length and return false if the input contains a character outside of the alphabet.
+ */
+
+static inline size_t YKFHexEncodedLength(size_t length) {
+    return length * 2;
+}
+
+void YKFHexEncode(const uint8_t *bytes, size_t length, char *output);
+
+/*
+ Accepts upper and lower case digits. The input length must be even.
+ */
+bool YKFHexDecode(const char *input, size_t length, uint8_t *output);
+
+static inline size_t YKFBase32EncodedLength(size_t length) {
+    return (length + 4) / 5 * 8;
+}
+
+/*
+ Encodes with upper case letters and '=' padding to a multiple of 8 characters.
+ */
+void YKFBase32Encode(const uint8_t *bytes, size_t length, char *output);
+
+static inline size_t YKFBase32DecodedMaxLength(size_t length) {
+    return (length + 7) / 8 * 5;
+}
+
+/*
+ Accepts upper and lower case letters. Padding characters are skipped wherever they are and a trailing partial
+ block is decoded without padding, as OATH secrets are often shared without it.
+ */
+bool YKFBase32Decode(const char *input, size_t length, uint8_t *output, size_t *outputLength);
+
+static inline size_t YKFBase64URLEncodedLength(size_t length) {
+    return length / 3 * 4 + (length % 3 ? length % 3 + 1 : 0);
+}
+
+void YKFBase64URLEncode(const uint8_t *bytes, size_t length, char *output);
+
+static inline size_t YKFBase64URLDecodedMaxLength(size_t length) {
+    return (length + 3) / 4 * 3;
+}
+
+/*
+ Accepts both the websafe ('-', '_') and the standard ('+', '/') alphabets and ignores trailing '=' padding.
+ Returns false if the unpadded length leaves a single character in the last block.
+ */
+bool YKFBase64URLDecode(const char *input, size_t length, uint8_t *output, size_t *outputLength);
+
+#endif
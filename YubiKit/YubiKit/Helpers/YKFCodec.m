@@ -0,0 +1,224 @@
+// Copyright 2018-2022 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include "YKFCodec.h"
+
+#define YKF_CODEC_INVALID 0xFF
+
+#pragma mark - Hex
+
+/*
+ Two characters per byte value, so each byte is encoded with a single 16 bit copy.
+ */
+static const char YKFHexPairs[513] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+static const uint8_t YKFHexValues[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14,
+    ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19,
+    ['a'] = 0x1A, ['b'] = 0x1B, ['c'] = 0x1C, ['d'] = 0x1D, ['e'] = 0x1E, ['f'] = 0x1F,
+    ['A'] = 0x1A, ['B'] = 0x1B, ['C'] = 0x1C, ['D'] = 0x1D, ['E'] = 0x1E, ['F'] = 0x1F
+};
+
+void YKFHexEncode(const uint8_t *bytes, size_t length, char *output) {
+    for (size_t i = 0; i < length; i++) {
+        memcpy(output + i * 2, YKFHexPairs + bytes[i] * 2, 2);
+    }
+}
+
+bool YKFHexDecode(const char *input, size_t length, uint8_t *output) {
+    if (length % 2) {
+        return false;
+    }
+    // Valid digits are stored with the 0x10 bit set so a single check per pair catches any invalid character.
+    const uint8_t *characters = (const uint8_t *)input;
+    uint8_t valid = 0x10;
+    for (size_t i = 0; i < length / 2; i++) {
+        uint8_t high = YKFHexValues[characters[i * 2]];
+        uint8_t low = YKFHexValues[characters[i * 2 + 1]];
+        valid &= high & low;
+        output[i] = (uint8_t)(high << 4 | (low & 0x0F));
+    }
+    return valid != 0;
+}
+
+#pragma mark - Base32
+
+static const char YKFBase32Alphabet[33] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+static uint8_t YKFBase32Values[256];
+static uint8_t YKFBase64URLValues[256];
+
+__attribute__((constructor)) static void YKFCodecInitializeTables(void) {
+    memset(YKFBase32Values, YKF_CODEC_INVALID, sizeof(YKFBase32Values));
+    for (uint8_t i = 0; i < 32; i++) {
+        uint8_t character = (uint8_t)YKFBase32Alphabet[i];
+        YKFBase32Values[character] = i;
+        if (character >= 'A' && character <= 'Z') {
+            YKFBase32Values[character + ('a' - 'A')] = i;
+        }
+    }
+
+    static const char base64URLAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    memset(YKFBase64URLValues, YKF_CODEC_INVALID, sizeof(YKFBase64URLValues));
+    for (uint8_t i = 0; i < 64; i++) {
+        YKFBase64URLValues[(uint8_t)base64URLAlphabet[i]] = i;
+    }
+    YKFBase64URLValues['+'] = 62;
+    YKFBase64URLValues['/'] = 63;
+}
+
+void YKFBase32Encode(const uint8_t *bytes, size_t length, char *output) {
+    size_t blocks = length / 5;
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8_t *in = bytes + i * 5;
+        uint64_t value = (uint64_t)in[0] << 32 | (uint64_t)in[1] << 24 | (uint64_t)in[2] << 16 | (uint64_t)in[3] << 8 | in[4];
+        char *out = output + i * 8;
+        for (int j = 0; j < 8; j++) {
+            out[j] = YKFBase32Alphabet[(value >> (35 - j * 5)) & 0x1F];
+        }
+    }
+
+    size_t remaining = length - blocks * 5;
+    if (remaining) {
+        uint8_t block[5] = {0};
+        memcpy(block, bytes + blocks * 5, remaining);
+        uint64_t value = (uint64_t)block[0] << 32 | (uint64_t)block[1] << 24 | (uint64_t)block[2] << 16 | (uint64_t)block[3] << 8 | block[4];
+        // Number of significant characters for 1 to 4 remaining bytes.
+        static const int characters[5] = {0, 2, 4, 5, 7};
+        char *out = output + blocks * 8;
+        for (int j = 0; j < 8; j++) {
+            out[j] = j < characters[remaining] ? YKFBase32Alphabet[(value >> (35 - j * 5)) & 0x1F] : '=';
+        }
+    }
+}
+
+bool YKFBase32Decode(const char *input, size_t length, uint8_t *output, size_t *outputLength) {
+    // Bytes decoded from a trailing partial block of 0 to 7 characters.
+    static const size_t partialBlockLength[8] = {0, 1, 1, 1, 2, 3, 3, 4};
+    const uint8_t *characters = (const uint8_t *)input;
+    size_t written = 0;
+    uint64_t value = 0;
+    int count = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t character = characters[i];
+        if (character == '=') {
+            continue;
+        }
+        uint8_t bits = YKFBase32Values[character];
+        if (bits == YKF_CODEC_INVALID) {
+            return false;
+        }
+        value = value << 5 | bits;
+        if (++count == 8) {
+            output[written++] = (uint8_t)(value >> 32);
+            output[written++] = (uint8_t)(value >> 24);
+            output[written++] = (uint8_t)(value >> 16);
+            output[written++] = (uint8_t)(value >> 8);
+            output[written++] = (uint8_t)value;
+            value = 0;
+            count = 0;
+        }
+    }
+
+    if (count) {
+        value <<= (8 - count) * 5;
+        for (size_t i = 0; i < partialBlockLength[count]; i++) {
+            output[written++] = (uint8_t)(value >> (32 - i * 8));
+        }
+    }
+    *outputLength = written;
+    return true;
+}
+
+#pragma mark - Websafe Base64
+
+static const char YKFBase64URLAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+void YKFBase64URLEncode(const uint8_t *bytes, size_t length, char *output) {
+    size_t blocks = length / 3;
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8_t *in = bytes + i * 3;
+        uint32_t value = (uint32_t)in[0] << 16 | (uint32_t)in[1] << 8 | in[2];
+        char *out = output + i * 4;
+        out[0] = YKFBase64URLAlphabet[value >> 18];
+        out[1] = YKFBase64URLAlphabet[(value >> 12) & 0x3F];
+        out[2] = YKFBase64URLAlphabet[(value >> 6) & 0x3F];
+        out[3] = YKFBase64URLAlphabet[value & 0x3F];
+    }
+
+    size_t remaining = length - blocks * 3;
+    if (remaining) {
+        const uint8_t *in = bytes + blocks * 3;
+        uint32_t value = (uint32_t)in[0] << 16 | (remaining == 2 ? (uint32_t)in[1] << 8 : 0);
+        char *out = output + blocks * 4;
+        out[0] = YKFBase64URLAlphabet[value >> 18];
+        out[1] = YKFBase64URLAlphabet[(value >> 12) & 0x3F];
+        if (remaining == 2) {
+            out[2] = YKFBase64URLAlphabet[(value >> 6) & 0x3F];
+        }
+    }
+}
+
+bool YKFBase64URLDecode(const char *input, size_t length, uint8_t *output, size_t *outputLength) {
+    const uint8_t *characters = (const uint8_t *)input;
+    while (length > 0 && characters[length - 1] == '=') {
+        length--;
+    }
+    if (length % 4 == 1) {
+        return false;
+    }
+
+    size_t blocks = length / 4;
+    size_t written = 0;
+    for (size_t i = 0; i < blocks; i++) {
+        const uint8_t *in = characters + i * 4;
+        uint8_t a = YKFBase64URLValues[in[0]], b = YKFBase64URLValues[in[1]];
+        uint8_t c = YKFBase64URLValues[in[2]], d = YKFBase64URLValues[in[3]];
+        // Invalid characters have the high bits set, valid ones fit in 6 bits.
+        if ((a | b | c | d) & 0xC0) {
+            return false;
+        }
+        uint32_t value = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | d;
+        output[written++] = (uint8_t)(value >> 16);
+        output[written++] = (uint8_t)(value >> 8);
+        output[written++] = (uint8_t)value;
+    }
+
+    size_t remaining = length - blocks * 4;
+    if (remaining) {
+        const uint8_t *in = characters + blocks * 4;
+        uint8_t a = YKFBase64URLValues[in[0]], b = YKFBase64URLValues[in[1]];
+        uint8_t c = remaining == 3 ? YKFBase64URLValues[in[2]] : 0;
+        if ((a | b | c) & 0xC0) {
+            return false;
+        }
+        uint32_t value = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6;
+        output[written++] = (uint8_t)(value >> 16);
+        if (remaining == 3) {
+            output[written++] = (uint8_t)(value >> 8);
+        }
+    }
+    *outputLength = written;
+    return true;
+}
@@ -13,16 +13,43 @@
 // limitations under the License.
 
 #import <Foundation/Foundation.h>
+#import <stdatomic.h>
+#import "YubiKitLogger.h"
 
-void YKFLogInfo(NSString* _Nonnull format, ...) NS_FORMAT_FUNCTION(1, 2);
+/*
+ The logging functions are macros so the arguments, e.g. the hex dumps of the APDUs, are only evaluated when the
+ message is actually logged. The format must be a string literal, the level prefix is concatenated at compile time.
+ */
 
-void YKFLogError(NSString* _Nonnull format, ...) NS_FORMAT_FUNCTION(1, 2);
+// This should be disabled for release builds.
+// #define YKF_ENABLE_VERBOSE_LOGGING
 
-void YKFLogNSError(NSError* _Nonnull error);
+// The most detailed level which is formatted, derived from YubiKitLogger.logLevel and customLogger.
+extern _Atomic(YKFLogLevel) YKFLogEnabledLevel;
 
-void YKFLogAssertion(NSString* _Nonnull format, ...) NS_FORMAT_FUNCTION(1, 2);
+static inline BOOL YKFLogIsEnabled(YKFLogLevel level) {
+    return level <= atomic_load_explicit(&YKFLogEnabledLevel, memory_order_relaxed);
+}
 
-// This should be disabled for release builds.
-// #define YKF_ENABLE_VERBOSE_LOGGING
+void YKFLogSetEnabledLevel(YKFLogLevel level);
+
+void YKFLogMessage(NSString* _Nonnull format, ...) NS_FORMAT_FUNCTION(1, 2);
 
-void YKFLogVerbose(NSString* _Nonnull format, ...) NS_FORMAT_FUNCTION(1, 2);
+#define YKFLogWithLevel(level, format, ...) \
+    do { if (YKFLogIsEnabled(level)) { YKFLogMessage(format, ##__VA_ARGS__); } } while (0)
+
+#define YKFLogInfo(format, ...) YKFLogWithLevel(YKFLogLevelInfo, @"►►[I]► YubiKit: " format, ##__VA_ARGS__)
+
+#define YKFLogError(format, ...) YKFLogWithLevel(YKFLogLevelError, @"►►[E]► YubiKit: " format, ##__VA_ARGS__)
+
+// Assertions logs are helpful in Automation.
+#define YKFLogAssertion(format, ...) YKFLogWithLevel(YKFLogLevelError, @"►►[A]► YubiKit: " format, ##__VA_ARGS__)
+
+#ifdef YKF_ENABLE_VERBOSE_LOGGING
+#define YKFLogVerbose(format, ...) YKFLogWithLevel(YKFLogLevelVerbose, @"►►[V]► YubiKit: " format, ##__VA_ARGS__)
+#else
+// Compiled out, the dead branch keeps the format checked and the logged variables used.
+#define YKFLogVerbose(format, ...) do { if (0) { YKFLogMessage(format, ##__VA_ARGS__); } } while (0)
+#endif
+
+void YKFLogNSError(NSError* _Nonnull error);
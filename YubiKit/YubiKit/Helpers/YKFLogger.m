@@ -15,74 +15,39 @@
 #import "YKFLogger.h"
 #import "YubiKitLogger.h"
 
-// Prefix for showing Info logs.
-static NSString* const YKFLogPrefixInfo = @"►►[I]► YubiKit:";
-
-// Prefix for showing Verbose logs.
-static NSString* const YKFLogPrefixVerbose = @"►►[V]► YubiKit:";
-
-// Prefix for showing Error logs.
-static NSString* const YKFLogPrefixError = @"►►[E]► YubiKit:";
-
-// Prefix for showing Assertions logs (helpful in Automation).
-static NSString* const YKFLogPrefixAssertion = @"►►[A]► YubiKit:";
-
-void YKFLog(NSString *format, va_list args) {
 #ifdef DEBUG
-    NSLogv(format, args);
+_Atomic(YKFLogLevel) YKFLogEnabledLevel = YKFLogLevelVerbose;
+#else
+// Release builds only log to the custom logger, nothing is formatted until one is set.
+_Atomic(YKFLogLevel) YKFLogEnabledLevel = YKFLogLevelNone;
 #endif
-    if (YubiKitLogger.customLogger) {
-        NSString *message = [[NSString alloc] initWithFormat:format arguments: args];
-        [YubiKitLogger.customLogger log:message];
-    }
-}
 
-void YKFLogInfo(NSString* _Nonnull format, ...) {
-    va_list args;
-    va_start(args, format);
-    
-    NSString *ykFormat = [NSString stringWithFormat:@"%@ %@", YKFLogPrefixInfo, format];
-    YKFLog(ykFormat, args);
-    
-    va_end(args);
+void YKFLogSetEnabledLevel(YKFLogLevel level) {
+    atomic_store_explicit(&YKFLogEnabledLevel, level, memory_order_relaxed);
 }
 
-void YKFLogError(NSString* _Nonnull format, ...) {
+void YKFLogMessage(NSString* _Nonnull format, ...) {
     va_list args;
     va_start(args, format);
-    
-    NSString *ykFormat = [NSString stringWithFormat:@"%@ %@", YKFLogPrefixError, format];
-    YKFLog(ykFormat, args);
-    
+    NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
     va_end(args);
+    
+#ifdef DEBUG
+    NSLog(@"%@", message);
+#endif
+    id<YubiKitLoggerProtocol> customLogger = YubiKitLogger.customLogger;
+    if (customLogger) {
+        [customLogger log:message];
+    }
 }
 
 void YKFLogNSError(NSError *error) {
+    if (!YKFLogIsEnabled(YKFLogLevelError)) {
+        return;
+    }
     NSInteger errorCode = error.code;
     NSString *errorType = NSStringFromClass(error.class);
     NSString *errorMessage = error.localizedDescription;
     
     YKFLogError(@"%@(%ld) - %@", errorType, (long)errorCode, errorMessage);
 }
-
-void YKFLogAssertion(NSString* _Nonnull format, ...) {
-    va_list args;
-    va_start(args, format);
-    
-    NSString *ykFormat = [NSString stringWithFormat:@"%@ %@", YKFLogPrefixAssertion, format];
-    YKFLog(ykFormat, args);
-    
-    va_end(args);
-}
-
-void YKFLogVerbose(NSString* _Nonnull format, ...) {
-#ifdef YKF_ENABLE_VERBOSE_LOGGING
-    va_list args;
-    va_start(args, format);
-    
-    NSString *ykFormat = [NSString stringWithFormat:@"%@ %@", YKFLogPrefixVerbose, format];
-    YKFLog(ykFormat, args);
-    
-    va_end(args);
-#endif
-}
@@ -0,0 +1,71 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Hands out buffers for secrets from a secure arena for the duration of a scope.
+///
+/// The buffers are zeroed when the scope ends, in one pass over the arena. They are also truncated to zero length
+/// then, so a buffer which escapes the scope by mistake reads as empty instead of as memory reused by a later scope.
+/// Don't grow the buffers: NSMutableData moves bytes which don't fit to the heap.
+@interface YKFSecureArenaScope : NSObject
+
+/// A zero filled buffer of the given length.
+- (NSMutableData *)mutableDataWithLength:(NSUInteger)length;
+
+/// A copy of data.
+- (NSMutableData *)dataWithData:(NSData *)data;
+
+/// The UTF-8 bytes of string, encoded directly into the buffer and followed by padding bytes up to length. Strings
+/// longer than length are not truncated.
+- (NSMutableData *)UTF8DataWithString:(NSString *)string paddedToLength:(NSUInteger)length padding:(UInt8)padding;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/// A zeroizing arena for PINs, keys and session secrets.
+///
+/// The memory is mapped once and locked in RAM when the system allows it, so the short lived copies of secrets
+/// made while building commands don't go through the allocator and are wiped exactly once, when their scope ends.
+/// Scopes nest and are serialized across threads; keep them short and don't wait for the YubiKey inside one.
+/// APDUs copy the buffers they are built from, so a command can outlive its scope; wipe it once the key has answered.
+/// When the arena is exhausted the scope falls back to heap buffers, which are zeroed at the end of the scope too.
+@interface YKFSecureArena : NSObject
+
+/// The arena shared by the sessions, one page.
+@property (class, nonatomic, readonly) YKFSecureArena *sharedArena;
+
+/// The usable size of the arena in bytes, the requested capacity rounded up to whole pages.
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/// YES when the arena pages are locked in memory.
+@property (nonatomic, readonly, getter=isLocked) BOOL locked;
+
+/// Returns nil when the memory can't be mapped.
+- (nullable instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/// Runs the block with a scope whose buffers are wiped when the block returns.
+- (void)performWithScope:(NS_NOESCAPE void (^)(YKFSecureArenaScope *scope))block;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/// Zeroes the bytes of data when it is mutable. Used for secrets kept beyond a scope, like cached tokens and keys.
+void YKFSecureZeroData(NSData * _Nullable data);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,152 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "YKFSecureArena.h"
+#import "YKFAssert.h"
+#import "ykf_secure_arena.h"
+#import "ykf_aes.h"
+
+static const NSUInteger YKFSecureArenaDefaultCapacity = 4096;
+
+void YKFSecureZeroData(NSData *data) {
+    if ([data isKindOfClass:NSMutableData.class]) {
+        ykf_secure_zero(((NSMutableData *)data).mutableBytes, data.length);
+    }
+}
+
+#pragma mark - YKFSecureArenaScope
+
+@interface YKFSecureArenaScope()
+
+@property (nonatomic, assign) ykf_secure_arena *arena;
+@property (nonatomic) NSMutableArray<NSMutableData *> *buffers;
+
+- (instancetype)initWithArena:(ykf_secure_arena *)arena NS_DESIGNATED_INITIALIZER;
+- (void)wipe;
+
+@end
+
+@implementation YKFSecureArenaScope
+
+- (instancetype)initWithArena:(ykf_secure_arena *)arena {
+    self = [super init];
+    if (self) {
+        _arena = arena;
+        _buffers = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSMutableData *)mutableDataWithLength:(NSUInteger)length {
+    NSMutableData *buffer = nil;
+    void *bytes = ykf_secure_arena_alloc(self.arena, length);
+    if (bytes) {
+        buffer = [[NSMutableData alloc] initWithBytesNoCopy:bytes length:length freeWhenDone:NO];
+    } else {
+        // Exhausted arena or empty buffer.
+        buffer = [[NSMutableData alloc] initWithLength:length];
+    }
+    [self.buffers addObject:buffer];
+    return buffer;
+}
+
+- (NSMutableData *)dataWithData:(NSData *)data {
+    NSMutableData *buffer = [self mutableDataWithLength:data.length];
+    if (data.length) {
+        memcpy(buffer.mutableBytes, data.bytes, data.length);
+    }
+    return buffer;
+}
+
+- (NSMutableData *)UTF8DataWithString:(NSString *)string paddedToLength:(NSUInteger)length padding:(UInt8)padding {
+    NSUInteger stringLength = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    NSMutableData *buffer = [self mutableDataWithLength:MAX(stringLength, length)];
+    
+    NSUInteger usedLength = 0;
+    [string getBytes:buffer.mutableBytes maxLength:stringLength usedLength:&usedLength encoding:NSUTF8StringEncoding
+             options:0 range:NSMakeRange(0, string.length) remainingRange:NULL];
+    memset((UInt8 *)buffer.mutableBytes + usedLength, padding, buffer.length - usedLength);
+    return buffer;
+}
+
+- (void)wipe {
+    // The arena buffers are zeroed by the release of the arena.
+    for (NSMutableData *buffer in self.buffers) {
+        if (buffer.length && !ykf_secure_arena_contains(self.arena, buffer.bytes)) {
+            ykf_secure_zero(buffer.mutableBytes, buffer.length);
+        }
+        buffer.length = 0;
+    }
+    [self.buffers removeAllObjects];
+}
+
+@end
+
+#pragma mark - YKFSecureArena
+
+@interface YKFSecureArena() {
+    ykf_secure_arena _arena;
+}
+
+@property (nonatomic) NSRecursiveLock *lock;
+
+@end
+
+@implementation YKFSecureArena
+
++ (YKFSecureArena *)sharedArena {
+    static YKFSecureArena *sharedArena = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedArena = [[YKFSecureArena alloc] initWithCapacity:YKFSecureArenaDefaultCapacity];
+    });
+    return sharedArena;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        if (ykf_secure_arena_init(&_arena, capacity) != YKF_OK) {
+            return nil;
+        }
+        _lock = [[NSRecursiveLock alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    ykf_secure_arena_destroy(&_arena);
+}
+
+- (NSUInteger)capacity {
+    return _arena.capacity;
+}
+
+- (BOOL)isLocked {
+    return _arena.locked != 0;
+}
+
+- (void)performWithScope:(void (^)(YKFSecureArenaScope *scope))block {
+    YKFParameterAssertReturn(block);
+    
+    [self.lock lock];
+    size_t mark = ykf_secure_arena_mark(&_arena);
+    YKFSecureArenaScope *scope = [[YKFSecureArenaScope alloc] initWithArena:&_arena];
+    block(scope);
+    [scope wipe];
+    ykf_secure_arena_release(&_arena, mark);
+    [self.lock unlock];
+}
+
+@end
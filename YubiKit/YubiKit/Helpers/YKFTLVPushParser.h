@@ -0,0 +1,55 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import <Foundation/Foundation.h>
+#import "YKFTLVRecord.h"
+#import "YKFSmartCardResponseConsumer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Called with every record as soon as its last value byte has been pushed.
+typedef void (^YKFTLVPushParserRecordHandler)(YKFTLVRecord *record);
+
+/// Parses a sequence of BER-TLV records from data arriving in slices of any size.
+///
+/// The tag, length and value of a record may be split across slices at any byte; the partial state is kept
+/// until the next slice instead of failing like YKFTLVRecord recordFromData:. The records follow the same rules
+/// as recordFromData: (tags of at most 8 bytes, definite lengths only). A value which lies within one slice is
+/// copied out of it directly, otherwise it is collected in a buffer allocated once from the decoded length.
+/// The parser is not thread safe; push the slices from one queue.
+@interface YKFTLVPushParser : NSObject<YKFSmartCardResponseConsumer>
+
+/// The longest value accepted. A larger length fails the parser before any buffer is allocated. Defaults to 1 MB.
+@property (nonatomic) NSUInteger maximumValueLength;
+
+/// YES when the bytes pushed so far end in the middle of a record.
+@property (nonatomic, readonly) BOOL hasPartialRecord;
+
+/// Creates a parser which passes the parsed records to the handler, in order, on the queue the data is pushed on.
+- (instancetype)initWithRecordHandler:(YKFTLVPushParserRecordHandler)recordHandler NS_DESIGNATED_INITIALIZER;
+
+/// Parses the next slice of data. Returns NO when the data is not valid BER-TLV; the parser then rejects all
+/// data until it is reset.
+- (BOOL)pushData:(NSData *)data error:(NSError **)error;
+
+/// Ends the sequence. Returns NO when the data ended in the middle of a record. The parser is reset either way.
+- (BOOL)finishWithError:(NSError **)error;
+
+/// Drops any partial record and error so the parser can parse a new sequence.
+- (void)reset;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
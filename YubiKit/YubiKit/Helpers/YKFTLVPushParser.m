@@ -0,0 +1,203 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import "YKFTLVPushParser.h"
+#import "YKFSessionError.h"
+#import "YKFSessionError+Private.h"
+
+static NSUInteger const YKFTLVPushParserDefaultMaximumValueLength = 1024 * 1024;
+
+typedef NS_ENUM(NSUInteger, YKFTLVPushParserState) {
+    YKFTLVPushParserStateTag,
+    YKFTLVPushParserStateSubsequentTag,
+    YKFTLVPushParserStateLength,
+    YKFTLVPushParserStateLongLength,
+    YKFTLVPushParserStateValue,
+    YKFTLVPushParserStateFailed
+};
+
+@interface YKFTLVPushParser()
+
+@property (nonatomic, copy) YKFTLVPushParserRecordHandler recordHandler;
+@property (nonatomic) YKFTLVPushParserState state;
+
+@property (nonatomic) YKFTLVTag tag;
+@property (nonatomic) NSUInteger tagLength;
+@property (nonatomic) NSUInteger valueLength;
+@property (nonatomic) NSUInteger remainingLengthBytes;
+@property (nonatomic, nullable) NSMutableData *value;
+
+@end
+
+@implementation YKFTLVPushParser
+
+- (instancetype)initWithRecordHandler:(YKFTLVPushParserRecordHandler)recordHandler {
+    self = [super init];
+    if (self) {
+        self.recordHandler = recordHandler;
+        self.maximumValueLength = YKFTLVPushParserDefaultMaximumValueLength;
+        self.state = YKFTLVPushParserStateTag;
+    }
+    return self;
+}
+
+- (BOOL)hasPartialRecord {
+    return self.state != YKFTLVPushParserStateTag && self.state != YKFTLVPushParserStateFailed;
+}
+
+- (void)reset {
+    self.state = YKFTLVPushParserStateTag;
+    self.tag = 0;
+    self.tagLength = 0;
+    self.valueLength = 0;
+    self.remainingLengthBytes = 0;
+    self.value = nil;
+}
+
+- (BOOL)pushData:(NSData *)data error:(NSError **)error {
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger offset = 0;
+    
+    if (self.state == YKFTLVPushParserStateFailed) {
+        return [self failWithError:error];
+    }
+    
+    while (offset < length) {
+        switch (self.state) {
+            case YKFTLVPushParserStateTag: {
+                UInt8 byte = bytes[offset++];
+                self.tag = byte;
+                self.tagLength = 1;
+                self.state = (byte & 0x1F) == 0x1F ? YKFTLVPushParserStateSubsequentTag : YKFTLVPushParserStateLength;
+                break;
+            }
+            case YKFTLVPushParserStateSubsequentTag: {
+                if (self.tagLength >= sizeof(YKFTLVTag)) {
+                    return [self failWithError:error];
+                }
+                UInt8 byte = bytes[offset++];
+                self.tag = (self.tag << 8) | byte;
+                self.tagLength++;
+                if ((byte & 0x80) == 0) {
+                    self.state = YKFTLVPushParserStateLength;
+                }
+                break;
+            }
+            case YKFTLVPushParserStateLength: {
+                UInt8 byte = bytes[offset++];
+                if (byte == 0x80) {
+                    // Indefinite lengths are not used by the YubiKey applications.
+                    return [self failWithError:error];
+                } else if (byte > 0x80) {
+                    self.remainingLengthBytes = byte - 0x80;
+                    if (self.remainingLengthBytes > sizeof(NSUInteger)) {
+                        return [self failWithError:error];
+                    }
+                    self.valueLength = 0;
+                    self.state = YKFTLVPushParserStateLongLength;
+                } else if (![self beginValueWithLength:byte]) {
+                    return [self failWithError:error];
+                }
+                break;
+            }
+            case YKFTLVPushParserStateLongLength: {
+                self.valueLength = (self.valueLength << 8) | bytes[offset++];
+                self.remainingLengthBytes--;
+                if (self.remainingLengthBytes == 0 && ![self beginValueWithLength:self.valueLength]) {
+                    return [self failWithError:error];
+                }
+                break;
+            }
+            case YKFTLVPushParserStateValue: {
+                NSUInteger available = length - offset;
+                if (!self.value && available >= self.valueLength) {
+                    // The whole value is in this slice, copy it out without buffering.
+                    NSData *value = [NSData dataWithBytes:bytes + offset length:self.valueLength];
+                    offset += self.valueLength;
+                    [self emitRecordWithValue:value];
+                    break;
+                }
+                if (!self.value) {
+                    self.value = [[NSMutableData alloc] initWithCapacity:self.valueLength];
+                }
+                NSUInteger count = MIN(available, self.valueLength - self.value.length);
+                [self.value appendBytes:bytes + offset length:count];
+                offset += count;
+                if (self.value.length == self.valueLength) {
+                    NSData *value = [self.value copy];
+                    self.value = nil;
+                    [self emitRecordWithValue:value];
+                }
+                break;
+            }
+            case YKFTLVPushParserStateFailed:
+                return [self failWithError:error];
+        }
+    }
+    return YES;
+}
+
+- (BOOL)finishWithError:(NSError **)error {
+    BOOL complete = self.state == YKFTLVPushParserStateTag;
+    [self reset];
+    if (!complete) {
+        if (error) {
+            *error = [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+#pragma mark - YKFSmartCardResponseConsumer
+
+- (BOOL)consumeResponseChunk:(NSData *)chunk error:(NSError **)error {
+    return [self pushData:chunk error:error];
+}
+
+- (BOOL)finishResponseWithError:(NSError **)error {
+    return [self finishWithError:error];
+}
+
+#pragma mark - Helpers
+
+- (BOOL)beginValueWithLength:(NSUInteger)length {
+    if (length > self.maximumValueLength) {
+        return NO;
+    }
+    self.valueLength = length;
+    if (length == 0) {
+        [self emitRecordWithValue:[NSData data]];
+    } else {
+        self.state = YKFTLVPushParserStateValue;
+    }
+    return YES;
+}
+
+- (void)emitRecordWithValue:(NSData *)value {
+    YKFTLVRecord *record = [[YKFTLVRecord alloc] initWithTag:self.tag value:value];
+    [self reset];
+    self.recordHandler(record);
+}
+
+- (BOOL)failWithError:(NSError **)error {
+    [self reset];
+    self.state = YKFTLVPushParserStateFailed;
+    if (error) {
+        *error = [YKFSessionError errorWithCode:YKFSessionErrorUnexpectedResult];
+    }
+    return NO;
+}
+
+@end
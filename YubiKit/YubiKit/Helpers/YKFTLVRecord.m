@@ -15,90 +15,37 @@
 #import <Foundation/Foundation.h>
 #import "YKFTLVRecord.h"
 #import "YKFNSDataAdditions+Private.h"
+#import "ykf_tlv.h"
 
 @interface YKFTLVRecord()
 @property (nonatomic, readwrite) YKFTLVTag tag;
 @property (nonatomic, readwrite) NSData *value;
 @end
 
-@interface NSData (NSData_ByteEncoding)
-    + (NSData *)ykf_dataWithBytesStripLeadingZeros:(char*)bytes length:(NSUInteger)length;
-@end
-
 @implementation YKFTLVRecord
 
 + (nullable instancetype)recordFromData:(NSData *_Nullable)data checkMatchingLength:(Boolean)checkMatchingLength bytesRead:(NSUInteger*)bytesRead {
     *bytesRead = 0;
     
-    // tag
-    if (data.length == 0) {
+    ykf_tlv_header header;
+    if (ykf_tlv_parse_record(data.bytes, data.length, &header) != YKF_OK) {
         return nil;
     }
-    Byte *bytes = (Byte *)data.bytes;
-    NSUInteger offset = 0;
-    YKFTLVTag tag = bytes[offset++];
-    if ((tag & 0x1F) == 0x1F) {
-        if (data.length < 2) { return nil; }
-        tag = (tag << 8) | (bytes[offset++] & 0xFF);
-        while ((tag & 0x80) == 0x80 && offset < data.length) {
-            if (offset >= sizeof(YKFTLVTag)) { return nil; }
-            tag = (tag << 8) | (bytes[offset++] & 0xFF);
-        }
-    }
-    
-    // length
-    if (offset > data.length) { return nil; }
-    NSUInteger length = bytes[offset++];
-    if (length == 0x80) {
+    NSUInteger length = header.header_length + header.value_length;
+    if (checkMatchingLength && data.length != length) {
         return nil;
-    } else if (length > 0x80) {
-        NSUInteger lengthOfLength = length - 0x80;
-        length = 0;
-        if (lengthOfLength > sizeof(length) || data.length < offset + lengthOfLength) {
-            return nil;
-        }
-        for (int i = 0; i < lengthOfLength; i++) {
-            length = (length << 8) | (bytes[offset++] & 0xFF);
-        }
     }
-    
-    // data
-    if (checkMatchingLength && data.length != offset + length) {
-        return nil;
-    }
-    if (data.length < offset + length || offset + length < length) {
-        return nil;
-    }
-    *bytesRead = offset + length;
-    return [[YKFTLVRecord alloc] initWithTag:tag value:[data subdataWithRange:NSMakeRange(offset, length)]];
+    *bytesRead = length;
+    return [[YKFTLVRecord alloc] initWithTag:header.tag value:[data subdataWithRange:NSMakeRange(header.header_length, header.value_length)]];
 }
 
 - (NSData *)data {
-
-    NSMutableData * result = [NSMutableData new];
-    
-    // tag
-    YKFTLVTag tag = CFSwapInt64HostToBig(self.tag);
-    char* tagBytes = (char*) &tag;
-    NSData *tagData = [NSData ykf_dataWithBytesStripLeadingZeros:tagBytes length:sizeof(YKFTLVTag)];
-    [result appendData:tagData];
+    UInt8 header[YKF_TLV_MAX_HEADER_LENGTH];
+    size_t headerLength = ykf_tlv_encode_header(self.tag, self.value.length, header);
     
-    // length
-    NSUInteger hostLength = self.value.length;
-    if (hostLength < 0x80) {
-        [result appendBytes:&hostLength length:1];
-    } else {
-        NSUInteger length = NSSwapHostLongToBig(hostLength);
-        char* lengthBytes = (char*)&length;
-        NSData *lengthData = [NSData ykf_dataWithBytesStripLeadingZeros:lengthBytes length:sizeof(length)];
-        Byte lengthHeader = 0x80 | lengthData.length;
-        [result appendBytes:&lengthHeader length:1];
-        [result appendData:lengthData];
-    }
-    
-    // data
+    NSMutableData *result = [[NSMutableData alloc] initWithCapacity:headerLength + self.value.length];
+    [result appendBytes:header length:headerLength];
     [result appendData:self.value];
-
     return result;
 }
 
@@ -125,49 +72,24 @@
 }
 
 + (nullable NSArray<YKFTLVRecord *> *)sequenceOfRecordsFromData:(NSData *_Nullable)data {
+    if (!data.length) {
+        return nil;
+    }
     
     NSMutableArray<YKFTLVRecord *> *records = [[NSMutableArray<YKFTLVRecord *> alloc] init];
-    
+    const UInt8 *bytes = data.bytes;
     NSUInteger location = 0;
-    bool keepScanning = true;
-    while (keepScanning) {
-        data = [data subdataWithRange:NSMakeRange(location, data.length - location)];
-        
-        NSUInteger bytesRead = 0;
-        YKFTLVRecord *record = [YKFTLVRecord recordFromData:data checkMatchingLength:NO bytesRead:&bytesRead];
-        if (record) {
-            [records addObject:record];
-            location = bytesRead;
-            if (location > data.length) {
-                records = nil;
-                keepScanning = NO;
-            }
-            if (location == data.length) {
-                keepScanning = NO;
-            }
-        } else {
-            records = nil;
-            keepScanning = NO;
+    while (location < data.length) {
+        ykf_tlv_header header;
+        if (ykf_tlv_parse_record(bytes + location, data.length - location, &header) != YKF_OK) {
+            return nil;
         }
+        NSRange valueRange = NSMakeRange(location + header.header_length, header.value_length);
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:header.tag value:[data subdataWithRange:valueRange]]];
+        location = NSMaxRange(valueRange);
     }
     return records;
 }
 
 @end
 
-
-@implementation NSData (NSData_ByteEncoding)
-    
-+ (NSData *)ykf_dataWithBytesStripLeadingZeros:(char*)bytes length:(NSUInteger)length {
-    int skippedBytes = 0;
-    for (int i = 0; i < length; i++) {
-        if (bytes[i] == 0) {
-            skippedBytes++;
-        } else {
-            break;
-        }
-    }
-    return [[NSData alloc] initWithBytes:&bytes[skippedBytes] length:length - skippedBytes];
-}
-
-@end
@@ -0,0 +1 @@
+../Connections/Shared/APDU/YKFAPDU+Constants.h
\ No newline at end of file
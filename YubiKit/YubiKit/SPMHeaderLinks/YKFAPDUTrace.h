@@ -0,0 +1 @@
+../Connections/Shared/Trace/YKFAPDUTrace.h
\ No newline at end of file
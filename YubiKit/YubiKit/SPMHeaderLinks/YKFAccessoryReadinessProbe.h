@@ -0,0 +1 @@
+../Connections/AccessoryConnection/YKFAccessoryReadinessProbe.h
\ No newline at end of file
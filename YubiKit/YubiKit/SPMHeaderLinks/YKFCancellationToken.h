@@ -0,0 +1 @@
+../Connections/Shared/YKFCancellationToken.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Helpers/YKFCodec.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/YKFCommandPriority.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Metrics/YKFConnectionMetrics+Private.h
\ No newline at end of file
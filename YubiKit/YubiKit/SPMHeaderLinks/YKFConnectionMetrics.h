@@ -0,0 +1 @@
+../Connections/Shared/Metrics/YKFConnectionMetrics.h
\ No newline at end of file
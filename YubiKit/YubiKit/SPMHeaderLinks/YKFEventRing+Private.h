@@ -0,0 +1 @@
+../Connections/Shared/Trace/YKFEventRing+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Trace/YKFEventRing.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/FIDO2/YKFFIDO2GetInfoCache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/NFCConnection/YKFNFCTagAvailabilityMonitor.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/OATH/YKFOATHAccessKeyCache+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/OATH/YKFOATHAccessKeyCache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/OATH/YKFOATHCredentialImportResult+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/OATH/YKFOATHCredentialImportResult.h
\ No newline at end of file
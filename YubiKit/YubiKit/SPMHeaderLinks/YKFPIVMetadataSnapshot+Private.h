@@ -0,0 +1 @@
+../Connections/Shared/Sessions/PIV/YKFPIVMetadataSnapshot+Private.h
\ No newline at end of file
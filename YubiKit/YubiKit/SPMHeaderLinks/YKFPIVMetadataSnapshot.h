@@ -0,0 +1 @@
+../Connections/Shared/Sessions/PIV/YKFPIVMetadataSnapshot.h
\ No newline at end of file
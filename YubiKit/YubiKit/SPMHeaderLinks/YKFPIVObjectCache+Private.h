@@ -0,0 +1 @@
+../Connections/Shared/Sessions/PIV/YKFPIVObjectCache+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/PIV/YKFPIVPinPukMetadata+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Sessions/PIV/YKFPIVPinPukMetadata.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Helpers/YKFSecureArena.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/SmartCardConnection/YKFSmartCardConnectionRegistry+Private.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/SmartCardConnection/YKFSmartCardConnectionRegistry.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/SmartCardInterface/YKFSmartCardResponseConsumer.h
\ No newline at end of file
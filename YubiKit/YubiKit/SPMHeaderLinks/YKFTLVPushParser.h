@@ -0,0 +1 @@
+../Helpers/YKFTLVPushParser.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/YKFTimeoutPolicy.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Trace/YKFTraceRecordingConnectionController.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Connections/Shared/Trace/YKFTraceReplayConnectionController.h
\ No newline at end of file
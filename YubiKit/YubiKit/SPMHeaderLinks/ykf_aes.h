@@ -0,0 +1 @@
+../Core/ykf_aes.h
\ No newline at end of file
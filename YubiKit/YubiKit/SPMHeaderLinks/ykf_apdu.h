@@ -0,0 +1 @@
+../Core/ykf_apdu.h
\ No newline at end of file
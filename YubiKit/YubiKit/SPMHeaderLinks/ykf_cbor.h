@@ -0,0 +1 @@
+../Core/ykf_cbor.h
\ No newline at end of file
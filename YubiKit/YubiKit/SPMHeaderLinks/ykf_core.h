@@ -0,0 +1 @@
+../Core/ykf_core.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Core/ykf_oath.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Core/ykf_piv.h
\ No newline at end of file
@@ -0,0 +1 @@
+../Core/ykf_scp.h
\ No newline at end of file
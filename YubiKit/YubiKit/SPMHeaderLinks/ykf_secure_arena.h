@@ -0,0 +1 @@
+../Core/ykf_secure_arena.h
\ No newline at end of file
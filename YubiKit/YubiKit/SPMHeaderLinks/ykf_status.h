@@ -0,0 +1 @@
+../Core/ykf_status.h
\ No newline at end of file
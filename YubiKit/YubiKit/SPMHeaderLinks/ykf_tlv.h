@@ -0,0 +1 @@
+../Core/ykf_tlv.h
\ No newline at end of file
@@ -40,4 +40,19 @@
 - (nullable NSData *)gunzippedData;
 - (BOOL)isGzippedData;
 
+/// Upper bound of the gzip output for an input of the given length, so the output can be written in one pass.
++ (NSUInteger)gzippedLengthBoundForLength:(NSUInteger)length;
+
+/// Compresses the data and appends it to the end of data without intermediate buffers. When data has at least
+/// gzippedLengthBoundForLength: bytes of spare capacity it is not reallocated. Returns NO if compression failed.
+- (BOOL)appendGzippedDataToData:(nonnull NSMutableData *)data compressionLevel:(float)level;
+
+/// The uncompressed length stored in the gzip ISIZE trailer, modulo 2^32, capped at the largest length deflate can
+/// expand the data to. Returns 0 if the data is not gzipped.
+- (NSUInteger)gunzippedLengthHint;
+
+/// Inflates the data and appends it to the end of data, sized from the ISIZE trailer so the output is normally
+/// allocated once. Returns NO if the data is not gzipped or inflation failed.
+- (BOOL)appendGunzippedDataToData:(nonnull NSMutableData *)data;
+
 @end
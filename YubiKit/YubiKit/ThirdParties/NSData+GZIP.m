@@ -46,6 +46,42 @@
         return self;
     }
 
+    NSMutableData *output = [NSMutableData dataWithCapacity:[NSData gzippedLengthBoundForLength:self.length]];
+    if (![self appendGzippedDataToData:output compressionLevel:level])
+    {
+        return nil;
+    }
+    return output;
+}
+
+- (NSData *)gzippedData
+{
+    return [self gzippedDataWithCompressionLevel:-1.0f];
+}
+
+- (NSData *)gunzippedData
+{
+    if (self.length == 0 || ![self isGzippedData])
+    {
+        return self;
+    }
+
+    NSMutableData *output = [NSMutableData dataWithCapacity:[self gunzippedLengthHint]];
+    if (![self appendGunzippedDataToData:output])
+    {
+        return nil;
+    }
+    return output;
+}
+
++ (NSUInteger)gzippedLengthBoundForLength:(NSUInteger)length
+{
+    // deflateBound without a stream assumes the 6 byte zlib wrapper, the gzip header and trailer take 18 bytes.
+    return deflateBound(Z_NULL, (uLong)length) - 6 + 18;
+}
+
+- (BOOL)appendGzippedDataToData:(NSMutableData *)data compressionLevel:(float)level
+{
     z_stream stream;
     stream.zalloc = Z_NULL;
     stream.zfree = Z_NULL;
@@ -53,77 +89,80 @@
     stream.avail_in = (uint)self.length;
     stream.next_in = (Bytef *)(void *)self.bytes;
     stream.total_out = 0;
-    stream.avail_out = 0;
-
-    static const NSUInteger ChunkSize = 16384;
 
-    NSMutableData *output = nil;
     int compression = (level < 0.0f)? Z_DEFAULT_COMPRESSION: (int)(roundf(level * 9));
-    if (deflateInit2(&stream, compression, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+    if (deflateInit2(&stream, compression, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY) != Z_OK)
     {
-        output = [NSMutableData dataWithLength:ChunkSize];
-        while (stream.avail_out == 0)
-        {
-            if (stream.total_out >= output.length)
-            {
-                output.length += ChunkSize;
-            }
-            stream.next_out = (uint8_t *)output.mutableBytes + stream.total_out;
-            stream.avail_out = (uInt)(output.length - stream.total_out);
-            deflate(&stream, Z_FINISH);
-        }
-        deflateEnd(&stream);
-        output.length = stream.total_out;
+        return NO;
     }
 
-    return output;
+    NSUInteger offset = data.length;
+    NSUInteger bound = deflateBound(&stream, (uLong)self.length);
+    data.length = offset + bound;
+    stream.next_out = (uint8_t *)data.mutableBytes + offset;
+    stream.avail_out = (uInt)bound;
+    int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+
+    data.length = offset + (status == Z_STREAM_END ? stream.total_out : 0);
+    return status == Z_STREAM_END;
 }
 
-- (NSData *)gzippedData
+- (NSUInteger)gunzippedLengthHint
 {
-    return [self gzippedDataWithCompressionLevel:-1.0f];
+    if (self.length < 18 || ![self isGzippedData])
+    {
+        return 0;
+    }
+    const UInt8 *trailer = (const UInt8 *)self.bytes + self.length - 4;
+    NSUInteger isize = (NSUInteger)trailer[0] | ((NSUInteger)trailer[1] << 8) | ((NSUInteger)trailer[2] << 16) | ((NSUInteger)trailer[3] << 24);
+    // The trailer is not authenticated. Deflate expands at most 1032 times, so a larger ISIZE is corrupt.
+    return MIN(isize, self.length * 1032);
 }
 
-- (NSData *)gunzippedData
+- (BOOL)appendGunzippedDataToData:(NSMutableData *)data
 {
-    if (self.length == 0 || ![self isGzippedData])
+    if (![self isGzippedData])
     {
-        return self;
+        return NO;
     }
 
     z_stream stream;
     stream.zalloc = Z_NULL;
     stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
     stream.avail_in = (uint)self.length;
     stream.next_in = (Bytef *)self.bytes;
     stream.total_out = 0;
-    stream.avail_out = 0;
 
-    NSMutableData *output = nil;
-    if (inflateInit2(&stream, 47) == Z_OK)
+    if (inflateInit2(&stream, 47) != Z_OK)
     {
-        int status = Z_OK;
-        output = [NSMutableData dataWithCapacity:self.length * 2];
-        while (status == Z_OK)
+        return NO;
+    }
+
+    // ISIZE is exact for single member streams below 4 GB; grow only if it turns out to be wrong.
+    NSUInteger offset = data.length;
+    NSUInteger expected = [self gunzippedLengthHint];
+    data.length = offset + (expected > 0 ? expected : self.length * 2);
+    int status = Z_OK;
+    while (status == Z_OK)
+    {
+        if (offset + stream.total_out >= data.length)
         {
-            if (stream.total_out >= output.length)
-            {
-                output.length += self.length / 2;
-            }
-            stream.next_out = (uint8_t *)output.mutableBytes + stream.total_out;
-            stream.avail_out = (uInt)(output.length - stream.total_out);
-            status = inflate (&stream, Z_SYNC_FLUSH);
+            data.length += MAX(self.length, (NSUInteger)1024);
         }
-        if (inflateEnd(&stream) == Z_OK)
+        stream.next_out = (uint8_t *)data.mutableBytes + offset + stream.total_out;
+        stream.avail_out = (uInt)(data.length - offset - stream.total_out);
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_BUF_ERROR && stream.avail_out == 0)
         {
-            if (status == Z_STREAM_END)
-            {
-                output.length = stream.total_out;
-            }
+            status = Z_OK;
         }
     }
+    inflateEnd(&stream);
 
-    return output;
+    data.length = offset + (status == Z_STREAM_END ? stream.total_out : 0);
+    return status == Z_STREAM_END;
 }
 
 - (BOOL)isGzippedData
@@ -43,6 +43,8 @@
 #import "YKFChallengeResponseError.h"
 
 #import "YKFSmartCardInterface.h"
+#import "YKFSmartCardResponseConsumer.h"
+#import "YKFSmartCardConnectionRegistry.h"
 
 #import "YKFSCPKeyParamsProtocol.h"
 #import "YKFSCP03KeyParams.h"
@@ -55,6 +57,12 @@
 
 #import "YKFU2FSession.h"
 #import "YKFFIDO2Session.h"
+#import "YKFFIDO2GetInfoCache.h"
+#import "YKFCancellationToken.h"
+#import "YKFCommandPriority.h"
+#import "YKFConnectionMetrics.h"
+#import "YKFTimeoutPolicy.h"
+#import "YKFEventRing.h"
 #import "YKFOATHSession.h"
 #import "YKFPIVSession.h"
 #import "YKFPIVSessionFeatures.h"
@@ -65,6 +73,9 @@
 #import "YKFPIVKeyType.h"
 #import "YKFPIVSlotMetadata.h"
 #import "YKFPIVBioMetadata.h"
+#import "YKFPIVObjectCache.h"
+#import "YKFPIVPinPukMetadata.h"
+#import "YKFPIVMetadataSnapshot.h"
 #import "YKFChallengeResponseSession.h"
 #import "YKFManagementSession.h"
 #import "YKFSCPSecurityDomainSession.h"
@@ -89,3 +100,5 @@
 #import "YKFOATHCredentialTypes.h"
 #import "YKFOATHCredentialTemplate.h"
 #import "YKFOATHCredentialWithCode.h"
+#import "YKFOATHCredentialImportResult.h"
+#import "YKFOATHAccessKeyCache.h"
@@ -57,6 +57,20 @@
  */
 @property (class, nonatomic, nullable) id<YKFOTPTextParserProtocol> customOTPTextParser;
 
+/*!
+ @property accessoryReadinessProbeEnabled
+
+ @abstract
+    When YES (the default), a YubiKey connected over the Lightning port is reported connected once it answers a
+    SELECT command sent right after the session streams open, retried a few times with a short backoff. When NO,
+    the key is reported connected as soon as the streams are open.
+
+ NOTE:
+    The time from opening the session to the key being ready is available in the timeToReady property of the
+    connection metrics.
+ */
+@property (class, nonatomic) BOOL accessoryReadinessProbeEnabled;
+
 - (nonnull instancetype)init NS_UNAVAILABLE;
 
 @end
@@ -34,4 +34,13 @@ static id<YKFOTPTextParserProtocol> internalCustomOTPTextParser = nil;
     internalCustomOTPTextParser = parser;
 }
 
+static BOOL internalAccessoryReadinessProbeEnabled = YES;
+
++ (BOOL)accessoryReadinessProbeEnabled {
+    return internalAccessoryReadinessProbeEnabled;
+}
++ (void)setAccessoryReadinessProbeEnabled:(BOOL)enabled {
+    internalAccessoryReadinessProbeEnabled = enabled;
+}
+
 @end
@@ -15,6 +15,21 @@
 #import <Foundation/Foundation.h>
 
 NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ @enum YKFLogLevel
+
+ @abstract
+    The levels of the library logs. A level includes all the levels above it.
+ */
+typedef NS_ENUM(NSUInteger, YKFLogLevel) {
+    YKFLogLevelNone = 0,
+    YKFLogLevelError = 1,
+    YKFLogLevelInfo = 2,
+    /// Verbose logs (e.g. the APDUs sent to the key) are only compiled in when YKF_ENABLE_VERBOSE_LOGGING is defined.
+    YKFLogLevelVerbose = 3
+};
+
 /*!
  @protocol YubiKitLoggerProtocol
  
@@ -41,6 +56,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (class, nonatomic, nullable) id<YubiKitLoggerProtocol> customLogger;
 
+/*!
+ @abstract
+    The most detailed level which is logged. Defaults to YKFLogLevelVerbose.
+
+ @discussion
+    Messages above this level are skipped before their arguments are evaluated. In release builds messages are only
+    formatted when a customLogger is set.
+ */
+@property (class, nonatomic) YKFLogLevel logLevel;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -13,16 +13,36 @@
 // limitations under the License.
 
 #import "YubiKitLogger.h"
+#import "YKFLogger.h"
 
 @implementation YubiKitLogger
 
 static id<YubiKitLoggerProtocol> internalCustomLogger = nil;
+static YKFLogLevel internalLogLevel = YKFLogLevelVerbose;
 
 + (id<YubiKitLoggerProtocol>)customLogger {
     return internalCustomLogger;
 }
 + (void)setCustomLogger:(id<YubiKitLoggerProtocol>)logger {
     internalCustomLogger = logger;
+    [self updateEnabledLogLevel];
+}
+
++ (YKFLogLevel)logLevel {
+    return internalLogLevel;
+}
++ (void)setLogLevel:(YKFLogLevel)logLevel {
+    internalLogLevel = logLevel;
+    [self updateEnabledLogLevel];
+}
+
++ (void)updateEnabledLogLevel {
+#ifdef DEBUG
+    // Debug builds always log to the console.
+    YKFLogSetEnabledLevel(internalLogLevel);
+#else
+    YKFLogSetEnabledLevel(internalCustomLogger ? internalLogLevel : YKFLogLevelNone);
+#endif
 }
 
 @end
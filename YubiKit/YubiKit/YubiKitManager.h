@@ -18,6 +18,7 @@
 #import "YKFNFCConnection.h"
 #import "YKFAccessoryConnection.h"
 #import "YKFSmartCardConnection.h"
+#import "YKFSmartCardConnectionRegistry.h"
 
 /*!
  @protocol YKFManagerDelegate
@@ -232,6 +233,19 @@
  */
 - (void)stopSmartCardConnection API_AVAILABLE(ios(16.0));
 
+/*!
+ @property smartCardConnectionRegistry
+ 
+ @abstract
+    Tracks every attached smart card slot and keeps one connection for each YubiKey.
+ 
+ @discussion
+    Use the registry instead of startSmartCardConnection when several keys are attached at the same time.
+    Commands sent to different keys run in parallel. Set the delegate of the registry and call start to
+    get notified when a key is attached or removed.
+ */
+@property(nonatomic, nonnull, readonly) YKFSmartCardConnectionRegistry *smartCardConnectionRegistry API_AVAILABLE(ios(16.0));
+
 
 /*!
  @property otpSession
@@ -21,12 +21,14 @@
 #import "YKFAccessoryConnection+Private.h"
 #import "YKFNFCConnection+Private.h"
 #import "YKFSmartCardConnection+Private.h"
+#import "YKFSmartCardConnectionRegistry+Private.h"
 
 @interface YubiKitManager()<YKFAccessoryConnectionDelegate, YKFNFCConnectionDelegate, YKFSmartCardConnectionDelegate>
 
 @property (nonatomic, readwrite) YKFNFCConnection *nfcConnection;
 @property (nonatomic, readwrite) YKFAccessoryConnection *accessoryConnection;
 @property (nonatomic, readwrite) YKFSmartCardConnection *smartCardConnection;
+@property (nonatomic, readwrite) YKFSmartCardConnectionRegistry *smartCardConnectionRegistry API_AVAILABLE(ios(16.0));
 @property (nonatomic, readwrite) YKFNFCOTPSession *otpSession;
 
 @end
@@ -62,6 +64,7 @@ static YubiKitManager *sharedInstance;
         
         if (@available(iOS 16.0, *)) {
             self.smartCardConnection = [[YKFSmartCardConnection alloc] initWithDelegate:self];
+            self.smartCardConnectionRegistry = [[YKFSmartCardConnectionRegistry alloc] initWithSlotSource:[[YKFTokenKitSlotSource alloc] init]];
         }
         
         if (@available(iOS 11.0, *)) {
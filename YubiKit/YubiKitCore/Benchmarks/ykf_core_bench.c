@@ -0,0 +1,162 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the codec and crypto hot paths of the portable core. Prints the time per operation:
+//   ykf_core_bench [iterations]
+// Build with -DCMAKE_BUILD_TYPE=RelWithDebInfo to profile it with perf, valgrind or Instruments.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ykf_core.h"
+#include "ykf_aes_openssl.h"
+
+// Keeps the compiler from removing the benchmarked calls.
+static volatile uint64_t sink;
+
+static double now_ns(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec * 1e9 + (double)time.tv_nsec;
+}
+
+#define BENCHMARK(name, iterations, body) do { \
+    double start = now_ns(); \
+    for (long i = 0; i < (iterations); i++) { body; } \
+    double elapsed = now_ns() - start; \
+    printf("%-36s %12.1f ns/op\n", name, elapsed / (double)(iterations)); \
+} while (0)
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    // The record walk and the crypto run a tenth of the iterations, at least one.
+    long slow_iterations = iterations / 10 > 0 ? iterations / 10 : 1;
+    
+    uint8_t data[1024];
+    uint8_t out[1200];
+    size_t length = 0;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 31);
+    }
+    
+    // APDU
+    BENCHMARK("apdu encode short 200 B", iterations, {
+        ykf_apdu_encode(0x00, 0xDB, 0x3F, 0xFF, data, 200, YKF_APDU_TYPE_SHORT, out, sizeof(out), &length);
+        sink += length;
+    });
+    BENCHMARK("apdu encode extended 1 KB", iterations, {
+        ykf_apdu_encode(0x00, 0xDB, 0x3F, 0xFF, data, sizeof(data), YKF_APDU_TYPE_EXTENDED, out, sizeof(out), &length);
+        sink += length;
+    });
+    
+    // TLV: a sequence of records like a PIV metadata or OATH LIST response.
+    uint8_t records[1024];
+    size_t records_length = 0;
+    while (records_length + 2 + 20 <= sizeof(records)) {
+        records_length += ykf_tlv_encode_header(0x71, 20, records + records_length);
+        memcpy(records + records_length, data, 20);
+        records_length += 20;
+    }
+    BENCHMARK("tlv parse header", iterations, {
+        ykf_tlv_header header;
+        ykf_tlv_parse_header(records, records_length, &header);
+        sink += header.value_length;
+    });
+    BENCHMARK("tlv walk 46 records", slow_iterations, {
+        size_t offset = 0;
+        ykf_tlv_header header;
+        while (offset < records_length && ykf_tlv_parse_record(records + offset, records_length - offset, &header) == YKF_OK) {
+            offset += header.header_length + header.value_length;
+        }
+        sink += offset;
+    });
+    BENCHMARK("tlv encode header", iterations, {
+        sink += ykf_tlv_encode_header(0x5FC105, (size_t)i & 0xFFFF, out);
+    });
+    
+    // CBOR
+    BENCHMARK("cbor encode integer", iterations, {
+        sink += ykf_cbor_encode_integer((int64_t)i * 7919 - 1000000, out);
+    });
+    uint8_t cbor[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t cbor_length = ykf_cbor_encode_integer(-1000000000000, cbor);
+    BENCHMARK("cbor decode integer", iterations, {
+        int64_t value;
+        size_t head_length;
+        ykf_cbor_decode_integer(cbor, cbor_length, &value, &head_length);
+        sink += (uint64_t)value;
+    });
+    
+    // AES-CMAC and SCP03
+    const ykf_aes_ops *ops = ykf_aes_openssl_ops();
+    uint8_t key[16];
+    uint8_t mac[YKF_AES_BLOCK_SIZE];
+    uint8_t chain[YKF_AES_BLOCK_SIZE] = {0};
+    memcpy(key, data, sizeof(key));
+    BENCHMARK("aes-cmac 64 B", slow_iterations, {
+        ykf_aes_cmac(ops, key, sizeof(key), data, 64, mac);
+        sink += mac[0];
+    });
+    BENCHMARK("aes-cmac 1 KB", slow_iterations, {
+        ykf_aes_cmac(ops, key, sizeof(key), data, sizeof(data), mac);
+        sink += mac[0];
+    });
+    BENCHMARK("scp03 encrypt 255 B", slow_iterations, {
+        ykf_scp_encrypt(ops, key, sizeof(key), (uint32_t)i, data, 255, out, sizeof(out), &length);
+        sink += length;
+    });
+    BENCHMARK("scp03 c-mac 255 B", slow_iterations, {
+        ykf_scp_mac(ops, key, sizeof(key), chain, data, 255, mac);
+        sink += mac[0];
+    });
+    
+    // OATH and PIV
+    char code[YKF_OATH_MAX_CODE_LENGTH];
+    BENCHMARK("oath format code", iterations, {
+        ykf_oath_format_code(data + (i & 0xFF), 4, 6 + (uint8_t)(i % 3), code, sizeof(code));
+        sink += (uint64_t)code[0];
+    });
+    BENCHMARK("piv pad ec hash", iterations, {
+        ykf_piv_pad_ec_hash(data, 32, 48, out);
+        sink += out[47];
+    });
+    
+    // Secure arena against the system allocator for a scoped 32 byte secret.
+    ykf_secure_arena arena;
+    if (ykf_secure_arena_init(&arena, 4096) != YKF_OK) {
+        return 1;
+    }
+    BENCHMARK("secure arena scope 32 B", iterations, {
+        size_t mark = ykf_secure_arena_mark(&arena);
+        uint8_t *secret = ykf_secure_arena_alloc(&arena, 32);
+        memcpy(secret, data + (i & 0xFF), 32);
+        sink += secret[31];
+        ykf_secure_arena_release(&arena, mark);
+    });
+    BENCHMARK("malloc, zero and free 32 B", iterations, {
+        uint8_t *secret = malloc(32);
+        memcpy(secret, data + (i & 0xFF), 32);
+        sink += secret[31];
+        ykf_secure_zero(secret, 32);
+        free(secret);
+    });
+    ykf_secure_arena_destroy(&arena);
+    
+    return sink == 0xFFFFFFFFFFFFFFFF ? 1 : 0;
+}
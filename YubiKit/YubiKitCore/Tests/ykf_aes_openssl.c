@@ -0,0 +1,65 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <openssl/evp.h>
+#include "ykf_aes_openssl.h"
+
+static const EVP_CIPHER *ykf_openssl_cipher(size_t key_length) {
+    switch (key_length) {
+        case 16: return EVP_aes_128_cbc();
+        case 24: return EVP_aes_192_cbc();
+        case 32: return EVP_aes_256_cbc();
+        default: return NULL;
+    }
+}
+
+static ykf_status ykf_openssl_cbc(int encrypt, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                  const uint8_t *in, size_t length, uint8_t *out) {
+    static const uint8_t zero_iv[YKF_AES_BLOCK_SIZE] = {0};
+    const EVP_CIPHER *cipher = ykf_openssl_cipher(key_length);
+    if (!cipher || length % YKF_AES_BLOCK_SIZE || length > INT32_MAX) {
+        return YKF_ERR_INVALID_ARGUMENT;
+    }
+    
+    EVP_CIPHER_CTX *context = EVP_CIPHER_CTX_new();
+    int out_length = 0;
+    int ok = context &&
+             EVP_CipherInit_ex(context, cipher, NULL, key, iv ? iv : zero_iv, encrypt) &&
+             EVP_CIPHER_CTX_set_padding(context, 0) &&
+             EVP_CipherUpdate(context, out, &out_length, in, (int)length) &&
+             (size_t)out_length == length;
+    EVP_CIPHER_CTX_free(context);
+    return ok ? YKF_OK : YKF_ERR_CRYPTO;
+}
+
+static ykf_status ykf_openssl_cbc_encrypt(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                          const uint8_t *in, size_t length, uint8_t *out) {
+    (void)context;
+    return ykf_openssl_cbc(1, key, key_length, iv, in, length, out);
+}
+
+static ykf_status ykf_openssl_cbc_decrypt(void *context, const uint8_t *key, size_t key_length, const uint8_t *iv,
+                                          const uint8_t *in, size_t length, uint8_t *out) {
+    (void)context;
+    return ykf_openssl_cbc(0, key, key_length, iv, in, length, out);
+}
+
+const ykf_aes_ops *ykf_aes_openssl_ops(void) {
+    static const ykf_aes_ops ops = {
+        NULL,
+        ykf_openssl_cbc_encrypt,
+        ykf_openssl_cbc_decrypt
+    };
+    return &ops;
+}
@@ -0,0 +1,408 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests of the portable core. Run through CTest:
+//   cmake -S . -B build && cmake --build build && ctest --test-dir build
+
+#include <stdio.h>
+#include <string.h>
+#include "ykf_core.h"
+#include "ykf_aes_openssl.h"
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    } \
+} while (0)
+
+static size_t hex(const char *string, uint8_t *out) {
+    size_t length = 0;
+    int high = -1;
+    for (; *string; string++) {
+        int nibble;
+        char c = *string;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else continue;
+        if (high < 0) {
+            high = nibble;
+        } else {
+            out[length++] = (uint8_t)(high << 4 | nibble);
+            high = -1;
+        }
+    }
+    return length;
+}
+
+static int equals_hex(const uint8_t *data, size_t length, const char *expected) {
+    uint8_t buffer[512];
+    size_t expected_length = hex(expected, buffer);
+    return expected_length == length && memcmp(buffer, data, length) == 0;
+}
+
+// APDU
+
+static void test_apdu(void) {
+    uint8_t data[300];
+    uint8_t out[400];
+    size_t length = 0;
+    memset(data, 0xAB, sizeof(data));
+    
+    CHECK(ykf_apdu_encode(0x00, 0xA4, 0x04, 0x00, NULL, 0, YKF_APDU_TYPE_SHORT, out, sizeof(out), &length) == YKF_OK);
+    CHECK(equals_hex(out, length, "00a40400"));
+    
+    CHECK(ykf_apdu_encode(0x00, 0xA4, 0x04, 0x00, data, 3, YKF_APDU_TYPE_SHORT, out, sizeof(out), &length) == YKF_OK);
+    CHECK(equals_hex(out, length, "00a4040003abab ab"));
+    
+    CHECK(ykf_apdu_encode(0x00, 0xCB, 0x3F, 0xFF, NULL, 0, YKF_APDU_TYPE_EXTENDED, out, sizeof(out), &length) == YKF_OK);
+    CHECK(equals_hex(out, length, "00cb3fff000000"));
+    
+    CHECK(ykf_apdu_encode(0x00, 0xDB, 0x3F, 0xFF, data, 300, YKF_APDU_TYPE_EXTENDED, out, sizeof(out), &length) == YKF_OK);
+    CHECK(length == 7 + 300 && ykf_apdu_encoded_length(YKF_APDU_TYPE_EXTENDED, 300) == length);
+    CHECK(equals_hex(out, 7, "00db3fff00012c") && out[306] == 0xAB);
+    
+    CHECK(ykf_apdu_encode(0x00, 0xDB, 0x3F, 0xFF, data, 256, YKF_APDU_TYPE_SHORT, out, sizeof(out), &length) == YKF_ERR_INVALID_ARGUMENT);
+    CHECK(ykf_apdu_encode(0x00, 0xDB, 0x3F, 0xFF, data, 10, YKF_APDU_TYPE_SHORT, out, 14, &length) == YKF_ERR_BUFFER_TOO_SMALL);
+}
+
+// TLV
+
+static void test_tlv(void) {
+    uint8_t buffer[64];
+    ykf_tlv_header header;
+    size_t length;
+    
+    length = hex("1e03112233", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_OK);
+    CHECK(header.tag == 0x1e && header.header_length == 2 && header.value_length == 3);
+    
+    length = hex("1e00", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_OK && header.value_length == 0);
+    
+    length = hex("7f49 8188", buffer);
+    CHECK(ykf_tlv_parse_header(buffer, length, &header) == YKF_OK);
+    CHECK(header.tag == 0x7f49 && header.header_length == 4 && header.value_length == 0x88);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_ERR_NEED_MORE_DATA);
+    
+    length = hex("DF81818181818101 03 303132", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_OK && header.tag == 0xDF81818181818101);
+    
+    length = hex("DF8181818181818101 03 303132", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_ERR_INVALID_DATA);
+    
+    length = hex("1e80", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_ERR_INVALID_DATA);
+    length = hex("1e89 010203040506070809", buffer);
+    CHECK(ykf_tlv_parse_record(buffer, length, &header) == YKF_ERR_INVALID_DATA);
+    
+    // Every prefix of a record needs more data.
+    length = hex("5f c1 05 82 01 00", buffer);
+    for (size_t i = 0; i < length; i++) {
+        CHECK(ykf_tlv_parse_header(buffer, i, &header) == YKF_ERR_NEED_MORE_DATA);
+    }
+    CHECK(ykf_tlv_parse_header(buffer, length, &header) == YKF_OK && header.tag == 0x5fc105 && header.value_length == 256);
+    
+    const struct { ykf_tlv_tag tag; size_t length; const char *expected; } headers[] = {
+        {0x53, 0, "5300"},
+        {0x53, 0x7F, "537f"},
+        {0x53, 0x80, "538180"},
+        {0x7f49, 0xFF, "7f4981ff"},
+        {0x5fc105, 0x100, "5fc105820100"},
+        {0x53, 0x10000, "5383010000"},
+    };
+    for (size_t i = 0; i < sizeof(headers) / sizeof(headers[0]); i++) {
+        uint8_t out[YKF_TLV_MAX_HEADER_LENGTH];
+        size_t out_length = ykf_tlv_encode_header(headers[i].tag, headers[i].length, out);
+        CHECK(equals_hex(out, out_length, headers[i].expected));
+        CHECK(ykf_tlv_parse_header(out, out_length, &header) == YKF_OK);
+        CHECK(header.tag == headers[i].tag && header.value_length == headers[i].length && header.header_length == out_length);
+    }
+}
+
+// CBOR
+
+static void test_cbor(void) {
+    const struct { int64_t value; const char *expected; } integers[] = {
+        {0, "00"}, {23, "17"}, {24, "1818"}, {100, "1864"}, {1000, "1903e8"}, {1000000, "1a000f4240"},
+        {1000000000000, "1b000000e8d4a51000"}, {INT64_MAX, "1b7fffffffffffffff"},
+        {-1, "20"}, {-10, "29"}, {-24, "37"}, {-25, "3818"}, {-100, "3863"}, {-129, "3880"}, {-256, "38ff"},
+        {-1000, "3903e7"}, {INT64_MIN, "3b7fffffffffffffff"},
+    };
+    for (size_t i = 0; i < sizeof(integers) / sizeof(integers[0]); i++) {
+        uint8_t out[YKF_CBOR_MAX_HEAD_LENGTH];
+        size_t length = ykf_cbor_encode_integer(integers[i].value, out);
+        CHECK(equals_hex(out, length, integers[i].expected));
+        
+        int64_t value = 0;
+        size_t head_length = 0;
+        CHECK(ykf_cbor_decode_integer(out, length, &value, &head_length) == YKF_OK);
+        CHECK(value == integers[i].value && head_length == length);
+        for (size_t j = 0; j < length; j++) {
+            CHECK(ykf_cbor_decode_integer(out, j, &value, &head_length) == YKF_ERR_NEED_MORE_DATA);
+        }
+    }
+    
+    uint8_t out[YKF_CBOR_MAX_HEAD_LENGTH];
+    size_t length = ykf_cbor_encode_head(YKF_CBOR_MAJOR_TYPE_MAP, 2, out);
+    CHECK(equals_hex(out, length, "a2"));
+    length = ykf_cbor_encode_head(YKF_CBOR_MAJOR_TYPE_BYTE_STRING, 300, out);
+    CHECK(equals_hex(out, length, "59012c"));
+    
+    uint8_t buffer[16];
+    uint8_t major_type;
+    uint64_t argument;
+    size_t head_length;
+    int64_t value;
+    length = hex("f5", buffer);
+    CHECK(ykf_cbor_decode_head(buffer, length, &major_type, &argument, &head_length) == YKF_OK);
+    CHECK(major_type == YKF_CBOR_MAJOR_TYPE_SIMPLE && argument == 21 && head_length == 1);
+    length = hex("1bffffffffffffffff", buffer);
+    CHECK(ykf_cbor_decode_integer(buffer, length, &value, &head_length) == YKF_ERR_INVALID_DATA);
+    length = hex("1c", buffer);
+    CHECK(ykf_cbor_decode_head(buffer, length, &major_type, &argument, &head_length) == YKF_ERR_INVALID_DATA);
+    length = hex("5f", buffer);
+    CHECK(ykf_cbor_decode_head(buffer, length, &major_type, &argument, &head_length) == YKF_ERR_INVALID_DATA);
+    length = hex("6161", buffer);
+    CHECK(ykf_cbor_decode_integer(buffer, length, &value, &head_length) == YKF_ERR_INVALID_DATA);
+}
+
+// AES
+
+static void test_aes_cmac(void) {
+    const ykf_aes_ops *ops = ykf_aes_openssl_ops();
+    uint8_t key[16];
+    uint8_t message[64];
+    uint8_t mac[YKF_AES_BLOCK_SIZE];
+    hex("2b7e1516 28aed2a6 abf71588 09cf4f3c", key);
+    hex("6bc1bee2 2e409f96 e93d7e11 7393172a ae2d8a57 1e03ac9c 9eb76fac 45af8e51 "
+        "30c81c46 a35ce411 e5fbc119 1a0a52ef f69f2445 df4f9b17 ad2b417b e66c3710", message);
+    
+    // RFC 4493 examples.
+    const struct { size_t length; const char *expected; } examples[] = {
+        {0, "bb1d6929 e9593728 7fa37d12 9b756746"},
+        {16, "070a16b4 6b4d4144 f79bdd9d d04a287c"},
+        {40, "dfa66747 de9ae630 30ca3261 1497c827"},
+        {64, "51f0bebf 7e3b9d92 fc497417 79363cfe"},
+    };
+    for (size_t i = 0; i < sizeof(examples) / sizeof(examples[0]); i++) {
+        CHECK(ykf_aes_cmac(ops, key, sizeof(key), message, examples[i].length, mac) == YKF_OK);
+        CHECK(equals_hex(mac, sizeof(mac), examples[i].expected));
+        
+        // Fed in two parts split at every offset.
+        for (size_t split = 0; split <= examples[i].length; split++) {
+            ykf_aes_cmac_context context;
+            CHECK(ykf_aes_cmac_init(&context, ops, key, sizeof(key)) == YKF_OK);
+            CHECK(ykf_aes_cmac_update(&context, message, split) == YKF_OK);
+            CHECK(ykf_aes_cmac_update(&context, message + split, examples[i].length - split) == YKF_OK);
+            CHECK(ykf_aes_cmac_final(&context, mac) == YKF_OK);
+            CHECK(equals_hex(mac, sizeof(mac), examples[i].expected));
+        }
+    }
+    CHECK(ykf_aes_cmac(ops, key, 15, message, 16, mac) == YKF_ERR_INVALID_ARGUMENT);
+}
+
+static void test_aes_cbc(void) {
+    const ykf_aes_ops *ops = ykf_aes_openssl_ops();
+    uint8_t key[16], iv[16], out[16];
+    hex("5ec1bf26a34a6300c23bb45a9f842049", key);
+    hex("000102030405060708090a0b0c0d0e0f", iv);
+    CHECK(ops->cbc_encrypt(ops->context, key, sizeof(key), iv, (const uint8_t *)"Hello World!0000", 16, out) == YKF_OK);
+    CHECK(equals_hex(out, sizeof(out), "9dcb09c51227ea753fad4c6bda8efa46"));
+    CHECK(ops->cbc_decrypt(ops->context, key, sizeof(key), iv, out, 16, out) == YKF_OK);
+    CHECK(memcmp(out, "Hello World!0000", 16) == 0);
+}
+
+static void test_bit_padding(void) {
+    uint8_t data[32];
+    uint8_t out[48];
+    size_t length;
+    memset(data, 0x11, sizeof(data));
+    
+    CHECK(ykf_bit_pad(data, 0, out, sizeof(out), &length) == YKF_OK);
+    CHECK(equals_hex(out, length, "80000000000000000000000000000000"));
+    CHECK(ykf_bit_pad(data, 15, out, sizeof(out), &length) == YKF_OK && length == 16 && out[15] == 0x80);
+    CHECK(ykf_bit_pad(data, 16, out, sizeof(out), &length) == YKF_OK && length == 32 && out[16] == 0x80 && out[31] == 0);
+    CHECK(ykf_bit_pad(data, 32, out, 32, &length) == YKF_ERR_BUFFER_TOO_SMALL);
+    
+    CHECK(ykf_bit_pad(data, 16, out, sizeof(out), &length) == YKF_OK);
+    CHECK(ykf_bit_unpad(out, length, &length) == YKF_OK && length == 16);
+    memset(out, 0, sizeof(out));
+    CHECK(ykf_bit_unpad(out, 16, &length) == YKF_ERR_INVALID_DATA);
+    out[3] = 0x81;
+    CHECK(ykf_bit_unpad(out, 16, &length) == YKF_ERR_INVALID_DATA);
+}
+
+// SCP
+
+static void test_scp(void) {
+    const ykf_aes_ops *ops = ykf_aes_openssl_ops();
+    uint8_t senc[16], smac[16], srmac[16];
+    uint8_t chain[YKF_AES_BLOCK_SIZE] = {0};
+    uint8_t data[40];
+    uint8_t encrypted[48], decrypted[48];
+    size_t encrypted_length, decrypted_length;
+    hex("404142434445464748494a4b4c4d4e4f", senc);
+    hex("505152535455565758595a5b5c5d5e5f", smac);
+    hex("606162636465666768696a6b6c6d6e6f", srmac);
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    
+    CHECK(ykf_scp_encrypt(ops, senc, 16, 7, data, sizeof(data), encrypted, sizeof(encrypted), &encrypted_length) == YKF_OK);
+    CHECK(encrypted_length == 48);
+    
+    // The response iv differs from the command iv; decrypt the command by hand to check the command encryption.
+    uint8_t iv[16] = {0};
+    iv[15] = 7;
+    CHECK(ops->cbc_encrypt(ops->context, senc, 16, NULL, iv, 16, iv) == YKF_OK);
+    CHECK(ops->cbc_decrypt(ops->context, senc, 16, iv, encrypted, encrypted_length, decrypted) == YKF_OK);
+    CHECK(memcmp(decrypted, data, sizeof(data)) == 0 && decrypted[40] == 0x80);
+    
+    // Encrypt a response the way the key does and decrypt it.
+    uint8_t padded[48];
+    size_t padded_length;
+    CHECK(ykf_bit_pad(data, 20, padded, sizeof(padded), &padded_length) == YKF_OK);
+    memset(iv, 0, sizeof(iv));
+    iv[0] = 0x80;
+    iv[15] = 7;
+    CHECK(ops->cbc_encrypt(ops->context, senc, 16, NULL, iv, 16, iv) == YKF_OK);
+    CHECK(ops->cbc_encrypt(ops->context, senc, 16, iv, padded, padded_length, encrypted) == YKF_OK);
+    CHECK(ykf_scp_decrypt(ops, senc, 16, 7, encrypted, padded_length, decrypted, sizeof(decrypted), &decrypted_length) == YKF_OK);
+    CHECK(decrypted_length == 20 && memcmp(decrypted, data, 20) == 0);
+    CHECK(ykf_scp_decrypt(ops, senc, 16, 7, encrypted, 20, decrypted, sizeof(decrypted), &decrypted_length) == YKF_ERR_INVALID_DATA);
+    
+    // The C-MAC chains: each MAC covers the previous chain value.
+    uint8_t mac[YKF_SCP_MAC_LENGTH];
+    uint8_t expected[YKF_AES_BLOCK_SIZE];
+    uint8_t message[16 + sizeof(data) + 2];
+    CHECK(ykf_scp_mac(ops, smac, 16, chain, data, sizeof(data), mac) == YKF_OK);
+    memset(message, 0, 16);
+    memcpy(message + 16, data, sizeof(data));
+    CHECK(ykf_aes_cmac(ops, smac, 16, message, 16 + sizeof(data), expected) == YKF_OK);
+    CHECK(memcmp(chain, expected, 16) == 0 && memcmp(mac, expected, 8) == 0);
+    
+    // The R-MAC covers the chain, the response data and the status word but does not advance the chain.
+    uint8_t response[24 + YKF_SCP_MAC_LENGTH];
+    memcpy(response, data, 24);
+    memcpy(message, chain, 16);
+    memcpy(message + 16, data, 24);
+    message[40] = 0x90;
+    message[41] = 0x00;
+    CHECK(ykf_aes_cmac(ops, srmac, 16, message, 42, expected) == YKF_OK);
+    memcpy(response + 24, expected, YKF_SCP_MAC_LENGTH);
+    CHECK(ykf_scp_unmac(ops, srmac, 16, chain, response, sizeof(response), 0x9000) == YKF_OK);
+    CHECK(ykf_scp_unmac(ops, srmac, 16, chain, response, sizeof(response), 0x6A80) == YKF_ERR_MAC_MISMATCH);
+    response[0] ^= 1;
+    CHECK(ykf_scp_unmac(ops, srmac, 16, chain, response, sizeof(response), 0x9000) == YKF_ERR_MAC_MISMATCH);
+    CHECK(ykf_scp_unmac(ops, srmac, 16, chain, response, 7, 0x9000) == YKF_ERR_INVALID_DATA);
+}
+
+// OATH and PIV
+
+static void test_oath(void) {
+    char code[YKF_OATH_MAX_CODE_LENGTH];
+    uint8_t truncated[4];
+    
+    hex("7fffffff", truncated);
+    CHECK(ykf_oath_format_code(truncated, 4, 6, code, sizeof(code)) == YKF_OK && strcmp(code, "483647") == 0);
+    CHECK(ykf_oath_format_code(truncated, 4, 8, code, sizeof(code)) == YKF_OK && strcmp(code, "47483647") == 0);
+    hex("80000001", truncated);
+    CHECK(ykf_oath_format_code(truncated, 4, 6, code, sizeof(code)) == YKF_OK && strcmp(code, "000001") == 0);
+    CHECK(ykf_oath_format_code(truncated, 4, 7, code, sizeof(code)) == YKF_OK && strcmp(code, "0000001") == 0);
+    CHECK(ykf_oath_format_code(truncated, 4, 5, code, sizeof(code)) == YKF_ERR_INVALID_DATA);
+    CHECK(ykf_oath_format_code(truncated, 3, 6, code, sizeof(code)) == YKF_ERR_INVALID_DATA);
+    CHECK(ykf_oath_format_code(truncated, 4, 8, code, 8) == YKF_ERR_BUFFER_TOO_SMALL);
+}
+
+static void test_piv(void) {
+    uint8_t hash[64];
+    uint8_t out[48];
+    for (size_t i = 0; i < sizeof(hash); i++) {
+        hash[i] = (uint8_t)(i + 1);
+    }
+    CHECK(ykf_piv_pad_ec_hash(hash, 32, 48, out) == YKF_OK);
+    CHECK(out[0] == 0 && out[15] == 0 && out[16] == 1 && out[47] == 32);
+    CHECK(ykf_piv_pad_ec_hash(hash, 64, 32, out) == YKF_OK);
+    CHECK(out[0] == 1 && out[31] == 32);
+    CHECK(ykf_piv_pad_ec_hash(hash, 32, 32, out) == YKF_OK && memcmp(out, hash, 32) == 0);
+}
+
+static void test_secure_arena(void) {
+    ykf_secure_arena arena;
+    CHECK(ykf_secure_arena_init(&arena, 100) == YKF_OK);
+    CHECK(arena.capacity >= 100 && arena.used == 0);
+    
+    size_t outer = ykf_secure_arena_mark(&arena);
+    uint8_t *pin = ykf_secure_arena_alloc(&arena, 8);
+    CHECK(pin != NULL && ((uintptr_t)pin % YKF_SECURE_ARENA_ALIGNMENT) == 0);
+    CHECK(ykf_secure_arena_contains(&arena, pin) && !ykf_secure_arena_contains(&arena, &arena));
+    memset(pin, 0x31, 8);
+    
+    size_t inner = ykf_secure_arena_mark(&arena);
+    uint8_t *key = ykf_secure_arena_alloc(&arena, 24);
+    CHECK(key != NULL && key >= pin + 8 && ((uintptr_t)key % YKF_SECURE_ARENA_ALIGNMENT) == 0);
+    memset(key, 0xAA, 24);
+    
+    // Releasing the inner scope wipes the key only.
+    ykf_secure_arena_release(&arena, inner);
+    CHECK(arena.used == inner);
+    CHECK(pin[0] == 0x31 && pin[7] == 0x31);
+    int zeroed = 1;
+    for (size_t i = 0; i < 24; i++) {
+        zeroed &= key[i] == 0;
+    }
+    CHECK(zeroed);
+    
+    // Released memory is handed out again, zeroed.
+    uint8_t *reused = ykf_secure_arena_alloc(&arena, 24);
+    CHECK(reused == key && reused[0] == 0);
+    
+    CHECK(ykf_secure_arena_alloc(&arena, arena.capacity) == NULL);
+    CHECK(ykf_secure_arena_alloc(&arena, 0) == NULL);
+    
+    ykf_secure_arena_release(&arena, outer);
+    CHECK(arena.used == 0 && pin[0] == 0);
+    
+    uint8_t *whole = ykf_secure_arena_alloc(&arena, arena.capacity);
+    CHECK(whole != NULL);
+    
+    ykf_secure_arena_destroy(&arena);
+    CHECK(arena.base == NULL && arena.capacity == 0);
+    CHECK(ykf_secure_arena_alloc(&arena, 1) == NULL);
+    CHECK(ykf_secure_arena_init(&arena, 0) == YKF_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+    test_apdu();
+    test_tlv();
+    test_cbor();
+    test_aes_cmac();
+    test_aes_cbc();
+    test_bit_padding();
+    test_scp();
+    test_oath();
+    test_piv();
+    test_secure_arena();
+    
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All core tests passed\n");
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeSmartCard.h"
+
+@interface FakeSmartCard()
+
+@property (nonatomic) NSMutableArray<NSData *> *requests;
+@property (nonatomic) dispatch_queue_t replyQueue;
+
+@end
+
+@implementation FakeSmartCard
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.valid = YES;
+        self.requests = [[NSMutableArray alloc] init];
+        self.replyQueue = dispatch_queue_create("com.yubico.FakeSmartCard", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (NSArray<NSData *> *)receivedRequests {
+    @synchronized (self) {
+        return [self.requests copy];
+    }
+}
+
+- (void)beginSessionWithReply:(void (^)(BOOL, NSError *))reply {
+    self.sessionStarted = YES;
+    dispatch_async(self.replyQueue, ^{
+        reply(YES, nil);
+    });
+}
+
+- (void)transmitRequest:(NSData *)request reply:(void (^)(NSData *, NSError *))reply {
+    @synchronized (self) {
+        [self.requests addObject:request];
+    }
+    UInt8 statusWord[] = {0x90, 0x00};
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.latency * NSEC_PER_SEC)), self.replyQueue, ^{
+        reply([NSData dataWithBytes:statusWord length:2], nil);
+    });
+}
+
+- (void)endSession {
+    self.sessionStarted = NO;
+}
+
+@end
@@ -17,6 +17,9 @@
 @interface FakeYKFConnectionController()
 
 @property (nonatomic, assign) NSUInteger commandExecutionSequenceIndex;
+@property (nonatomic, readwrite) YKFCancellationToken *cancellationToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
 
 @end
 
@@ -62,6 +65,35 @@
     ++self.commandExecutionSequenceIndex;
 }
 
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout completion:completion];
+}
+
+- (YKFCancellationToken *)cancellationToken {
+    if (!_cancellationToken) {
+        _cancellationToken = [[YKFCancellationToken alloc] init];
+    }
+    return _cancellationToken;
+}
+
+- (YKFConnectionMetrics *)metrics {
+    if (!_metrics) {
+        _metrics = [[YKFConnectionMetrics alloc] init];
+    }
+    return _metrics;
+}
+
+- (YKFTimeoutPolicy *)timeoutPolicy {
+    if (!_timeoutPolicy) {
+        _timeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    }
+    return _timeoutPolicy;
+}
+
 - (void)dispatchOnSequentialQueue:(YKFConnectionControllerCompletionBlock)block delay:(NSTimeInterval)delay {
     self.operationExecutionBlock = block;
     
@@ -87,7 +119,9 @@
 }
 
 - (void)cancelAllCommands {
-    // Do nothing
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    _cancellationToken = nil;
+    [cancellationToken cancel];
 }
 
 - (void)dispatchBlockOnCommunicationQueue:(nonnull YKFConnectionControllerCommunicationQueueBlock)block {
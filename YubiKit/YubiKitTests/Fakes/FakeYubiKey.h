@@ -0,0 +1,118 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <Foundation/Foundation.h>
+#import "YKFConnectionControllerProtocol.h"
+#import "YKFAPDUError.h"
+#import "YKFVersion.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class FakeYubiKey;
+@class YKFSCPStaticKeys;
+
+/*
+ A command APDU parsed by the simulated key. Short and extended encodings are both accepted.
+ */
+@interface FakeYubiKeyCommand: NSObject
+
+@property (nonatomic, readonly) UInt8 cla;
+@property (nonatomic, readonly) UInt8 ins;
+@property (nonatomic, readonly) UInt8 p1;
+@property (nonatomic, readonly) UInt8 p2;
+@property (nonatomic, readonly) NSData *data;
+
++ (nullable instancetype)commandWithData:(NSData *)data;
+- (instancetype)initWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data;
+
+@end
+
+/*
+ An application running on the simulated key. The key selects the applet by AID and forwards all the other commands
+ to the selected applet. Responses include the status code.
+ */
+@protocol FakeYubiKeyApplet<NSObject>
+
+@property (nonatomic, readonly) NSData *aid;
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key;
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key;
+
+@optional
+
+/*
+ The instruction used to read the rest of a chained response. Defaults to GET RESPONSE (0xC0).
+ */
+@property (nonatomic, readonly) UInt8 sendRemainingIns;
+
+@end
+
+/*
+ In-process simulation of a YubiKey which can be used in place of a connection controller by any session.
+
+ The key runs the applets on a serial queue like the real connections, splits long responses with 61XX chaining,
+ establishes SCP03 sessions with the configured static keys and simulates the per APDU latency and the time the user
+ takes to touch the key. The default key runs the Management, OATH, PIV, OTP (challenge-response) and FIDO applets.
+ */
+@interface FakeYubiKey: NSObject<YKFConnectionControllerProtocol>
+
+@property (nonatomic, readonly) NSArray<id<FakeYubiKeyApplet>> *applets;
+
+@property (nonatomic) YKFVersion *version;
+@property (nonatomic) UInt32 serialNumber;
+
+// Delay added to every APDU exchange. A command with a shorter timeout fails with a read timeout once the
+// timeout has passed, like a key which stopped answering.
+@property (atomic) NSTimeInterval commandLatency;
+
+// Time until the simulated user touches the key. Applets waiting for touch block the key for this long.
+@property (atomic) NSTimeInterval touchDelay;
+
+// Interval of the waiting time extensions sent by the key while it waits for touch.
+@property (atomic) NSTimeInterval waitingTimeExtensionInterval;
+
+// Responses longer than this are split with 61XX chaining.
+@property (atomic) NSUInteger maxResponseLength;
+
+// Static keys accepted by INITIALIZE UPDATE. Defaults to the well known default SCP03 keys.
+@property (nonatomic) YKFSCPStaticKeys *scp03StaticKeys;
+@property (nonatomic) UInt8 scp03KeyVersion;
+
+// Raw commands received by the key, in order.
+@property (atomic, readonly) NSArray<NSData *> *receivedCommands;
+@property (atomic, readonly) NSUInteger waitingTimeExtensionCount;
+@property (atomic, readonly) BOOL isSecureChannelOpen;
+
+- (instancetype)init;
+- (instancetype)initWithApplets:(NSArray<id<FakeYubiKeyApplet>> *)applets NS_DESIGNATED_INITIALIZER;
+
+- (nullable id)appletOfClass:(Class)appletClass;
+
+/*
+ Called by the applets on the key queue. Blocks for touchDelay, counting the waiting time extensions.
+ Returns NO if the command was cancelled while waiting.
+ */
+- (BOOL)waitForTouch;
+
+/*
+ Called by the applets which answer with a keep-alive status instead of blocking, like CTAP2 over NFC.
+ */
+- (void)sendWaitingTimeExtension;
+
++ (NSData *)responseWithStatus:(UInt16)status;
++ (NSData *)responseWithData:(nullable NSData *)data status:(UInt16)status;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,530 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyManagementApplet.h"
+#import "FakeYubiKeyOATHApplet.h"
+#import "FakeYubiKeyPIVApplet.h"
+#import "FakeYubiKeyOTPApplet.h"
+#import "FakeYubiKeyFIDOApplet.h"
+#import "YKFAPDU+Private.h"
+#import "YKFSCPStaticKeys.h"
+#import "YKFSCPSessionKeys.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFSessionError+Private.h"
+
+static const UInt8 FakeYubiKeyInsSelect = 0xA4;
+static const UInt8 FakeYubiKeyInsGetResponse = 0xC0;
+static const UInt8 FakeYubiKeyInsInitializeUpdate = 0x50;
+static const UInt8 FakeYubiKeyInsExternalAuthenticate = 0x82;
+
+typedef NS_ENUM(NSUInteger, FakeYubiKeySecureChannelState) {
+    FakeYubiKeySecureChannelStateClosed,
+    FakeYubiKeySecureChannelStateInitialized,
+    FakeYubiKeySecureChannelStateOpen
+};
+
+#pragma mark - FakeYubiKeyCommand
+
+@implementation FakeYubiKeyCommand
+
+- (instancetype)initWithCla:(UInt8)cla ins:(UInt8)ins p1:(UInt8)p1 p2:(UInt8)p2 data:(NSData *)data {
+    self = [super init];
+    if (self) {
+        _cla = cla;
+        _ins = ins;
+        _p1 = p1;
+        _p2 = p2;
+        _data = [data copy];
+    }
+    return self;
+}
+
++ (instancetype)commandWithData:(NSData *)data {
+    if (data.length < 4) {
+        return nil;
+    }
+    const UInt8 *bytes = data.bytes;
+    NSData *commandData = [NSData data];
+    if (data.length > 5 && bytes[4] == 0x00) {
+        // Extended length: 00 LcH LcL, optionally followed by Le.
+        NSUInteger length = (bytes[5] << 8) | bytes[6];
+        if (data.length < 7 + length) {
+            return nil;
+        }
+        commandData = [data subdataWithRange:NSMakeRange(7, length)];
+    } else if (data.length > 5) {
+        NSUInteger length = bytes[4];
+        if (data.length < 5 + length) {
+            return nil;
+        }
+        commandData = [data subdataWithRange:NSMakeRange(5, length)];
+    }
+    return [[FakeYubiKeyCommand alloc] initWithCla:bytes[0] ins:bytes[1] p1:bytes[2] p2:bytes[3] data:commandData];
+}
+
+@end
+
+#pragma mark - FakeYubiKey
+
+@interface FakeYubiKey()
+
+@property (nonatomic, readwrite) NSArray<id<FakeYubiKeyApplet>> *applets;
+@property (nonatomic) NSOperationQueue *communicationQueue;
+@property (atomic, readwrite) YKFCancellationToken *cancellationToken;
+@property (nonatomic, readwrite) YKFConnectionMetrics *metrics;
+@property (nonatomic, readwrite) YKFTimeoutPolicy *timeoutPolicy;
+@property (nonatomic) NSMutableArray<NSData *> *commandLog;
+@property (atomic, readwrite) NSUInteger waitingTimeExtensionCount;
+
+// Only accessed on the communication queue.
+@property (nonatomic) id<FakeYubiKeyApplet> selectedApplet;
+@property (nonatomic) NSData *remainingResponse;
+@property (nonatomic) YKFCancellationToken *activeWaitToken;
+@property (nonatomic) FakeYubiKeySecureChannelState secureChannelState;
+@property (nonatomic) YKFSCPSessionKeys *sessionKeys;
+@property (nonatomic) NSData *hostChallenge;
+@property (nonatomic) NSData *cardChallenge;
+@property (nonatomic) NSData *macChain;
+@property (nonatomic) UInt32 encryptionCounter;
+
+@end
+
+@implementation FakeYubiKey
+
+- (instancetype)init {
+    return [self initWithApplets:@[[[FakeYubiKeyManagementApplet alloc] init],
+                                   [[FakeYubiKeyOATHApplet alloc] init],
+                                   [[FakeYubiKeyPIVApplet alloc] init],
+                                   [[FakeYubiKeyOTPApplet alloc] init],
+                                   [[FakeYubiKeyFIDOApplet alloc] init]]];
+}
+
+- (instancetype)initWithApplets:(NSArray<id<FakeYubiKeyApplet>> *)applets {
+    self = [super init];
+    if (self) {
+        self.applets = [applets copy];
+        self.version = [[YKFVersion alloc] initWithBytes:5 minor:4 micro:3];
+        self.serialNumber = 12345678;
+        self.waitingTimeExtensionInterval = 0.1;
+        self.maxResponseLength = 256;
+        self.scp03StaticKeys = [YKFSCPStaticKeys defaultKeys];
+        self.scp03KeyVersion = 0xFF;
+        self.commandLog = [[NSMutableArray alloc] init];
+        self.communicationQueue = [[NSOperationQueue alloc] init];
+        self.communicationQueue.maxConcurrentOperationCount = 1;
+        self.communicationQueue.underlyingQueue = dispatch_queue_create("com.yubico.FakeYubiKey", DISPATCH_QUEUE_SERIAL);
+        self.cancellationToken = [[YKFCancellationToken alloc] init];
+        self.metrics = [[YKFConnectionMetrics alloc] init];
+        self.timeoutPolicy = [[YKFTimeoutPolicy alloc] init];
+    }
+    return self;
+}
+
+- (id)appletOfClass:(Class)appletClass {
+    for (id<FakeYubiKeyApplet> applet in self.applets) {
+        if ([applet isKindOfClass:appletClass]) {
+            return applet;
+        }
+    }
+    return nil;
+}
+
+- (NSArray<NSData *> *)receivedCommands {
+    @synchronized (self.commandLog) {
+        return [self.commandLog copy];
+    }
+}
+
+- (BOOL)isSecureChannelOpen {
+    __block BOOL open = NO;
+    NSOperation *operation = [NSBlockOperation blockOperationWithBlock:^{
+        open = self.secureChannelState == FakeYubiKeySecureChannelStateOpen;
+    }];
+    [self.communicationQueue addOperations:@[operation] waitUntilFinished:YES];
+    return open;
+}
+
++ (NSData *)responseWithStatus:(UInt16)status {
+    return [self responseWithData:nil status:status];
+}
+
++ (NSData *)responseWithData:(NSData *)data status:(UInt16)status {
+    NSMutableData *response = data ? [data mutableCopy] : [[NSMutableData alloc] init];
+    UInt8 statusBytes[2] = {status >> 8, status & 0xFF};
+    [response appendBytes:statusBytes length:2];
+    return response;
+}
+
+#pragma mark - Touch
+
+- (BOOL)waitForTouch {
+    NSTimeInterval remaining = self.touchDelay;
+    NSTimeInterval interval = self.waitingTimeExtensionInterval > 0 ? self.waitingTimeExtensionInterval : remaining;
+    while (remaining > 0) {
+        NSTimeInterval step = MIN(interval, remaining);
+        if ([self.activeWaitToken waitForTimeInterval:step]) {
+            return NO;
+        }
+        remaining -= step;
+        if (remaining > 0) {
+            self.waitingTimeExtensionCount++;
+            [self.metrics recordWaitingTimeExtension];
+        }
+    }
+    return YES;
+}
+
+- (void)sendWaitingTimeExtension {
+    self.waitingTimeExtensionCount++;
+    [self.metrics recordWaitingTimeExtension];
+}
+
+#pragma mark - YKFConnectionControllerProtocol
+
+- (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:YKFTimeoutPolicyAdaptiveTimeout completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:timeout cancellationToken:nil completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command priority:YKFCommandPriorityNormal deadline:nil timeout:timeout cancellationToken:cancellationToken completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command priority:(YKFCommandPriority)priority deadline:(NSDate *)deadline timeout:(NSTimeInterval)timeout cancellationToken:(YKFCancellationToken *)cancellationToken completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    YKFCancellationToken *generationToken = self.cancellationToken;
+    NSData *commandData = command.apduData;
+    NSDate *queuedDate = [NSDate date];
+
+    NSOperation *queuedOperation = [self operationWithBlock:^(NSOperation *operation) {
+        if (cancellationToken.isCancelled || generationToken.isCancelled) {
+            return;
+        }
+        BOOL deadlineExceeded = deadline && deadline.timeIntervalSinceNow <= 0;
+        [self.metrics recordQueueingDelay:-queuedDate.timeIntervalSinceNow priority:priority deadlineExceeded:deadlineExceeded];
+        if (deadlineExceeded) {
+            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorDeadlineExceededCode], 0);
+            return;
+        }
+        NSTimeInterval commandTimeout = timeout == YKFTimeoutPolicyAdaptiveTimeout ? [self.timeoutPolicy timeoutForCommand:command] : timeout;
+        NSDate *startDate = [NSDate date];
+
+        // Wakes up the latency and touch waits when either the command or the generation is cancelled.
+        YKFCancellationToken *waitToken = [[YKFCancellationToken alloc] init];
+        id registration = [cancellationToken addCancellationHandler:^{
+            [waitToken cancel];
+        }];
+        id generationRegistration = [generationToken addCancellationHandler:^{
+            [waitToken cancel];
+        }];
+        self.activeWaitToken = waitToken;
+
+        @synchronized (self.commandLog) {
+            [self.commandLog addObject:commandData];
+        }
+        NSTimeInterval latency = self.commandLatency;
+        BOOL timedOut = commandTimeout > 0 && latency > commandTimeout;
+        BOOL cancelled = latency > 0 && [waitToken waitForTimeInterval:timedOut ? commandTimeout : latency];
+        NSData *response = cancelled || timedOut ? nil : [self processCommandData:commandData];
+
+        self.activeWaitToken = nil;
+        [cancellationToken removeCancellationHandler:registration];
+        [generationToken removeCancellationHandler:generationRegistration];
+
+        if (waitToken.isCancelled) {
+            return;
+        }
+        NSTimeInterval executionTime = -[startDate timeIntervalSinceNow];
+        if (timedOut) {
+            [self.metrics recordCommand:command response:nil duration:executionTime];
+            completion(nil, [YKFSessionError errorWithCode:YKFSessionErrorReadTimeoutCode], executionTime);
+            return;
+        }
+        if (!response) {
+            return;
+        }
+        [self.metrics recordCommand:command response:response duration:executionTime];
+        [self.timeoutPolicy recordExecutionTime:executionTime forIns:command.ins];
+        completion(response, nil, executionTime);
+    }];
+    queuedOperation.queuePriority = YKFOperationQueuePriorityForCommandPriority(priority);
+    [self.communicationQueue addOperation:queuedOperation];
+}
+
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
+    NSOperation *operation = [self operationWithBlock:block];
+    for (NSOperation *queuedOperation in self.communicationQueue.operations) {
+        [operation addDependency:queuedOperation];
+    }
+    [self.communicationQueue addOperation:operation];
+}
+
+- (NSOperation *)operationWithBlock:(YKFConnectionControllerCommunicationQueueBlock)block {
+    NSBlockOperation *operation = [[NSBlockOperation alloc] init];
+    __weak NSBlockOperation *weakOperation = operation;
+    [operation addExecutionBlock:^{
+        __strong NSBlockOperation *strongOperation = weakOperation;
+        if (!strongOperation || strongOperation.isCancelled) {
+            return;
+        }
+        block(strongOperation);
+    }];
+    return operation;
+}
+
+- (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion {
+    completion();
+}
+
+- (void)cancelAllCommands {
+    [self.communicationQueue cancelAllOperations];
+
+    YKFCancellationToken *cancellationToken = self.cancellationToken;
+    self.cancellationToken = [[YKFCancellationToken alloc] init];
+    [cancellationToken cancel];
+}
+
+#pragma mark - Command processing
+
+- (NSData *)processCommandData:(NSData *)commandData {
+    FakeYubiKeyCommand *command = [FakeYubiKeyCommand commandWithData:commandData];
+    if (!command) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongLength];
+    }
+
+    // The rest of a chained response is read with plain commands, also when a secure channel is open.
+    if (self.remainingResponse && [self isSendRemainingCommand:command]) {
+        return [self nextResponseChunk];
+    }
+    self.remainingResponse = nil;
+
+    NSData *response;
+    if ((command.cla & 0x04) && command.ins == FakeYubiKeyInsExternalAuthenticate) {
+        response = [self externalAuthenticate:command rawData:commandData];
+    } else if (command.cla & 0x04) {
+        response = [self processSecureCommand:command rawData:commandData];
+    } else if ((command.cla & 0x80) && command.ins == FakeYubiKeyInsInitializeUpdate) {
+        response = [self initializeUpdate:command];
+    } else {
+        response = [self processPlainCommand:command];
+    }
+
+    // Split the response when it doesn't fit in a single APDU.
+    UInt16 status = [self statusFromResponse:response];
+    if (status == YKFAPDUErrorCodeNoError && response.length - 2 > self.maxResponseLength) {
+        self.remainingResponse = [response subdataWithRange:NSMakeRange(0, response.length - 2)];
+        return [self nextResponseChunk];
+    }
+    return response;
+}
+
+- (NSData *)processPlainCommand:(FakeYubiKeyCommand *)command {
+    if (command.ins == FakeYubiKeyInsSelect && command.p1 == 0x04) {
+        [self closeSecureChannel];
+        return [self selectApplet:command.data];
+    }
+    if (!self.selectedApplet) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+    return [self.selectedApplet processCommand:command key:self];
+}
+
+- (NSData *)selectApplet:(NSData *)aid {
+    for (id<FakeYubiKeyApplet> applet in self.applets) {
+        if (aid.length && applet.aid.length >= aid.length && [[applet.aid subdataWithRange:NSMakeRange(0, aid.length)] isEqualToData:aid]) {
+            self.selectedApplet = applet;
+            return [applet selectWithKey:self];
+        }
+    }
+    self.selectedApplet = nil;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeMissingFile];
+}
+
+- (BOOL)isSendRemainingCommand:(FakeYubiKeyCommand *)command {
+    if (command.cla & 0x04) {
+        return NO;
+    }
+    if (command.ins == FakeYubiKeyInsGetResponse) {
+        return YES;
+    }
+    return [self.selectedApplet respondsToSelector:@selector(sendRemainingIns)] && command.ins == self.selectedApplet.sendRemainingIns;
+}
+
+- (NSData *)nextResponseChunk {
+    NSUInteger length = MIN(self.maxResponseLength, self.remainingResponse.length);
+    NSData *chunk = [self.remainingResponse subdataWithRange:NSMakeRange(0, length)];
+    NSUInteger remaining = self.remainingResponse.length - length;
+    if (remaining == 0) {
+        self.remainingResponse = nil;
+        return [FakeYubiKey responseWithData:chunk status:YKFAPDUErrorCodeNoError];
+    }
+    self.remainingResponse = [self.remainingResponse subdataWithRange:NSMakeRange(length, remaining)];
+    UInt16 status = (YKFAPDUErrorCodeMoreData << 8) | (remaining > 0xFF ? 0x00 : remaining);
+    return [FakeYubiKey responseWithData:chunk status:status];
+}
+
+- (UInt16)statusFromResponse:(NSData *)response {
+    const UInt8 *bytes = response.bytes;
+    return (bytes[response.length - 2] << 8) | bytes[response.length - 1];
+}
+
+#pragma mark - SCP03
+
+- (void)closeSecureChannel {
+    self.secureChannelState = FakeYubiKeySecureChannelStateClosed;
+    self.sessionKeys = nil;
+    self.macChain = nil;
+}
+
+- (NSData *)initializeUpdate:(FakeYubiKeyCommand *)command {
+    if (command.data.length != 8) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongLength];
+    }
+    if (command.p1 != 0 && command.p1 != self.scp03KeyVersion) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeReferencedDataNotFound];
+    }
+    self.hostChallenge = command.data;
+    self.cardChallenge = [NSData ykf_randomDataOfSize:8];
+
+    NSMutableData *context = [self.hostChallenge mutableCopy];
+    [context appendData:self.cardChallenge];
+    self.sessionKeys = [self.scp03StaticKeys deriveWithContext:context];
+    NSData *cardCryptogram = [YKFSCPStaticKeys deriveKeyWithKey:self.sessionKeys.smac t:0x00 context:context l:0x40 error:nil];
+
+    NSMutableData *response = [NSMutableData dataWithLength:10]; // Key diversification data
+    UInt8 keyInfo[3] = {self.scp03KeyVersion, 0x03, 0x00};
+    [response appendBytes:keyInfo length:3];
+    [response appendData:self.cardChallenge];
+    [response appendData:cardCryptogram];
+
+    self.secureChannelState = FakeYubiKeySecureChannelStateInitialized;
+    self.macChain = [NSMutableData dataWithLength:16];
+    self.encryptionCounter = 1;
+    return [FakeYubiKey responseWithData:response status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)externalAuthenticate:(FakeYubiKeyCommand *)command rawData:(NSData *)rawData {
+    if (self.secureChannelState != FakeYubiKeySecureChannelStateInitialized || command.data.length != 16) {
+        [self closeSecureChannel];
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+    }
+    if (![self verifyCommandMAC:rawData]) {
+        [self closeSecureChannel];
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    NSMutableData *context = [self.hostChallenge mutableCopy];
+    [context appendData:self.cardChallenge];
+    NSData *hostCryptogram = [YKFSCPStaticKeys deriveKeyWithKey:self.sessionKeys.smac t:0x01 context:context l:0x40 error:nil];
+    if (![hostCryptogram ykf_constantTimeCompareWithData:[command.data subdataWithRange:NSMakeRange(0, 8)]]) {
+        [self closeSecureChannel];
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    self.secureChannelState = FakeYubiKeySecureChannelStateOpen;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processSecureCommand:(FakeYubiKeyCommand *)command rawData:(NSData *)rawData {
+    if (self.secureChannelState != FakeYubiKeySecureChannelStateOpen || command.data.length < 8) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    if (![self verifyCommandMAC:rawData]) {
+        [self closeSecureChannel];
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+
+    NSData *encryptedData = [command.data subdataWithRange:NSMakeRange(0, command.data.length - 8)];
+    NSData *plainData = [NSData data];
+    UInt32 counter = self.encryptionCounter;
+    if (encryptedData.length) {
+        plainData = [self decryptCommandData:encryptedData counter:counter];
+        self.encryptionCounter++;
+        if (!plainData) {
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+        }
+    }
+
+    FakeYubiKeyCommand *plainCommand = [[FakeYubiKeyCommand alloc] initWithCla:command.cla & ~0x04 ins:command.ins p1:command.p1 p2:command.p2 data:plainData];
+    NSData *response;
+    if (plainCommand.ins == FakeYubiKeyInsSelect && plainCommand.p1 == 0x04) {
+        // Keep the secure channel when the host reselects through it.
+        response = [self selectApplet:plainCommand.data];
+    } else {
+        response = [self processPlainCommand:plainCommand];
+    }
+
+    UInt16 status = [self statusFromResponse:response];
+    if (status != YKFAPDUErrorCodeNoError) {
+        return response;
+    }
+    NSData *responseData = [response subdataWithRange:NSMakeRange(0, response.length - 2)];
+    NSMutableData *wrappedData = [[NSMutableData alloc] init];
+    if (responseData.length) {
+        [wrappedData appendData:[self encryptResponseData:responseData counter:counter]];
+    }
+    NSMutableData *macInput = [self.macChain mutableCopy];
+    [macInput appendData:wrappedData];
+    UInt8 statusBytes[2] = {status >> 8, status & 0xFF};
+    [macInput appendBytes:statusBytes length:2];
+    [wrappedData appendData:[[macInput ykf_aesCMACWithKey:self.sessionKeys.srmac] subdataWithRange:NSMakeRange(0, 8)]];
+    return [FakeYubiKey responseWithData:wrappedData status:status];
+}
+
+- (BOOL)verifyCommandMAC:(NSData *)rawData {
+    // The C-MAC covers the header, the length (including the MAC) and the data.
+    NSData *mac = [rawData subdataWithRange:NSMakeRange(rawData.length - 8, 8)];
+    NSMutableData *macInput = [self.macChain mutableCopy];
+    [macInput appendData:[rawData subdataWithRange:NSMakeRange(0, rawData.length - 8)]];
+    NSData *macChain = [macInput ykf_aesCMACWithKey:self.sessionKeys.smac];
+    if (![[macChain subdataWithRange:NSMakeRange(0, 8)] ykf_constantTimeCompareWithData:mac]) {
+        return NO;
+    }
+    self.macChain = macChain;
+    return YES;
+}
+
+- (NSData *)ivWithCounter:(UInt32)counter response:(BOOL)response {
+    NSMutableData *ivData = [NSMutableData dataWithLength:12];
+    if (response) {
+        ((UInt8 *)ivData.mutableBytes)[0] = 0x80;
+    }
+    UInt32 counterBE = CFSwapInt32HostToBig(counter);
+    [ivData appendBytes:&counterBE length:sizeof(counterBE)];
+    return [ivData ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeECB key:self.sessionKeys.senc iv:nil];
+}
+
+- (NSData *)decryptCommandData:(NSData *)data counter:(UInt32)counter {
+    NSData *iv = [self ivWithCounter:counter response:NO];
+    NSData *padded = [data ykf_cryptOperation:kCCDecrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:self.sessionKeys.senc iv:iv];
+    const UInt8 *bytes = padded.bytes;
+    for (NSInteger i = (NSInteger)padded.length - 1; i >= 0; i--) {
+        if (bytes[i] == 0x80) {
+            return [padded subdataWithRange:NSMakeRange(0, i)];
+        }
+        if (bytes[i] != 0x00) {
+            break;
+        }
+    }
+    return nil;
+}
+
+- (NSData *)encryptResponseData:(NSData *)data counter:(UInt32)counter {
+    NSData *iv = [self ivWithCounter:counter response:YES];
+    return [[data ykf_bitPadded] ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:self.sessionKeys.senc iv:iv];
+}
+
+@end
@@ -0,0 +1,50 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ FIDO applet, reachable over U2F and CTAP2 like on the key.
+
+ U2F register and sign answer with "condition not satisfied" until the touch delay of the key elapsed, like a key
+ waiting for user presence. The registration data and signatures are random bytes since the sessions don't verify them.
+ CTAP2 supports GetInfo, MakeCredential, GetAssertion, GetNextAssertion, ClientPIN (getRetries, getKeyAgreement, setPIN
+ and getPinToken over PIN protocols 1 and 2) and Reset. Credentials are P-256 keys with packed self attestation, so
+ signatures verify against the credential public key. Operations that need user presence keep the host polling for touch.
+ */
+@interface FakeYubiKeyFIDOApplet: NSObject<FakeYubiKeyApplet>
+
+@property (nonatomic) NSData *aaguid;
+@property (nonatomic) NSUInteger maxMsgSize;
+
+// Number of completed CTAP2 resets.
+@property (nonatomic, readonly) NSUInteger resetCount;
+
+// The CTAP2 PIN, nil when no PIN is set.
+@property (nonatomic, nullable) NSString *pin;
+@property (nonatomic, readonly) NSUInteger pinRetries;
+
+// Number of CTAP2 credentials, resident or not.
+@property (nonatomic, readonly) NSUInteger credentialCount;
+
+/*
+ Registers a key handle for an application parameter (SHA256 of the appId) so that it can be used to sign.
+ */
+- (void)addKeyHandle:(NSData *)keyHandle applicationParameter:(NSData *)applicationParameter;
+
+@end
+
+NS_ASSUME_NONNULL_END
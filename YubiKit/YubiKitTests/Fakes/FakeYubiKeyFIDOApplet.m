@@ -0,0 +1,656 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <CommonCrypto/CommonCrypto.h>
+#import "FakeYubiKeyFIDOApplet.h"
+#import "YKFCBORType.h"
+#import "YKFCBOREncoder.h"
+#import "YKFCBORDecoder.h"
+#import "YKFFIDO2Error.h"
+#import "YKFFIDO2PinAuthKey.h"
+#import "YKFNSDataAdditions.h"
+#import "YKFNSDataAdditions+Private.h"
+
+static const UInt8 FakeYubiKeyU2FInsRegister = 0x01;
+static const UInt8 FakeYubiKeyU2FInsSign = 0x02;
+static const UInt8 FakeYubiKeyCTAPInsMessage = 0x10;
+static const UInt8 FakeYubiKeyCTAPInsGetResponse = 0x11;
+
+static const UInt8 FakeYubiKeyCTAPCommandMakeCredential = 0x01;
+static const UInt8 FakeYubiKeyCTAPCommandGetAssertion = 0x02;
+static const UInt8 FakeYubiKeyCTAPCommandGetInfo = 0x04;
+static const UInt8 FakeYubiKeyCTAPCommandClientPin = 0x06;
+static const UInt8 FakeYubiKeyCTAPCommandReset = 0x07;
+static const UInt8 FakeYubiKeyCTAPCommandGetNextAssertion = 0x08;
+
+static const NSUInteger FakeYubiKeyClientPinGetRetries = 0x01;
+static const NSUInteger FakeYubiKeyClientPinGetKeyAgreement = 0x02;
+static const NSUInteger FakeYubiKeyClientPinSetPin = 0x03;
+static const NSUInteger FakeYubiKeyClientPinGetPinToken = 0x05;
+
+static const UInt8 FakeYubiKeyAuthDataFlagUserPresent = 0x01;
+static const UInt8 FakeYubiKeyAuthDataFlagUserVerified = 0x04;
+static const UInt8 FakeYubiKeyAuthDataFlagAttestedCredentialData = 0x40;
+
+static const NSInteger FakeYubiKeyCOSEAlgorithmES256 = -7;
+static const NSUInteger FakeYubiKeyMaxPinRetries = 8;
+static const NSUInteger FakeYubiKeyU2FParametersLength = 64;
+
+typedef NSData * _Nonnull (^FakeYubiKeyFIDOOperation)(FakeYubiKeyFIDOApplet *applet);
+
+#pragma mark - FakeYubiKeyFIDOCredential
+
+@interface FakeYubiKeyFIDOCredential: NSObject
+
+@property (nonatomic) NSData *credentialId;
+@property (nonatomic) NSString *rpId;
+@property (nonatomic) NSDictionary *user;
+@property (nonatomic) BOOL isResident;
+@property (nonatomic) id privateKey;
+
+@end
+
+@implementation FakeYubiKeyFIDOCredential
+@end
+
+#pragma mark - FakeYubiKeyFIDOApplet
+
+@interface FakeYubiKeyFIDOApplet()
+
+@property (nonatomic) NSMutableDictionary<NSData *, NSData *> *keyHandles;
+@property (nonatomic) NSMutableArray<FakeYubiKeyFIDOCredential *> *credentials;
+@property (nonatomic) UInt32 signatureCounter;
+@property (nonatomic, readwrite) NSUInteger resetCount;
+@property (nonatomic, readwrite) NSUInteger pinRetries;
+
+// PIN protocol state, regenerated on power up like on the key.
+@property (nonatomic, nullable) YKFFIDO2PinAuthKey *keyAgreementKey;
+@property (nonatomic) NSData *pinToken;
+
+// Credentials left for authenticatorGetNextAssertion.
+@property (nonatomic, nullable) NSMutableArray<FakeYubiKeyFIDOCredential *> *remainingAssertions;
+@property (nonatomic, nullable) NSData *assertionClientDataHash;
+@property (nonatomic) UInt8 assertionFlags;
+
+// The time when the pending operation gets user presence. Nil when no operation waits for touch.
+@property (nonatomic, nullable) NSDate *touchDate;
+// The CTAP2 operation completed on touch. Nil when the host has nothing to poll for.
+@property (nonatomic, copy, nullable) FakeYubiKeyFIDOOperation pendingOperation;
+
+@end
+
+@implementation FakeYubiKeyFIDOApplet
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.aaguid = [NSData ykf_randomDataOfSize:16];
+        self.maxMsgSize = 1200;
+        self.keyHandles = [[NSMutableDictionary alloc] init];
+        self.credentials = [[NSMutableArray alloc] init];
+        self.pinRetries = FakeYubiKeyMaxPinRetries;
+        self.pinToken = [NSData ykf_randomDataOfSize:32];
+    }
+    return self;
+}
+
+- (void)addKeyHandle:(NSData *)keyHandle applicationParameter:(NSData *)applicationParameter {
+    self.keyHandles[keyHandle] = applicationParameter;
+}
+
+- (NSUInteger)credentialCount {
+    return self.credentials.count;
+}
+
+- (NSData *)aid {
+    return [NSData dataWithBytes:(UInt8[]){0xA0, 0x00, 0x00, 0x06, 0x47, 0x2F, 0x00, 0x01} length:8];
+}
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key {
+    self.touchDate = nil;
+    self.pendingOperation = nil;
+    self.remainingAssertions = nil;
+    return [FakeYubiKey responseWithData:[@"U2F_V2" dataUsingEncoding:NSUTF8StringEncoding] status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    switch (command.ins) {
+        case FakeYubiKeyU2FInsRegister:
+            return [self registerWithCommand:command key:key];
+        case FakeYubiKeyU2FInsSign:
+            return [self signWithCommand:command key:key];
+        case FakeYubiKeyCTAPInsMessage:
+            return [self processCTAPCommand:command key:key];
+        case FakeYubiKeyCTAPInsGetResponse:
+            return [self pollTouchWithKey:key];
+        default:
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+}
+
+#pragma mark - Touch
+
+/*
+ Returns YES once the user touched the key for the current operation. The host keeps resending the command until then.
+ */
+- (BOOL)hasUserPresenceWithKey:(FakeYubiKey *)key {
+    if (!self.touchDate) {
+        self.touchDate = [NSDate dateWithTimeIntervalSinceNow:key.touchDelay];
+    }
+    if ([self.touchDate timeIntervalSinceNow] > 0) {
+        [key sendWaitingTimeExtension];
+        return NO;
+    }
+    self.touchDate = nil;
+    return YES;
+}
+
+#pragma mark - U2F
+
+- (NSData *)registerWithCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    if (command.data.length != FakeYubiKeyU2FParametersLength) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongLength];
+    }
+    if (![self hasUserPresenceWithKey:key]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+    }
+
+    NSData *applicationParameter = [command.data subdataWithRange:NSMakeRange(32, 32)];
+    NSData *keyHandle = [NSData ykf_randomDataOfSize:64];
+    [self addKeyHandle:keyHandle applicationParameter:applicationParameter];
+
+    // Reserved byte, public key, key handle, attestation certificate and signature.
+    NSMutableData *registrationData = [NSMutableData dataWithBytes:(UInt8[]){0x05, 0x04} length:2];
+    [registrationData appendData:[NSData ykf_randomDataOfSize:64]];
+    UInt8 keyHandleLength = keyHandle.length;
+    [registrationData appendBytes:&keyHandleLength length:1];
+    [registrationData appendData:keyHandle];
+    [registrationData appendBytes:(UInt8[]){0x30, 0x00} length:2];
+    [registrationData appendData:[NSData ykf_randomDataOfSize:70]];
+    return [FakeYubiKey responseWithData:registrationData status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)signWithCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    const UInt8 *bytes = command.data.bytes;
+    if (command.data.length < FakeYubiKeyU2FParametersLength + 1 || command.data.length != FakeYubiKeyU2FParametersLength + 1 + bytes[FakeYubiKeyU2FParametersLength]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongLength];
+    }
+    NSData *applicationParameter = [command.data subdataWithRange:NSMakeRange(32, 32)];
+    NSData *keyHandle = [command.data subdataWithRange:NSMakeRange(FakeYubiKeyU2FParametersLength + 1, bytes[FakeYubiKeyU2FParametersLength])];
+    if (![self.keyHandles[keyHandle] isEqualToData:applicationParameter]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    if (![self hasUserPresenceWithKey:key]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+    }
+
+    // User presence flag, counter and signature.
+    UInt32 counter = CFSwapInt32HostToBig(++self.signatureCounter);
+    NSMutableData *signatureData = [NSMutableData dataWithBytes:(UInt8[]){0x01} length:1];
+    [signatureData appendBytes:&counter length:4];
+    [signatureData appendData:[NSData ykf_randomDataOfSize:70]];
+    return [FakeYubiKey responseWithData:signatureData status:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - CTAP2
+
+- (NSData *)processCTAPCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    if (command.data.length == 0) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_LENGTH data:nil];
+    }
+    if (command.data.length > self.maxMsgSize) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeREQUEST_TOO_LARGE data:nil];
+    }
+    UInt8 ctapCommand = ((const UInt8 *)command.data.bytes)[0];
+    if (ctapCommand != FakeYubiKeyCTAPCommandGetNextAssertion) {
+        self.remainingAssertions = nil;
+    }
+
+    // Commands without parameters.
+    switch (ctapCommand) {
+        case FakeYubiKeyCTAPCommandGetInfo:
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[self getInfoDataWithKey:key]];
+        case FakeYubiKeyCTAPCommandGetNextAssertion:
+            return [self getNextAssertion];
+        case FakeYubiKeyCTAPCommandReset:
+            self.touchDate = nil;
+            self.pendingOperation = ^NSData *(FakeYubiKeyFIDOApplet *applet) {
+                [applet resetApplication];
+                return [applet ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:nil];
+            };
+            return [self pollTouchWithKey:key];
+        default:
+            break;
+    }
+
+    NSDictionary *request = [self requestFromCommand:command];
+    if (!request) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_CBOR data:nil];
+    }
+    switch (ctapCommand) {
+        case FakeYubiKeyCTAPCommandMakeCredential:
+            return [self makeCredentialWithRequest:request key:key];
+        case FakeYubiKeyCTAPCommandGetAssertion:
+            return [self getAssertionWithRequest:request key:key];
+        case FakeYubiKeyCTAPCommandClientPin:
+            return [self clientPinWithRequest:request];
+        default:
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_COMMAND data:nil];
+    }
+}
+
+- (NSData *)pollTouchWithKey:(FakeYubiKey *)key {
+    if (!self.pendingOperation) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+    }
+    if (![self hasUserPresenceWithKey:key]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeFIDO2TouchRequired];
+    }
+    FakeYubiKeyFIDOOperation operation = self.pendingOperation;
+    self.pendingOperation = nil;
+    return operation(self);
+}
+
+- (void)resetApplication {
+    self.resetCount++;
+    [self.keyHandles removeAllObjects];
+    [self.credentials removeAllObjects];
+    self.pin = nil;
+    self.pinRetries = FakeYubiKeyMaxPinRetries;
+    self.pinToken = [NSData ykf_randomDataOfSize:32];
+    self.keyAgreementKey = nil;
+}
+
+- (NSData *)getInfoDataWithKey:(FakeYubiKey *)key {
+    NSInteger firmwareVersion = (key.version.major << 16) | (key.version.minor << 8) | key.version.micro;
+    NSDictionary *info = @{
+        YKFCBORInteger(0x01): YKFCBORArray((@[YKFCBORTextString(@"U2F_V2"), YKFCBORTextString(@"FIDO_2_0"), YKFCBORTextString(@"FIDO_2_1")])),
+        YKFCBORInteger(0x03): YKFCBORByteString(self.aaguid),
+        YKFCBORInteger(0x04): YKFCBORMap((@{YKFCBORTextString(@"rk"): YKFCBORBool(YES),
+                                            YKFCBORTextString(@"up"): YKFCBORBool(YES),
+                                            YKFCBORTextString(@"plat"): YKFCBORBool(NO),
+                                            YKFCBORTextString(@"clientPin"): YKFCBORBool(self.pin != nil)})),
+        YKFCBORInteger(0x05): YKFCBORInteger(self.maxMsgSize),
+        YKFCBORInteger(0x06): YKFCBORArray((@[YKFCBORInteger(2), YKFCBORInteger(1)])),
+        YKFCBORInteger(0x0E): YKFCBORInteger(firmwareVersion)
+    };
+    return [YKFCBOREncoder encodeMap:YKFCBORMap(info)];
+}
+
+#pragma mark - MakeCredential
+
+- (NSData *)makeCredentialWithRequest:(NSDictionary *)request key:(FakeYubiKey *)key {
+    NSData *clientDataHash = request[@1];
+    NSDictionary *rp = request[@2];
+    NSDictionary *user = request[@3];
+    NSArray *pubKeyCredParams = request[@4];
+    NSDictionary *options = request[@7];
+    if (!clientDataHash || !rp[@"id"] || !user[@"id"] || !pubKeyCredParams) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeMISSING_PARAMETER data:nil];
+    }
+    BOOL supportsAlgorithm = NO;
+    for (NSDictionary *param in pubKeyCredParams) {
+        supportsAlgorithm |= [param[@"alg"] integerValue] == FakeYubiKeyCOSEAlgorithmES256 && [param[@"type"] isEqual:@"public-key"];
+    }
+    if (!supportsAlgorithm) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeUNSUPPORTED_ALGORITHM data:nil];
+    }
+    if (options[@"up"]) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_OPTION data:nil];
+    }
+    UInt8 status = YKFFIDO2ErrorCodeSUCCESS;
+    BOOL userVerified = [self verifyPinAuth:request[@8] pinProtocol:request[@9] clientDataHash:clientDataHash status:&status];
+    if (status != YKFFIDO2ErrorCodeSUCCESS) {
+        return [self ctapResponseWithStatus:status data:nil];
+    }
+    NSString *rpId = rp[@"id"];
+    for (NSDictionary *descriptor in request[@5]) {
+        if ([self credentialWithId:descriptor[@"id"] rpId:rpId]) {
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeCREDENTIAL_EXCLUDED data:nil];
+        }
+    }
+
+    BOOL isResident = [options[@"rk"] boolValue];
+    self.touchDate = nil;
+    self.pendingOperation = ^NSData *(FakeYubiKeyFIDOApplet *applet) {
+        FakeYubiKeyFIDOCredential *credential = [[FakeYubiKeyFIDOCredential alloc] init];
+        credential.credentialId = [NSData ykf_randomDataOfSize:64];
+        credential.rpId = rpId;
+        credential.user = user;
+        credential.isResident = isResident;
+        NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeySizeInBits: @256};
+        credential.privateKey = CFBridgingRelease(SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil));
+        if (!credential.privateKey) {
+            return [applet ctapResponseWithStatus:YKFFIDO2ErrorCodeOTHER data:nil];
+        }
+        [applet.credentials addObject:credential];
+
+        UInt8 flags = FakeYubiKeyAuthDataFlagUserPresent | FakeYubiKeyAuthDataFlagAttestedCredentialData;
+        if (userVerified) {
+            flags |= FakeYubiKeyAuthDataFlagUserVerified;
+        }
+        NSData *authData = [applet authenticatorDataWithRpId:rpId flags:flags attestedCredential:credential];
+
+        // Packed self attestation: signed with the credential key itself.
+        NSData *signature = [applet signData:authData clientDataHash:clientDataHash credential:credential];
+        NSDictionary *response = @{
+            YKFCBORInteger(0x01): YKFCBORTextString(@"packed"),
+            YKFCBORInteger(0x02): YKFCBORByteString(authData),
+            YKFCBORInteger(0x03): YKFCBORMap((@{YKFCBORTextString(@"alg"): YKFCBORInteger(FakeYubiKeyCOSEAlgorithmES256),
+                                                YKFCBORTextString(@"sig"): YKFCBORByteString(signature)}))
+        };
+        return [applet ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[YKFCBOREncoder encodeMap:YKFCBORMap(response)]];
+    };
+    return [self pollTouchWithKey:key];
+}
+
+#pragma mark - GetAssertion
+
+- (NSData *)getAssertionWithRequest:(NSDictionary *)request key:(FakeYubiKey *)key {
+    NSString *rpId = request[@1];
+    NSData *clientDataHash = request[@2];
+    NSArray *allowList = request[@3];
+    NSDictionary *options = request[@5];
+    if (!rpId || !clientDataHash) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeMISSING_PARAMETER data:nil];
+    }
+    UInt8 status = YKFFIDO2ErrorCodeSUCCESS;
+    BOOL userVerified = [self verifyPinAuth:request[@6] pinProtocol:request[@7] clientDataHash:clientDataHash status:&status];
+    if (status != YKFFIDO2ErrorCodeSUCCESS) {
+        return [self ctapResponseWithStatus:status data:nil];
+    }
+
+    // With an allow list the first match is used, without it all the resident credentials of the RP.
+    NSMutableArray<FakeYubiKeyFIDOCredential *> *matches = [[NSMutableArray alloc] init];
+    if (allowList.count) {
+        for (NSDictionary *descriptor in allowList) {
+            FakeYubiKeyFIDOCredential *credential = [self credentialWithId:descriptor[@"id"] rpId:rpId];
+            if (credential) {
+                [matches addObject:credential];
+                break;
+            }
+        }
+    } else {
+        for (FakeYubiKeyFIDOCredential *credential in self.credentials.reverseObjectEnumerator) {
+            if (credential.isResident && [credential.rpId isEqualToString:rpId]) {
+                [matches addObject:credential];
+            }
+        }
+    }
+    if (!matches.count) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeNO_CREDENTIALS data:nil];
+    }
+
+    BOOL requiresUserPresence = !options[@"up"] || [options[@"up"] boolValue];
+    UInt8 flags = (requiresUserPresence ? FakeYubiKeyAuthDataFlagUserPresent : 0) | (userVerified ? FakeYubiKeyAuthDataFlagUserVerified : 0);
+    NSUInteger numberOfCredentials = allowList.count ? 0 : matches.count;
+    FakeYubiKeyFIDOOperation operation = ^NSData *(FakeYubiKeyFIDOApplet *applet) {
+        FakeYubiKeyFIDOCredential *credential = matches.firstObject;
+        [matches removeObjectAtIndex:0];
+        applet.remainingAssertions = matches.count ? matches : nil;
+        applet.assertionClientDataHash = clientDataHash;
+        applet.assertionFlags = flags;
+        return [applet assertionResponseWithCredential:credential clientDataHash:clientDataHash flags:flags numberOfCredentials:numberOfCredentials];
+    };
+    if (!requiresUserPresence) {
+        return operation(self);
+    }
+    self.touchDate = nil;
+    self.pendingOperation = operation;
+    return [self pollTouchWithKey:key];
+}
+
+- (NSData *)getNextAssertion {
+    if (!self.remainingAssertions.count) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeNOT_ALLOWED data:nil];
+    }
+    FakeYubiKeyFIDOCredential *credential = self.remainingAssertions.firstObject;
+    [self.remainingAssertions removeObjectAtIndex:0];
+    return [self assertionResponseWithCredential:credential clientDataHash:self.assertionClientDataHash flags:self.assertionFlags numberOfCredentials:0];
+}
+
+- (NSData *)assertionResponseWithCredential:(FakeYubiKeyFIDOCredential *)credential clientDataHash:(NSData *)clientDataHash flags:(UInt8)flags numberOfCredentials:(NSUInteger)numberOfCredentials {
+    NSData *authData = [self authenticatorDataWithRpId:credential.rpId flags:flags attestedCredential:nil];
+    NSMutableDictionary *response = [@{
+        YKFCBORInteger(0x01): YKFCBORMap((@{YKFCBORTextString(@"id"): YKFCBORByteString(credential.credentialId),
+                                            YKFCBORTextString(@"type"): YKFCBORTextString(@"public-key")})),
+        YKFCBORInteger(0x02): YKFCBORByteString(authData),
+        YKFCBORInteger(0x03): YKFCBORByteString([self signData:authData clientDataHash:clientDataHash credential:credential])
+    } mutableCopy];
+    if (credential.isResident) {
+        NSMutableDictionary *user = [@{YKFCBORTextString(@"id"): YKFCBORByteString(credential.user[@"id"])} mutableCopy];
+        if (credential.user[@"name"]) {
+            user[YKFCBORTextString(@"name")] = YKFCBORTextString(credential.user[@"name"]);
+        }
+        if (credential.user[@"displayName"]) {
+            user[YKFCBORTextString(@"displayName")] = YKFCBORTextString(credential.user[@"displayName"]);
+        }
+        response[YKFCBORInteger(0x04)] = YKFCBORMap(user);
+    }
+    if (numberOfCredentials > 1) {
+        response[YKFCBORInteger(0x05)] = YKFCBORInteger(numberOfCredentials);
+    }
+    return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[YKFCBOREncoder encodeMap:YKFCBORMap(response)]];
+}
+
+#pragma mark - ClientPIN
+
+- (NSData *)clientPinWithRequest:(NSDictionary *)request {
+    NSUInteger pinProtocol = [request[@1] unsignedIntegerValue];
+    NSUInteger subCommand = [request[@2] unsignedIntegerValue];
+    if (pinProtocol != 1 && pinProtocol != 2) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_PARAMETER data:nil];
+    }
+    if (subCommand == FakeYubiKeyClientPinGetRetries) {
+        NSDictionary *response = @{YKFCBORInteger(0x03): YKFCBORInteger(self.pinRetries)};
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[YKFCBOREncoder encodeMap:YKFCBORMap(response)]];
+    }
+    if (subCommand == FakeYubiKeyClientPinGetKeyAgreement) {
+        NSDictionary *response = @{YKFCBORInteger(0x01): self.keyAgreement.cosePublicKey};
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[YKFCBOREncoder encodeMap:YKFCBORMap(response)]];
+    }
+    if (subCommand != FakeYubiKeyClientPinSetPin && subCommand != FakeYubiKeyClientPinGetPinToken) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeINVALID_COMMAND data:nil];
+    }
+
+    YKFFIDO2PinAuthKey *platformKey = request[@3] ? [[YKFFIDO2PinAuthKey alloc] initWithCosePublicKey:request[@3]] : nil;
+    if (!platformKey) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeMISSING_PARAMETER data:nil];
+    }
+    NSData *sharedSecret = [self sharedSecretWithPlatformKey:platformKey pinProtocol:pinProtocol];
+
+    if (subCommand == FakeYubiKeyClientPinSetPin) {
+        NSData *pinEnc = request[@5];
+        if (!pinEnc || !request[@4]) {
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeMISSING_PARAMETER data:nil];
+        }
+        if (self.pin) {
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeNOT_ALLOWED data:nil];
+        }
+        if (![[self authenticateData:pinEnc key:sharedSecret pinProtocol:pinProtocol] isEqualToData:request[@4]]) {
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodePIN_AUTH_INVALID data:nil];
+        }
+        NSData *paddedPin = [self decryptData:pinEnc key:sharedSecret pinProtocol:pinProtocol];
+        NSUInteger pinLength = paddedPin.length == 64 ? strnlen(paddedPin.bytes, paddedPin.length) : 0;
+        if (pinLength < 4) {
+            return [self ctapResponseWithStatus:YKFFIDO2ErrorCodePIN_POLICY_VIOLATION data:nil];
+        }
+        self.pin = [[NSString alloc] initWithData:[paddedPin subdataWithRange:NSMakeRange(0, pinLength)] encoding:NSUTF8StringEncoding];
+        self.pinRetries = FakeYubiKeyMaxPinRetries;
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:nil];
+    }
+
+    NSData *pinHashEnc = request[@6];
+    if (!pinHashEnc) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeMISSING_PARAMETER data:nil];
+    }
+    if (!self.pin) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodePIN_NOT_SET data:nil];
+    }
+    if (self.pinRetries == 0) {
+        return [self ctapResponseWithStatus:YKFFIDO2ErrorCodePIN_BLOCKED data:nil];
+    }
+    NSData *pinHash = [[[self.pin dataUsingEncoding:NSUTF8StringEncoding] ykf_SHA256] subdataWithRange:NSMakeRange(0, 16)];
+    if (![[self decryptData:pinHashEnc key:sharedSecret pinProtocol:pinProtocol] isEqualToData:pinHash]) {
+        // A wrong PIN invalidates the key agreement, the host has to start over.
+        self.pinRetries--;
+        self.keyAgreementKey = nil;
+        return [self ctapResponseWithStatus:self.pinRetries ? YKFFIDO2ErrorCodePIN_INVALID : YKFFIDO2ErrorCodePIN_BLOCKED data:nil];
+    }
+    self.pinRetries = FakeYubiKeyMaxPinRetries;
+    NSDictionary *response = @{YKFCBORInteger(0x02): YKFCBORByteString([self encryptData:self.pinToken key:sharedSecret pinProtocol:pinProtocol])};
+    return [self ctapResponseWithStatus:YKFFIDO2ErrorCodeSUCCESS data:[YKFCBOREncoder encodeMap:YKFCBORMap(response)]];
+}
+
+/*
+ Checks the pinAuth of a MakeCredential or GetAssertion request. Returns YES when the request carries a valid pinAuth,
+ or sets the CTAP2 status when the request can't proceed.
+ */
+- (BOOL)verifyPinAuth:(NSData *)pinAuth pinProtocol:(NSNumber *)pinProtocol clientDataHash:(NSData *)clientDataHash status:(UInt8 *)status {
+    if (!pinAuth) {
+        if (self.pin) {
+            *status = YKFFIDO2ErrorCodePIN_REQUIRED;
+        }
+        return NO;
+    }
+    if (!self.pin) {
+        *status = YKFFIDO2ErrorCodePIN_NOT_SET;
+        return NO;
+    }
+    if (![[self authenticateData:clientDataHash key:self.pinToken pinProtocol:pinProtocol.unsignedIntegerValue] isEqualToData:pinAuth]) {
+        *status = YKFFIDO2ErrorCodePIN_AUTH_INVALID;
+        return NO;
+    }
+    return YES;
+}
+
+- (YKFFIDO2PinAuthKey *)keyAgreement {
+    if (!self.keyAgreementKey) {
+        self.keyAgreementKey = [[YKFFIDO2PinAuthKey alloc] init];
+    }
+    return self.keyAgreementKey;
+}
+
+#pragma mark - PIN protocols
+
+- (NSData *)sharedSecretWithPlatformKey:(YKFFIDO2PinAuthKey *)platformKey pinProtocol:(NSUInteger)pinProtocol {
+    NSData *z = [self.keyAgreement sharedSecretWithAuthKey:platformKey];
+    if (pinProtocol == 1) {
+        return [z ykf_SHA256];
+    }
+    NSData *salt = [NSMutableData dataWithLength:32];
+    NSMutableData *sharedSecret = [[z ykf_deriveHKDFWithSalt:salt info:[@"CTAP2 HMAC key" dataUsingEncoding:NSUTF8StringEncoding]] mutableCopy];
+    [sharedSecret appendData:[z ykf_deriveHKDFWithSalt:salt info:[@"CTAP2 AES key" dataUsingEncoding:NSUTF8StringEncoding]]];
+    return sharedSecret;
+}
+
+- (NSData *)authenticateData:(NSData *)data key:(NSData *)key pinProtocol:(NSUInteger)pinProtocol {
+    if (pinProtocol == 1) {
+        return [[data ykf_fido2HMACWithKey:key] subdataWithRange:NSMakeRange(0, 16)];
+    }
+    return [data ykf_fido2HMACWithKey:[key subdataWithRange:NSMakeRange(0, 32)]];
+}
+
+- (NSData *)encryptData:(NSData *)data key:(NSData *)key pinProtocol:(NSUInteger)pinProtocol {
+    if (pinProtocol == 1) {
+        return [data ykf_aes256Operation:kCCEncrypt withKey:key];
+    }
+    NSData *iv = [NSData ykf_randomDataOfSize:16];
+    NSMutableData *result = [iv mutableCopy];
+    [result appendData:[data ykf_cryptOperation:kCCEncrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:[key subdataWithRange:NSMakeRange(32, 32)] iv:iv]];
+    return result;
+}
+
+- (nullable NSData *)decryptData:(NSData *)data key:(NSData *)key pinProtocol:(NSUInteger)pinProtocol {
+    if (pinProtocol == 1) {
+        return [data ykf_aes256Operation:kCCDecrypt withKey:key];
+    }
+    if (data.length <= 16) {
+        return nil;
+    }
+    NSData *iv = [data subdataWithRange:NSMakeRange(0, 16)];
+    NSData *cipher = [data subdataWithRange:NSMakeRange(16, data.length - 16)];
+    return [cipher ykf_cryptOperation:kCCDecrypt algorithm:kCCAlgorithmAES mode:kCCModeCBC key:[key subdataWithRange:NSMakeRange(32, 32)] iv:iv];
+}
+
+#pragma mark - Credentials
+
+- (nullable FakeYubiKeyFIDOCredential *)credentialWithId:(NSData *)credentialId rpId:(NSString *)rpId {
+    for (FakeYubiKeyFIDOCredential *credential in self.credentials) {
+        if ([credential.credentialId isEqualToData:credentialId] && [credential.rpId isEqualToString:rpId]) {
+            return credential;
+        }
+    }
+    return nil;
+}
+
+/*
+ rpIdHash, flags, signature counter and, when registering, the attested credential data with the COSE public key.
+ */
+- (NSData *)authenticatorDataWithRpId:(NSString *)rpId flags:(UInt8)flags attestedCredential:(nullable FakeYubiKeyFIDOCredential *)credential {
+    NSMutableData *authData = [[[rpId dataUsingEncoding:NSUTF8StringEncoding] ykf_SHA256] mutableCopy];
+    [authData appendBytes:&flags length:1];
+    UInt32 counter = CFSwapInt32HostToBig(++self.signatureCounter);
+    [authData appendBytes:&counter length:4];
+    if (!credential) {
+        return authData;
+    }
+    [authData appendData:self.aaguid];
+    UInt16 credentialIdLength = CFSwapInt16HostToBig(credential.credentialId.length);
+    [authData appendBytes:&credentialIdLength length:2];
+    [authData appendData:credential.credentialId];
+
+    SecKeyRef publicKey = SecKeyCopyPublicKey((__bridge SecKeyRef)credential.privateKey);
+    NSData *point = CFBridgingRelease(SecKeyCopyExternalRepresentation(publicKey, nil));
+    CFRelease(publicKey);
+    NSDictionary *coseKey = @{
+        YKFCBORInteger(1): YKFCBORInteger(2),
+        YKFCBORInteger(3): YKFCBORInteger(FakeYubiKeyCOSEAlgorithmES256),
+        YKFCBORInteger(-1): YKFCBORInteger(1),
+        YKFCBORInteger(-2): YKFCBORByteString([point subdataWithRange:NSMakeRange(1, 32)]),
+        YKFCBORInteger(-3): YKFCBORByteString([point subdataWithRange:NSMakeRange(33, 32)])
+    };
+    [authData appendData:[YKFCBOREncoder encodeMap:YKFCBORMap(coseKey)]];
+    return authData;
+}
+
+- (NSData *)signData:(NSData *)authData clientDataHash:(NSData *)clientDataHash credential:(FakeYubiKeyFIDOCredential *)credential {
+    NSMutableData *message = [authData mutableCopy];
+    [message appendData:clientDataHash];
+    return CFBridgingRelease(SecKeyCreateSignature((__bridge SecKeyRef)credential.privateKey, kSecKeyAlgorithmECDSASignatureMessageX962SHA256, (__bridge CFDataRef)message, nil));
+}
+
+#pragma mark - CBOR
+
+- (nullable NSDictionary *)requestFromCommand:(FakeYubiKeyCommand *)command {
+    if (command.data.length < 2) {
+        return nil;
+    }
+    NSInputStream *inputStream = [[NSInputStream alloc] initWithData:[command.data subdataWithRange:NSMakeRange(1, command.data.length - 1)]];
+    [inputStream open];
+    id cborObject = [YKFCBORDecoder decodeObjectFrom:inputStream];
+    [inputStream close];
+    id request = cborObject ? [YKFCBORDecoder convertCBORObjectToFoundationType:cborObject] : nil;
+    return [request isKindOfClass:NSDictionary.class] ? request : nil;
+}
+
+- (NSData *)ctapResponseWithStatus:(UInt8)status data:(NSData *)data {
+    NSMutableData *response = [NSMutableData dataWithBytes:&status length:1];
+    if (data) {
+        [response appendData:data];
+    }
+    return [FakeYubiKey responseWithData:response status:YKFAPDUErrorCodeNoError];
+}
+
+@end
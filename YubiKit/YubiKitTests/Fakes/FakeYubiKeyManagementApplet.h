@@ -0,0 +1,33 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Management applet. Reports the version and serial number of the key together with the configured interfaces.
+ */
+@interface FakeYubiKeyManagementApplet: NSObject<FakeYubiKeyApplet>
+
+@property (nonatomic) UInt8 formFactor;
+@property (nonatomic) UInt16 usbSupportedApplications;
+@property (nonatomic) UInt16 usbEnabledApplications;
+@property (nonatomic) UInt16 nfcSupportedApplications;
+@property (nonatomic) UInt16 nfcEnabledApplications;
+@property (nonatomic) BOOL isConfigurationLocked;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,79 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKeyManagementApplet.h"
+#import "YKFTLVRecord.h"
+#import "YKFManagementDeviceInfo+Private.h"
+
+static const UInt8 FakeYubiKeyManagementInsReadConfig = 0x1D;
+
+@implementation FakeYubiKeyManagementApplet
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.formFactor = 0x01; // USB-A keychain
+        self.usbSupportedApplications = 0x023F;
+        self.usbEnabledApplications = 0x023F;
+        self.nfcSupportedApplications = 0x023F;
+        self.nfcEnabledApplications = 0x023F;
+    }
+    return self;
+}
+
+- (NSData *)aid {
+    return [NSData dataWithBytes:(UInt8[]){0xA0, 0x00, 0x00, 0x05, 0x27, 0x47, 0x11, 0x17} length:8];
+}
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key {
+    NSString *version = [NSString stringWithFormat:@"Virtual mgr - FW version %d.%d.%d", key.version.major, key.version.minor, key.version.micro];
+    return [FakeYubiKey responseWithData:[version dataUsingEncoding:NSUTF8StringEncoding] status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    if (command.ins != FakeYubiKeyManagementInsReadConfig) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+    if (command.p1 != 0) {
+        // All the records fit in the first page.
+        return [FakeYubiKey responseWithData:[NSData dataWithBytes:(UInt8[]){0x00} length:1] status:YKFAPDUErrorCodeNoError];
+    }
+
+    UInt32 serial = CFSwapInt32HostToBig(key.serialNumber);
+    UInt8 version[3] = {key.version.major, key.version.minor, key.version.micro};
+    NSArray<YKFTLVRecord *> *records = @[
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagUSBSupported value:[self dataWithApplications:self.usbSupportedApplications]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagSerialNumber value:[NSData dataWithBytes:&serial length:4]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagUSBEnabled value:[self dataWithApplications:self.usbEnabledApplications]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagFormfactor value:[NSData dataWithBytes:&_formFactor length:1]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagFirmwareVersion value:[NSData dataWithBytes:version length:3]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagNFCSupported value:[self dataWithApplications:self.nfcSupportedApplications]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagNFCEnabled value:[self dataWithApplications:self.nfcEnabledApplications]],
+        [[YKFTLVRecord alloc] initWithTag:YKFManagementTagConfigLocked value:[NSData dataWithBytes:(UInt8[]){self.isConfigurationLocked ? 0x01 : 0x00} length:1]]
+    ];
+
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:1];
+    for (YKFTLVRecord *record in records) {
+        [data appendData:record.data];
+    }
+    ((UInt8 *)data.mutableBytes)[0] = data.length - 1;
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)dataWithApplications:(UInt16)applications {
+    UInt16 applicationsBE = CFSwapInt16HostToBig(applications);
+    return [NSData dataWithBytes:&applicationsBE length:2];
+}
+
+@end
@@ -0,0 +1,52 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ A credential stored by the OATH applet. The type and algorithm are encoded like in the PUT command.
+ */
+@interface FakeYubiKeyOATHCredential: NSObject
+
+@property (nonatomic) NSString *name;
+@property (nonatomic) UInt8 typeAndAlgorithm;
+@property (nonatomic) UInt8 digits;
+@property (nonatomic) NSData *secret;
+@property (nonatomic) BOOL requiresTouch;
+@property (nonatomic) UInt32 counter;
+
+@end
+
+/*
+ OATH applet. Stores the credentials in memory and calculates the codes like the key, including the access key
+ (password) protection and the touch policy.
+ */
+@interface FakeYubiKeyOATHApplet: NSObject<FakeYubiKeyApplet>
+
+@property (nonatomic, readonly) NSArray<FakeYubiKeyOATHCredential *> *credentials;
+
+// The access key set with SET CODE. Nil when the applet is not password protected.
+@property (nonatomic, nullable) NSData *accessKey;
+
+// The salt used by the host to derive the access key from the password.
+@property (nonatomic, readonly) NSData *salt;
+
+// PUT fails with 6A84 when adding a credential would exceed this count. Defaults to 32.
+@property (nonatomic) NSUInteger maxCredentialCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
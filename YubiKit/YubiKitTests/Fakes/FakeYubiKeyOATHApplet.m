@@ -0,0 +1,372 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <CommonCrypto/CommonCrypto.h>
+#import "FakeYubiKeyOATHApplet.h"
+#import "YKFNSDataAdditions+Private.h"
+
+static const UInt8 FakeYubiKeyOATHInsPut = 0x01;
+static const UInt8 FakeYubiKeyOATHInsDelete = 0x02;
+static const UInt8 FakeYubiKeyOATHInsSetCode = 0x03;
+static const UInt8 FakeYubiKeyOATHInsReset = 0x04;
+static const UInt8 FakeYubiKeyOATHInsRename = 0x05;
+static const UInt8 FakeYubiKeyOATHInsList = 0xA1;
+static const UInt8 FakeYubiKeyOATHInsCalculate = 0xA2;
+static const UInt8 FakeYubiKeyOATHInsValidate = 0xA3;
+static const UInt8 FakeYubiKeyOATHInsCalculateAll = 0xA4;
+static const UInt8 FakeYubiKeyOATHInsSendRemaining = 0xA5;
+
+static const UInt8 FakeYubiKeyOATHTagName = 0x71;
+static const UInt8 FakeYubiKeyOATHTagNameList = 0x72;
+static const UInt8 FakeYubiKeyOATHTagKey = 0x73;
+static const UInt8 FakeYubiKeyOATHTagChallenge = 0x74;
+static const UInt8 FakeYubiKeyOATHTagResponse = 0x75;
+static const UInt8 FakeYubiKeyOATHTagTruncatedResponse = 0x76;
+static const UInt8 FakeYubiKeyOATHTagHOTP = 0x77;
+static const UInt8 FakeYubiKeyOATHTagProperty = 0x78;
+static const UInt8 FakeYubiKeyOATHTagVersion = 0x79;
+static const UInt8 FakeYubiKeyOATHTagImf = 0x7A;
+static const UInt8 FakeYubiKeyOATHTagAlgorithm = 0x7B;
+static const UInt8 FakeYubiKeyOATHTagTouch = 0x7C;
+
+static const UInt8 FakeYubiKeyOATHPropertyTouch = 0x02;
+static const UInt8 FakeYubiKeyOATHTypeHOTP = 0x10;
+
+@implementation FakeYubiKeyOATHCredential
+@end
+
+@interface FakeYubiKeyOATHApplet()
+
+@property (nonatomic) NSMutableArray<FakeYubiKeyOATHCredential *> *storedCredentials;
+@property (nonatomic, readwrite) NSData *salt;
+@property (nonatomic) NSData *challenge;
+@property (nonatomic) BOOL isAuthenticated;
+
+@end
+
+@implementation FakeYubiKeyOATHApplet
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.storedCredentials = [[NSMutableArray alloc] init];
+        self.salt = [NSData ykf_randomDataOfSize:8];
+        self.maxCredentialCount = 32;
+    }
+    return self;
+}
+
+- (NSArray<FakeYubiKeyOATHCredential *> *)credentials {
+    return [self.storedCredentials copy];
+}
+
+- (NSData *)aid {
+    return [NSData dataWithBytes:(UInt8[]){0xA0, 0x00, 0x00, 0x05, 0x27, 0x21, 0x01} length:7];
+}
+
+- (UInt8)sendRemainingIns {
+    return FakeYubiKeyOATHInsSendRemaining;
+}
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key {
+    self.isAuthenticated = NO;
+    NSMutableData *data = [[NSMutableData alloc] init];
+    UInt8 version[3] = {key.version.major, key.version.minor, key.version.micro};
+    [self appendTag:FakeYubiKeyOATHTagVersion value:[NSData dataWithBytes:version length:3] to:data];
+    [self appendTag:FakeYubiKeyOATHTagName value:self.salt to:data];
+    if (self.accessKey) {
+        self.challenge = [NSData ykf_randomDataOfSize:8];
+        [self appendTag:FakeYubiKeyOATHTagChallenge value:self.challenge to:data];
+        [self appendTag:FakeYubiKeyOATHTagAlgorithm value:[NSData dataWithBytes:(UInt8[]){0x01} length:1] to:data];
+    }
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    NSDictionary<NSNumber *, NSData *> *records = [self recordsFromData:command.data];
+    if (!records) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    if (command.ins == FakeYubiKeyOATHInsReset) {
+        return [self reset:command];
+    }
+    if (command.ins == FakeYubiKeyOATHInsValidate) {
+        return [self validate:records];
+    }
+    if (self.accessKey && !self.isAuthenticated) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+
+    switch (command.ins) {
+        case FakeYubiKeyOATHInsPut:
+            return [self put:records];
+        case FakeYubiKeyOATHInsDelete:
+            return [self delete:records];
+        case FakeYubiKeyOATHInsRename:
+            return [self rename:command.data];
+        case FakeYubiKeyOATHInsSetCode:
+            return [self setCode:records];
+        case FakeYubiKeyOATHInsList:
+            return [self list];
+        case FakeYubiKeyOATHInsCalculate:
+            return [self calculate:records truncated:command.p2 == 0x01 key:key];
+        case FakeYubiKeyOATHInsCalculateAll:
+            return [self calculateAll:records];
+        default:
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+}
+
+#pragma mark - Commands
+
+- (NSData *)put:(NSDictionary<NSNumber *, NSData *> *)records {
+    NSString *name = [self nameFromRecords:records];
+    NSData *keyData = records[@(FakeYubiKeyOATHTagKey)];
+    if (!name || keyData.length < 2) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    FakeYubiKeyOATHCredential *credential = [self credentialWithName:name];
+    if (!credential) {
+        if (self.storedCredentials.count >= self.maxCredentialCount) {
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoSpace];
+        }
+        credential = [[FakeYubiKeyOATHCredential alloc] init];
+        [self.storedCredentials addObject:credential];
+    }
+    const UInt8 *keyBytes = keyData.bytes;
+    credential.name = name;
+    credential.typeAndAlgorithm = keyBytes[0];
+    credential.digits = keyBytes[1];
+    credential.secret = [keyData subdataWithRange:NSMakeRange(2, keyData.length - 2)];
+    credential.requiresTouch = ([self byteFromData:records[@(FakeYubiKeyOATHTagProperty)]] & FakeYubiKeyOATHPropertyTouch) != 0;
+    NSData *counter = records[@(FakeYubiKeyOATHTagImf)];
+    credential.counter = counter.length == 4 ? CFSwapInt32BigToHost(*(UInt32 *)counter.bytes) : 0;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)delete:(NSDictionary<NSNumber *, NSData *> *)records {
+    FakeYubiKeyOATHCredential *credential = [self credentialWithName:[self nameFromRecords:records]];
+    if (!credential) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeDataInvalid];
+    }
+    [self.storedCredentials removeObject:credential];
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)rename:(NSData *)data {
+    // Both names use the same tag, so they can't be read from the dictionary.
+    const UInt8 *bytes = data.bytes;
+    if (data.length < 2 || bytes[0] != FakeYubiKeyOATHTagName || data.length < 2 + bytes[1] + 2) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    NSUInteger oldLength = bytes[1];
+    NSDictionary<NSNumber *, NSData *> *newRecords = [self recordsFromData:[data subdataWithRange:NSMakeRange(2 + oldLength, data.length - 2 - oldLength)]];
+    NSString *oldName = [[NSString alloc] initWithData:[data subdataWithRange:NSMakeRange(2, oldLength)] encoding:NSUTF8StringEncoding];
+    NSString *newName = [self nameFromRecords:newRecords];
+    FakeYubiKeyOATHCredential *credential = [self credentialWithName:oldName];
+    if (!credential) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeDataInvalid];
+    }
+    if (!newName || [self credentialWithName:newName]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    credential.name = newName;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)setCode:(NSDictionary<NSNumber *, NSData *> *)records {
+    NSData *keyData = records[@(FakeYubiKeyOATHTagKey)];
+    if (keyData && keyData.length == 0) {
+        self.accessKey = nil;
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+    }
+    NSData *challenge = records[@(FakeYubiKeyOATHTagChallenge)];
+    NSData *response = records[@(FakeYubiKeyOATHTagResponse)];
+    if (keyData.length < 2 || !challenge || !response) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    NSData *accessKey = [keyData subdataWithRange:NSMakeRange(1, keyData.length - 1)];
+    if (![[challenge ykf_oathHMACWithKey:accessKey] isEqualToData:response]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    self.accessKey = accessKey;
+    self.isAuthenticated = YES;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)reset:(FakeYubiKeyCommand *)command {
+    if (command.p1 != 0xDE || command.p2 != 0xAD) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    [self.storedCredentials removeAllObjects];
+    self.accessKey = nil;
+    self.salt = [NSData ykf_randomDataOfSize:8];
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)validate:(NSDictionary<NSNumber *, NSData *> *)records {
+    NSData *response = records[@(FakeYubiKeyOATHTagResponse)];
+    NSData *hostChallenge = records[@(FakeYubiKeyOATHTagChallenge)];
+    if (!self.accessKey || !self.challenge || !response || !hostChallenge) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    if (![[self.challenge ykf_oathHMACWithKey:self.accessKey] ykf_constantTimeCompareWithData:response]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    self.isAuthenticated = YES;
+    NSMutableData *data = [[NSMutableData alloc] init];
+    [self appendTag:FakeYubiKeyOATHTagResponse value:[hostChallenge ykf_oathHMACWithKey:self.accessKey] to:data];
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)list {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    for (FakeYubiKeyOATHCredential *credential in self.storedCredentials) {
+        UInt8 typeAndAlgorithm = credential.typeAndAlgorithm;
+        NSMutableData *value = [NSMutableData dataWithBytes:&typeAndAlgorithm length:1];
+        [value appendData:[credential.name dataUsingEncoding:NSUTF8StringEncoding]];
+        [self appendTag:FakeYubiKeyOATHTagNameList value:value to:data];
+    }
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)calculate:(NSDictionary<NSNumber *, NSData *> *)records truncated:(BOOL)truncated key:(FakeYubiKey *)key {
+    FakeYubiKeyOATHCredential *credential = [self credentialWithName:[self nameFromRecords:records]];
+    NSData *challenge = records[@(FakeYubiKeyOATHTagChallenge)];
+    if (!credential) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeDataInvalid];
+    }
+    if (!challenge) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    if (credential.requiresTouch && ![key waitForTouch]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+
+    NSData *hmac = [self hmacForCredential:credential challenge:challenge];
+    UInt8 digits = credential.digits;
+    NSMutableData *value = [NSMutableData dataWithBytes:&digits length:1];
+    [value appendData:truncated ? [self truncatedHMAC:hmac] : hmac];
+    NSMutableData *data = [[NSMutableData alloc] init];
+    [self appendTag:truncated ? FakeYubiKeyOATHTagTruncatedResponse : FakeYubiKeyOATHTagResponse value:value to:data];
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)calculateAll:(NSDictionary<NSNumber *, NSData *> *)records {
+    NSData *challenge = records[@(FakeYubiKeyOATHTagChallenge)];
+    if (!challenge) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    NSMutableData *data = [[NSMutableData alloc] init];
+    for (FakeYubiKeyOATHCredential *credential in self.storedCredentials) {
+        [self appendTag:FakeYubiKeyOATHTagName value:[credential.name dataUsingEncoding:NSUTF8StringEncoding] to:data];
+        UInt8 digits = credential.digits;
+        NSMutableData *value = [NSMutableData dataWithBytes:&digits length:1];
+        if (credential.typeAndAlgorithm & FakeYubiKeyOATHTypeHOTP) {
+            [self appendTag:FakeYubiKeyOATHTagHOTP value:value to:data];
+        } else if (credential.requiresTouch) {
+            [self appendTag:FakeYubiKeyOATHTagTouch value:value to:data];
+        } else {
+            [value appendData:[self truncatedHMAC:[self hmacForCredential:credential challenge:challenge]]];
+            [self appendTag:FakeYubiKeyOATHTagTruncatedResponse value:value to:data];
+        }
+    }
+    return [FakeYubiKey responseWithData:data status:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - Helpers
+
+- (NSData *)hmacForCredential:(FakeYubiKeyOATHCredential *)credential challenge:(NSData *)challenge {
+    if (credential.typeAndAlgorithm & FakeYubiKeyOATHTypeHOTP) {
+        UInt64 counter = CFSwapInt64HostToBig(credential.counter++);
+        challenge = [NSData dataWithBytes:&counter length:sizeof(counter)];
+    }
+    CCHmacAlgorithm algorithm;
+    NSUInteger length;
+    switch (credential.typeAndAlgorithm & 0x0F) {
+        case 0x02:
+            algorithm = kCCHmacAlgSHA256;
+            length = CC_SHA256_DIGEST_LENGTH;
+            break;
+        case 0x03:
+            algorithm = kCCHmacAlgSHA512;
+            length = CC_SHA512_DIGEST_LENGTH;
+            break;
+        default:
+            algorithm = kCCHmacAlgSHA1;
+            length = CC_SHA1_DIGEST_LENGTH;
+    }
+    NSMutableData *hmac = [NSMutableData dataWithLength:length];
+    CCHmac(algorithm, credential.secret.bytes, credential.secret.length, challenge.bytes, challenge.length, hmac.mutableBytes);
+    return hmac;
+}
+
+- (NSData *)truncatedHMAC:(NSData *)hmac {
+    const UInt8 *bytes = hmac.bytes;
+    NSUInteger offset = bytes[hmac.length - 1] & 0x0F;
+    UInt8 truncated[4] = {bytes[offset] & 0x7F, bytes[offset + 1], bytes[offset + 2], bytes[offset + 3]};
+    return [NSData dataWithBytes:truncated length:4];
+}
+
+- (FakeYubiKeyOATHCredential *)credentialWithName:(NSString *)name {
+    for (FakeYubiKeyOATHCredential *credential in self.storedCredentials) {
+        if ([credential.name isEqualToString:name]) {
+            return credential;
+        }
+    }
+    return nil;
+}
+
+- (NSString *)nameFromRecords:(NSDictionary<NSNumber *, NSData *> *)records {
+    NSData *name = records[@(FakeYubiKeyOATHTagName)];
+    return name.length ? [[NSString alloc] initWithData:name encoding:NSUTF8StringEncoding] : nil;
+}
+
+- (UInt8)byteFromData:(NSData *)data {
+    return data.length ? ((const UInt8 *)data.bytes)[0] : 0;
+}
+
+/*
+ The OATH applet uses single byte tags and lengths. The property tag has no length byte.
+ */
+- (NSDictionary<NSNumber *, NSData *> *)recordsFromData:(NSData *)data {
+    NSMutableDictionary<NSNumber *, NSData *> *records = [[NSMutableDictionary alloc] init];
+    const UInt8 *bytes = data.bytes;
+    NSUInteger index = 0;
+    while (index < data.length) {
+        UInt8 tag = bytes[index++];
+        if (index >= data.length) {
+            return nil;
+        }
+        if (tag == FakeYubiKeyOATHTagProperty) {
+            records[@(tag)] = [data subdataWithRange:NSMakeRange(index++, 1)];
+            continue;
+        }
+        NSUInteger length = bytes[index++];
+        if (index + length > data.length) {
+            return nil;
+        }
+        records[@(tag)] = [data subdataWithRange:NSMakeRange(index, length)];
+        index += length;
+    }
+    return records;
+}
+
+- (void)appendTag:(UInt8)tag value:(NSData *)value to:(NSMutableData *)data {
+    UInt8 header[2] = {tag, value.length};
+    [data appendBytes:header length:2];
+    [data appendData:value];
+}
+
+@end
@@ -0,0 +1,33 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ YubiOTP applet. Simulates the HMAC-SHA1 challenge-response configuration of the two slots.
+ */
+@interface FakeYubiKeyOTPApplet: NSObject<FakeYubiKeyApplet>
+
+// HMAC-SHA1 secrets of the slots. The key answers with an empty response when the slot is not configured.
+@property (nonatomic, nullable) NSData *slot1Secret;
+@property (nonatomic, nullable) NSData *slot2Secret;
+
+@property (nonatomic) BOOL slot1RequiresTouch;
+@property (nonatomic) BOOL slot2RequiresTouch;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,60 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKeyOTPApplet.h"
+#import "YKFNSDataAdditions+Private.h"
+
+static const UInt8 FakeYubiKeyOTPInsCommand = 0x01;
+static const UInt8 FakeYubiKeyOTPSlot1ChallengeHMAC = 0x30;
+static const UInt8 FakeYubiKeyOTPSlot2ChallengeHMAC = 0x38;
+
+@implementation FakeYubiKeyOTPApplet
+
+- (NSData *)aid {
+    return [NSData dataWithBytes:(UInt8[]){0xA0, 0x00, 0x00, 0x05, 0x27, 0x20, 0x01, 0x01} length:8];
+}
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key {
+    // Version, programming sequence and touch level.
+    UInt8 status[6] = {key.version.major, key.version.minor, key.version.micro, 0x01, 0x00, 0x00};
+    return [FakeYubiKey responseWithData:[NSData dataWithBytes:status length:6] status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    if (command.ins != FakeYubiKeyOTPInsCommand) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+
+    NSData *secret;
+    BOOL requiresTouch;
+    if (command.p1 == FakeYubiKeyOTPSlot1ChallengeHMAC) {
+        secret = self.slot1Secret;
+        requiresTouch = self.slot1RequiresTouch;
+    } else if (command.p1 == FakeYubiKeyOTPSlot2ChallengeHMAC) {
+        secret = self.slot2Secret;
+        requiresTouch = self.slot2RequiresTouch;
+    } else {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+
+    if (!secret) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+    }
+    if (requiresTouch && ![key waitForTouch]) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+    }
+    return [FakeYubiKey responseWithData:[command.data ykf_oathHMACWithKey:secret] status:YKFAPDUErrorCodeNoError];
+}
+
+@end
@@ -0,0 +1,47 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import "FakeYubiKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ PIV applet. Simulates the PIN and PUK retry counters, management key authentication and the data objects.
+ Signing is simulated for EC keys set with setPrivateKey:forSlot:, the other private key operations are not.
+ */
+@interface FakeYubiKeyPIVApplet: NSObject<FakeYubiKeyApplet>
+
+@property (nonatomic) NSString *pin;
+@property (nonatomic) NSString *puk;
+@property (nonatomic) UInt8 pinRetries;
+@property (nonatomic) UInt8 pukRetries;
+@property (nonatomic, readonly) UInt8 pinRetriesRemaining;
+@property (nonatomic, readonly) UInt8 pukRetriesRemaining;
+
+// The management key and its type (0x03 for 3DES, 0x08, 0x0A or 0x0C for AES). Defaults to the default 3DES key.
+@property (nonatomic) NSData *managementKey;
+@property (nonatomic) UInt8 managementKeyType;
+
+// Data objects stored with PUT DATA, keyed by object id.
+@property (nonatomic, readonly) NSDictionary<NSData *, NSData *> *objects;
+
+// Stores a data object without authenticating with the management key. A nil object deletes it.
+- (void)setObject:(nullable NSData *)object forObjectId:(NSData *)objectId;
+
+// Sets the EC private key used by GENERAL AUTHENTICATE in a slot. Signing requires the PIN to be verified.
+- (void)setPrivateKey:(SecKeyRef)privateKey forSlot:(UInt8)slot;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,365 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <CommonCrypto/CommonCrypto.h>
+#import "FakeYubiKeyPIVApplet.h"
+#import "YKFTLVRecord.h"
+#import "NSArray+YKFTLVRecord.h"
+#import "YKFNSDataAdditions+Private.h"
+
+static const UInt8 FakeYubiKeyPIVInsVerify = 0x20;
+static const UInt8 FakeYubiKeyPIVInsChangeReference = 0x24;
+static const UInt8 FakeYubiKeyPIVInsResetRetry = 0x2C;
+static const UInt8 FakeYubiKeyPIVInsAuthenticate = 0x87;
+static const UInt8 FakeYubiKeyPIVInsGetData = 0xCB;
+static const UInt8 FakeYubiKeyPIVInsPutData = 0xDB;
+static const UInt8 FakeYubiKeyPIVInsGetMetadata = 0xF7;
+static const UInt8 FakeYubiKeyPIVInsGetSerial = 0xF8;
+static const UInt8 FakeYubiKeyPIVInsSetPinPukAttempts = 0xFA;
+static const UInt8 FakeYubiKeyPIVInsReset = 0xFB;
+static const UInt8 FakeYubiKeyPIVInsGetVersion = 0xFD;
+
+static const UInt8 FakeYubiKeyPIVP2Pin = 0x80;
+static const UInt8 FakeYubiKeyPIVP2Puk = 0x81;
+static const UInt8 FakeYubiKeyPIVSlotCardManagement = 0x9B;
+
+static const UInt8 FakeYubiKeyPIVTagObjectId = 0x5C;
+static const UInt8 FakeYubiKeyPIVTagObjectData = 0x53;
+static const UInt8 FakeYubiKeyPIVTagDynAuth = 0x7C;
+static const UInt8 FakeYubiKeyPIVTagAuthWitness = 0x80;
+static const UInt8 FakeYubiKeyPIVTagChallenge = 0x81;
+static const UInt8 FakeYubiKeyPIVTagAuthResponse = 0x82;
+static const UInt8 FakeYubiKeyPIVTagMetadataAlgorithm = 0x01;
+static const UInt8 FakeYubiKeyPIVTagMetadataPolicy = 0x02;
+static const UInt8 FakeYubiKeyPIVTagMetadataOrigin = 0x03;
+static const UInt8 FakeYubiKeyPIVTagMetadataPublicKey = 0x04;
+static const UInt8 FakeYubiKeyPIVTagMetadataIsDefault = 0x05;
+static const UInt8 FakeYubiKeyPIVTagMetadataRetries = 0x06;
+
+static const UInt16 FakeYubiKeyPIVStatusBlocked = 0x6983;
+
+@interface FakeYubiKeyPIVApplet()
+
+@property (nonatomic, readwrite) UInt8 pinRetriesRemaining;
+@property (nonatomic, readwrite) UInt8 pukRetriesRemaining;
+@property (nonatomic) NSMutableDictionary<NSData *, NSData *> *storedObjects;
+@property (nonatomic) BOOL isPinVerified;
+@property (nonatomic) BOOL isManagementKeyAuthenticated;
+@property (nonatomic, nullable) NSData *witness;
+@property (nonatomic) NSMutableDictionary<NSNumber *, id> *privateKeys;
+
+@end
+
+@implementation FakeYubiKeyPIVApplet
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        [self resetApplet];
+    }
+    return self;
+}
+
+- (void)resetApplet {
+    self.pin = @"123456";
+    self.puk = @"12345678";
+    self.pinRetries = 3;
+    self.pukRetries = 3;
+    self.pinRetriesRemaining = 3;
+    self.pukRetriesRemaining = 3;
+    self.managementKey = [self defaultManagementKey];
+    self.managementKeyType = 0x03;
+    self.storedObjects = [[NSMutableDictionary alloc] init];
+    self.isPinVerified = NO;
+    self.isManagementKeyAuthenticated = NO;
+    self.witness = nil;
+    self.privateKeys = [[NSMutableDictionary alloc] init];
+}
+
+- (void)setPrivateKey:(SecKeyRef)privateKey forSlot:(UInt8)slot {
+    self.privateKeys[@(slot)] = (__bridge id)privateKey;
+}
+
+- (NSData *)defaultManagementKey {
+    UInt8 key[24] = {1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8};
+    return [NSData dataWithBytes:key length:24];
+}
+
+- (NSDictionary<NSData *, NSData *> *)objects {
+    return [self.storedObjects copy];
+}
+
+- (void)setObject:(NSData *)object forObjectId:(NSData *)objectId {
+    self.storedObjects[objectId] = object.length ? object : nil;
+}
+
+- (NSData *)aid {
+    return [NSData dataWithBytes:(UInt8[]){0xA0, 0x00, 0x00, 0x03, 0x08} length:5];
+}
+
+- (NSData *)selectWithKey:(FakeYubiKey *)key {
+    self.isPinVerified = NO;
+    self.isManagementKeyAuthenticated = NO;
+    self.witness = nil;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)processCommand:(FakeYubiKeyCommand *)command key:(FakeYubiKey *)key {
+    switch (command.ins) {
+        case FakeYubiKeyPIVInsGetVersion: {
+            UInt8 version[3] = {key.version.major, key.version.minor, key.version.micro};
+            return [FakeYubiKey responseWithData:[NSData dataWithBytes:version length:3] status:YKFAPDUErrorCodeNoError];
+        }
+        case FakeYubiKeyPIVInsGetSerial: {
+            UInt32 serial = CFSwapInt32HostToBig(key.serialNumber);
+            return [FakeYubiKey responseWithData:[NSData dataWithBytes:&serial length:4] status:YKFAPDUErrorCodeNoError];
+        }
+        case FakeYubiKeyPIVInsVerify:
+            return [self verify:command];
+        case FakeYubiKeyPIVInsChangeReference:
+        case FakeYubiKeyPIVInsResetRetry:
+            return [self changeReference:command];
+        case FakeYubiKeyPIVInsGetMetadata:
+            return [self metadata:command];
+        case FakeYubiKeyPIVInsGetData:
+            return [self getData:command];
+        case FakeYubiKeyPIVInsPutData:
+            return [self putData:command];
+        case FakeYubiKeyPIVInsAuthenticate:
+            return [self authenticate:command];
+        case FakeYubiKeyPIVInsSetPinPukAttempts:
+            return [self setPinPukAttempts:command];
+        case FakeYubiKeyPIVInsReset:
+            if (self.pinRetriesRemaining > 0 || self.pukRetriesRemaining > 0) {
+                return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeConditionNotSatisfied];
+            }
+            [self resetApplet];
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+        default:
+            return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeInsNotSupported];
+    }
+}
+
+#pragma mark - PIN and PUK
+
+- (NSData *)verify:(FakeYubiKeyCommand *)command {
+    if (command.p2 != FakeYubiKeyPIVP2Pin) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeReferencedDataNotFound];
+    }
+    if (command.data.length == 0) {
+        // Empty VERIFY reads the retry counter.
+        return [FakeYubiKey responseWithStatus:self.isPinVerified ? YKFAPDUErrorCodeNoError : 0x63C0 | self.pinRetriesRemaining];
+    }
+    if (self.pinRetriesRemaining == 0) {
+        return [FakeYubiKey responseWithStatus:FakeYubiKeyPIVStatusBlocked];
+    }
+    if (![command.data isEqualToData:[self paddedDataWithPin:self.pin]]) {
+        self.isPinVerified = NO;
+        self.pinRetriesRemaining--;
+        return [FakeYubiKey responseWithStatus:0x63C0 | self.pinRetriesRemaining];
+    }
+    self.isPinVerified = YES;
+    self.pinRetriesRemaining = self.pinRetries;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)changeReference:(FakeYubiKeyCommand *)command {
+    if (command.data.length != 16) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongLength];
+    }
+    // RESET RETRY is always verified with the PUK.
+    BOOL usesPuk = command.ins == FakeYubiKeyPIVInsResetRetry || command.p2 == FakeYubiKeyPIVP2Puk;
+    UInt8 remaining = usesPuk ? self.pukRetriesRemaining : self.pinRetriesRemaining;
+    if (remaining == 0) {
+        return [FakeYubiKey responseWithStatus:FakeYubiKeyPIVStatusBlocked];
+    }
+
+    NSData *current = [command.data subdataWithRange:NSMakeRange(0, 8)];
+    NSString *newValue = [self pinFromPaddedData:[command.data subdataWithRange:NSMakeRange(8, 8)]];
+    if (![current isEqualToData:[self paddedDataWithPin:usesPuk ? self.puk : self.pin]]) {
+        remaining--;
+        if (usesPuk) {
+            self.pukRetriesRemaining = remaining;
+        } else {
+            self.pinRetriesRemaining = remaining;
+        }
+        return [FakeYubiKey responseWithStatus:0x63C0 | remaining];
+    }
+
+    if (command.ins == FakeYubiKeyPIVInsResetRetry) {
+        self.pin = newValue;
+        self.pinRetriesRemaining = self.pinRetries;
+        self.pukRetriesRemaining = self.pukRetries;
+    } else if (usesPuk) {
+        self.puk = newValue;
+        self.pukRetriesRemaining = self.pukRetries;
+    } else {
+        self.pin = newValue;
+        self.pinRetriesRemaining = self.pinRetries;
+    }
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)setPinPukAttempts:(FakeYubiKeyCommand *)command {
+    if (!self.isManagementKeyAuthenticated || !self.isPinVerified) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    self.pinRetries = command.p1;
+    self.pukRetries = command.p2;
+    self.pinRetriesRemaining = command.p1;
+    self.pukRetriesRemaining = command.p2;
+    self.pin = @"123456";
+    self.puk = @"12345678";
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)metadata:(FakeYubiKeyCommand *)command {
+    NSMutableArray<YKFTLVRecord *> *records = [[NSMutableArray alloc] init];
+    if (command.p2 == FakeYubiKeyPIVP2Pin || command.p2 == FakeYubiKeyPIVP2Puk) {
+        BOOL isPin = command.p2 == FakeYubiKeyPIVP2Pin;
+        BOOL isDefault = isPin ? [self.pin isEqualToString:@"123456"] : [self.puk isEqualToString:@"12345678"];
+        UInt8 retries[2] = {isPin ? self.pinRetries : self.pukRetries, isPin ? self.pinRetriesRemaining : self.pukRetriesRemaining};
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataAlgorithm value:[NSData dataWithBytes:(UInt8[]){0xFF} length:1]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataIsDefault value:[NSData dataWithBytes:(UInt8[]){isDefault ? 1 : 0} length:1]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataRetries value:[NSData dataWithBytes:retries length:2]]];
+    } else if (command.p2 == FakeYubiKeyPIVSlotCardManagement) {
+        BOOL isDefault = [self.managementKey isEqualToData:[self defaultManagementKey]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataAlgorithm value:[NSData dataWithBytes:&_managementKeyType length:1]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataPolicy value:[NSData dataWithBytes:(UInt8[]){0x00, 0x01} length:2]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataIsDefault value:[NSData dataWithBytes:(UInt8[]){isDefault ? 1 : 0} length:1]]];
+    } else if (self.privateKeys[@(command.p2)]) {
+        SecKeyRef publicKey = SecKeyCopyPublicKey((__bridge SecKeyRef)self.privateKeys[@(command.p2)]);
+        NSData *point = (__bridge_transfer NSData *)SecKeyCopyExternalRepresentation(publicKey, nil);
+        CFRelease(publicKey);
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataAlgorithm value:[NSData dataWithBytes:(UInt8[]){0x11} length:1]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataPolicy value:[NSData dataWithBytes:(UInt8[]){0x02, 0x01} length:2]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataOrigin value:[NSData dataWithBytes:(UInt8[]){0x01} length:1]]];
+        [records addObject:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagMetadataPublicKey value:[[YKFTLVRecord alloc] initWithTag:0x86 value:point].data]];
+    } else {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeReferencedDataNotFound];
+    }
+    return [FakeYubiKey responseWithData:[self dataWithRecords:records] status:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - Data objects
+
+- (NSData *)getData:(FakeYubiKeyCommand *)command {
+    NSData *objectId = [[YKFTLVRecord sequenceOfRecordsFromData:command.data] ykfTLVRecordWithTag:FakeYubiKeyPIVTagObjectId].value;
+    NSData *object = objectId ? self.storedObjects[objectId] : nil;
+    if (!object) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeMissingFile];
+    }
+    return [FakeYubiKey responseWithData:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagObjectData value:object].data status:YKFAPDUErrorCodeNoError];
+}
+
+- (NSData *)putData:(FakeYubiKeyCommand *)command {
+    if (!self.isManagementKeyAuthenticated) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    NSArray<YKFTLVRecord *> *records = [YKFTLVRecord sequenceOfRecordsFromData:command.data];
+    NSData *objectId = [records ykfTLVRecordWithTag:FakeYubiKeyPIVTagObjectId].value;
+    NSData *object = [records ykfTLVRecordWithTag:FakeYubiKeyPIVTagObjectData].value;
+    if (!objectId || !object) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    self.storedObjects[objectId] = object.length ? object : nil;
+    return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - Management key
+
+- (NSData *)authenticate:(FakeYubiKeyCommand *)command {
+    if (command.p2 != FakeYubiKeyPIVSlotCardManagement) {
+        return [self sign:command];
+    }
+    if (command.p1 != self.managementKeyType) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    YKFTLVRecord *dynAuth = [YKFTLVRecord recordFromData:command.data];
+    NSArray<YKFTLVRecord *> *records = dynAuth.tag == FakeYubiKeyPIVTagDynAuth ? [YKFTLVRecord sequenceOfRecordsFromData:dynAuth.value] : nil;
+    YKFTLVRecord *witness = [records ykfTLVRecordWithTag:FakeYubiKeyPIVTagAuthWitness];
+    YKFTLVRecord *challenge = [records ykfTLVRecordWithTag:FakeYubiKeyPIVTagChallenge];
+    if (!witness) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+
+    CCAlgorithm algorithm = self.managementKeyType == 0x03 ? kCCAlgorithm3DES : kCCAlgorithmAES;
+    if (witness.value.length == 0) {
+        // Step 1: send the encrypted witness.
+        self.isManagementKeyAuthenticated = NO;
+        self.witness = [NSData ykf_randomDataOfSize:algorithm == kCCAlgorithm3DES ? 8 : 16];
+        YKFTLVRecord *response = [[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagAuthWitness value:[self.witness ykf_encryptDataWithAlgorithm:algorithm key:self.managementKey]];
+        return [FakeYubiKey responseWithData:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagDynAuth records:@[response]].data status:YKFAPDUErrorCodeNoError];
+    }
+
+    // Step 2: check the decrypted witness and answer the host challenge.
+    BOOL isValid = self.witness && challenge && [witness.value ykf_constantTimeCompareWithData:self.witness];
+    self.witness = nil;
+    if (!isValid) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    self.isManagementKeyAuthenticated = YES;
+    YKFTLVRecord *response = [[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagAuthResponse value:[challenge.value ykf_encryptDataWithAlgorithm:algorithm key:self.managementKey]];
+    return [FakeYubiKey responseWithData:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagDynAuth records:@[response]].data status:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - Private keys
+
+- (NSData *)sign:(FakeYubiKeyCommand *)command {
+    SecKeyRef privateKey = (__bridge SecKeyRef)self.privateKeys[@(command.p2)];
+    YKFTLVRecord *dynAuth = [YKFTLVRecord recordFromData:command.data];
+    NSArray<YKFTLVRecord *> *records = dynAuth.tag == FakeYubiKeyPIVTagDynAuth ? [YKFTLVRecord sequenceOfRecordsFromData:dynAuth.value] : nil;
+    YKFTLVRecord *challenge = [records ykfTLVRecordWithTag:FakeYubiKeyPIVTagChallenge];
+    if (!privateKey || !challenge) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    if (!self.isPinVerified) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeAuthenticationRequired];
+    }
+    NSData *signature = (__bridge_transfer NSData *)SecKeyCreateSignature(privateKey, kSecKeyAlgorithmECDSASignatureDigestX962, (__bridge CFDataRef)challenge.value, nil);
+    if (!signature) {
+        return [FakeYubiKey responseWithStatus:YKFAPDUErrorCodeWrongData];
+    }
+    YKFTLVRecord *response = [[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagAuthResponse value:signature];
+    return [FakeYubiKey responseWithData:[[YKFTLVRecord alloc] initWithTag:FakeYubiKeyPIVTagDynAuth records:@[response]].data status:YKFAPDUErrorCodeNoError];
+}
+
+#pragma mark - Helpers
+
+- (NSData *)paddedDataWithPin:(NSString *)pin {
+    NSMutableData *data = [[pin dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+    while (data.length < 8) {
+        [data appendBytes:(UInt8[]){0xFF} length:1];
+    }
+    return data;
+}
+
+- (NSString *)pinFromPaddedData:(NSData *)data {
+    const UInt8 *bytes = data.bytes;
+    NSUInteger length = data.length;
+    while (length > 0 && bytes[length - 1] == 0xFF) {
+        length--;
+    }
+    return [[NSString alloc] initWithData:[data subdataWithRange:NSMakeRange(0, length)] encoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)dataWithRecords:(NSArray<YKFTLVRecord *> *)records {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    for (YKFTLVRecord *record in records) {
+        [data appendData:record.data];
+    }
+    return data;
+}
+
+@end
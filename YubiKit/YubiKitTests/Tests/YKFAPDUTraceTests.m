@@ -0,0 +1,201 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYKFConnectionController.h"
+#import "YKFSmartCardInterface.h"
+#import "YKFAPDUTrace.h"
+#import "YKFTraceRecordingConnectionController.h"
+#import "YKFTraceReplayConnectionController.h"
+#import "YKFSessionError.h"
+
+@interface YKFAPDUTraceTests: YKFTestCase
+@end
+
+@implementation YKFAPDUTraceTests
+
+- (YKFAPDUTrace *)chainedResponseTrace {
+    NSData *select = [NSData dataFromHexString:@"00a4040007a0000005272101"];
+    NSData *getResponse = [NSData dataFromHexString:@"00c0000000"];
+    return [[YKFAPDUTrace alloc] initWithEntries:@[
+        [[YKFAPDUTraceEntry alloc] initWithCommand:select response:[NSData dataFromHexString:@"0102036102"] error:nil offset:0 duration:0.02],
+        [[YKFAPDUTraceEntry alloc] initWithCommand:getResponse response:[NSData dataFromHexString:@"04059000"] error:nil offset:0.025 duration:0.01]
+    ]];
+}
+
+- (NSData *)executeCommand:(NSString *)hexCommand controller:(id<YKFConnectionControllerProtocol>)controller error:(NSError **)error {
+    YKFSmartCardInterface *smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:controller];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Trace command"];
+    __block NSData *result = nil;
+    __block NSError *resultError = nil;
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithData:[NSData dataFromHexString:hexCommand]];
+    [smartCardInterface executeCommand:apdu completion:^(NSData *data, NSError *executionError) {
+        result = data;
+        resultError = executionError;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    if (error) {
+        *error = resultError;
+    }
+    return result;
+}
+
+- (NSArray<YKFAPDUTraceEntry *> *)entriesRecordedForCommands:(NSArray<NSString *> *)hexCommands {
+    FakeYKFConnectionController *fakeController = [[FakeYKFConnectionController alloc] init];
+    NSMutableArray<NSData *> *responses = [[NSMutableArray alloc] initWithCapacity:hexCommands.count];
+    for (NSUInteger i = 0; i < hexCommands.count; i++) {
+        [responses addObject:[NSData dataFromHexString:@"9000"]];
+    }
+    fakeController.commandExecutionResponseDataSequence = responses;
+    YKFTraceRecordingConnectionController *recorder = [[YKFTraceRecordingConnectionController alloc] initWithConnectionController:fakeController];
+    for (NSString *hexCommand in hexCommands) {
+        [self executeCommand:hexCommand controller:recorder error:nil];
+    }
+    return recorder.trace.entries;
+}
+
+- (void)test_WhenSerializingTrace_TraceIsParsedBack {
+    NSError *error = [NSError errorWithDomain:@"com.apple.CryptoTokenKit" code:-3 userInfo:nil];
+    NSArray *entries = [self.chainedResponseTrace.entries arrayByAddingObject:
+        [[YKFAPDUTraceEntry alloc] initWithCommand:[NSData dataFromHexString:@"00a4040000"] response:nil error:error offset:1.5 duration:0.000001]];
+    YKFAPDUTrace *trace = [[YKFAPDUTrace alloc] initWithEntries:entries];
+
+    YKFAPDUTrace *parsedTrace = [[YKFAPDUTrace alloc] initWithData:trace.dataRepresentation];
+    XCTAssertNotNil(parsedTrace);
+    XCTAssertEqual(parsedTrace.entries.count, 3);
+    for (NSUInteger i = 0; i < 3; i++) {
+        XCTAssertEqualObjects(parsedTrace.entries[i].command, trace.entries[i].command);
+        XCTAssertEqualObjects(parsedTrace.entries[i].response, trace.entries[i].response);
+        XCTAssertEqualObjects(parsedTrace.entries[i].error, trace.entries[i].error);
+        XCTAssertEqualWithAccuracy(parsedTrace.entries[i].offset, trace.entries[i].offset, 0.000001);
+        XCTAssertEqualWithAccuracy(parsedTrace.entries[i].duration, trace.entries[i].duration, 0.000001);
+    }
+}
+
+- (void)test_WhenParsingInvalidTrace_NilIsReturned {
+    NSData *data = self.chainedResponseTrace.dataRepresentation;
+    XCTAssertNil([[YKFAPDUTrace alloc] initWithData:[data subdataWithRange:NSMakeRange(0, data.length - 1)]]);
+    XCTAssertNil([[YKFAPDUTrace alloc] initWithData:[NSData dataFromHexString:@"594b545202"]]);
+    XCTAssertNotNil([[YKFAPDUTrace alloc] initWithData:[NSData dataFromHexString:@"594b545201"]]);
+}
+
+- (void)test_WhenRecordingCommands_ReplayReturnsTheSameResponses {
+    FakeYKFConnectionController *fakeController = [[FakeYKFConnectionController alloc] init];
+    fakeController.commandExecutionResponseDataSequence = @[[NSData dataFromHexString:@"0102036102"], [NSData dataFromHexString:@"04059000"]];
+    YKFTraceRecordingConnectionController *recorder = [[YKFTraceRecordingConnectionController alloc] initWithConnectionController:fakeController];
+
+    NSData *recordedResult = [self executeCommand:@"00a4040007a0000005272101" controller:recorder error:nil];
+    XCTAssertEqualObjects(recordedResult, [NSData dataFromHexString:@"0102030405"]);
+    XCTAssertEqual(recorder.trace.entries.count, 2);
+
+    YKFAPDUTrace *trace = [[YKFAPDUTrace alloc] initWithData:recorder.trace.dataRepresentation];
+    YKFTraceReplayConnectionController *replay = [[YKFTraceReplayConnectionController alloc] initWithTrace:trace];
+    NSError *error = nil;
+    NSData *replayedResult = [self executeCommand:@"00a4040007a0000005272101" controller:replay error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(replayedResult, recordedResult);
+    XCTAssertEqual(replay.remainingEntryCount, 0);
+}
+
+- (void)test_WhenRecordingSecrets_CommandAndResponseDataIsRedacted {
+    FakeYKFConnectionController *fakeController = [[FakeYKFConnectionController alloc] init];
+    fakeController.commandExecutionResponseDataSequence = @[[NSData dataFromHexString:@"9000"],
+                                                            [NSData dataFromHexString:@"7504010203049000"],
+                                                            [NSData dataFromHexString:@"7504010203049000"]];
+    YKFTraceRecordingConnectionController *recorder = [[YKFTraceRecordingConnectionController alloc] initWithConnectionController:fakeController];
+
+    [self executeCommand:@"0020008008313233343536ffff" controller:recorder error:nil];
+    [self executeCommand:@"00a300000c7504010203047404aabbccdd" controller:recorder error:nil];
+    recorder.redactionBlock = nil;
+    [self executeCommand:@"00a300000c7504010203047404aabbccdd" controller:recorder error:nil];
+
+    NSArray<YKFAPDUTraceEntry *> *entries = recorder.trace.entries;
+    XCTAssertEqual(entries.count, 3);
+    XCTAssertEqualObjects(entries[0].command, [NSData dataFromHexString:@"00200080080000000000000000"]);
+    XCTAssertEqualObjects(entries[1].command, [NSData dataFromHexString:@"00a300000c000000000000000000000000000000"]);
+    XCTAssertEqualObjects(entries[1].response, [NSData dataFromHexString:@"0000000000009000"]);
+    XCTAssertEqualObjects(entries[2].command, [NSData dataFromHexString:@"00a300000c7504010203047404aabbccdd"]);
+    XCTAssertEqualObjects(entries[2].response, [NSData dataFromHexString:@"7504010203049000"]);
+}
+
+- (void)test_WhenRecordingOATHPut_CredentialSecretIsRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"000100000f710361626373072106010203040506"]];
+    XCTAssertEqualObjects(entries.firstObject.command, [NSData dataFromHexString:@"000100000f000000000000000000000000000000"]);
+}
+
+- (void)test_WhenRecordingOATHSetCode_AccessKeyIsRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"00030000087306010102030405"]];
+    XCTAssertEqualObjects(entries.firstObject.command, [NSData dataFromHexString:@"00030000080000000000000000"]);
+}
+
+- (void)test_WhenRecordingPIVImportKey_PrivateKeyIsRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"00fe119a090604a1a2a3a4aa0101"]];
+    XCTAssertEqualObjects(entries.firstObject.command, [NSData dataFromHexString:@"00fe119a09000000000000000000"]);
+}
+
+- (void)test_WhenRecordingPIVResetRetryCounter_PUKAndPINAreRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"002c0080103132333435363738313233343536ffff"]];
+    XCTAssertEqualObjects(entries.firstObject.command, [NSData dataFromHexString:@"002c00801000000000000000000000000000000000"]);
+}
+
+- (void)test_WhenRecordingPutKey_SCPKeysAreRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"80d80001100102030405060708090a0b0c0d0e0f10"]];
+    XCTAssertEqualObjects(entries.firstObject.command, [NSData dataFromHexString:@"80d800011000000000000000000000000000000000"]);
+}
+
+- (void)test_WhenRecordingChainedClientPIN_EveryChunkIsRedacted {
+    NSArray<YKFAPDUTraceEntry *> *entries = [self entriesRecordedForCommands:@[@"901000000406a1a2a3", @"9010000004b1b2b3b4", @"8010000002c1c2", @"801000000104"]];
+    XCTAssertEqual(entries.count, 4);
+    XCTAssertEqualObjects(entries[0].command, [NSData dataFromHexString:@"901000000406000000"]);
+    XCTAssertEqualObjects(entries[1].command, [NSData dataFromHexString:@"901000000400000000"]);
+    XCTAssertEqualObjects(entries[2].command, [NSData dataFromHexString:@"80100000020000"]);
+    // Commands after the chain are recorded as sent.
+    XCTAssertEqualObjects(entries[3].command, [NSData dataFromHexString:@"801000000104"]);
+}
+
+- (void)test_WhenReplayingDifferentCommand_UnexpectedResultIsReturned {
+    YKFTraceReplayConnectionController *replay = [[YKFTraceReplayConnectionController alloc] initWithTrace:self.chainedResponseTrace];
+    NSError *error = nil;
+    XCTAssertNil([self executeCommand:@"00a4040007a0000003080000" controller:replay error:&error]);
+    XCTAssertEqual(error.code, YKFSessionErrorUnexpectedResult);
+    XCTAssertEqual(replay.remainingEntryCount, 2);
+
+    replay.matchesCommands = NO;
+    XCTAssertEqualObjects([self executeCommand:@"00a4040007a0000003080000" controller:replay error:&error], [NSData dataFromHexString:@"0102030405"]);
+
+    XCTAssertNil([self executeCommand:@"00a4040007a0000003080000" controller:replay error:&error]);
+    XCTAssertEqual(error.code, YKFSessionErrorConnectionLost);
+}
+
+- (void)test_WhenReplayingWithTimeScale_RecordedTimingIsKept {
+    YKFTraceReplayConnectionController *replay = [[YKFTraceReplayConnectionController alloc] initWithTrace:self.chainedResponseTrace];
+    replay.timeScale = 1;
+    NSDate *start = [NSDate date];
+    [self executeCommand:@"00a4040007a0000005272101" controller:replay error:nil];
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.03);
+}
+
+- (void)test_ReplayThroughput {
+    YKFTraceReplayConnectionController *replay = [[YKFTraceReplayConnectionController alloc] initWithTrace:self.chainedResponseTrace];
+    [self measureBlock:^{
+        for (int i = 0; i < 100; i++) {
+            [replay rewind];
+            [self executeCommand:@"00a4040007a0000005272101" controller:replay error:nil];
+        }
+    }];
+}
+
+@end
@@ -174,4 +174,50 @@
     XCTAssert(result == XCTWaiterResultTimedOut); // The result should time out because the key didn't reply to the request.
 }
 
+#pragma mark - Cancellation
+
+- (void)test_WhenCommandIsCancelled_QueueIsReleasedWithoutWaitingForTimeout {
+    
+    NSData *inputData = [NSData dataWithBytes:@[@(0x01), @(0x00), @(0x00)]];
+    self.eaSession = [[FakeEASession alloc] initWithInputData:inputData accessory:nil protocol:@"YLP"];
+    
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.eaSession operationQueue:self.operationQueue];
+    [self waitForTimeInterval:0.2];
+    
+    // The key keeps the command busy, the controller waits for the read timeout unless cancelled.
+    NSData *commandData = [@"command" dataUsingEncoding:NSUTF8StringEncoding];
+    YKFAPDU *command = [[YKFAPDU alloc] initWithData:commandData];
+    YKFCancellationToken *cancellationToken = [[YKFCancellationToken alloc] init];
+    
+    XCTestExpectation *commandExpectation = [[XCTestExpectation alloc] initWithDescription:@"Command execution completion."];
+    commandExpectation.inverted = YES;
+    [connectionController execute:command timeout:10 cancellationToken:cancellationToken completion:^(NSData *result, NSError *error, NSTimeInterval executionTime) {
+        [commandExpectation fulfill];
+    }];
+    [self waitForTimeInterval:0.2];
+    [cancellationToken cancel];
+    
+    XCTestExpectation *queueExpectation = [[XCTestExpectation alloc] initWithDescription:@"Queue released."];
+    [connectionController dispatchBlockOnCommunicationQueue:^(NSOperation *operation) {
+        [queueExpectation fulfill];
+    }];
+    
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[queueExpectation, commandExpectation] timeout:0.5];
+    XCTAssert(result == XCTWaiterResultCompleted);
+}
+
+- (void)test_WhenAllCommandsAreCancelled_ControllerTokenIsCancelledAndReplaced {
+    NSData *inputData = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
+    self.eaSession = [[FakeEASession alloc] initWithInputData:inputData accessory:nil protocol:@"YLP"];
+    
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:self.eaSession operationQueue:self.operationQueue];
+    YKFCancellationToken *cancellationToken = connectionController.cancellationToken;
+    
+    [connectionController cancelAllCommands];
+    
+    XCTAssertTrue(cancellationToken.isCancelled);
+    XCTAssertFalse(connectionController.cancellationToken.isCancelled);
+    XCTAssertFalse(self.operationQueue.isSuspended);
+}
+
 @end
@@ -0,0 +1,127 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "YKFAccessoryReadinessProbe.h"
+#import "YKFAccessoryConnectionController.h"
+#import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Private.h"
+#import "FakeEAAccessory.h"
+#import "FakeEASession.h"
+
+@interface YKFAccessoryReadinessProbeTests: YKFTestCase
+
+@property (nonatomic) NSOperationQueue *operationQueue;
+@property (nonatomic) dispatch_queue_t sharedDispatchQueue;
+@property (nonatomic) FakeEAAccessory *accessory;
+
+@end
+
+@implementation YKFAccessoryReadinessProbeTests
+
+- (void)setUp {
+    [super setUp];
+    
+    self.operationQueue = [[NSOperationQueue alloc] init];
+    self.operationQueue.maxConcurrentOperationCount = 1;
+    
+    dispatch_queue_attr_t dispatchQueueAttributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, DISPATCH_QUEUE_PRIORITY_HIGH, -1);
+    self.sharedDispatchQueue = dispatch_queue_create("com.yubico.YKCommunication", dispatchQueueAttributes);
+    self.operationQueue.underlyingQueue = self.sharedDispatchQueue;
+    
+    self.accessory = [[FakeEAAccessory alloc] init];
+    self.accessory.protocolStrings = @[@"com.yubico.ylp"];
+}
+
+- (void)tearDown {
+    self.operationQueue = nil;
+    self.sharedDispatchQueue = nil;
+    [super tearDown];
+}
+
+// Opens a fake session like YKFAccessoryConnection does and waits until the probe reports the key ready.
+- (BOOL)waitUntilReadyWithInputData:(NSData *)inputData probeCommand:(YKFAPDU *)probeCommand session:(FakeEASession **)session timeToReady:(NSTimeInterval *)timeToReady {
+    FakeEASession *eaSession = [[FakeEASession alloc] initWithInputData:inputData accessory:self.accessory protocol:@"com.yubico.ylp"];
+    YKFAccessoryReadinessProbe *probe = [[YKFAccessoryReadinessProbe alloc] initWithSession:eaSession queue:self.sharedDispatchQueue];
+    probe.probeCommand = probeCommand;
+    probe.probeTimeout = 0.05;
+    probe.maxProbeAttempts = 2;
+    eaSession.inputStream.delegate = probe;
+    eaSession.outputStream.delegate = probe;
+    YKFAccessoryConnectionController *connectionController = [[YKFAccessoryConnectionController alloc] initWithSession:eaSession operationQueue:self.operationQueue];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Accessory ready"];
+    __block BOOL result = NO;
+    [probe waitUntilReadyWithConnectionController:connectionController completion:^(BOOL ready, NSTimeInterval time) {
+        result = ready;
+        *timeToReady = time;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:2], XCTWaiterResultCompleted);
+    
+    XCTestExpectation *closeExpectation = [[XCTestExpectation alloc] initWithDescription:@"Close connection controller"];
+    [connectionController closeConnectionWithCompletion:^{
+        [closeExpectation fulfill];
+    }];
+    [XCTWaiter waitForExpectations:@[closeExpectation] timeout:1];
+    if (session) {
+        *session = eaSession;
+    }
+    return result;
+}
+
+- (void)test_WhenStreamsOpen_KeyIsReadyWithoutFixedDelay {
+    NSTimeInterval timeToReady = 0;
+    XCTAssertTrue([self waitUntilReadyWithInputData:[NSData data] probeCommand:nil session:nil timeToReady:&timeToReady]);
+    XCTAssertLessThan(timeToReady, 0.25);
+}
+
+- (void)test_WhenKeyAnswersProbe_KeyIsReady {
+    UInt8 responseBytes[] = {0x00, 0x90, 0x00};
+    YKFAPDU *probeCommand = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    FakeEASession *session = nil;
+    NSTimeInterval timeToReady = 0;
+    XCTAssertTrue([self waitUntilReadyWithInputData:[NSData dataWithBytes:responseBytes length:3] probeCommand:probeCommand session:&session timeToReady:&timeToReady]);
+    XCTAssertGreaterThan(session.outputStreamData.length, 0);
+}
+
+- (void)test_WhenKeyDoesNotAnswerProbe_ProbeIsRetriedAndGivesUp {
+    YKFAPDU *probeCommand = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    FakeEASession *session = nil;
+    NSTimeInterval timeToReady = 0;
+    XCTAssertFalse([self waitUntilReadyWithInputData:[NSData data] probeCommand:probeCommand session:&session timeToReady:&timeToReady]);
+    // Two probe commands were written.
+    NSData *written = session.outputStreamData;
+    XCTAssertEqual(written.length, 2 * probeCommand.ylpApduData.length);
+}
+
+- (void)test_TimeToReadyBenchmark {
+    UInt8 responseBytes[] = {0x00, 0x90, 0x00};
+    YKFAPDU *probeCommand = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    NSData *inputData = [NSData dataWithBytes:responseBytes length:3];
+    __block NSTimeInterval totalTimeToReady = 0;
+    __block NSUInteger runs = 0;
+    [self measureBlock:^{
+        NSTimeInterval timeToReady = 0;
+        XCTAssertTrue([self waitUntilReadyWithInputData:inputData probeCommand:probeCommand session:nil timeToReady:&timeToReady]);
+        totalTimeToReady += timeToReady;
+        runs += 1;
+    }];
+    // The fixed delays added 250 ms to every connection.
+    XCTAssertLessThan(totalTimeToReady / runs, 0.25);
+}
+
+@end
@@ -53,6 +53,8 @@
         @[@[@(-1), [NSData dataWithBytes:(UInt8[]){0x20} length:1]],
           @[@(-10), [NSData dataWithBytes:(UInt8[]){0x29} length:1]],
           @[@(-100), [NSData dataWithBytes:(UInt8[]){0x38, 0x63} length:2]],
+          @[@(-129), [NSData dataWithBytes:(UInt8[]){0x38, 0x80} length:2]],
+          @[@(-256), [NSData dataWithBytes:(UInt8[]){0x38, 0xFF} length:2]],
           @[@(-1000), [NSData dataWithBytes:(UInt8[]){0x39, 0x03, 0xE7} length:3]]
           ];
     
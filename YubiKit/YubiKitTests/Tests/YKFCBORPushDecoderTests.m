@@ -0,0 +1,127 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFCBOREncoder.h"
+#import "YKFCBORDecoder.h"
+#import "YKFCBORPushDecoder.h"
+#import "YKFSessionError.h"
+#import "YKFNSDataAdditions+Private.h"
+
+@interface YKFCBORPushDecoderTests: YKFTestCase
+
+@property (nonatomic) NSMutableArray *objects;
+@property (nonatomic) YKFCBORPushDecoder *decoder;
+
+@end
+
+@implementation YKFCBORPushDecoderTests
+
+- (void)setUp {
+    [super setUp];
+    self.objects = [[NSMutableArray alloc] init];
+    NSMutableArray *objects = self.objects;
+    self.decoder = [[YKFCBORPushDecoder alloc] initWithObjectHandler:^(id object) {
+        [objects addObject:object];
+    }];
+}
+
+- (YKFCBORMap *)testMap {
+    return YKFCBORMap((@{
+        YKFCBORInteger(1): YKFCBORTextString(@"水 IETF 𐅑"),
+        YKFCBORInteger(2): YKFCBORByteString([NSData ykf_randomDataOfSize:300]),
+        YKFCBORInteger(3): YKFCBORArray((@[YKFCBORInteger(-1000000), YKFCBORInteger(1000000000000), YKFCBORBool(YES),
+                                           YKFCBORArray(@[]), YKFCBORMap(@{YKFCBORTextString(@"a"): YKFCBORBool(NO)})])),
+        YKFCBORInteger(-24): YKFCBORByteString([NSData data])
+    }));
+}
+
+- (id)decodeWithStream:(NSData *)data {
+    NSInputStream *inputStream = [NSInputStream inputStreamWithData:data];
+    [inputStream open];
+    id decodedObject = [YKFCBORDecoder decodeObjectFrom:inputStream];
+    [inputStream close];
+    return decodedObject;
+}
+
+- (void)test_WhenDataIsSplitAtAnyOffset_ObjectsMatchTheStreamDecoder {
+    NSData *encodedMap = [YKFCBOREncoder encodeObject:[self testMap]];
+    id expected = [self decodeWithStream:encodedMap];
+    XCTAssertNotNil(expected);
+    
+    NSMutableData *data = [encodedMap mutableCopy];
+    [data appendData:encodedMap];
+    for (NSUInteger split = 0; split <= data.length; split++) {
+        [self.objects removeAllObjects];
+        NSError *error = nil;
+        XCTAssertTrue([self.decoder pushData:[data subdataWithRange:NSMakeRange(0, split)] error:&error]);
+        XCTAssertTrue([self.decoder pushData:[data subdataWithRange:NSMakeRange(split, data.length - split)] error:&error]);
+        XCTAssertTrue([self.decoder finishWithError:&error]);
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(self.objects, (@[expected, expected]));
+    }
+}
+
+- (void)test_WhenDataIsPushedByteByByte_ObjectsAreEmittedAsTheyComplete {
+    NSData *data = [NSData dataFromHexString:@"820102190100"];
+    const UInt8 *bytes = data.bytes;
+    NSArray<NSNumber *> *expectedCounts = @[@0, @0, @1, @1, @1, @2];
+    
+    for (NSUInteger i = 0; i < data.length; i++) {
+        XCTAssertTrue([self.decoder pushData:[NSData dataWithBytes:bytes + i length:1] error:nil]);
+        XCTAssertEqual(self.objects.count, expectedCounts[i].unsignedIntegerValue);
+        XCTAssertEqual(self.decoder.hasPartialObject, i != 2 && i != 5);
+    }
+    XCTAssertEqualObjects(self.objects, (@[YKFCBORArray((@[YKFCBORInteger(1), YKFCBORInteger(2)])), YKFCBORInteger(256)]));
+}
+
+- (void)test_WhenDataEndsInObject_FinishFails {
+    XCTAssertTrue([self.decoder pushData:[NSData dataFromHexString:@"a10182"] error:nil]);
+    NSError *error = nil;
+    XCTAssertFalse([self.decoder finishWithError:&error]);
+    XCTAssertEqual(error.code, YKFSessionErrorUnexpectedResult);
+    XCTAssertEqual(self.objects.count, 0);
+    
+    // The decoder is reset by finish.
+    XCTAssertTrue([self.decoder pushData:[NSData dataFromHexString:@"f5"] error:nil]);
+    XCTAssertTrue([self.decoder finishWithError:nil]);
+    XCTAssertEqualObjects(self.objects, @[YKFCBORBool(YES)]);
+}
+
+- (void)test_WhenDataIsInvalid_DecoderFailsUntilReset {
+    NSArray<NSString *> *invalidData = @[
+        @"a201010102",          // duplicated map key
+        @"1bffffffffffffffff",  // integer too large
+        @"62c328",              // invalid UTF-8
+        @"f6",                  // null is not supported
+        @"1c"                   // reserved additional information
+    ];
+    for (NSString *hex in invalidData) {
+        NSError *error = nil;
+        XCTAssertFalse([self.decoder pushData:[NSData dataFromHexString:hex] error:&error], @"%@", hex);
+        XCTAssertEqual(error.code, YKFSessionErrorUnexpectedResult);
+        XCTAssertFalse([self.decoder pushData:[NSData dataFromHexString:@"f5"] error:nil]);
+        [self.decoder reset];
+    }
+    XCTAssertEqual(self.objects.count, 0);
+}
+
+- (void)test_WhenStringIsTooLong_DecoderFailsBeforeReadingIt {
+    self.decoder.maximumStringLength = 16;
+    XCTAssertTrue([self.decoder pushData:[YKFCBOREncoder encodeObject:YKFCBORByteString([NSData ykf_randomDataOfSize:16])] error:nil]);
+    XCTAssertFalse([self.decoder pushData:[NSData dataFromHexString:@"51"] error:nil]);
+    XCTAssertEqual(self.objects.count, 1);
+}
+
+@end
@@ -0,0 +1,73 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFCancellationToken.h"
+
+@interface YKFCancellationTokenTests: YKFTestCase
+@end
+
+@implementation YKFCancellationTokenTests
+
+- (void)test_WhenNotCancelled_WaitTimesOut {
+    YKFCancellationToken *token = [[YKFCancellationToken alloc] init];
+    NSDate *start = [NSDate date];
+    XCTAssertFalse([token waitForTimeInterval:0.05]);
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.05);
+    XCTAssertFalse(token.isCancelled);
+}
+
+- (void)test_WhenCancelled_WaitWakesUpImmediately {
+    YKFCancellationToken *token = [[YKFCancellationToken alloc] init];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.05 * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        [token cancel];
+    });
+    NSDate *start = [NSDate date];
+    XCTAssertTrue([token waitForTimeInterval:10]);
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 1);
+    XCTAssertTrue(token.isCancelled);
+}
+
+- (void)test_WhenCancelled_HandlersAreCalledOnce {
+    YKFCancellationToken *token = [[YKFCancellationToken alloc] init];
+    __block int calls = 0;
+    __block int removedCalls = 0;
+    [token addCancellationHandler:^{
+        calls++;
+    }];
+    id registration = [token addCancellationHandler:^{
+        removedCalls++;
+    }];
+    [token removeCancellationHandler:registration];
+
+    [token cancel];
+    [token cancel];
+
+    XCTAssertEqual(calls, 1);
+    XCTAssertEqual(removedCalls, 0);
+}
+
+- (void)test_WhenAlreadyCancelled_HandlerIsCalledImmediately {
+    YKFCancellationToken *token = [[YKFCancellationToken alloc] init];
+    [token cancel];
+    __block BOOL called = NO;
+    id registration = [token addCancellationHandler:^{
+        called = YES;
+    }];
+    XCTAssertTrue(called);
+    XCTAssertNil(registration);
+}
+
+@end
@@ -0,0 +1,175 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "YKFSmartCardInterface.h"
+#import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Private.h"
+#import "YKFSessionError.h"
+#import "YKFConnectionMetrics.h"
+
+@interface YKFCommandPriorityTests: YKFTestCase
+
+@property (nonatomic) FakeYubiKey *key;
+@property (nonatomic) YKFSmartCardInterface *smartCardInterface;
+
+@end
+
+@implementation YKFCommandPriorityTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[FakeYubiKey alloc] init];
+    self.key.commandLatency = 0.02;
+    self.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:self.key];
+}
+
+- (YKFAPDU *)commandWithIns:(UInt8)ins {
+    return [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(UInt8[]){0x00, ins, 0x00, 0x00} length:4]];
+}
+
+- (NSArray<NSNumber *> *)receivedInstructions {
+    NSMutableArray *instructions = [[NSMutableArray alloc] init];
+    for (NSData *command in self.key.receivedCommands) {
+        [instructions addObject:@(((const UInt8 *)command.bytes)[1])];
+    }
+    return instructions;
+}
+
+- (void)test_WhenInteractiveCommandIsQueued_ItRunsAheadOfBackgroundCommands {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Commands completed"];
+    expectation.expectedFulfillmentCount = 4;
+    
+    [self.smartCardInterface performWithCommandPriority:YKFCommandPriorityBackground block:^{
+        for (UInt8 ins = 0x01; ins <= 0x03; ins++) {
+            [self.smartCardInterface executeCommand:[self commandWithIns:ins] completion:^(NSData *data, NSError *error) {
+                [expectation fulfill];
+            }];
+        }
+    }];
+    [self.smartCardInterface performWithCommandPriority:YKFCommandPriorityInteractive block:^{
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x10] completion:^(NSData *data, NSError *error) {
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    // The first background command may already be running when the interactive command is queued.
+    NSUInteger interactiveIndex = [self.receivedInstructions indexOfObject:@0x10];
+    XCTAssertLessThanOrEqual(interactiveIndex, 1);
+    
+    NSArray<YKFCommandQueueMetrics *> *queues = self.key.metrics.snapshot.queues;
+    XCTAssertEqual(queues.count, 2);
+    XCTAssertEqual(queues[0].priority, YKFCommandPriorityBackground);
+    XCTAssertEqual(queues[0].count, 3);
+    XCTAssertEqual(queues[1].priority, YKFCommandPriorityInteractive);
+    XCTAssertLessThan(queues[1].maxDelay, queues[0].maxDelay);
+}
+
+- (void)test_WhenResponseIsChained_InteractiveCommandDoesNotSplitTheChain {
+    self.key.maxResponseLength = 8;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Commands completed"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    YKFSelectApplicationAPDU *select = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameManagement];
+    [self.smartCardInterface selectApplication:select completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"Virtual mgr - FW version 5.4.3");
+        [expectation fulfill];
+    }];
+    [self.smartCardInterface performWithCommandPriority:YKFCommandPriorityInteractive block:^{
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x10] completion:^(NSData *data, NSError *error) {
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    NSArray *expected = @[@0xA4, @0xC0, @0xC0, @0xC0, @0x10];
+    XCTAssertEqualObjects(self.receivedInstructions, expected);
+}
+
+- (void)test_WhenCompletionQueuesCommand_CommandInheritsThePriority {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Commands completed"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    [self.smartCardInterface performWithCommandPriority:YKFCommandPriorityBackground block:^{
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x01] completion:^(NSData *data, NSError *error) {
+            [self.smartCardInterface executeCommand:[self commandWithIns:0x02] completion:^(NSData *data, NSError *error) {
+                [expectation fulfill];
+            }];
+        }];
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x03] completion:^(NSData *data, NSError *error) {
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    NSArray *expected = @[@0x01, @0x03, @0x02];
+    XCTAssertEqualObjects(self.receivedInstructions, expected);
+    XCTAssertEqual(self.key.metrics.snapshot.queues.firstObject.count, 3);
+}
+
+- (void)test_WhenCommandCannotStartBeforeDeadline_CommandIsNotSent {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Commands completed"];
+    expectation.expectedFulfillmentCount = 2;
+    
+    [self.key execute:[self commandWithIns:0x01] completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        [expectation fulfill];
+    }];
+    [self.key execute:[self commandWithIns:0x02] priority:YKFCommandPriorityNormal deadline:[NSDate dateWithTimeIntervalSinceNow:0.005] timeout:1 cancellationToken:nil completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(response);
+        XCTAssertEqual(error.code, YKFSessionErrorDeadlineExceededCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqualObjects(self.receivedInstructions, @[@0x01]);
+    XCTAssertEqual(self.key.metrics.snapshot.queues.firstObject.deadlineExceededCount, 1);
+}
+
+- (void)test_WhenCommandStartsBeforeDeadline_CommandRunsWithItsFullTimeout {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Command completed"];
+    self.key.commandLatency = 0.1;
+    
+    [self.key execute:[self commandWithIns:0x01] priority:YKFCommandPriorityNormal deadline:[NSDate dateWithTimeIntervalSinceNow:0.05] timeout:1 cancellationToken:nil completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(error);
+        XCTAssertNotNil(response);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqual(self.key.metrics.snapshot.queues.firstObject.deadlineExceededCount, 0);
+}
+
+- (void)test_WhenBlockIsDispatched_ItRunsAfterTheQueuedCommands {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Block called"];
+    __block NSUInteger commandCountInBlock = 0;
+    
+    [self.smartCardInterface performWithCommandPriority:YKFCommandPriorityBackground block:^{
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x01] completion:^(NSData *data, NSError *error) {}];
+        [self.smartCardInterface executeCommand:[self commandWithIns:0x02] completion:^(NSData *data, NSError *error) {}];
+    }];
+    [self.smartCardInterface dispatchAfterCurrentCommands:^{
+        commandCountInBlock = self.key.receivedCommands.count;
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqual(commandCountInBlock, 2);
+}
+
+@end
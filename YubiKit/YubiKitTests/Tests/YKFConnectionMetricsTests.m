@@ -0,0 +1,171 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "YKFConnectionMetrics.h"
+#import "YKFConnectionMetrics+Private.h"
+#import "YKFOATHSession+Private.h"
+#import "YKFU2FSession+Private.h"
+#import "YKFSCP03KeyParams.h"
+#import "YKFSCPKeyRef.h"
+#import "YKFSCPStaticKeys.h"
+
+@interface YKFConnectionMetricsTests: YKFTestCase
+@end
+
+@implementation YKFConnectionMetricsTests
+
+- (YKFCommandMetrics *)metricsForIns:(UInt8)ins inSnapshot:(YKFConnectionMetricsSnapshot *)snapshot {
+    for (YKFCommandMetrics *command in snapshot.commands) {
+        if (command.ins == ins) {
+            return command;
+        }
+    }
+    return nil;
+}
+
+- (void)test_WhenRecordingCommands_SnapshotContainsTheMetricsPerInstruction {
+    YKFConnectionMetrics *metrics = [[YKFConnectionMetrics alloc] init];
+    [metrics recordCommandWithIns:0xA4 duration:0.0005 bytesSent:12 bytesReceived:20 failed:NO];
+    [metrics recordCommandWithIns:0xA4 duration:0.03 bytesSent:12 bytesReceived:0 failed:YES];
+    [metrics recordCommandWithIns:0xA1 duration:10 bytesSent:5 bytesReceived:100 failed:NO];
+    [metrics recordGetResponseChunk];
+    [metrics recordWaitingTimeExtension];
+    [metrics recordTouchWaitWithDuration:1.5];
+    [metrics recordSCPCommandWithOverheadBytes:24 duration:0.001];
+
+    YKFConnectionMetricsSnapshot *snapshot = [metrics snapshot];
+    XCTAssertEqual(snapshot.commands.count, 2);
+    XCTAssertEqual(snapshot.commands[0].ins, 0xA1);
+
+    YKFCommandMetrics *select = [self metricsForIns:0xA4 inSnapshot:snapshot];
+    XCTAssertEqual(select.count, 2);
+    XCTAssertEqual(select.errorCount, 1);
+    XCTAssertEqual(select.bytesSent, 24);
+    XCTAssertEqual(select.bytesReceived, 20);
+    XCTAssertEqualWithAccuracy(select.totalDuration, 0.0305, 0.000001);
+    XCTAssertEqualWithAccuracy(select.maxDuration, 0.03, 0.000001);
+
+    // 0.5 ms goes to the first bucket, 30 ms to the < 50 ms bucket and 10 s to the last bucket.
+    NSArray<NSNumber *> *bounds = YKFCommandMetrics.latencyBucketUpperBounds;
+    XCTAssertEqual(select.latencyHistogram.count, bounds.count + 1);
+    XCTAssertEqual(select.latencyHistogram[0].integerValue, 1);
+    XCTAssertEqual(select.latencyHistogram[[bounds indexOfObject:@0.05]].integerValue, 1);
+    XCTAssertEqual([self metricsForIns:0xA1 inSnapshot:snapshot].latencyHistogram.lastObject.integerValue, 1);
+
+    XCTAssertEqual(snapshot.totalCommandCount, 3);
+    XCTAssertEqual(snapshot.totalBytesSent, 29);
+    XCTAssertEqual(snapshot.totalBytesReceived, 120);
+    XCTAssertEqual(snapshot.getResponseChunkCount, 1);
+    XCTAssertEqual(snapshot.waitingTimeExtensionCount, 1);
+    XCTAssertEqual(snapshot.touchWaitCount, 1);
+    XCTAssertEqualWithAccuracy(snapshot.touchWaitDuration, 1.5, 0.000001);
+    XCTAssertEqual(snapshot.scpCommandCount, 1);
+    XCTAssertEqual(snapshot.scpOverheadBytes, 24);
+}
+
+- (void)test_WhenExportingSnapshot_DictionaryIsValidJSON {
+    YKFConnectionMetrics *metrics = [[YKFConnectionMetrics alloc] init];
+    [metrics recordCommandWithIns:0x01 duration:0.002 bytesSent:40 bytesReceived:22 failed:NO];
+    NSDictionary *dictionary = [[metrics snapshot] dictionaryRepresentation];
+    XCTAssertTrue([NSJSONSerialization isValidJSONObject:dictionary]);
+    XCTAssertEqualObjects(dictionary[@"commands"][@"01"][@"count"], @1);
+    XCTAssertEqualObjects(dictionary[@"commands"][@"01"][@"bytesSent"], @40);
+}
+
+- (void)test_WhenResettingMetrics_CountersAreCleared {
+    YKFConnectionMetrics *metrics = [[YKFConnectionMetrics alloc] init];
+    NSDate *startDate = [metrics snapshot].startDate;
+    [metrics recordCommandWithIns:0xA4 duration:0.01 bytesSent:12 bytesReceived:20 failed:NO];
+    [metrics recordTouchWaitWithDuration:1];
+    [self waitForTimeInterval:0.01];
+    [metrics reset];
+
+    YKFConnectionMetricsSnapshot *snapshot = [metrics snapshot];
+    XCTAssertEqual(snapshot.commands.count, 0);
+    XCTAssertEqual(snapshot.touchWaitCount, 0);
+    XCTAssertGreaterThan([snapshot.startDate timeIntervalSinceDate:startDate], 0);
+}
+
+- (void)test_WhenRecordingFromManyThreads_NoCommandIsLost {
+    YKFConnectionMetrics *metrics = [[YKFConnectionMetrics alloc] init];
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (int i = 0; i < 1000; i++) {
+            [metrics recordCommandWithIns:0xA2 duration:(thread + 1) * 0.001 bytesSent:10 bytesReceived:10 failed:NO];
+        }
+    });
+    YKFCommandMetrics *command = [self metricsForIns:0xA2 inSnapshot:[metrics snapshot]];
+    XCTAssertEqual(command.count, 8000);
+    XCTAssertEqual(command.bytesSent, 80000);
+    XCTAssertEqualWithAccuracy(command.maxDuration, 0.008, 0.000001);
+}
+
+- (void)test_WhenUsingSessions_ControllerRecordsChainingAndSecureChannel {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.maxResponseLength = 16;
+    YKFSCPKeyRef *keyRef = [[YKFSCPKeyRef alloc] initWithKid:0x01 kvn:0xFF];
+    YKFSCP03KeyParams *params = [[YKFSCP03KeyParams alloc] initWithKeyRef:keyRef staticKeys:[YKFSCPStaticKeys defaultKeys]];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"OATH session over SCP03"];
+    [YKFOATHSession sessionWithConnectionController:key scpKeyParams:params completion:^(YKFOATHSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session listCredentialsWithCompletion:^(NSArray<YKFOATHCredential *> * _Nullable credentials, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+
+    YKFConnectionMetricsSnapshot *snapshot = [key.metrics snapshot];
+    XCTAssertEqual(snapshot.totalCommandCount, key.receivedCommands.count);
+    XCTAssertNotNil([self metricsForIns:0xA4 inSnapshot:snapshot]);
+    XCTAssertNotNil([self metricsForIns:0xA1 inSnapshot:snapshot]);
+    XCTAssertGreaterThan(snapshot.getResponseChunkCount, 0);
+    XCTAssertGreaterThan(snapshot.scpCommandCount, 0);
+    // At least the 8 byte C-MAC of each command and the R-MAC of each response.
+    XCTAssertGreaterThanOrEqual(snapshot.scpOverheadBytes, snapshot.scpCommandCount * 8);
+}
+
+- (void)test_WhenWaitingForTouch_TouchWaitIsRecorded {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.touchDelay = 0.6;
+    __block YKFU2FSession *u2fSession = nil;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F register with touch"];
+    [YKFU2FSession sessionWithConnectionController:key completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+        u2fSession = session;
+        [session registerWithChallenge:@"J3tMC4hiRP9PDQ1M4IsOp8A-_oh6hge0c38CqwiqYmo" appId:@"https://demo.yubico.com" completion:^(YKFU2FRegisterResponse * _Nullable response, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+
+    YKFConnectionMetricsSnapshot *snapshot = [key.metrics snapshot];
+    XCTAssertEqual(snapshot.touchWaitCount, 1);
+    XCTAssertGreaterThanOrEqual(snapshot.touchWaitDuration, 0.5);
+    XCTAssertGreaterThan(snapshot.waitingTimeExtensionCount, 0);
+}
+
+- (void)test_RecordingPerformance {
+    YKFConnectionMetrics *metrics = [[YKFConnectionMetrics alloc] init];
+    [self measureBlock:^{
+        for (int i = 0; i < 100000; i++) {
+            [metrics recordCommandWithIns:(UInt8)i duration:0.01 bytesSent:12 bytesReceived:258 failed:NO];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,95 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "YKFAPDU+Constants.h"
+#import "YKFAPDU+Private.h"
+#import "YKFFIDO2TouchPoolingAPDU.h"
+#import "YKFFIDO2GetInfoAPDU.h"
+#import "YKFFIDO2GetNextAssertionAPDU.h"
+#import "YKFFIDO2ResetAPDU.h"
+#import "YKFOATHListAPDU.h"
+
+@interface YKFConstantAPDUTests: YKFTestCase
+@end
+
+@implementation YKFConstantAPDUTests
+
+- (void)assertAPDU:(YKFAPDU *)shared encodesAs:(YKFAPDU *)built {
+    XCTAssertEqualObjects(shared.apduData, built.apduData);
+    XCTAssertEqualObjects(shared.ylpApduData, built.ylpApduData);
+}
+
+- (void)test_WhenUsingSendRemainingAPDUs_BytesAreEncodedOnce {
+    XCTAssertEqualObjects(YKFAPDU.getResponseAPDU.apduData, [NSData dataFromHexString:@"00c0000000"]);
+    XCTAssertEqualObjects(YKFAPDU.getResponseAPDU.ylpApduData, [NSData dataFromHexString:@"0000c0000000"]);
+    XCTAssertEqualObjects(YKFAPDU.oathSendRemainingAPDU.apduData, [NSData dataFromHexString:@"00a5000000"]);
+    XCTAssertEqualObjects(YKFAPDU.oathSendRemainingAPDU.ylpApduData, [NSData dataFromHexString:@"0000a5000000"]);
+    XCTAssertEqual(YKFAPDU.getResponseAPDU, YKFAPDU.getResponseAPDU);
+    XCTAssertEqual(YKFAPDU.oathSendRemainingAPDU, YKFAPDU.oathSendRemainingAPDU);
+}
+
+- (void)test_WhenUsingSessionAPDUs_BytesMatchTheBuiltCommands {
+    [self assertAPDU:YKFAPDU.oathListAPDU encodesAs:[[YKFOATHListAPDU alloc] init]];
+    [self assertAPDU:YKFAPDU.fido2TouchPollingAPDU encodesAs:[[YKFFIDO2TouchPoolingAPDU alloc] init]];
+    [self assertAPDU:YKFAPDU.fido2GetInfoAPDU encodesAs:[[YKFFIDO2GetInfoAPDU alloc] init]];
+    [self assertAPDU:YKFAPDU.fido2GetNextAssertionAPDU encodesAs:[[YKFFIDO2GetNextAssertionAPDU alloc] init]];
+    [self assertAPDU:YKFAPDU.fido2ResetAPDU encodesAs:[[YKFFIDO2ResetAPDU alloc] init]];
+    [self assertAPDU:YKFAPDU.managementDeviceResetAPDU encodesAs:[[YKFAPDU alloc] initWithCla:0 ins:0x1F p1:0 p2:0 data:[NSData data] type:YKFAPDUTypeExtended]];
+    XCTAssertEqual(YKFAPDU.fido2TouchPollingAPDU, YKFAPDU.fido2TouchPollingAPDU);
+}
+
+- (void)test_WhenSelectingApplications_SharedAPDUMatchesEachApplication {
+    for (YKFSelectApplicationAPDUName name = YKFSelectApplicationAPDUNameManagement; name <= YKFSelectApplicationAPDUNameSecurityDomain; name++) {
+        YKFSelectApplicationAPDU *shared = [YKFAPDU selectApplicationAPDUWithName:name];
+        [self assertAPDU:shared encodesAs:[[YKFSelectApplicationAPDU alloc] initWithApplicationName:name]];
+        XCTAssertEqual(shared, [YKFAPDU selectApplicationAPDUWithName:name]);
+    }
+}
+
+- (void)test_WhenReadingDeviceInfoPages_FirstPagesAreShared {
+    for (UInt8 page = 0; page < 6; page++) {
+        YKFAPDU *apdu = [YKFAPDU managementReadDeviceInfoAPDUWithPage:page];
+        [self assertAPDU:apdu encodesAs:[[YKFAPDU alloc] initWithCla:0x00 ins:0x1D p1:page p2:0x00 data:[NSData data] type:YKFAPDUTypeShort]];
+    }
+    XCTAssertEqual([YKFAPDU managementReadDeviceInfoAPDUWithPage:1], [YKFAPDU managementReadDeviceInfoAPDUWithPage:1]);
+    XCTAssertNotEqual([YKFAPDU managementReadDeviceInfoAPDUWithPage:5], [YKFAPDU managementReadDeviceInfoAPDUWithPage:5]);
+}
+
+- (void)test_BuildingConstantAPDUsPerCommandPerformance {
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            YKFAPDU *getResponse = [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(UInt8[]){0x00, 0xC0, 0x00, 0x00, 0x00} length:5]];
+            YKFAPDU *touchPolling = [[YKFFIDO2TouchPoolingAPDU alloc] init];
+            YKFAPDU *select = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNameFIDO2];
+            XCTAssertNotNil(getResponse.ylpApduData);
+            XCTAssertNotNil(touchPolling.ylpApduData);
+            XCTAssertNotNil(select.ylpApduData);
+        }
+    }];
+}
+
+- (void)test_SharingConstantAPDUsPerformance {
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            XCTAssertNotNil(YKFAPDU.getResponseAPDU.ylpApduData);
+            XCTAssertNotNil(YKFAPDU.fido2TouchPollingAPDU.ylpApduData);
+            XCTAssertNotNil([YKFAPDU selectApplicationAPDUWithName:YKFSelectApplicationAPDUNameFIDO2].ylpApduData);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,111 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "YKFSmartCardInterface.h"
+#import "YKFEventRing.h"
+#import "YKFEventRing+Private.h"
+
+@interface YKFEventRingTests: YKFTestCase
+@end
+
+@implementation YKFEventRingTests
+
+- (void)setUp {
+    [super setUp];
+    [YKFEventRing clear];
+}
+
+- (void)test_WhenRecordingEvents_EventsAreDumpedInOrder {
+    YKFEventRingRecord(YKFEventTypeAPDUSent, 0xA4, 13, 0);
+    YKFEventRingRecordResponse(0xA4, [NSData dataFromHexString:@"01026102"]);
+    YKFEventRingRecord(YKFEventTypeGetResponse, 0xC0, 0, 0x6102);
+
+    NSArray<YKFEvent *> *events = [YKFEventRing dump];
+    XCTAssertEqual(events.count, 3);
+    XCTAssertEqual(events[0].type, YKFEventTypeAPDUSent);
+    XCTAssertEqual(events[0].ins, 0xA4);
+    XCTAssertEqual(events[0].length, 13);
+    XCTAssertEqual(events[1].type, YKFEventTypeAPDUReceived);
+    XCTAssertEqual(events[1].length, 4);
+    XCTAssertEqual(events[1].sw, 0x6102);
+    XCTAssertEqual(events[2].ins, 0xC0);
+    XCTAssertEqual(events[1].sequenceNumber + 1, events[2].sequenceNumber);
+    XCTAssertLessThanOrEqual(events[0].timestamp, events[2].timestamp);
+    XCTAssertEqual([[YKFEventRing dumpDescription] componentsSeparatedByString:@"\n"].count, 4);
+
+    [YKFEventRing clear];
+    XCTAssertEqual([YKFEventRing dump].count, 0);
+}
+
+- (void)test_WhenRecordingMoreEventsThanCapacity_OldestEventsAreOverwritten {
+    NSUInteger capacity = YKFEventRing.capacity;
+    for (NSUInteger i = 0; i < capacity + 10; i++) {
+        YKFEventRingRecord(YKFEventTypeAPDUSent, 0x01, (UInt32)i, 0);
+    }
+    NSArray<YKFEvent *> *events = [YKFEventRing dump];
+    XCTAssertEqual(events.count, capacity);
+    XCTAssertEqual(events.firstObject.length, 10);
+    XCTAssertEqual(events.lastObject.length, capacity + 9);
+}
+
+- (void)test_WhenRecordingFromManyThreads_NoEventIsTorn {
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (UInt32 i = 0; i < 10000; i++) {
+            // The SW is derived from the other fields so a torn event can be detected.
+            YKFEventRingRecord(YKFEventTypeAPDUReceived, (UInt8)thread, i, (UInt16)(i ^ thread));
+            if (i % 1000 == 0) {
+                [YKFEventRing dump];
+            }
+        }
+    });
+    NSArray<YKFEvent *> *events = [YKFEventRing dump];
+    XCTAssertEqual(events.count, YKFEventRing.capacity);
+    for (YKFEvent *event in events) {
+        XCTAssertEqual(event.sw, (UInt16)(event.length ^ event.ins));
+    }
+}
+
+- (void)test_WhenReadingChainedResponse_GetResponseEventsAreRecorded {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.maxResponseLength = 8;
+    YKFSmartCardInterface *smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:key];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Chained response"];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithData:[NSData dataFromHexString:@"00a4040008a000000527471117"]];
+    [smartCardInterface executeCommand:apdu completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+
+    NSArray<YKFEvent *> *events = [[YKFEventRing dump] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(YKFEvent *event, NSDictionary *bindings) {
+        return event.type == YKFEventTypeGetResponse;
+    }]];
+    XCTAssertEqual(events.count, 3);
+    XCTAssertEqual(events.firstObject.ins, 0xC0);
+    XCTAssertEqual(events.firstObject.sw >> 8, 0x61);
+}
+
+- (void)test_RecordingPerformance {
+    [self measureBlock:^{
+        for (UInt32 i = 0; i < 100000; i++) {
+            YKFEventRingRecord(YKFEventTypeAPDUSent, 0xA4, i, 0);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,75 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFFIDO2GetInfoCache.h"
+#import "YKFFIDO2GetInfoResponse+Private.h"
+
+@interface YKFFIDO2GetInfoCacheTests: YKFTestCase
+
+@property (nonatomic) YKFFIDO2GetInfoCache *cache;
+@property (nonatomic) YKFFIDO2GetInfoResponse *response;
+
+@end
+
+@implementation YKFFIDO2GetInfoCacheTests
+
+- (void)setUp {
+    [super setUp];
+    self.cache = [[YKFFIDO2GetInfoCache alloc] init];
+
+    // {1: ["FIDO_2_0"], 3: h'000102030405060708090a0b0c0d0e0f', 5: 1200, 6: [2, 1], 14: 328707}
+    NSData *cborData = [NSData dataFromHexString:@"a50181684649444f5f325f300350000102030405060708090a0b0c0d0e0f051904b0068202010e1a00050403"];
+    self.response = [[YKFFIDO2GetInfoResponse alloc] initWithCBORData:cborData];
+}
+
+- (void)test_WhenParsingGetInfo_FirmwareVersionIsRead {
+    XCTAssertNotNil(self.response);
+    XCTAssertEqual(self.response.firmwareVersion, 328707);
+    XCTAssertEqual(self.response.maxMsgSize, 1200);
+}
+
+- (void)test_WhenStoringResponse_ResponseIsFoundByAllKeys {
+    NSObject *connection = [[NSObject alloc] init];
+    [self.cache storeResponse:self.response deviceIdentifier:@"123456/5.4.3" connection:connection];
+
+    XCTAssertEqual([self.cache responseForDeviceIdentifier:nil connection:connection], self.response);
+    XCTAssertEqual([self.cache responseForDeviceIdentifier:@"123456/5.4.3" connection:nil], self.response);
+    XCTAssertEqual([self.cache responseForAAGUID:self.response.aaguid firmwareVersion:328707], self.response);
+    XCTAssertNil([self.cache responseForAAGUID:self.response.aaguid firmwareVersion:328708]);
+    XCTAssertNil([self.cache responseForDeviceIdentifier:@"654321/5.4.3" connection:nil]);
+    XCTAssertFalse([self.cache needsRefreshForDeviceIdentifier:nil connection:connection]);
+}
+
+- (void)test_WhenResponseIsOld_RefreshIsNeeded {
+    NSObject *connection = [[NSObject alloc] init];
+    [self.cache storeResponse:self.response deviceIdentifier:nil connection:connection];
+    self.cache.refreshInterval = 0;
+    [self waitForTimeInterval:0.01];
+    XCTAssertTrue([self.cache needsRefreshForDeviceIdentifier:nil connection:connection]);
+    XCTAssertNotNil([self.cache responseForDeviceIdentifier:nil connection:connection]);
+}
+
+- (void)test_WhenRemovingResponse_ResponseIsNotFound {
+    NSObject *connection = [[NSObject alloc] init];
+    [self.cache storeResponse:self.response deviceIdentifier:@"123456/5.4.3" connection:connection];
+    [self.cache removeResponseForDeviceIdentifier:@"123456/5.4.3" connection:connection];
+
+    XCTAssertNil([self.cache responseForDeviceIdentifier:@"123456/5.4.3" connection:connection]);
+    XCTAssertNil([self.cache responseForAAGUID:self.response.aaguid firmwareVersion:328707]);
+    XCTAssertTrue([self.cache needsRefreshForDeviceIdentifier:nil connection:connection]);
+}
+
+@end
@@ -0,0 +1,854 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyOATHApplet.h"
+#import "FakeYubiKeyOTPApplet.h"
+#import "FakeYubiKeyFIDOApplet.h"
+#import "FakeYubiKeyPIVApplet.h"
+#import "YKFManagementSession+Private.h"
+#import "YKFManagementDeviceInfo.h"
+#import "YKFOATHSession+Private.h"
+#import "YKFOATHCredentialTemplate.h"
+#import "YKFOATHCredentialWithCode.h"
+#import "YKFOATHCode.h"
+#import "YKFOATHError.h"
+#import "YKFOATHCredentialImportResult.h"
+#import "YKFOATHCredential.h"
+#import "YKFPIVSession+Private.h"
+#import "YKFPIVManagementKeyType.h"
+#import "YKFPIVManagementKeyMetadata.h"
+#import "YKFPIVSlotMetadata.h"
+#import "YKFPIVPinPukMetadata.h"
+#import "YKFPIVMetadataSnapshot.h"
+#import "YKFChallengeResponseSession+Private.h"
+#import "YKFFIDO2Session+Private.h"
+#import "YKFFIDO2GetInfoResponse.h"
+#import "YKFFIDO2MakeCredentialResponse.h"
+#import "YKFFIDO2GetAssertionResponse.h"
+#import "YKFFIDO2Type.h"
+#import "YKFFIDO2Error.h"
+#import "YKFCBORDecoder.h"
+#import "YKFSCP03KeyParams.h"
+#import "YKFSCPKeyRef.h"
+#import "YKFSCPStaticKeys.h"
+#import "YKFNSDataAdditions+Private.h"
+
+@interface YKFFakeYubiKeyTests: YKFTestCase
+
+@property (nonatomic) FakeYubiKey *key;
+
+@end
+
+@implementation YKFFakeYubiKeyTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[FakeYubiKey alloc] init];
+}
+
+- (void)waitForExpectation:(XCTestExpectation *)expectation {
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssertEqual(result, XCTWaiterResultCompleted);
+}
+
+- (YKFOATHCredentialTemplate *)rfc6238Template {
+    // RFC 6238 test secret, SHA1.
+    NSData *secret = [@"12345678901234567890" dataUsingEncoding:NSUTF8StringEncoding];
+    return [[YKFOATHCredentialTemplate alloc] initWithType:YKFOATHCredentialTypeTOTP algorithm:YKFOATHCredentialAlgorithmSHA1 secret:secret issuer:@"Yubico" accountName:@"test" digits:8 period:30 counter:0];
+}
+
+- (void)putCredentials:(NSArray<YKFOATHCredentialTemplate *> *)templates requiresTouch:(BOOL)requiresTouch session:(YKFOATHSession *)session {
+    for (YKFOATHCredentialTemplate *template in templates) {
+        XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Put credential"];
+        [session putCredentialTemplate:template requiresTouch:requiresTouch completion:^(NSError * _Nullable error) {
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+        [self waitForExpectation:expectation];
+    }
+}
+
+- (YKFOATHSession *)oathSessionWithSCPKeyParams:(YKFSCP03KeyParams *)scpKeyParams error:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"OATH session"];
+    __block YKFOATHSession *result = nil;
+    __block NSError *resultError = nil;
+    YKFOATHSessionCompletion completion = ^(YKFOATHSession * _Nullable session, NSError * _Nullable sessionError) {
+        result = session;
+        resultError = sessionError;
+        [expectation fulfill];
+    };
+    if (scpKeyParams) {
+        [YKFOATHSession sessionWithConnectionController:self.key scpKeyParams:scpKeyParams completion:completion];
+    } else {
+        [YKFOATHSession sessionWithConnectionController:self.key completion:completion];
+    }
+    [self waitForExpectation:expectation];
+    if (error) {
+        *error = resultError;
+    }
+    return result;
+}
+
+#pragma mark - Management
+
+- (void)test_WhenReadingDeviceInfo_SerialAndVersionOfTheKeyAreReturned {
+    self.key.serialNumber = 87654321;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Device info"];
+    [YKFManagementSession sessionWithConnectionController:self.key completion:^(YKFManagementSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session getDeviceInfoWithCompletion:^(YKFManagementDeviceInfo * _Nullable deviceInfo, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            XCTAssertEqual(deviceInfo.serialNumber, 87654321);
+            XCTAssertEqual(deviceInfo.version.major, 5);
+            XCTAssertEqual(deviceInfo.version.minor, 4);
+            XCTAssertEqual(deviceInfo.formFactor, YKFFormFactorUSBAKeychain);
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+#pragma mark - OATH
+
+- (void)test_WhenCalculatingAllCredentials_RFC6238CodeIsReturned {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    [self putCredentials:@[self.rfc6238Template] requiresTouch:NO session:session];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Calculate all"];
+    [session calculateAllWithTimestamp:[NSDate dateWithTimeIntervalSince1970:59] completion:^(NSArray<YKFOATHCredentialWithCode *> * _Nullable credentials, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(credentials.count, 1);
+        XCTAssertEqualObjects(credentials.firstObject.credential.accountName, @"test");
+        XCTAssertEqualObjects(credentials.firstObject.code.otp, @"94287082");
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (void)test_WhenListingManyCredentials_ChainedResponseIsRead {
+    self.key.maxResponseLength = 32;
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    NSMutableArray *templates = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 10; i++) {
+        [templates addObject:[[YKFOATHCredentialTemplate alloc] initWithType:YKFOATHCredentialTypeTOTP algorithm:YKFOATHCredentialAlgorithmSHA256 secret:[NSData ykf_randomDataOfSize:20] issuer:@"Yubico" accountName:[NSString stringWithFormat:@"account%d", i] digits:6 period:30 counter:0]];
+    }
+    [self putCredentials:templates requiresTouch:NO session:session];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"List"];
+    [session listCredentialsWithCompletion:^(NSArray<YKFOATHCredential *> * _Nullable credentials, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(credentials.count, 10);
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+
+    // The list response is read with SEND REMAINING.
+    NSUInteger sendRemainingCount = 0;
+    for (NSData *command in self.key.receivedCommands) {
+        sendRemainingCount += ((const UInt8 *)command.bytes)[1] == 0xA5 ? 1 : 0;
+    }
+    XCTAssertGreaterThan(sendRemainingCount, 0);
+}
+
+- (void)test_WhenPasswordIsSet_NewSessionsMustUnlock {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    XCTestExpectation *passwordExpectation = [[XCTestExpectation alloc] initWithDescription:@"Set password"];
+    [session setPassword:@"password" completion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [passwordExpectation fulfill];
+    }];
+    [self waitForExpectation:passwordExpectation];
+
+    session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Unlock"];
+    [session listCredentialsWithCompletion:^(NSArray<YKFOATHCredential *> * _Nullable credentials, NSError * _Nullable error) {
+        XCTAssertEqual(error.code, YKFOATHErrorCodeAuthenticationRequired);
+        [session unlockWithPassword:@"wrong" completion:^(NSError * _Nullable error) {
+            XCTAssertEqual(error.code, YKFOATHErrorCodeWrongPassword);
+            [session unlockWithPassword:@"password" completion:^(NSError * _Nullable error) {
+                XCTAssertNil(error);
+                [session listCredentialsWithCompletion:^(NSArray<YKFOATHCredential *> * _Nullable credentials, NSError * _Nullable error) {
+                    XCTAssertNil(error);
+                    XCTAssertEqual(credentials.count, 0);
+                    [expectation fulfill];
+                }];
+            }];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (YKFOATHSession *)oathSessionWithAccessKeyProvider:(YKFOATHAccessKeyProvider)accessKeyProvider credentials:(NSArray<YKFOATHCredentialWithCode *> **)credentials error:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Unlocked OATH session"];
+    __block YKFOATHSession *result = nil;
+    __block NSArray<YKFOATHCredentialWithCode *> *resultCredentials = nil;
+    __block NSError *resultError = nil;
+    [YKFOATHSession sessionWithConnectionController:self.key scpKeyParams:nil accessKeyProvider:accessKeyProvider completion:^(YKFOATHSession * _Nullable session, NSArray<YKFOATHCredentialWithCode *> * _Nullable sessionCredentials, NSError * _Nullable sessionError) {
+        result = session;
+        resultCredentials = sessionCredentials;
+        resultError = sessionError;
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    *credentials = resultCredentials;
+    *error = resultError;
+    return result;
+}
+
+- (void)setOATHPassword:(NSString *)password session:(YKFOATHSession *)session {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Set password"];
+    [session setPassword:password completion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (void)test_WhenOpeningSessionWithAccessKeyProvider_ValidateAndCalculateAllFollowSelect {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    [self putCredentials:@[self.rfc6238Template] requiresTouch:NO session:session];
+    [self setOATHPassword:@"password" session:session];
+    NSUInteger commandCount = self.key.receivedCommands.count;
+
+    NSArray<YKFOATHCredentialWithCode *> *credentials = nil;
+    NSError *error = nil;
+    session = [self oathSessionWithAccessKeyProvider:^NSData * _Nullable(YKFOATHSession * _Nonnull session) {
+        return [session deriveAccessKey:@"password"];
+    } credentials:&credentials error:&error];
+    XCTAssertNotNil(session);
+    XCTAssertNil(error);
+    XCTAssertEqual(credentials.count, 1);
+    XCTAssertEqualObjects(credentials.firstObject.credential.accountName, @"test");
+
+    // SELECT, VALIDATE and CALCULATE ALL, nothing else.
+    NSArray<NSData *> *commands = [self.key.receivedCommands subarrayWithRange:NSMakeRange(commandCount, self.key.receivedCommands.count - commandCount)];
+    XCTAssertEqual(commands.count, 3);
+    XCTAssertEqual(((const UInt8 *)commands[0].bytes)[1], 0xA4);
+    XCTAssertEqual(((const UInt8 *)commands[0].bytes)[2], 0x04);
+    XCTAssertEqual(((const UInt8 *)commands[1].bytes)[1], 0xA3);
+    XCTAssertEqual(((const UInt8 *)commands[2].bytes)[1], 0xA4);
+    XCTAssertEqual(((const UInt8 *)commands[2].bytes)[2], 0x00);
+}
+
+- (void)test_WhenOpeningSessionWithAccessKeyProvider_LockedSessionIsReturnedOnError {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    [self setOATHPassword:@"password" session:session];
+
+    NSArray<YKFOATHCredentialWithCode *> *credentials = nil;
+    NSError *error = nil;
+    session = [self oathSessionWithAccessKeyProvider:^NSData * _Nullable(YKFOATHSession * _Nonnull session) {
+        return nil;
+    } credentials:&credentials error:&error];
+    XCTAssertNotNil(session);
+    XCTAssertNil(credentials);
+    XCTAssertEqual(error.code, YKFOATHErrorCodeAuthenticationRequired);
+
+    session = [self oathSessionWithAccessKeyProvider:^NSData * _Nullable(YKFOATHSession * _Nonnull session) {
+        return [session deriveAccessKey:@"wrong"];
+    } credentials:&credentials error:&error];
+    XCTAssertNotNil(session);
+    XCTAssertEqual(error.code, YKFOATHErrorCodeWrongPassword);
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Unlock"];
+    [session unlockWithPassword:@"password" completion:^(NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (void)test_WhenOpeningSessionWithoutPassword_AccessKeyProviderIsNotCalled {
+    __block BOOL providerCalled = NO;
+    NSArray<YKFOATHCredentialWithCode *> *credentials = nil;
+    NSError *error = nil;
+    YKFOATHSession *session = [self oathSessionWithAccessKeyProvider:^NSData * _Nullable(YKFOATHSession * _Nonnull session) {
+        providerCalled = YES;
+        return nil;
+    } credentials:&credentials error:&error];
+    XCTAssertNotNil(session);
+    XCTAssertNil(error);
+    XCTAssertEqual(credentials.count, 0);
+    XCTAssertFalse(providerCalled);
+}
+
+- (void)test_WhenCalculatingTouchCredential_KeyWaitsForTouch {
+    self.key.touchDelay = 0.3;
+    self.key.waitingTimeExtensionInterval = 0.1;
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    [self putCredentials:@[self.rfc6238Template] requiresTouch:YES session:session];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Calculate with touch"];
+    NSDate *start = [NSDate date];
+    [session calculateAllWithTimestamp:[NSDate dateWithTimeIntervalSince1970:59] completion:^(NSArray<YKFOATHCredentialWithCode *> * _Nullable credentials, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertTrue(credentials.firstObject.credential.requiresTouch);
+        [session calculateCredential:credentials.firstObject.credential timestamp:[NSDate dateWithTimeIntervalSince1970:59] completion:^(YKFOATHCode * _Nullable code, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(code.otp, @"94287082");
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.3);
+    XCTAssertEqual(self.key.waitingTimeExtensionCount, 2);
+}
+
+- (NSArray<YKFOATHCredentialImportResult *> *)importCredentialsFromURLs:(NSArray<NSURL *> *)urls session:(YKFOATHSession *)session error:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Import credentials"];
+    __block NSArray<YKFOATHCredentialImportResult *> *results = nil;
+    __block NSError *importError = nil;
+    [session importCredentialsFromURLs:urls requiresTouch:NO completion:^(NSArray<YKFOATHCredentialImportResult *> * _Nullable importResults, NSError * _Nullable error) {
+        results = importResults;
+        importError = error;
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    if (error) {
+        *error = importError;
+    }
+    return results;
+}
+
+- (NSArray<NSURL *> *)otpauthURLsWithCount:(NSUInteger)count {
+    NSMutableArray<NSURL *> *urls = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *url = [NSString stringWithFormat:@"otpauth://totp/Yubico:user%lu@example.com?secret=JBSWY3DPEHPK3PXP&issuer=Yubico", (unsigned long)i];
+        [urls addObject:[NSURL URLWithString:url]];
+    }
+    return urls;
+}
+
+- (void)test_WhenImportingCredentials_AllPutsAreSentAfterOneList {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    NSMutableArray<NSURL *> *urls = [[self otpauthURLsWithCount:20] mutableCopy];
+    [urls insertObject:[NSURL URLWithString:@"otpauth://totp/Yubico:invalid?secret=0189"] atIndex:5];
+    NSUInteger commandCount = self.key.receivedCommands.count;
+
+    NSError *error = nil;
+    NSArray<YKFOATHCredentialImportResult *> *results = [self importCredentialsFromURLs:urls session:session error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(results.count, 21);
+    XCTAssertNil(results[5].credentialTemplate);
+    XCTAssertNotNil(results[5].error);
+    XCTAssertNil(results[5].credential);
+    XCTAssertNil(results[6].error);
+    XCTAssertEqualObjects(results[6].credential.accountName, @"user5@example.com");
+    XCTAssertEqualObjects(results[6].credential.issuer, @"Yubico");
+    XCTAssertEqual([[self.key appletOfClass:[FakeYubiKeyOATHApplet class]] credentials].count, 20);
+
+    // One LIST and one PUT per valid URL.
+    NSArray<NSData *> *commands = [self.key.receivedCommands subarrayWithRange:NSMakeRange(commandCount, self.key.receivedCommands.count - commandCount)];
+    XCTAssertEqual(commands.count, 21);
+    XCTAssertEqual(((const UInt8 *)commands.firstObject.bytes)[1], 0xA1);
+}
+
+- (void)test_WhenImportingMoreCredentialsThanTheKeyCanStore_NothingIsWritten {
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    [self putCredentials:@[self.rfc6238Template] requiresTouch:NO session:session];
+
+    NSError *error = nil;
+    NSArray<YKFOATHCredentialImportResult *> *results = [self importCredentialsFromURLs:[self otpauthURLsWithCount:32] session:session error:&error];
+    XCTAssertNil(results);
+    XCTAssertEqual(error.code, YKFOATHErrorCodeNoSpace);
+    XCTAssertEqual([[self.key appletOfClass:[FakeYubiKeyOATHApplet class]] credentials].count, 1);
+
+    // Replacing existing credentials does not need room.
+    results = [self importCredentialsFromURLs:[self otpauthURLsWithCount:31] session:session error:&error];
+    XCTAssertEqual(results.count, 31);
+    results = [self importCredentialsFromURLs:[self otpauthURLsWithCount:31] session:session error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(results.count, 31);
+    XCTAssertEqual([[self.key appletOfClass:[FakeYubiKeyOATHApplet class]] credentials].count, 32);
+}
+
+- (void)test_ImportPerformance {
+    self.key.commandLatency = 0.002;
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:nil error:nil];
+    NSArray<NSURL *> *urls = [self otpauthURLsWithCount:30];
+    [self measureBlock:^{
+        [self importCredentialsFromURLs:urls session:session error:nil];
+    }];
+}
+
+#pragma mark - SCP03
+
+- (void)test_WhenOpeningSCP03Session_CommandsAreSecured {
+    YKFSCPKeyRef *keyRef = [[YKFSCPKeyRef alloc] initWithKid:0x01 kvn:0xFF];
+    YKFSCP03KeyParams *params = [[YKFSCP03KeyParams alloc] initWithKeyRef:keyRef staticKeys:[YKFSCPStaticKeys defaultKeys]];
+    NSError *error = nil;
+    YKFOATHSession *session = [self oathSessionWithSCPKeyParams:params error:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue(self.key.isSecureChannelOpen);
+
+    self.key.maxResponseLength = 16;
+    [self putCredentials:@[self.rfc6238Template] requiresTouch:NO session:session];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Calculate all over SCP03"];
+    [session calculateAllWithTimestamp:[NSDate dateWithTimeIntervalSince1970:59] completion:^(NSArray<YKFOATHCredentialWithCode *> * _Nullable credentials, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(credentials.firstObject.code.otp, @"94287082");
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+
+    // The secret is never sent in clear text.
+    NSData *secret = [@"12345678901234567890" dataUsingEncoding:NSUTF8StringEncoding];
+    for (NSData *command in self.key.receivedCommands) {
+        XCTAssertEqual([command rangeOfData:secret options:0 range:NSMakeRange(0, command.length)].location, NSNotFound);
+    }
+}
+
+- (void)test_WhenOpeningSCP03SessionWithWrongKeys_SessionFails {
+    NSData *wrongKey = [NSData ykf_randomDataOfSize:16];
+    self.key.scp03StaticKeys = [[YKFSCPStaticKeys alloc] initWithEnc:wrongKey mac:wrongKey dek:wrongKey];
+    YKFSCPKeyRef *keyRef = [[YKFSCPKeyRef alloc] initWithKid:0x01 kvn:0xFF];
+    YKFSCP03KeyParams *params = [[YKFSCP03KeyParams alloc] initWithKeyRef:keyRef staticKeys:[YKFSCPStaticKeys defaultKeys]];
+    NSError *error = nil;
+    XCTAssertNil([self oathSessionWithSCPKeyParams:params error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertFalse(self.key.isSecureChannelOpen);
+}
+
+#pragma mark - PIV
+
+- (void)test_WhenVerifyingPin_RetryCounterIsUpdated {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV"];
+    [YKFPIVSession sessionWithConnectionController:self.key completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session verifyPin:@"000000" completion:^(int retries, NSError * _Nullable error) {
+            XCTAssertEqual(error.code, YKFPIVErrorCodeInvalidPin);
+            XCTAssertEqual(retries, 2);
+            [session getPinMetadataWithCompletion:^(bool isDefault, int retriesTotal, int retriesRemaining, NSError * _Nullable error) {
+                XCTAssertNil(error);
+                XCTAssertTrue(isDefault);
+                XCTAssertEqual(retriesTotal, 3);
+                XCTAssertEqual(retriesRemaining, 2);
+                [session verifyPin:@"123456" completion:^(int retries, NSError * _Nullable error) {
+                    XCTAssertNil(error);
+                    [session getSerialNumberWithCompletion:^(int serialNumber, NSError * _Nullable error) {
+                        XCTAssertNil(error);
+                        XCTAssertEqual(serialNumber, 12345678);
+                        [expectation fulfill];
+                    }];
+                }];
+            }];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (void)test_WhenVerifyingPinOverSCP03_PinIsSentEncrypted {
+    YKFSCPKeyRef *keyRef = [[YKFSCPKeyRef alloc] initWithKid:0x01 kvn:0xFF];
+    YKFSCP03KeyParams *params = [[YKFSCP03KeyParams alloc] initWithKeyRef:keyRef staticKeys:[YKFSCPStaticKeys defaultKeys]];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV over SCP03"];
+    [YKFPIVSession sessionWithConnectionController:self.key scpKeyParams:params completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertTrue(self.key.isSecureChannelOpen);
+        [session verifyPin:@"000000" completion:^(int retries, NSError * _Nullable error) {
+            XCTAssertEqual(error.code, YKFPIVErrorCodeInvalidPin);
+            XCTAssertEqual(retries, 2);
+            [session verifyPin:@"123456" completion:^(int retries, NSError * _Nullable error) {
+                XCTAssertNil(error);
+                [expectation fulfill];
+            }];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+
+    NSData *pin = [@"123456" dataUsingEncoding:NSUTF8StringEncoding];
+    for (NSData *command in self.key.receivedCommands) {
+        XCTAssertEqual([command rangeOfData:pin options:0 range:NSMakeRange(0, command.length)].location, NSNotFound);
+    }
+}
+
+- (void)test_WhenAuthenticatingWithManagementKey_OnlyTheRightKeyIsAccepted {
+    NSData *defaultKey = [NSData dataFromHexString:@"010203040506070801020304050607080102030405060708"];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV management key"];
+    [YKFPIVSession sessionWithConnectionController:self.key completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        [session authenticateWithManagementKey:[NSData ykf_randomDataOfSize:24] type:[YKFPIVManagementKeyType TripleDES] completion:^(NSError * _Nullable error) {
+            XCTAssertNotNil(error);
+            [session authenticateWithManagementKey:defaultKey type:[YKFPIVManagementKeyType TripleDES] completion:^(NSError * _Nullable error) {
+                XCTAssertNil(error);
+                [expectation fulfill];
+            }];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (NSArray<NSData *> *)batchSignMessages:(NSArray<NSData *> *)messages pin:(NSString *)pin error:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV batch sign"];
+    __block NSArray<NSData *> *result = nil;
+    __block NSError *resultError = nil;
+    [YKFPIVSession sessionWithConnectionController:self.key completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session signWithKeyInSlot:YKFPIVSlotSignature type:YKFPIVKeyTypeECCP256 algorithm:kSecKeyAlgorithmECDSASignatureMessageX962SHA256 messages:messages pin:pin completion:^(NSArray<NSData *> * _Nullable signatures, NSError * _Nullable error) {
+            result = signatures;
+            resultError = error;
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+    *error = resultError;
+    return result;
+}
+
+- (NSUInteger)receivedCommandCountWithIns:(UInt8)ins {
+    NSUInteger count = 0;
+    for (NSData *command in self.key.receivedCommands) {
+        count += ((const UInt8 *)command.bytes)[1] == ins ? 1 : 0;
+    }
+    return count;
+}
+
+- (void)test_WhenBatchSigning_PinIsVerifiedOnceAndSignaturesAreInOrder {
+    NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeySizeInBits: @256};
+    SecKeyRef privateKey = SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil);
+    SecKeyRef publicKey = SecKeyCopyPublicKey(privateKey);
+    [[self.key appletOfClass:[FakeYubiKeyPIVApplet class]] setPrivateKey:privateKey forSlot:YKFPIVSlotSignature];
+    NSMutableArray<NSData *> *messages = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 8; i++) {
+        [messages addObject:[[NSString stringWithFormat:@"document %d", i] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    NSError *error = nil;
+    NSArray<NSData *> *signatures = [self batchSignMessages:messages pin:@"123456" error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(signatures.count, messages.count);
+    for (NSUInteger i = 0; i < messages.count; i++) {
+        XCTAssertTrue(SecKeyVerifySignature(publicKey, kSecKeyAlgorithmECDSASignatureMessageX962SHA256, (__bridge CFDataRef)messages[i], (__bridge CFDataRef)signatures[i], nil));
+    }
+    XCTAssertEqual([self receivedCommandCountWithIns:0x20], 1);
+    XCTAssertEqual([self receivedCommandCountWithIns:0x87], messages.count);
+    CFRelease(publicKey);
+    CFRelease(privateKey);
+}
+
+- (void)test_WhenBatchSigningWithWrongPin_NoSignatureIsRequested {
+    NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeySizeInBits: @256};
+    SecKeyRef privateKey = SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil);
+    [[self.key appletOfClass:[FakeYubiKeyPIVApplet class]] setPrivateKey:privateKey forSlot:YKFPIVSlotSignature];
+    NSArray<NSData *> *messages = @[[NSData dataFromHexString:@"00"], [NSData dataFromHexString:@"01"], [NSData dataFromHexString:@"02"]];
+
+    NSError *error = nil;
+    XCTAssertNil([self batchSignMessages:messages pin:@"000000" error:&error]);
+    XCTAssertEqual(error.code, YKFPIVErrorCodeInvalidPin);
+    XCTAssertEqual([self receivedCommandCountWithIns:0x87], 0);
+    CFRelease(privateKey);
+}
+
+- (YKFPIVMetadataSnapshot *)metadataSnapshotWithError:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV metadata snapshot"];
+    __block YKFPIVMetadataSnapshot *result = nil;
+    __block NSError *resultError = nil;
+    [YKFPIVSession sessionWithConnectionController:self.key completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session getMetadataSnapshotWithCompletion:^(YKFPIVMetadataSnapshot * _Nullable snapshot, NSError * _Nullable error) {
+            result = snapshot;
+            resultError = error;
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+    *error = resultError;
+    return result;
+}
+
+- (void)test_WhenReadingMetadataSnapshot_AllMetadataIsReadInOneCall {
+    NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeySizeInBits: @256};
+    SecKeyRef privateKey = SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil);
+    [[self.key appletOfClass:[FakeYubiKeyPIVApplet class]] setPrivateKey:privateKey forSlot:YKFPIVSlotSignature];
+
+    NSError *error = nil;
+    YKFPIVMetadataSnapshot *snapshot = [self metadataSnapshotWithError:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(snapshot.serialNumber, @12345678);
+    XCTAssertTrue(snapshot.pinMetadata.isDefault);
+    XCTAssertEqual(snapshot.pinMetadata.retriesRemaining, 3);
+    XCTAssertTrue(snapshot.pukMetadata.isDefault);
+    XCTAssertTrue(snapshot.managementKeyMetadata.isDefault);
+    XCTAssertNil(snapshot.bioMetadata);
+    XCTAssertEqualObjects(snapshot.slotMetadata.allKeys, @[@(YKFPIVSlotSignature)]);
+    YKFPIVSlotMetadata *slotMetadata = [snapshot metadataForSlot:YKFPIVSlotSignature];
+    XCTAssertEqual(slotMetadata.keyType, YKFPIVKeyTypeECCP256);
+    XCTAssertEqual(slotMetadata.pinPolicy, YKFPIVPinPolicyOnce);
+    XCTAssertTrue(slotMetadata.generated);
+    // PIN, PUK, management key, 25 key slots and bio
+    XCTAssertEqual([self receivedCommandCountWithIns:0xF7], 29);
+    XCTAssertEqual([self receivedCommandCountWithIns:0xF8], 1);
+    CFRelease(privateKey);
+}
+
+- (void)test_WhenComparingMetadataSnapshots_ChangedSlotsAreReported {
+    NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeySizeInBits: @256};
+    SecKeyRef privateKey = SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil);
+    FakeYubiKeyPIVApplet *applet = [self.key appletOfClass:[FakeYubiKeyPIVApplet class]];
+    [applet setPrivateKey:privateKey forSlot:YKFPIVSlotSignature];
+
+    NSError *error = nil;
+    YKFPIVMetadataSnapshot *first = [self metadataSnapshotWithError:&error];
+    XCTAssertNil(error);
+    YKFPIVMetadataSnapshot *second = [self metadataSnapshotWithError:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(first, second);
+    XCTAssertEqualObjects([second slotsChangedFromSnapshot:first], @[]);
+
+    SecKeyRef otherPrivateKey = SecKeyCreateRandomKey((__bridge CFDictionaryRef)attributes, nil);
+    [applet setPrivateKey:otherPrivateKey forSlot:YKFPIVSlotSignature];
+    [applet setPrivateKey:privateKey forSlot:YKFPIVSlotAuthentication];
+    YKFPIVMetadataSnapshot *third = [self metadataSnapshotWithError:&error];
+    XCTAssertNil(error);
+    XCTAssertNotEqualObjects(first, third);
+    NSArray *expectedSlots = @[@(YKFPIVSlotAuthentication), @(YKFPIVSlotSignature)];
+    XCTAssertEqualObjects([third slotsChangedFromSnapshot:first], expectedSlots);
+    CFRelease(otherPrivateKey);
+    CFRelease(privateKey);
+}
+
+#pragma mark - Challenge-response
+
+- (void)test_WhenSendingChallenge_HMACOfTheSlotIsReturned {
+    FakeYubiKeyOTPApplet *otp = [self.key appletOfClass:FakeYubiKeyOTPApplet.class];
+    otp.slot2Secret = [NSData ykf_randomDataOfSize:20];
+    NSData *challenge = [NSData ykf_randomDataOfSize:32];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Challenge-response"];
+    [YKFChallengeResponseSession sessionWithConnectionController:self.key completion:^(YKFChallengeResponseSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session sendChallenge:challenge slot:YKFSlotTwo completion:^(NSData * _Nullable response, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(response, [challenge ykf_oathHMACWithKey:otp.slot2Secret]);
+            [session sendChallenge:challenge slot:YKFSlotOne completion:^(NSData * _Nullable response, NSError * _Nullable error) {
+                XCTAssertNil(response);
+                XCTAssertNotNil(error);
+                [expectation fulfill];
+            }];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+#pragma mark - FIDO2
+
+- (YKFFIDO2Session *)fido2Session {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2 session"];
+    __block YKFFIDO2Session *result = nil;
+    [YKFFIDO2Session sessionWithConnectionController:self.key completion:^(YKFFIDO2Session * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        result = session;
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    return result;
+}
+
+- (YKFFIDO2MakeCredentialResponse *)makeCredentialWithSession:(YKFFIDO2Session *)session userId:(NSData *)userId error:(NSError **)error {
+    YKFFIDO2PublicKeyCredentialRpEntity *rp = [[YKFFIDO2PublicKeyCredentialRpEntity alloc] init];
+    rp.rpId = @"yubico.com";
+    rp.rpName = @"Yubico";
+    YKFFIDO2PublicKeyCredentialUserEntity *user = [[YKFFIDO2PublicKeyCredentialUserEntity alloc] init];
+    user.userId = userId;
+    user.userName = @"john";
+    YKFFIDO2PublicKeyCredentialParam *param = [[YKFFIDO2PublicKeyCredentialParam alloc] init];
+    param.alg = YKFFIDO2PublicKeyAlgorithmES256;
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2 make credential"];
+    __block YKFFIDO2MakeCredentialResponse *result = nil;
+    __block NSError *resultError = nil;
+    [session makeCredentialWithClientDataHash:[NSData ykf_randomDataOfSize:32] rp:rp user:user pubKeyCredParams:@[param] excludeList:nil options:@{YKFFIDO2OptionRK: @YES} completion:^(YKFFIDO2MakeCredentialResponse * _Nullable response, NSError * _Nullable makeCredentialError) {
+        result = response;
+        resultError = makeCredentialError;
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    if (error) {
+        *error = resultError;
+    }
+    return result;
+}
+
+- (YKFFIDO2GetAssertionResponse *)getAssertionWithSession:(YKFFIDO2Session *)session clientDataHash:(NSData *)clientDataHash {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2 get assertion"];
+    __block YKFFIDO2GetAssertionResponse *result = nil;
+    [session getAssertionWithClientDataHash:clientDataHash rpId:@"yubico.com" allowList:nil options:nil completion:^(YKFFIDO2GetAssertionResponse * _Nullable response, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        result = response;
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    return result;
+}
+
+- (NSError *)runFIDO2PinOperation:(void (^)(YKFFIDO2SessionGenericCompletionBlock completion))operation {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2 PIN"];
+    __block NSError *result = nil;
+    operation(^(NSError * _Nullable error) {
+        result = error;
+        [expectation fulfill];
+    });
+    [self waitForExpectation:expectation];
+    return result;
+}
+
+- (BOOL)verifySignature:(NSData *)signature authData:(NSData *)authData clientDataHash:(NSData *)clientDataHash coseKey:(NSData *)coseKey {
+    NSInputStream *inputStream = [[NSInputStream alloc] initWithData:coseKey];
+    [inputStream open];
+    NSDictionary *key = [YKFCBORDecoder convertCBORObjectToFoundationType:[YKFCBORDecoder decodeObjectFrom:inputStream]];
+    [inputStream close];
+    NSMutableData *point = [NSMutableData dataWithBytes:(UInt8[]){0x04} length:1];
+    [point appendData:key[@-2]];
+    [point appendData:key[@-3]];
+    NSDictionary *attributes = @{(id)kSecAttrKeyType: (id)kSecAttrKeyTypeECSECPrimeRandom, (id)kSecAttrKeyClass: (id)kSecAttrKeyClassPublic};
+    SecKeyRef publicKey = SecKeyCreateWithData((__bridge CFDataRef)point, (__bridge CFDictionaryRef)attributes, nil);
+    if (!publicKey) {
+        return NO;
+    }
+    NSMutableData *message = [authData mutableCopy];
+    [message appendData:clientDataHash];
+    BOOL isValid = SecKeyVerifySignature(publicKey, kSecKeyAlgorithmECDSASignatureMessageX962SHA256, (__bridge CFDataRef)message, (__bridge CFDataRef)signature, nil);
+    CFRelease(publicKey);
+    return isValid;
+}
+
+- (void)test_WhenCreatingFIDO2Session_GetInfoOfTheKeyIsRead {
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2"];
+    [YKFFIDO2Session sessionWithConnectionController:self.key completion:^(YKFFIDO2Session * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        [session getInfoWithCompletion:^(YKFFIDO2GetInfoResponse * _Nullable response, NSError * _Nullable error) {
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(response.aaguid, fido.aaguid);
+            XCTAssertEqual(response.maxMsgSize, 1200);
+            XCTAssertTrue([response.versions containsObject:@"FIDO_2_0"]);
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+}
+
+- (void)test_WhenResettingFIDO2_SessionPollsUntilTouch {
+    self.key.touchDelay = 0.6;
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"FIDO2 reset"];
+    [YKFFIDO2Session sessionWithConnectionController:self.key completion:^(YKFFIDO2Session * _Nullable session, NSError * _Nullable error) {
+        [session resetWithCompletion:^(NSError * _Nullable error) {
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectation:expectation];
+    XCTAssertEqual(fido.resetCount, 1);
+    XCTAssertGreaterThan(self.key.waitingTimeExtensionCount, 0);
+}
+
+- (void)test_WhenMakingFIDO2Credential_AssertionVerifiesWithTheCredentialKey {
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    YKFFIDO2Session *session = [self fido2Session];
+    NSData *userId = [NSData ykf_randomDataOfSize:16];
+    NSError *error = nil;
+    YKFFIDO2MakeCredentialResponse *credential = [self makeCredentialWithSession:session userId:userId error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(credential.fmt, @"packed");
+    XCTAssertEqualObjects(credential.authenticatorData.aaguid, fido.aaguid);
+    XCTAssertEqual(fido.credentialCount, 1);
+
+    NSData *clientDataHash = [NSData ykf_randomDataOfSize:32];
+    YKFFIDO2GetAssertionResponse *assertion = [self getAssertionWithSession:session clientDataHash:clientDataHash];
+    XCTAssertEqualObjects(assertion.credential.credentialId, credential.authenticatorData.credentialId);
+    XCTAssertEqualObjects(assertion.user.userId, userId);
+    XCTAssertTrue([self verifySignature:assertion.signature authData:assertion.authData clientDataHash:clientDataHash coseKey:credential.authenticatorData.coseEncodedCredentialPublicKey]);
+}
+
+- (void)test_WhenFIDO2PinIsSet_CredentialsRequireThePin {
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    YKFFIDO2Session *session = [self fido2Session];
+    XCTAssertNil([self runFIDO2PinOperation:^(YKFFIDO2SessionGenericCompletionBlock completion) {
+        [session setPin:@"123456" completion:completion];
+    }]);
+    XCTAssertEqualObjects(fido.pin, @"123456");
+
+    NSError *error = nil;
+    XCTAssertNil([self makeCredentialWithSession:session userId:[NSData ykf_randomDataOfSize:16] error:&error]);
+    XCTAssertEqual(error.code, YKFFIDO2ErrorCodePIN_REQUIRED);
+
+    XCTAssertNil([self runFIDO2PinOperation:^(YKFFIDO2SessionGenericCompletionBlock completion) {
+        [session verifyPin:@"123456" completion:completion];
+    }]);
+    YKFFIDO2MakeCredentialResponse *credential = [self makeCredentialWithSession:session userId:[NSData ykf_randomDataOfSize:16] error:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue(credential.authenticatorData.flags & 0x04);
+}
+
+- (void)test_WhenVerifyingWrongFIDO2Pin_RetriesDecrease {
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    fido.pin = @"123456";
+    YKFFIDO2Session *session = [self fido2Session];
+    NSError *error = [self runFIDO2PinOperation:^(YKFFIDO2SessionGenericCompletionBlock completion) {
+        [session verifyPin:@"654321" completion:completion];
+    }];
+    XCTAssertEqual(error.code, YKFFIDO2ErrorCodePIN_INVALID);
+    XCTAssertEqual(fido.pinRetries, 7);
+
+    XCTAssertNil([self runFIDO2PinOperation:^(YKFFIDO2SessionGenericCompletionBlock completion) {
+        [session verifyPin:@"123456" completion:completion];
+    }]);
+    XCTAssertEqual(fido.pinRetries, 8);
+}
+
+- (void)test_FIDO2GetAssertionPerformance {
+    YKFFIDO2Session *session = [self fido2Session];
+    [self makeCredentialWithSession:session userId:[NSData ykf_randomDataOfSize:16] error:nil];
+    [self measureBlock:^{
+        for (int i = 0; i < 20; ++i) {
+            [self getAssertionWithSession:session clientDataHash:[NSData ykf_randomDataOfSize:32]];
+        }
+    }];
+}
+
+#pragma mark - Connection controller
+
+- (void)test_WhenCancellingCommands_PendingCommandsAreDropped {
+    self.key.commandLatency = 1;
+    __block BOOL completed = NO;
+    [YKFOATHSession sessionWithConnectionController:self.key completion:^(YKFOATHSession * _Nullable session, NSError * _Nullable error) {
+        completed = YES;
+    }];
+    [self waitForTimeInterval:0.1];
+    NSDate *start = [NSDate date];
+    [self.key cancelAllCommands];
+
+    // The next command runs right away instead of waiting for the cancelled one.
+    self.key.commandLatency = 0;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Command after cancel"];
+    [self.key execute:[[YKFAPDU alloc] initWithData:[NSData dataFromHexString:@"00a4040005a000000308"]] completion:^(NSData * _Nullable response, NSError * _Nullable error, NSTimeInterval executionTime) {
+        XCTAssertEqualObjects(response, [NSData dataFromHexString:@"9000"]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectation:expectation];
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 0.5);
+    XCTAssertFalse(completed);
+}
+
+- (void)test_CommandLatencyIsApplied {
+    self.key.commandLatency = 0.05;
+    NSDate *start = [NSDate date];
+    NSError *error = nil;
+    [self oathSessionWithSCPKeyParams:nil error:&error];
+    XCTAssertNil(error);
+    XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.05);
+}
+
+@end
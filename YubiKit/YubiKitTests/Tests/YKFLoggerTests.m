@@ -0,0 +1,106 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "YKFLogger.h"
+#import "YubiKitLogger.h"
+
+@interface YKFTestLogger: NSObject<YubiKitLoggerProtocol>
+@property (nonatomic) NSMutableArray<NSString *> *messages;
+@end
+
+@implementation YKFTestLogger
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.messages = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (void)log:(NSString *)message {
+    [self.messages addObject:message];
+}
+
+@end
+
+@interface YKFLoggerTests: YKFTestCase
+
+@property (nonatomic) YKFTestLogger *logger;
+@property (nonatomic) NSUInteger evaluationCount;
+
+@end
+
+@implementation YKFLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    self.logger = [[YKFTestLogger alloc] init];
+    YubiKitLogger.customLogger = self.logger;
+}
+
+- (void)tearDown {
+    YubiKitLogger.customLogger = nil;
+    YubiKitLogger.logLevel = YKFLogLevelVerbose;
+    [super tearDown];
+}
+
+- (NSString *)evaluatedArgument {
+    self.evaluationCount++;
+    return @"argument";
+}
+
+- (void)test_WhenLoggingInfo_PrefixedMessageIsSentToTheCustomLogger {
+    YKFLogInfo(@"Message %d %@", 1, [self evaluatedArgument]);
+    XCTAssertEqualObjects(self.logger.messages, @[@"►►[I]► YubiKit: Message 1 argument"]);
+    XCTAssertEqual(self.evaluationCount, 1);
+}
+
+- (void)test_WhenLevelIsDisabled_ArgumentsAreNotEvaluated {
+    YubiKitLogger.logLevel = YKFLogLevelError;
+    YKFLogInfo(@"Message %@", [self evaluatedArgument]);
+    YKFLogError(@"Error %@", [self evaluatedArgument]);
+    XCTAssertEqualObjects(self.logger.messages, @[@"►►[E]► YubiKit: Error argument"]);
+    XCTAssertEqual(self.evaluationCount, 1);
+
+    YubiKitLogger.logLevel = YKFLogLevelNone;
+    YKFLogError(@"Error %@", [self evaluatedArgument]);
+    YKFLogNSError([NSError errorWithDomain:@"test" code:1 userInfo:nil]);
+    XCTAssertEqual(self.logger.messages.count, 1);
+    XCTAssertEqual(self.evaluationCount, 1);
+}
+
+- (void)test_WhenVerboseLoggingIsCompiledOut_ArgumentsAreNotEvaluated {
+    YKFLogVerbose(@"Sent: %@", [self evaluatedArgument]);
+#ifdef YKF_ENABLE_VERBOSE_LOGGING
+    XCTAssertEqual(self.evaluationCount, 1);
+#else
+    XCTAssertEqual(self.evaluationCount, 0);
+    XCTAssertEqual(self.logger.messages.count, 0);
+#endif
+}
+
+- (void)test_DisabledLogPerformance {
+    YubiKitLogger.logLevel = YKFLogLevelError;
+    NSData *apdu = [NSData dataFromHexString:@"00a4040008a000000527471117"];
+    [self measureBlock:^{
+        for (int i = 0; i < 100000; i++) {
+            YKFLogInfo(@"Sent: %@", apdu.description);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,90 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "YKFNFCTagAvailabilityMonitor.h"
+
+@interface YKFNFCTagAvailabilityMonitorTests: YKFTestCase
+
+@property (nonatomic) dispatch_queue_t queue;
+@property (atomic) BOOL tagAvailable;
+@property (atomic) NSUInteger checkCount;
+
+@end
+
+@implementation YKFNFCTagAvailabilityMonitorTests
+
+- (void)setUp {
+    [super setUp];
+    self.queue = dispatch_queue_create("com.yubico.YKCOMNFC", DISPATCH_QUEUE_SERIAL);
+    self.tagAvailable = YES;
+    self.checkCount = 0;
+}
+
+- (YKFNFCTagAvailabilityMonitor *)monitorWithLostExpectation:(XCTestExpectation *)lostExpectation {
+    YKFNFCTagAvailabilityMonitor *monitor = [[YKFNFCTagAvailabilityMonitor alloc] initWithQueue:self.queue availabilityCheck:^BOOL{
+        self.checkCount++;
+        return self.tagAvailable;
+    } lostHandler:^{
+        [lostExpectation fulfill];
+    }];
+    monitor.minimumInterval = 0.01;
+    monitor.maximumInterval = 0.04;
+    return monitor;
+}
+
+- (void)test_WhenTagIsRemovedWhileIdle_LostIsReported {
+    XCTestExpectation *lostExpectation = [self expectationWithDescription:@"Tag lost"];
+    YKFNFCTagAvailabilityMonitor *monitor = [self monitorWithLostExpectation:lostExpectation];
+    [monitor start];
+    
+    [self waitForTimeInterval:0.1];
+    XCTAssertGreaterThan(self.checkCount, 0);
+    
+    self.tagAvailable = NO;
+    [self waitForExpectations:@[lostExpectation] timeout:1.0];
+    [monitor stop];
+}
+
+- (void)test_WhenCommandReportsTagLost_LostIsReportedOnce {
+    XCTestExpectation *lostExpectation = [self expectationWithDescription:@"Tag lost"];
+    lostExpectation.assertForOverFulfill = YES;
+    YKFNFCTagAvailabilityMonitor *monitor = [self monitorWithLostExpectation:lostExpectation];
+    monitor.minimumInterval = 10;
+    monitor.maximumInterval = 10;
+    [monitor start];
+    
+    dispatch_async(self.queue, ^{
+        [monitor recordCommandWithTagLost:NO];
+        [monitor recordCommandWithTagLost:YES];
+        [monitor recordCommandWithTagLost:YES];
+    });
+    [self waitForExpectations:@[lostExpectation] timeout:1.0];
+    XCTAssertEqual(self.checkCount, 0);
+}
+
+- (void)test_WhenMonitorIsStopped_LostIsNotReported {
+    XCTestExpectation *lostExpectation = [self expectationWithDescription:@"Tag lost"];
+    lostExpectation.inverted = YES;
+    YKFNFCTagAvailabilityMonitor *monitor = [self monitorWithLostExpectation:lostExpectation];
+    [monitor start];
+    [monitor stop];
+    
+    self.tagAvailable = NO;
+    [self waitForExpectations:@[lostExpectation] timeout:0.2];
+}
+
+@end
@@ -9,6 +9,7 @@
 #import <XCTest/XCTest.h>
 
 #import "YKFNSDataAdditions.h"
+#import "YKFNSDataAdditions+Private.h"
 
 @interface YKFNSDataAdditionsTests : XCTestCase
 @end
@@ -43,4 +44,75 @@
     XCTAssertNil(result, @"Returned nil because the secret contains symbol that could not be decoded");
 }
 
+- (void)test_WhenEncodingRFC4648Vectors_Base32MatchesTheVectors {
+    NSDictionary<NSString *, NSString *> *vectors = @{@"": @"", @"f": @"MY======", @"fo": @"MZXQ====", @"foo": @"MZXW6===",
+                                                      @"foob": @"MZXW6YQ=", @"fooba": @"MZXW6YTB", @"foobar": @"MZXW6YTBOI======"};
+    for (NSString *plain in vectors) {
+        NSData *data = [plain dataUsingEncoding:NSASCIIStringEncoding];
+        XCTAssertEqualObjects([data ykf_base32String], vectors[plain]);
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:vectors[plain]], data);
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:[vectors[plain].lowercaseString stringByReplacingOccurrencesOfString:@"=" withString:@""]], data);
+    }
+}
+
+- (void)test_WhenEncodingRandomData_CodecsRoundTrip {
+    for (NSUInteger length = 0; length < 70; length++) {
+        NSData *data = [NSData ykf_randomDataOfSize:length] ?: [NSData data];
+        NSString *hex = [data ykf_hexadecimalString];
+        XCTAssertEqual(hex.length, length * 2);
+        XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:hex], data);
+        XCTAssertEqualObjects([NSData ykf_dataWithHexadecimalString:hex.uppercaseString], data);
+
+        XCTAssertEqualObjects([NSData ykf_dataWithBase32String:[data ykf_base32String]], data);
+
+        NSString *websafe = [data ykf_websafeBase64EncodedString];
+        NSString *expected = [[[[data base64EncodedStringWithOptions:0] stringByReplacingOccurrencesOfString:@"+" withString:@"-"]
+                               stringByReplacingOccurrencesOfString:@"/" withString:@"_"] stringByReplacingOccurrencesOfString:@"=" withString:@""];
+        XCTAssertEqualObjects(websafe, expected);
+        XCTAssertEqualObjects([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:websafe dataLength:length], data);
+    }
+}
+
+- (void)test_WhenDecodingInvalidStrings_NilIsReturned {
+    XCTAssertNil([NSData ykf_dataWithHexadecimalString:@"abc"]);
+    XCTAssertNil([NSData ykf_dataWithHexadecimalString:@"0g"]);
+    XCTAssertNil([NSData ykf_dataWithHexadecimalString:@"éé"]);
+    XCTAssertNil([NSData ykf_dataWithBase32String:@"MZXW 6YTB"]);
+    XCTAssertNil([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"Zm9*" dataLength:3]);
+    XCTAssertNil([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"Zm9vY" dataLength:4]);
+    XCTAssertNil([[NSData alloc] ykf_initWithWebsafeBase64EncodedString:@"Zm9v" dataLength:4]);
+}
+
+#pragma mark - Performance
+
+- (void)measureCodecsWithLength:(NSUInteger)length {
+    NSData *data = [NSData ykf_randomDataOfSize:length];
+    NSString *hex = [data ykf_hexadecimalString];
+    NSString *base32 = [data ykf_base32String];
+    NSString *websafe = [data ykf_websafeBase64EncodedString];
+    NSUInteger iterations = MAX(65536 / length, 16);
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < iterations; i++) {
+            [data ykf_hexadecimalString];
+            [NSData ykf_dataWithHexadecimalString:hex];
+            [data ykf_base32String];
+            [NSData ykf_dataWithBase32String:base32];
+            [data ykf_websafeBase64EncodedString];
+            (void)[[NSData alloc] ykf_initWithWebsafeBase64EncodedString:websafe dataLength:length];
+        }
+    }];
+}
+
+- (void)test_CodecPerformance_16B {
+    [self measureCodecsWithLength:16];
+}
+
+- (void)test_CodecPerformance_1KB {
+    [self measureCodecsWithLength:1024];
+}
+
+- (void)test_CodecPerformance_64KB {
+    [self measureCodecsWithLength:65536];
+}
+
 @end
@@ -0,0 +1,146 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyOATHApplet.h"
+#import "YKFOATHSession+Private.h"
+#import "YKFOATHError.h"
+#import "YKFOATHAccessKeyCache.h"
+#import "YKFOATHAccessKeyCache+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+
+@interface YKFOATHAccessKeyCacheTests: YKFTestCase
+@end
+
+@implementation YKFOATHAccessKeyCacheTests
+
+- (void)setUp {
+    [super setUp];
+    [YKFOATHAccessKeyCache.sharedCache invalidate];
+}
+
+- (YKFOATHSession *)oathSessionWithKey:(FakeYubiKey *)key {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"OATH session"];
+    __block YKFOATHSession *result = nil;
+    [YKFOATHSession sessionWithConnectionController:key completion:^(YKFOATHSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        result = session;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    return result;
+}
+
+- (NSError *)performWithSession:(YKFOATHSession *)session block:(void (^)(YKFOATHSessionGenericCompletionBlock completion))block {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"OATH request"];
+    __block NSError *result = nil;
+    block(^(NSError * _Nullable error) {
+        result = error;
+        [expectation fulfill];
+    });
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    return result;
+}
+
+- (void)test_WhenDerivingTheSameAccessKeyTwice_CachedKeyIsReturned {
+    YKFOATHAccessKeyCache *cache = [[YKFOATHAccessKeyCache alloc] initWithCapacity:2];
+    NSData *salt = [NSData dataFromHexString:@"0102030405060708"];
+    NSData *expected = [[@"password" dataUsingEncoding:NSUTF8StringEncoding] ykf_deriveOATHKeyWithSalt:salt];
+
+    XCTAssertEqualObjects([cache accessKeyForPassword:@"password" salt:salt], expected);
+    XCTAssertEqualObjects([cache accessKeyForPassword:@"password" salt:salt], expected);
+    XCTAssertEqual(cache.count, 1);
+
+    [cache accessKeyForPassword:@"other" salt:salt];
+    [cache accessKeyForPassword:@"password" salt:salt];
+    [cache accessKeyForPassword:@"third" salt:salt];
+    // The least recently used entry ("other") was evicted.
+    XCTAssertEqual(cache.count, 2);
+    [cache removeAccessKeyForPassword:@"other" salt:salt];
+    XCTAssertEqual(cache.count, 2);
+    [cache removeAccessKeyForPassword:@"password" salt:salt];
+    XCTAssertEqual(cache.count, 1);
+
+    cache.capacity = 0;
+    XCTAssertEqual(cache.count, 0);
+    XCTAssertEqualObjects([cache accessKeyForPassword:@"password" salt:salt], expected);
+    XCTAssertEqual(cache.count, 0);
+}
+
+- (void)test_WhenInvalidatingDevice_OnlyItsKeysAreRemoved {
+    YKFOATHAccessKeyCache *cache = [[YKFOATHAccessKeyCache alloc] initWithCapacity:8];
+    NSData *salt1 = [NSData dataFromHexString:@"0101010101010101"];
+    NSData *salt2 = [NSData dataFromHexString:@"0202020202020202"];
+    [cache rememberSalt:salt1 forDeviceId:@"device1"];
+    [cache rememberSalt:salt2 forDeviceId:@"device2"];
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Prederive"];
+    [cache prederiveAccessKeyForPassword:@"password" deviceId:nil completion:^(NSUInteger count) {
+        XCTAssertEqual(count, 2);
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    XCTAssertEqual(cache.count, 2);
+
+    [cache invalidateDeviceId:@"device1"];
+    XCTAssertEqual(cache.count, 1);
+    [cache invalidate];
+    XCTAssertEqual(cache.count, 0);
+}
+
+- (void)test_WhenPasswordIsPrederived_UnlockUsesTheCachedKey {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    YKFOATHSession *session = [self oathSessionWithKey:key];
+    XCTAssertNil([self performWithSession:session block:^(YKFOATHSessionGenericCompletionBlock completion) {
+        [session setPassword:@"password" completion:completion];
+    }]);
+    NSString *deviceId = session.deviceId;
+    [YKFOATHAccessKeyCache.sharedCache invalidate];
+
+    // A new session remembers the salt of the key.
+    session = [self oathSessionWithKey:key];
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Prederive"];
+    [YKFOATHAccessKeyCache.sharedCache prederiveAccessKeyForPassword:@"password" deviceId:deviceId completion:^(NSUInteger count) {
+        XCTAssertEqual(count, 1);
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+
+    XCTAssertNil([self performWithSession:session block:^(YKFOATHSessionGenericCompletionBlock completion) {
+        [session unlockWithPassword:@"password" completion:completion];
+    }]);
+    XCTAssertEqual(YKFOATHAccessKeyCache.sharedCache.count, 1);
+
+    // Wrong passwords are not kept.
+    session = [self oathSessionWithKey:key];
+    NSError *error = [self performWithSession:session block:^(YKFOATHSessionGenericCompletionBlock completion) {
+        [session unlockWithPassword:@"wrong" completion:completion];
+    }];
+    XCTAssertEqual(error.code, YKFOATHErrorCodeWrongPassword);
+    XCTAssertEqual(YKFOATHAccessKeyCache.sharedCache.count, 1);
+}
+
+- (void)test_CachedDerivationPerformance {
+    YKFOATHAccessKeyCache *cache = [[YKFOATHAccessKeyCache alloc] initWithCapacity:8];
+    NSData *salt = [NSData dataFromHexString:@"0102030405060708"];
+    [self measureBlock:^{
+        for (int i = 0; i < 1000; i++) {
+            [cache accessKeyForPassword:@"password" salt:salt];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,253 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyPIVApplet.h"
+#import "YKFPIVSession+Private.h"
+#import "YKFPIVManagementKeyType.h"
+#import "YKFPIVObjectCache.h"
+#import "YKFPIVObjectCache+Private.h"
+#import "YKFNSDataAdditions+Private.h"
+#import "YKFTLVRecord.h"
+#import "NSData+GZIP.h"
+
+// Self-signed P-256 certificate, CN=Yubico PIV Test.
+static NSString *const YKFPIVObjectCacheTestsCertificate = @"308201883082012fa00302010202144fce1f38c001a70add0c5aa3449ff8135254f2eb300a06082a8648ce3d040302301a3118301606035504030c0f59756269636f205049562054657374301e170d3236313031393135343433365a170d3336313031363135343433365a301a3118301606035504030c0f59756269636f2050495620546573743059301306072a8648ce3d020106082a8648ce3d030107034200047c48075527158bea714ede8f25204b660e29ee24009cca3c2458ad5133468177c275c6a56ff305054caf092bec0f59dabe3f2c115bf1948ad84a331f67beacfea3533051301d0603551d0e04160414197667656285cba1c17120664904937a61882799301f0603551d23041830168014197667656285cba1c17120664904937a61882799300f0603551d130101ff040530030101ff300a06082a8648ce3d0403020347003044022078476b79311a2b6f803842d5ccfbc018b8c102ba0016df82d53d5ee3c7b00272022074b417b32c7bb8dca10ab1fef606df762cd9567fb934dcd6d5b9e9af7c1155fb";
+
+@interface YKFPIVObjectCacheTests: YKFTestCase
+
+@property (nonatomic) FakeYubiKey *key;
+@property (nonatomic) SecCertificateRef certificate;
+
+@end
+
+@implementation YKFPIVObjectCacheTests
+
+- (void)setUp {
+    [super setUp];
+    [YKFPIVObjectCache.sharedCache invalidate];
+    self.key = [[FakeYubiKey alloc] init];
+    NSData *certificateData = [NSData dataFromHexString:YKFPIVObjectCacheTestsCertificate];
+    self.certificate = SecCertificateCreateWithData(nil, (__bridge CFDataRef)certificateData);
+}
+
+- (void)tearDown {
+    CFRelease(self.certificate);
+    [super tearDown];
+}
+
+- (YKFPIVSession *)pivSession {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV session"];
+    __block YKFPIVSession *result = nil;
+    [YKFPIVSession sessionWithConnectionController:self.key completion:^(YKFPIVSession * _Nullable session, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        result = session;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    return result;
+}
+
+- (NSError *)performWithSession:(YKFPIVSession *)session block:(void (^)(YKFPIVSessionGenericCompletionBlock completion))block {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"PIV request"];
+    __block NSError *result = nil;
+    block(^(NSError * _Nullable error) {
+        result = error;
+        [expectation fulfill];
+    });
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    return result;
+}
+
+- (YKFPIVSession *)authenticatedPIVSession {
+    YKFPIVSession *session = [self pivSession];
+    NSData *defaultKey = [NSData dataFromHexString:@"010203040506070801020304050607080102030405060708"];
+    XCTAssertNil([self performWithSession:session block:^(YKFPIVSessionGenericCompletionBlock completion) {
+        [session authenticateWithManagementKey:defaultKey type:[YKFPIVManagementKeyType TripleDES] completion:completion];
+    }]);
+    return session;
+}
+
+- (NSData *)certificateDataInSlot:(YKFPIVSlot)slot session:(YKFPIVSession *)session error:(NSError **)error {
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"Read certificate"];
+    __block NSData *result = nil;
+    __block NSError *resultError = nil;
+    [session getCertificateInSlot:slot completion:^(SecCertificateRef _Nullable certificate, NSError * _Nullable error) {
+        result = certificate ? (__bridge_transfer NSData *)SecCertificateCopyData(certificate) : nil;
+        resultError = error;
+        [expectation fulfill];
+    }];
+    XCTAssertEqual([XCTWaiter waitForExpectations:@[expectation] timeout:10], XCTWaiterResultCompleted);
+    if (error) {
+        *error = resultError;
+    }
+    return result;
+}
+
+- (NSUInteger)getDataCountSince:(NSUInteger)commandIndex {
+    NSUInteger count = 0;
+    for (NSUInteger i = commandIndex; i < self.key.receivedCommands.count; i++) {
+        count += ((const UInt8 *)self.key.receivedCommands[i].bytes)[1] == 0xCB ? 1 : 0;
+    }
+    return count;
+}
+
+#pragma mark - Cache
+
+- (void)test_WhenStoringObject_CertificateIsReturnedForTheSameKeyOnly {
+    YKFPIVObjectCache *cache = [[YKFPIVObjectCache alloc] initWithCapacity:4];
+    NSData *objectId = [NSData dataFromHexString:@"5fc105"];
+    NSData *object = [NSData dataFromHexString:@"700100"];
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:1 objectId:objectId]);
+
+    SecCertificateRef certificate = [cache copyCertificateForSerialNumber:1 objectId:objectId];
+    XCTAssertEqual(certificate, self.certificate);
+    CFRelease(certificate);
+    XCTAssertNil((__bridge id)[cache copyCertificateForSerialNumber:2 objectId:objectId]);
+    XCTAssertNil((__bridge id)[cache copyCertificateForSerialNumber:1 objectId:[NSData dataFromHexString:@"5fc10a"]]);
+}
+
+- (void)test_WhenStoringTheSameContent_ParsedCertificateIsReused {
+    YKFPIVObjectCache *cache = [[YKFPIVObjectCache alloc] initWithCapacity:4];
+    NSData *objectId = [NSData dataFromHexString:@"5fc105"];
+    NSData *object = [NSData dataFromHexString:@"700100"];
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:1 objectId:objectId]);
+
+    NSData *certificateData = (__bridge_transfer NSData *)SecCertificateCopyData(self.certificate);
+    SecCertificateRef otherCertificate = SecCertificateCreateWithData(nil, (__bridge CFDataRef)certificateData);
+    SecCertificateRef stored = [cache storeObject:object certificate:otherCertificate serialNumber:1 objectId:objectId];
+    XCTAssertEqual(stored, self.certificate);
+    CFRelease(stored);
+
+    stored = [cache storeObject:[NSData dataFromHexString:@"700101"] certificate:otherCertificate serialNumber:1 objectId:objectId];
+    XCTAssertEqual(stored, otherCertificate);
+    CFRelease(stored);
+    CFRelease(otherCertificate);
+    XCTAssertEqual(cache.count, 1);
+}
+
+- (void)test_WhenInvalidating_OnlyTheObjectsOfTheKeyAreRemoved {
+    YKFPIVObjectCache *cache = [[YKFPIVObjectCache alloc] initWithCapacity:4];
+    NSData *authentication = [NSData dataFromHexString:@"5fc105"];
+    NSData *signature = [NSData dataFromHexString:@"5fc10a"];
+    NSData *object = [NSData dataFromHexString:@"700100"];
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:1 objectId:authentication]);
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:1 objectId:signature]);
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:2 objectId:authentication]);
+
+    [cache removeObjectId:authentication serialNumber:@1];
+    XCTAssertEqual(cache.count, 2);
+    [cache removeObjectId:authentication serialNumber:nil];
+    XCTAssertEqual(cache.count, 1);
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:2 objectId:authentication]);
+    [cache invalidateSerialNumber:1];
+    XCTAssertEqual(cache.count, 1);
+    XCTAssertNil((__bridge id)[cache copyCertificateForSerialNumber:1 objectId:signature]);
+}
+
+- (void)test_WhenCacheIsFull_LeastRecentlyUsedObjectIsEvicted {
+    YKFPIVObjectCache *cache = [[YKFPIVObjectCache alloc] initWithCapacity:2];
+    NSData *object = [NSData dataFromHexString:@"700100"];
+    for (UInt32 serialNumber = 1; serialNumber <= 2; serialNumber++) {
+        CFRelease([cache storeObject:object certificate:self.certificate serialNumber:serialNumber objectId:[NSData dataFromHexString:@"5fc105"]]);
+    }
+    CFRelease([cache copyCertificateForSerialNumber:1 objectId:[NSData dataFromHexString:@"5fc105"]]);
+    CFRelease([cache storeObject:object certificate:self.certificate serialNumber:3 objectId:[NSData dataFromHexString:@"5fc105"]]);
+
+    XCTAssertEqual(cache.count, 2);
+    XCTAssertNil((__bridge id)[cache copyCertificateForSerialNumber:2 objectId:[NSData dataFromHexString:@"5fc105"]]);
+    cache.capacity = 0;
+    XCTAssertEqual(cache.count, 0);
+}
+
+#pragma mark - Session
+
+- (void)test_WhenReadingCertificateAgain_NoGetDataIsSent {
+    YKFPIVSession *session = [self authenticatedPIVSession];
+    XCTAssertNil([self performWithSession:session block:^(YKFPIVSessionGenericCompletionBlock completion) {
+        [session putCertificate:self.certificate inSlot:YKFPIVSlotAuthentication completion:completion];
+    }]);
+    NSData *expected = (__bridge_transfer NSData *)SecCertificateCopyData(self.certificate);
+    XCTAssertEqualObjects([self certificateDataInSlot:YKFPIVSlotAuthentication session:session error:nil], expected);
+
+    // A new session, e.g. the next tap, only confirms the serial number.
+    session = [self pivSession];
+    NSUInteger commandIndex = self.key.receivedCommands.count;
+    XCTAssertEqualObjects([self certificateDataInSlot:YKFPIVSlotAuthentication session:session error:nil], expected);
+    XCTAssertEqualObjects([self certificateDataInSlot:YKFPIVSlotAuthentication session:session error:nil], expected);
+    XCTAssertEqual([self getDataCountSince:commandIndex], 0);
+    XCTAssertEqual(self.key.receivedCommands.count - commandIndex, 1);
+
+    // Another key with a different serial number is read.
+    self.key.serialNumber += 1;
+    session = [self pivSession];
+    commandIndex = self.key.receivedCommands.count;
+    XCTAssertEqualObjects([self certificateDataInSlot:YKFPIVSlotAuthentication session:session error:nil], expected);
+    XCTAssertEqual([self getDataCountSince:commandIndex], 1);
+}
+
+- (void)test_WhenDeletingCertificate_CachedCertificateIsRemoved {
+    YKFPIVSession *session = [self authenticatedPIVSession];
+    XCTAssertNil([self performWithSession:session block:^(YKFPIVSessionGenericCompletionBlock completion) {
+        [session putCertificate:self.certificate inSlot:YKFPIVSlotSignature completion:completion];
+    }]);
+    XCTAssertNotNil([self certificateDataInSlot:YKFPIVSlotSignature session:session error:nil]);
+    XCTAssertNil([self performWithSession:session block:^(YKFPIVSessionGenericCompletionBlock completion) {
+        [session deleteCertificateInSlot:YKFPIVSlotSignature completion:completion];
+    }]);
+
+    NSError *error = nil;
+    NSUInteger commandIndex = self.key.receivedCommands.count;
+    XCTAssertNil([self certificateDataInSlot:YKFPIVSlotSignature session:session error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual([self getDataCountSince:commandIndex], 1);
+}
+
+- (void)test_WhenWritingCompressedCertificate_ObjectMatchesTLVEncodingAndReadsBack {
+    YKFPIVSession *session = [self authenticatedPIVSession];
+    XCTAssertNil([self performWithSession:session block:^(YKFPIVSessionGenericCompletionBlock completion) {
+        [session putCertificate:self.certificate inSlot:YKFPIVSlotCardAuth compress:YES completion:completion];
+    }]);
+
+    NSData *certificateData = (__bridge_transfer NSData *)SecCertificateCopyData(self.certificate);
+    NSMutableData *object = [NSMutableData data];
+    [object appendData:[[YKFTLVRecord alloc] initWithTag:0x70 value:[certificateData gzippedData]].data];
+    [object appendData:[[YKFTLVRecord alloc] initWithTag:0x71 value:[NSData dataFromHexString:@"01"]].data];
+    [object appendData:[[YKFTLVRecord alloc] initWithTag:0xfe value:[NSData data]].data];
+    NSMutableData *expected = [NSMutableData data];
+    [expected appendData:[[YKFTLVRecord alloc] initWithTag:0x5c value:[NSData dataFromHexString:@"5fc101"]].data];
+    [expected appendData:[[YKFTLVRecord alloc] initWithTag:0x53 value:object].data];
+    NSData *putDataCommand = self.key.receivedCommands.lastObject;
+    XCTAssertEqual(((const UInt8 *)putDataCommand.bytes)[1], 0xdb);
+    XCTAssertNotEqual([putDataCommand rangeOfData:expected options:0 range:NSMakeRange(0, putDataCommand.length)].location, NSNotFound);
+
+    [YKFPIVObjectCache.sharedCache invalidate];
+    XCTAssertEqualObjects([self certificateDataInSlot:YKFPIVSlotCardAuth session:session error:nil], certificateData);
+}
+
+- (void)test_WhenGzipTrailerIsCorrupt_LengthHintIsBoundedAndInflateFails {
+    NSData *certificateData = (__bridge_transfer NSData *)SecCertificateCopyData(self.certificate);
+    NSMutableData *gzipped = [[certificateData gzippedData] mutableCopy];
+    memset((UInt8 *)gzipped.mutableBytes + gzipped.length - 4, 0xff, 4);
+    XCTAssertLessThanOrEqual(gzipped.gunzippedLengthHint, gzipped.length * 1032);
+
+    // zlib checks ISIZE at the end of the stream, after the bounded buffer was filled.
+    NSMutableData *inflated = [NSMutableData data];
+    XCTAssertFalse([gzipped appendGunzippedDataToData:inflated]);
+    XCTAssertEqual(inflated.length, 0);
+}
+
+@end
@@ -0,0 +1,111 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "YKFSecureArena.h"
+#import "YKFAPDU+Private.h"
+
+@interface YKFSecureArenaTests: YKFTestCase
+
+@property (nonatomic) YKFSecureArena *arena;
+
+@end
+
+@implementation YKFSecureArenaTests
+
+- (void)setUp {
+    [super setUp];
+    self.arena = [[YKFSecureArena alloc] initWithCapacity:256];
+}
+
+- (void)test_WhenCreatingArena_CapacityIsRoundedToPages {
+    XCTAssertNotNil(self.arena);
+    XCTAssertGreaterThanOrEqual(self.arena.capacity, 256);
+    XCTAssertEqual(self.arena.capacity % getpagesize(), 0);
+    XCTAssertNotNil(YKFSecureArena.sharedArena);
+}
+
+- (void)test_WhenScopeEnds_BuffersAreWipedAndEmptied {
+    __block NSMutableData *escaped = nil;
+    [self.arena performWithScope:^(YKFSecureArenaScope *scope) {
+        escaped = [scope dataWithData:[NSData dataFromHexString:@"0102030405060708"]];
+        XCTAssertEqualObjects(escaped, [NSData dataFromHexString:@"0102030405060708"]);
+    }];
+    XCTAssertEqual(escaped.length, 0);
+}
+
+- (void)test_WhenNestingScopes_InnerScopeIsWipedFirst {
+    [self.arena performWithScope:^(YKFSecureArenaScope *outer) {
+        NSMutableData *pin = [outer dataWithData:[NSData dataFromHexString:@"3132333435363738"]];
+        __block NSMutableData *key = nil;
+        [self.arena performWithScope:^(YKFSecureArenaScope *inner) {
+            key = [inner mutableDataWithLength:24];
+            memset(key.mutableBytes, 0xAA, key.length);
+        }];
+        XCTAssertEqual(key.length, 0);
+        XCTAssertEqualObjects(pin, [NSData dataFromHexString:@"3132333435363738"]);
+        
+        NSMutableData *reused = [outer mutableDataWithLength:24];
+        XCTAssertEqualObjects(reused, [NSMutableData dataWithLength:24]);
+    }];
+}
+
+- (void)test_WhenEncodingPin_PaddingIsAppended {
+    [self.arena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSData *pin = [scope UTF8DataWithString:@"123456" paddedToLength:8 padding:0xff];
+        XCTAssertEqualObjects(pin, [NSData dataFromHexString:@"313233343536ffff"]);
+        
+        NSData *longPin = [scope UTF8DataWithString:@"123456789" paddedToLength:8 padding:0xff];
+        XCTAssertEqualObjects(longPin, [NSData dataFromHexString:@"313233343536373839"]);
+        
+        NSData *unicodePin = [scope UTF8DataWithString:@"12é" paddedToLength:0 padding:0x00];
+        XCTAssertEqualObjects(unicodePin, [NSData dataFromHexString:@"3132c3a9"]);
+    }];
+}
+
+- (void)test_WhenArenaIsExhausted_ScopeFallsBackToHeapAndWipesIt {
+    __block NSMutableData *large = nil;
+    [self.arena performWithScope:^(YKFSecureArenaScope *scope) {
+        large = [scope mutableDataWithLength:self.arena.capacity + 1];
+        memset(large.mutableBytes, 0xAA, large.length);
+        XCTAssertEqual(large.length, self.arena.capacity + 1);
+    }];
+    XCTAssertEqual(large.length, 0);
+}
+
+- (void)test_WhenZeroingMutableData_BytesAreCleared {
+    NSMutableData *key = [[NSData dataFromHexString:@"0102030405060708"] mutableCopy];
+    YKFSecureZeroData(key);
+    XCTAssertEqualObjects(key, [NSMutableData dataWithLength:8]);
+    YKFSecureZeroData(nil);
+}
+
+- (void)test_WhenBuildingAPDUInScope_APDUKeepsTheDataUntilWiped {
+    __block YKFAPDU *apdu = nil;
+    [self.arena performWithScope:^(YKFSecureArenaScope *scope) {
+        NSMutableData *pin = [scope UTF8DataWithString:@"123456" paddedToLength:8 padding:0xff];
+        apdu = [[YKFAPDU alloc] initWithCla:0 ins:0x20 p1:0 p2:0x80 data:pin type:YKFAPDUTypeShort];
+    }];
+    XCTAssertEqualObjects(apdu.data, [NSData dataFromHexString:@"313233343536ffff"]);
+    XCTAssertEqualObjects(apdu.apduData, [NSData dataFromHexString:@"0020008008313233343536ffff"]);
+
+    [apdu wipe];
+    XCTAssertEqualObjects(apdu.data, [NSMutableData dataWithLength:8]);
+    XCTAssertEqualObjects(apdu.apduData, [NSMutableData dataWithLength:13]);
+    XCTAssertEqualObjects(apdu.ylpApduData, [NSMutableData dataWithLength:14]);
+}
+
+@end
@@ -0,0 +1,198 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "YKFSmartCardConnectionRegistry+Private.h"
+#import "FakeSmartCard.h"
+
+@interface FakeSmartCardSlotSource: NSObject<YKFSmartCardSlotSource>
+
+@property (nonatomic) NSDictionary<NSString *, FakeSmartCard *> *smartCards;
+@property (nonatomic, copy) dispatch_block_t slotNamesHandler;
+
+@end
+
+@implementation FakeSmartCardSlotSource
+
+- (NSArray<NSString *> *)slotNames {
+    return self.smartCards.allKeys;
+}
+
+- (void)setSmartCards:(NSDictionary<NSString *,FakeSmartCard *> *)smartCards {
+    _smartCards = smartCards;
+    if (self.slotNamesHandler) {
+        self.slotNamesHandler();
+    }
+}
+
+- (void)startObservingSlotNamesWithHandler:(dispatch_block_t)handler {
+    self.slotNamesHandler = handler;
+}
+
+- (void)stopObservingSlotNames {
+    self.slotNamesHandler = nil;
+}
+
+- (id<YKFSmartCardTransport>)makeSmartCardForSlotNamed:(NSString *)slotName {
+    return self.smartCards[slotName];
+}
+
+@end
+
+@interface YKFSmartCardConnectionRegistryTests: YKFTestCase<YKFSmartCardConnectionRegistryDelegate>
+
+@property (nonatomic) FakeSmartCardSlotSource *slotSource;
+@property (nonatomic) YKFSmartCardConnectionRegistry *registry;
+@property (nonatomic) NSMutableArray<NSString *> *connectedSlotNames;
+@property (nonatomic) NSMutableArray<NSString *> *disconnectedSlotNames;
+@property (nonatomic) XCTestExpectation *connectExpectation;
+
+@end
+
+@implementation YKFSmartCardConnectionRegistryTests
+
+- (void)setUp {
+    [super setUp];
+    self.slotSource = [[FakeSmartCardSlotSource alloc] init];
+    self.registry = [[YKFSmartCardConnectionRegistry alloc] initWithSlotSource:self.slotSource];
+    self.registry.delegate = self;
+    self.connectedSlotNames = [[NSMutableArray alloc] init];
+    self.disconnectedSlotNames = [[NSMutableArray alloc] init];
+}
+
+- (void)tearDown {
+    [self.registry stop];
+    self.registry = nil;
+    [super tearDown];
+}
+
+- (NSDictionary<NSString *, FakeSmartCard *> *)smartCardsWithCount:(NSUInteger)count latency:(NSTimeInterval)latency {
+    NSMutableDictionary *smartCards = [[NSMutableDictionary alloc] init];
+    for (NSUInteger i = 0; i < count; ++i) {
+        FakeSmartCard *smartCard = [[FakeSmartCard alloc] init];
+        smartCard.latency = latency;
+        smartCards[[NSString stringWithFormat:@"Yubico YubiKey %02lu", (unsigned long)i]] = smartCard;
+    }
+    return smartCards;
+}
+
+- (void)attachSmartCards:(NSDictionary<NSString *, FakeSmartCard *> *)smartCards {
+    self.connectExpectation = [self expectationWithDescription:@"Connect smart cards"];
+    self.connectExpectation.expectedFulfillmentCount = smartCards.count;
+    self.slotSource.smartCards = smartCards;
+    [self waitForExpectations:@[self.connectExpectation] timeout:2];
+}
+
+// Sends commandCount commands to every connection at once and waits for all responses.
+- (void)executeCommands:(NSUInteger)commandCount onConnections:(NSArray<YKFSmartCardConnection *> *)connections {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Execute commands"];
+    expectation.expectedFulfillmentCount = commandCount * connections.count;
+    for (NSUInteger i = 0; i < commandCount; ++i) {
+        for (YKFSmartCardConnection *connection in connections) {
+            UInt8 command[] = {0x00, 0xA4, 0x04, (UInt8)i};
+            [connection executeRawCommand:[NSData dataWithBytes:command length:4] completion:^(NSData *response, NSError *error) {
+                XCTAssertNil(error);
+                [expectation fulfill];
+            }];
+        }
+    }
+    [self waitForExpectations:@[expectation] timeout:10];
+}
+
+#pragma mark - YKFSmartCardConnectionRegistryDelegate
+
+- (void)smartCardConnectionRegistry:(YKFSmartCardConnectionRegistry *)registry didConnect:(YKFSmartCardConnection *)connection {
+    [self.connectedSlotNames addObject:connection.slotName];
+    [self.connectExpectation fulfill];
+}
+
+- (void)smartCardConnectionRegistry:(YKFSmartCardConnectionRegistry *)registry didDisconnect:(YKFSmartCardConnection *)connection error:(NSError *)error {
+    [self.disconnectedSlotNames addObject:connection.slotName];
+}
+
+#pragma mark - Tests
+
+- (void)test_WhenKeysAreAttached_EveryKeyGetsAConnection {
+    [self.registry start];
+    NSDictionary *smartCards = [self smartCardsWithCount:3 latency:0];
+    [self attachSmartCards:smartCards];
+    
+    XCTAssertEqual(self.registry.connections.count, 3);
+    XCTAssertEqualObjects(self.registry.connections.firstObject.slotName, @"Yubico YubiKey 00");
+    for (NSString *slotName in smartCards) {
+        YKFSmartCardConnection *connection = [self.registry connectionForSlotName:slotName];
+        XCTAssertNotNil(connection);
+        XCTAssertTrue(smartCards[slotName].sessionStarted);
+    }
+}
+
+- (void)test_WhenKeyIsRemoved_OnlyItsConnectionIsClosed {
+    [self.registry start];
+    NSDictionary *smartCards = [self smartCardsWithCount:2 latency:0];
+    [self attachSmartCards:smartCards];
+    YKFSmartCardConnection *remainingConnection = [self.registry connectionForSlotName:@"Yubico YubiKey 00"];
+    
+    self.slotSource.smartCards = @{@"Yubico YubiKey 00": smartCards[@"Yubico YubiKey 00"]};
+    
+    XCTAssertEqualObjects(self.disconnectedSlotNames, @[@"Yubico YubiKey 01"]);
+    XCTAssertFalse([smartCards[@"Yubico YubiKey 01"] sessionStarted]);
+    XCTAssertEqual([self.registry connectionForSlotName:@"Yubico YubiKey 00"], remainingConnection);
+    XCTAssertEqual(self.registry.connections.count, 1);
+}
+
+- (void)test_WhenRegistryStops_AllConnectionsAreClosed {
+    [self.registry start];
+    [self attachSmartCards:[self smartCardsWithCount:2 latency:0]];
+    
+    [self.registry stop];
+    
+    XCTAssertEqual(self.registry.connections.count, 0);
+    XCTAssertEqual(self.disconnectedSlotNames.count, 2);
+}
+
+- (void)test_WhenCommandsAreSentToSeveralKeys_KeysRunInParallelAndKeepTheirOrder {
+    NSUInteger keyCount = 4;
+    NSUInteger commandCount = 5;
+    NSTimeInterval latency = 0.02;
+    [self.registry start];
+    NSDictionary<NSString *, FakeSmartCard *> *smartCards = [self smartCardsWithCount:keyCount latency:latency];
+    [self attachSmartCards:smartCards];
+    
+    NSDate *start = [NSDate date];
+    [self executeCommands:commandCount onConnections:self.registry.connections];
+    NSTimeInterval duration = [[NSDate date] timeIntervalSinceDate:start];
+    
+    // One key at a time would take keyCount * commandCount * latency.
+    XCTAssertLessThan(duration, keyCount * commandCount * latency / 2);
+    for (FakeSmartCard *smartCard in smartCards.allValues) {
+        NSArray<NSData *> *requests = smartCard.receivedRequests;
+        XCTAssertEqual(requests.count, commandCount);
+        for (NSUInteger i = 0; i < requests.count; ++i) {
+            XCTAssertEqual(((UInt8 *)requests[i].bytes)[3], i);
+        }
+    }
+}
+
+- (void)test_EightKeysThroughput {
+    NSUInteger commandCount = 10;
+    [self.registry start];
+    [self attachSmartCards:[self smartCardsWithCount:8 latency:0.005]];
+    [self measureBlock:^{
+        [self executeCommands:commandCount onConnections:self.registry.connections];
+    }];
+}
+
+@end
@@ -15,9 +15,41 @@
 #import <XCTest/XCTest.h>
 #import "YKFTestCase.h"
 #import "FakeYKFConnectionController.h"
+#import "FakeYubiKey.h"
 #import "YKFSmartCardInterface.h"
 #import "YKFAPDU+Private.h"
 
+// A connection controller implementing only the required members of the protocol.
+@interface YKFMinimalConnectionController: NSObject<YKFConnectionControllerProtocol>
+
+@property (nonatomic) NSTimeInterval lastTimeout;
+
+@end
+
+@implementation YKFMinimalConnectionController
+
+- (void)execute:(YKFAPDU *)command completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    [self execute:command timeout:0 completion:completion];
+}
+
+- (void)execute:(YKFAPDU *)command timeout:(NSTimeInterval)timeout completion:(YKFConnectionControllerCommandResponseBlock)completion {
+    self.lastTimeout = timeout;
+    completion([NSData dataFromHexString:@"01029000"], nil, 0);
+}
+
+- (void)dispatchBlockOnCommunicationQueue:(YKFConnectionControllerCommunicationQueueBlock)block {
+    block([[NSOperation alloc] init]);
+}
+
+- (void)closeConnectionWithCompletion:(YKFConnectionControllerCompletionBlock)completion {
+    completion();
+}
+
+- (void)cancelAllCommands {
+}
+
+@end
+
 @interface YKFSmartCardInterfaceTests: YKFTestCase
 
 @property (nonatomic) FakeYKFConnectionController *keyConnectionController;
@@ -96,4 +128,45 @@
     XCTAssert(result == XCTWaiterResultCompleted, @"");
 }
 
+- (void)test_WhenRunningSmartCardCommandsAgainstTheKey_ChainedResponseIsRead {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.maxResponseLength = 8;
+    self.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:key];
+    
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"SmartCardChainedResponse"];
+
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithData:[NSData dataFromHexString:@"00a4040008a000000527471117"]];
+    
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        NSString *version = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        XCTAssertEqualObjects(version, @"Virtual mgr - FW version 5.4.3");
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    XCTAssertEqual(key.receivedCommands.count, 4);
+}
+
+- (void)test_WhenControllerImplementsOnlyTheRequiredMembers_CommandsAreSentWithoutPriority {
+    YKFMinimalConnectionController *connectionController = [[YKFMinimalConnectionController alloc] init];
+    connectionController.lastTimeout = -1;
+    self.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:connectionController];
+    XCTAssertNil(self.smartCardInterface.cancellationToken);
+    XCTAssertNil(self.smartCardInterface.metrics);
+    XCTAssertNil(self.smartCardInterface.timeoutPolicy);
+
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"SmartCardMinimalController"];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithData:[NSData dataFromHexString:@"00010000"]];
+    [self.smartCardInterface executeCommand:apdu completion:^(NSData * _Nullable data, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, [NSData dataFromHexString:@"0102"]);
+        [expectation fulfill];
+    }];
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    // The adaptive timeout is left to the controller.
+    XCTAssertEqual(connectionController.lastTimeout, 0);
+}
+
 @end
@@ -0,0 +1,188 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyPIVApplet.h"
+#import "YKFSmartCardInterface.h"
+#import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Private.h"
+#import "YKFSessionError.h"
+#import "YKFAPDUError.h"
+#import "YKFNSDataAdditions+Private.h"
+
+// Records the chunks and the number of commands the key had received when each chunk arrived.
+@interface YKFRecordingResponseConsumer: NSObject<YKFSmartCardResponseConsumer>
+
+@property (nonatomic) FakeYubiKey *key;
+@property (nonatomic) NSMutableArray<NSData *> *chunks;
+@property (nonatomic) NSMutableArray<NSNumber *> *commandCounts;
+@property (nonatomic) NSUInteger finishCount;
+@property (nonatomic) NSUInteger failingChunkIndex;
+@property (nonatomic) BOOL failsToFinish;
+
+@end
+
+@implementation YKFRecordingResponseConsumer
+
+- (instancetype)initWithKey:(FakeYubiKey *)key {
+    self = [super init];
+    if (self) {
+        self.key = key;
+        self.chunks = [[NSMutableArray alloc] init];
+        self.commandCounts = [[NSMutableArray alloc] init];
+        self.failingChunkIndex = NSNotFound;
+    }
+    return self;
+}
+
+- (BOOL)consumeResponseChunk:(NSData *)chunk error:(NSError **)error {
+    if (self.chunks.count == self.failingChunkIndex) {
+        *error = [NSError errorWithDomain:@"test" code:1 userInfo:nil];
+        return NO;
+    }
+    [self.chunks addObject:[chunk copy]];
+    [self.commandCounts addObject:@(self.key.receivedCommands.count)];
+    return YES;
+}
+
+- (BOOL)finishResponseWithError:(NSError **)error {
+    self.finishCount++;
+    if (self.failsToFinish) {
+        *error = [NSError errorWithDomain:@"test" code:2 userInfo:nil];
+        return NO;
+    }
+    return YES;
+}
+
+- (NSData *)data {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    for (NSData *chunk in self.chunks) {
+        [data appendData:chunk];
+    }
+    return data;
+}
+
+@end
+
+@interface YKFSmartCardResponseConsumerTests: YKFTestCase
+
+@property (nonatomic) FakeYubiKey *key;
+@property (nonatomic) YKFSmartCardInterface *smartCardInterface;
+@property (nonatomic) NSData *object;
+
+@end
+
+@implementation YKFSmartCardResponseConsumerTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[FakeYubiKey alloc] init];
+    self.key.maxResponseLength = 64;
+    self.object = [NSData ykf_randomDataOfSize:1000];
+    FakeYubiKeyPIVApplet *piv = [self.key appletOfClass:[FakeYubiKeyPIVApplet class]];
+    [piv setObject:self.object forObjectId:[NSData dataWithBytes:(UInt8[]){0x5F, 0xC1, 0x05} length:3]];
+    self.smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:self.key];
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Select PIV"];
+    YKFSelectApplicationAPDU *selectApdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNamePIV];
+    [self.smartCardInterface selectApplication:selectApdu completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+}
+
+- (YKFAPDU *)getDataCommandWithObjectId:(UInt8)objectIdByte {
+    NSData *data = [NSData dataWithBytes:(UInt8[]){0x5C, 0x03, 0x5F, 0xC1, objectIdByte} length:5];
+    return [[YKFAPDU alloc] initWithCla:0 ins:0xCB p1:0x3F p2:0xFF data:data type:YKFAPDUTypeExtended];
+}
+
+- (NSError *)executeWithConsumer:(YKFRecordingResponseConsumer *)consumer objectId:(UInt8)objectIdByte {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Get data"];
+    __block NSError *result = nil;
+    [self.smartCardInterface executeCommand:[self getDataCommandWithObjectId:objectIdByte] sendRemainingIns:YKFSmartCardInterfaceSendRemainingInsNormal timeout:YKFTimeoutPolicyAdaptiveTimeout consumer:consumer completion:^(NSError *error) {
+        result = error;
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    return result;
+}
+
+- (NSUInteger)getResponseCount {
+    NSUInteger count = 0;
+    for (NSData *command in self.key.receivedCommands) {
+        count += ((const UInt8 *)command.bytes)[1] == 0xC0 ? 1 : 0;
+    }
+    return count;
+}
+
+- (void)test_WhenResponseIsChained_ChunksArePassedAsTheyArrive {
+    YKFRecordingResponseConsumer *consumer = [[YKFRecordingResponseConsumer alloc] initWithKey:self.key];
+    XCTAssertNil([self executeWithConsumer:consumer objectId:0x05]);
+    
+    // 0x53, 0x82, 2 length bytes and the object, in chunks of 64 bytes.
+    XCTAssertEqual(consumer.chunks.count, (1004 + 63) / 64);
+    XCTAssertEqual(consumer.finishCount, 1);
+    XCTAssertEqualObjects([consumer.data subdataWithRange:NSMakeRange(4, 1000)], self.object);
+    
+    // The first chunk is passed on before the rest of the response is read.
+    XCTAssertLessThan(consumer.commandCounts.firstObject.unsignedIntegerValue, self.key.receivedCommands.count);
+}
+
+- (void)test_WhenConsumerFails_RemainingChunksAreNotRead {
+    YKFRecordingResponseConsumer *consumer = [[YKFRecordingResponseConsumer alloc] initWithKey:self.key];
+    consumer.failingChunkIndex = 1;
+    NSError *error = [self executeWithConsumer:consumer objectId:0x05];
+    
+    XCTAssertEqual(error.code, 1);
+    XCTAssertEqual(consumer.chunks.count, 1);
+    XCTAssertEqual(consumer.finishCount, 0);
+    XCTAssertEqual([self getResponseCount], 1);
+}
+
+- (void)test_WhenConsumerFailsToFinish_CommandFails {
+    YKFRecordingResponseConsumer *consumer = [[YKFRecordingResponseConsumer alloc] initWithKey:self.key];
+    consumer.failsToFinish = YES;
+    NSError *error = [self executeWithConsumer:consumer objectId:0x05];
+    
+    XCTAssertEqual(error.code, 2);
+    XCTAssertEqual(consumer.finishCount, 1);
+}
+
+- (void)test_WhenKeyReturnsError_ConsumerIsNotCalled {
+    YKFRecordingResponseConsumer *consumer = [[YKFRecordingResponseConsumer alloc] initWithKey:self.key];
+    NSError *error = [self executeWithConsumer:consumer objectId:0x0A];
+    
+    XCTAssertEqual(error.code, YKFAPDUErrorCodeMissingFile);
+    XCTAssertEqual(consumer.chunks.count, 0);
+    XCTAssertEqual(consumer.finishCount, 0);
+}
+
+- (void)test_WhenResponseIsBuffered_ItMatchesTheChunks {
+    YKFRecordingResponseConsumer *consumer = [[YKFRecordingResponseConsumer alloc] initWithKey:self.key];
+    XCTAssertNil([self executeWithConsumer:consumer objectId:0x05]);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Get data"];
+    [self.smartCardInterface executeCommand:[self getDataCommandWithObjectId:0x05] completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, consumer.data);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+}
+
+@end
@@ -0,0 +1,154 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyPIVApplet.h"
+#import "YKFTLVPushParser.h"
+#import "YKFSmartCardInterface.h"
+#import "YKFSelectApplicationAPDU.h"
+#import "YKFAPDU+Private.h"
+#import "YKFSessionError.h"
+#import "YKFNSDataAdditions+Private.h"
+
+@interface YKFTLVPushParserTests: YKFTestCase
+
+@property (nonatomic) NSMutableArray<YKFTLVRecord *> *records;
+@property (nonatomic) YKFTLVPushParser *parser;
+
+@end
+
+@implementation YKFTLVPushParserTests
+
+- (void)setUp {
+    [super setUp];
+    self.records = [[NSMutableArray alloc] init];
+    NSMutableArray<YKFTLVRecord *> *records = self.records;
+    self.parser = [[YKFTLVPushParser alloc] initWithRecordHandler:^(YKFTLVRecord *record) {
+        [records addObject:record];
+    }];
+}
+
+- (NSData *)sequenceData {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    [data appendData:[NSData dataFromHexString:@"1e03112233"]];
+    [data appendData:[NSData dataFromHexString:@"1e00"]];
+    [data appendData:[[YKFTLVRecord alloc] initWithTag:0x53 value:[NSData ykf_randomDataOfSize:300]].data];
+    [data appendData:[NSData dataFromHexString:@"DF81818181818101 03 303132"]];
+    [data appendData:[[YKFTLVRecord alloc] initWithTag:0x7F49 value:[NSData ykf_randomDataOfSize:0x88]].data];
+    return data;
+}
+
+- (void)assertRecords:(NSArray<YKFTLVRecord *> *)records equalToRecords:(NSArray<YKFTLVRecord *> *)expected {
+    XCTAssertEqual(records.count, expected.count);
+    for (NSUInteger i = 0; i < MIN(records.count, expected.count); i++) {
+        XCTAssertEqual(records[i].tag, expected[i].tag);
+        XCTAssertEqualObjects(records[i].value, expected[i].value);
+    }
+}
+
+- (void)test_WhenDataIsSplitAtAnyOffset_RecordsMatchTheSequenceParser {
+    NSData *data = [self sequenceData];
+    NSArray<YKFTLVRecord *> *expected = [YKFTLVRecord sequenceOfRecordsFromData:data];
+    XCTAssertEqual(expected.count, 5);
+    
+    for (NSUInteger split = 0; split <= data.length; split++) {
+        [self.records removeAllObjects];
+        NSError *error = nil;
+        XCTAssertTrue([self.parser pushData:[data subdataWithRange:NSMakeRange(0, split)] error:&error]);
+        XCTAssertTrue([self.parser pushData:[data subdataWithRange:NSMakeRange(split, data.length - split)] error:&error]);
+        XCTAssertTrue([self.parser finishWithError:&error]);
+        XCTAssertNil(error);
+        [self assertRecords:self.records equalToRecords:expected];
+    }
+}
+
+- (void)test_WhenDataIsPushedByteByByte_RecordsAreEmittedAsTheyComplete {
+    NSData *data = [NSData dataFromHexString:@"1e031122331f2001aa"];
+    const UInt8 *bytes = data.bytes;
+    NSArray<NSNumber *> *expectedCounts = @[@0, @0, @0, @0, @1, @1, @1, @1, @2];
+    
+    for (NSUInteger i = 0; i < data.length; i++) {
+        XCTAssertTrue([self.parser pushData:[NSData dataWithBytes:bytes + i length:1] error:nil]);
+        XCTAssertEqual(self.records.count, expectedCounts[i].unsignedIntegerValue);
+        XCTAssertEqual(self.parser.hasPartialRecord, i != 4 && i != 8);
+    }
+    XCTAssertEqual(self.records[1].tag, 0x1f20);
+    XCTAssertEqualObjects(self.records[1].value, [NSData dataFromHexString:@"aa"]);
+}
+
+- (void)test_WhenDataEndsInRecord_FinishFails {
+    XCTAssertTrue([self.parser pushData:[NSData dataFromHexString:@"1e8201"] error:nil]);
+    NSError *error = nil;
+    XCTAssertFalse([self.parser finishWithError:&error]);
+    XCTAssertEqual(error.code, YKFSessionErrorUnexpectedResult);
+    XCTAssertEqual(self.records.count, 0);
+    
+    // The parser is reset by finish.
+    XCTAssertTrue([self.parser pushData:[NSData dataFromHexString:@"1e00"] error:nil]);
+    XCTAssertTrue([self.parser finishWithError:nil]);
+    XCTAssertEqual(self.records.count, 1);
+}
+
+- (void)test_WhenDataIsInvalid_ParserFailsUntilReset {
+    NSArray<NSString *> *invalidData = @[@"DF8181818181818101 03 303132", @"1e80", @"1e89010203040506070809"];
+    for (NSString *hex in invalidData) {
+        NSError *error = nil;
+        XCTAssertFalse([self.parser pushData:[NSData dataFromHexString:hex] error:&error]);
+        XCTAssertEqual(error.code, YKFSessionErrorUnexpectedResult);
+        XCTAssertFalse([self.parser pushData:[NSData dataFromHexString:@"1e00"] error:nil]);
+        [self.parser reset];
+    }
+    XCTAssertEqual(self.records.count, 0);
+}
+
+- (void)test_WhenValueIsTooLong_ParserFailsBeforeReadingIt {
+    self.parser.maximumValueLength = 16;
+    XCTAssertTrue([self.parser pushData:[[YKFTLVRecord alloc] initWithTag:0x53 value:[NSData ykf_randomDataOfSize:16]].data error:nil]);
+    XCTAssertFalse([self.parser pushData:[NSData dataFromHexString:@"5311"] error:nil]);
+    XCTAssertEqual(self.records.count, 1);
+}
+
+- (void)test_WhenUsedAsResponseConsumer_ChainedResponseIsParsed {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.maxResponseLength = 64;
+    NSData *object = [NSData ykf_randomDataOfSize:1000];
+    FakeYubiKeyPIVApplet *piv = [key appletOfClass:[FakeYubiKeyPIVApplet class]];
+    [piv setObject:object forObjectId:[NSData dataWithBytes:(UInt8[]){0x5F, 0xC1, 0x05} length:3]];
+    YKFSmartCardInterface *smartCardInterface = [[YKFSmartCardInterface alloc] initWithConnectionController:key];
+    
+    XCTestExpectation *selectExpectation = [self expectationWithDescription:@"Select PIV"];
+    YKFSelectApplicationAPDU *selectApdu = [[YKFSelectApplicationAPDU alloc] initWithApplicationName:YKFSelectApplicationAPDUNamePIV];
+    [smartCardInterface selectApplication:selectApdu completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(error);
+        [selectExpectation fulfill];
+    }];
+    [self waitForExpectations:@[selectExpectation] timeout:5];
+    
+    NSData *data = [NSData dataWithBytes:(UInt8[]){0x5C, 0x03, 0x5F, 0xC1, 0x05} length:5];
+    YKFAPDU *apdu = [[YKFAPDU alloc] initWithCla:0 ins:0xCB p1:0x3F p2:0xFF data:data type:YKFAPDUTypeExtended];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Get data"];
+    [smartCardInterface executeCommand:apdu sendRemainingIns:YKFSmartCardInterfaceSendRemainingInsNormal timeout:YKFTimeoutPolicyAdaptiveTimeout consumer:self.parser completion:^(NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:5];
+    
+    XCTAssertEqual(self.records.count, 1);
+    XCTAssertEqual(self.records.firstObject.tag, 0x53);
+    XCTAssertEqualObjects(self.records.firstObject.value, object);
+}
+
+@end
@@ -0,0 +1,169 @@
+// Copyright 2018-2026 Yubico AB
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#import <XCTest/XCTest.h>
+
+#import "YKFTestCase.h"
+#import "FakeYubiKey.h"
+#import "YKFTimeoutPolicy.h"
+#import "YKFAPDU+Private.h"
+#import "YKFSessionError.h"
+
+@interface YKFTimeoutPolicyTests: YKFTestCase
+
+@property (nonatomic) YKFTimeoutPolicy *policy;
+
+@end
+
+@implementation YKFTimeoutPolicyTests
+
+- (void)setUp {
+    [super setUp];
+    self.policy = [[YKFTimeoutPolicy alloc] init];
+}
+
+- (void)recordExecutionTime:(NSTimeInterval)executionTime count:(NSUInteger)count forIns:(UInt8)ins {
+    for (NSUInteger i = 0; i < count; i++) {
+        [self.policy recordExecutionTime:executionTime forIns:ins];
+    }
+}
+
+- (YKFAPDU *)commandWithIns:(UInt8)ins {
+    return [[YKFAPDU alloc] initWithData:[NSData dataWithBytes:(UInt8[]){0x00, ins, 0x00, 0x00} length:4]];
+}
+
+#pragma mark - Policy
+
+- (void)test_WhenInstructionHasTooFewSamples_DefaultTimeoutIsUsed {
+    [self recordExecutionTime:0.01 count:7 forIns:0xCB];
+    XCTAssertEqual([self.policy timeoutForIns:0xCB], 10.0);
+    
+    [self.policy recordExecutionTime:0.01 forIns:0xCB];
+    XCTAssertEqual([self.policy timeoutForIns:0xCB], 1.0);
+    XCTAssertEqual([self.policy timeoutForIns:0xFD], 10.0);
+}
+
+- (void)test_LearnedTimeoutIsTheSlowestSampleTimesTheFactorWithinBounds {
+    [self recordExecutionTime:0.1 count:31 forIns:0xCB];
+    [self.policy recordExecutionTime:0.6 forIns:0xCB];
+    XCTAssertEqualWithAccuracy([self.policy timeoutForIns:0xCB], 2.4, 0.0001);
+    
+    [self recordExecutionTime:5 count:8 forIns:0xFD];
+    XCTAssertEqual([self.policy timeoutForIns:0xFD], 10.0);
+    
+    self.policy.latencyFactor = 2;
+    self.policy.minimumTimeout = 0.1;
+    [self recordExecutionTime:0.02 count:8 forIns:0xCA];
+    XCTAssertEqualWithAccuracy([self.policy timeoutForIns:0xCA], 0.1, 0.0001);
+}
+
+- (void)test_WhenInstructionGetsFaster_OldSamplesAreForgotten {
+    [self recordExecutionTime:2 count:32 forIns:0xCB];
+    XCTAssertEqual([self.policy timeoutForIns:0xCB], 8.0);
+    
+    [self recordExecutionTime:0.05 count:32 forIns:0xCB];
+    XCTAssertEqualWithAccuracy([self.policy timeoutForIns:0xCB], 1.0, 0.0001);
+}
+
+- (void)test_TouchAndKeyGenerationInstructionsHaveFixedTimeouts {
+    [self recordExecutionTime:0.01 count:32 forIns:0x47];
+    XCTAssertEqual([self.policy timeoutForIns:0x47], 120.0);
+    XCTAssertEqual([self.policy timeoutForIns:0x87], 120.0);
+    XCTAssertEqual([self.policy timeoutForIns:0xA2], 30.0);
+    XCTAssertEqual([self.policy timeoutForIns:0x10], 30.0);
+    XCTAssertEqual([self.policy timeoutForCommand:[self commandWithIns:0x01]], 30.0);
+    
+    // Fast SELECT samples don't shorten OATH CALCULATE ALL, which shares the instruction.
+    [self recordExecutionTime:0.01 count:32 forIns:0xA4];
+    XCTAssertEqual([self.policy timeoutForIns:0xA4], 10.0);
+    
+    [self.policy setTimeout:5 forIns:0xA2];
+    XCTAssertEqual([self.policy timeoutForIns:0xA2], 5.0);
+    
+    [self.policy removeTimeoutForIns:0x47];
+    XCTAssertEqualWithAccuracy([self.policy timeoutForIns:0x47], 1.0, 0.0001);
+}
+
+- (void)test_WhenOneApplicationSendsFastPayloadCommands_OtherApplicationsKeepTheirTimeout {
+    // Writing small PIV objects doesn't shorten the timeout of a large OpenPGP PUT DATA, nor of an RSA 4096 IMPORT
+    // or ATTEST after EC keys.
+    [self recordExecutionTime:0.02 count:32 forIns:0xDB];
+    [self recordExecutionTime:0.05 count:32 forIns:0xFE];
+    [self recordExecutionTime:0.1 count:32 forIns:0xF9];
+    XCTAssertEqual([self.policy timeoutForIns:0xDB], 10.0);
+    XCTAssertEqual([self.policy timeoutForIns:0xFE], 10.0);
+    XCTAssertEqual([self.policy timeoutForIns:0xF9], 10.0);
+}
+
+- (void)test_WhenLearningIsDisabledOrReset_DefaultTimeoutIsUsed {
+    [self recordExecutionTime:0.01 count:8 forIns:0xCB];
+    self.policy.learningEnabled = NO;
+    XCTAssertEqual([self.policy timeoutForIns:0xCB], 10.0);
+    
+    self.policy.learningEnabled = YES;
+    XCTAssertEqualWithAccuracy([self.policy timeoutForIns:0xCB], 1.0, 0.0001);
+    
+    [self.policy reset];
+    XCTAssertEqual([self.policy timeoutForIns:0xCB], 10.0);
+    XCTAssertEqual([self.policy timeoutForIns:0x47], 120.0);
+}
+
+#pragma mark - Connection controller
+
+- (void)test_WhenKeyStopsAnswering_CommandFailsAfterTheLearnedTimeout {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.commandLatency = 0.01;
+    
+    XCTestExpectation *learnExpectation = [self expectationWithDescription:@"Commands completed"];
+    learnExpectation.expectedFulfillmentCount = 8;
+    for (NSUInteger i = 0; i < 8; i++) {
+        [key execute:[self commandWithIns:0xCB] completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+            XCTAssertNil(error);
+            [learnExpectation fulfill];
+        }];
+    }
+    [self waitForExpectations:@[learnExpectation] timeout:5];
+    XCTAssertEqualWithAccuracy([key.timeoutPolicy timeoutForIns:0xCB], 1.0, 0.0001);
+    
+    key.commandLatency = 10;
+    NSDate *start = [NSDate date];
+    XCTestExpectation *timeoutExpectation = [self expectationWithDescription:@"Command timed out"];
+    [key execute:[self commandWithIns:0xCB] completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertNil(response);
+        XCTAssertEqual(error.code, YKFSessionErrorReadTimeoutCode);
+        [timeoutExpectation fulfill];
+    }];
+    [self waitForExpectations:@[timeoutExpectation] timeout:3];
+    NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+    XCTAssertGreaterThanOrEqual(elapsed, 0.9);
+    XCTAssertLessThan(elapsed, 2);
+    
+    // The timed out command is not learned.
+    XCTAssertEqualWithAccuracy([key.timeoutPolicy timeoutForIns:0xCB], 1.0, 0.0001);
+}
+
+- (void)test_WhenTimeoutIsExplicit_PolicyIsNotUsed {
+    FakeYubiKey *key = [[FakeYubiKey alloc] init];
+    key.commandLatency = 0.3;
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Command timed out"];
+    [key execute:[self commandWithIns:0xCB] timeout:0.1 completion:^(NSData *response, NSError *error, NSTimeInterval executionTime) {
+        XCTAssertEqual(error.code, YKFSessionErrorReadTimeoutCode);
+        XCTAssertLessThan(executionTime, 0.3);
+        [expectation fulfill];
+    }];
+    [self waitForExpectations:@[expectation] timeout:2];
+}
+
+@end
@@ -18,6 +18,9 @@
 #import "YKFU2FSession.h"
 #import "YKFU2FSession+Private.h"
 #import "FakeYKFConnectionController.h"
+#import "FakeYubiKey.h"
+#import "FakeYubiKeyFIDOApplet.h"
+#import "YKFNSDataAdditions+Private.h"
 
 #import "YKFAPDUError.h"
 #import "YKFU2FError.h"
@@ -25,6 +28,7 @@
 @interface YKFU2FServiceTests: YKFTestCase
 
 @property (nonatomic) FakeYKFConnectionController *keyConnectionController;
+@property (nonatomic) FakeYubiKey *key;
 @property (nonatomic) YKFU2FSession *session;
 
 // Predefined U2F params
@@ -42,49 +46,70 @@
     self.keyHandle  = @"UiC-Kth0iN3JmoSHFeHPu5M8GUvbhC-Gv8n0q0OBt42F3S1qTZBX81UudCuT29utRQZlTP5QpO_OncQFn5Mjaw";
     self.appId = @"https://demo.yubico.com";
     self.keyConnectionController = [[FakeYKFConnectionController alloc] init];
+    self.key = [[FakeYubiKey alloc] init];
+}
+
+- (void)registerKeyHandle {
+    FakeYubiKeyFIDOApplet *fido = [self.key appletOfClass:FakeYubiKeyFIDOApplet.class];
+    NSData *keyHandle = [[NSData alloc] ykf_initWithWebsafeBase64EncodedString:self.keyHandle dataLength:64];
+    [fido addKeyHandle:keyHandle applicationParameter:[[self.appId dataUsingEncoding:NSUTF8StringEncoding] ykf_SHA256]];
 }
 
 - (void)test_WhenExecutingRegisterRequest_RequestIsForwarededToTheKey {
-    NSData *applicationSelectionResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
-    NSData *commandResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
-    self.keyConnectionController.commandExecutionResponseDataSequence = @[applicationSelectionResponse, commandResponse];
-    
     XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
     
-    [YKFU2FSession sessionWithConnectionController:self.keyConnectionController completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+    [YKFU2FSession sessionWithConnectionController:self.key completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
         self.session = session; // save session to keep it from being dealloced by ARC
         [self.session registerWithChallenge:self.challenge appId:self.appId completion:^(YKFU2FRegisterResponse * _Nullable response, NSError * _Nullable error) {
             XCTAssertNil(error, @"Unexpected error: %@", error);
             XCTAssertNotNil(response);
+            XCTAssertEqual(((const UInt8 *)response.registrationData.bytes)[0], 0x05);
             [expectation fulfill];
         }];
     }];
 
     XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
     XCTAssert(result == XCTWaiterResultCompleted, @"");
-    XCTAssertNotNil(self.keyConnectionController.executionCommand, @"No command data executed on the connection controller.");
+    XCTAssertEqual(self.key.receivedCommands.count, 2);
+}
+
+- (void)test_WhenExecutingRegisterRequestWithTouchRequired_RequestIsRetriedUntilTouch {
+    self.key.touchDelay = 0.6;
+    XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
+    
+    [YKFU2FSession sessionWithConnectionController:self.key completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+        self.session = session;
+        [self.session registerWithChallenge:self.challenge appId:self.appId completion:^(YKFU2FRegisterResponse * _Nullable response, NSError * _Nullable error) {
+            XCTAssertNil(error, @"Unexpected error: %@", error);
+            XCTAssertNotNil(response);
+            [expectation fulfill];
+        }];
+    }];
+
+    XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
+    XCTAssert(result == XCTWaiterResultCompleted, @"");
+    XCTAssertGreaterThan(self.key.receivedCommands.count, 2);
 }
 
 - (void)test_WhenExecutingSignRequest_RequestIsForwarededToTheKey {
-    NSData *applicationSelectionResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
-    NSData *commandResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
-    self.keyConnectionController.commandExecutionResponseDataSequence = @[applicationSelectionResponse, commandResponse];
+    [self registerKeyHandle];
 
     XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
     
-    [YKFU2FSession sessionWithConnectionController:self.keyConnectionController completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+    [YKFU2FSession sessionWithConnectionController:self.key completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
         self.session = session;
         
         [self.session signWithChallenge:self.challenge keyHandle:self.keyHandle appId:self.appId completion:^(YKFU2FSignResponse * _Nullable response, NSError * _Nullable error) {
             XCTAssertNil(error, @"Unexpected error: %@", error);
             XCTAssertNotNil(response);
+            XCTAssertEqualObjects(response.keyHandle, self.keyHandle);
             [expectation fulfill];
         }];
     }];
 
     XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
     XCTAssert(result == XCTWaiterResultCompleted, @"");
-    XCTAssertNotNil(self.keyConnectionController.executionCommand, @"No command data executed on the connection controller.");
+    XCTAssertEqual(self.key.receivedCommands.count, 2);
 }
 
 #pragma mark - Generic Error Tests
@@ -200,14 +225,11 @@
 #pragma mark - Mapped Error Tests
 
 - (void)test_WhenExecutingSignRequestWithoutRegistration_MappedErrorIsReceivedBack {
-    NSData *applicationSelectionResponse = [NSData dataWithBytes:@[@(0x00), @(0x90), @(0x00)]];
-    NSData *errorResponse = [NSData dataWithBytes:@[@(0x00), @(0x6A), @(0x80)]]; // Wrong data code
     NSUInteger expectedErrorCode = YKFU2FErrorCodeU2FSigningUnavailable;
-    self.keyConnectionController.commandExecutionResponseDataSequence = @[applicationSelectionResponse, errorResponse];
     
     XCTestExpectation *expectation = [[XCTestExpectation alloc] initWithDescription:@"U2F"];
 
-    [YKFU2FSession sessionWithConnectionController:self.keyConnectionController completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
+    [YKFU2FSession sessionWithConnectionController:self.key completion:^(YKFU2FSession * _Nullable session, NSError * _Nullable error) {
         self.session = session;
         [self.session signWithChallenge:self.challenge keyHandle:self.keyHandle appId:self.appId completion:^(YKFU2FSignResponse * _Nullable response, NSError * _Nullable error) {
             XCTAssertNotNil(error, @"Unexpected error: %@", error);
@@ -219,7 +241,7 @@
 
     XCTWaiterResult result = [XCTWaiter waitForExpectations:@[expectation] timeout:10];
     XCTAssert(result == XCTWaiterResultCompleted, @"");
-    XCTAssertNotNil(self.keyConnectionController.executionCommand, @"No command data executed on the connection controller.");
+    XCTAssertEqual(self.key.receivedCommands.count, 2);
 }
 
 #pragma mark - Key State Tests